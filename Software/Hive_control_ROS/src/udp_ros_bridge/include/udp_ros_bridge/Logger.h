@@ -0,0 +1,261 @@
+#ifndef UDP_ROS_BRIDGE_LOGGER_H
+#define UDP_ROS_BRIDGE_LOGGER_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+/**
+ * @file Logger.h
+ * @brief 异步日志
+ * @details 热路径只把"格式id（调用点指针）+ 参数"拷贝进本线程的无锁环形缓冲区，
+ *          格式化和终端输出全部在后台线程完成，避免 std::cout 在高包率下串行化所有线程。
+ *
+ *          格式串使用 {} 作为占位符：
+ *              LOG_INFO("收到来自 {}:{} ({} 字节)", ip, port, len);
+ *          字符串参数会被拷贝（最长 LOG_STRING_MAX-1 字节，超出截断），
+ *          整数、浮点、bool 按值拷贝。最多 LOG_MAX_ARGS 个参数。
+ *
+ *          *_EVERY(ms, ...) 版本在同一调用点 ms 毫秒内只输出一次，
+ *          被省略的次数会附在下一条输出后面。
+ */
+
+// 日志级别
+enum class LogLevel : uint8_t {
+    DEBUG = 0,
+    INFO  = 1,
+    WARN  = 2,
+    ERROR = 3,
+    OFF   = 4
+};
+
+// 单条日志最多参数个数
+#define LOG_MAX_ARGS 6
+// 字符串参数最大长度（含结尾0）
+#define LOG_STRING_MAX 24
+
+/**
+ * @brief 日志调用点
+ * @note 每个 LOG_* 宏展开处有一个静态实例，其地址就是格式id
+ */
+struct LogSite {
+    LogLevel level;
+    const char* format;
+    const char* file;
+    int line;
+    // 限频间隔（纳秒），0表示不限频
+    uint64_t interval_ns;
+    // 上次输出时间（纳秒）
+    std::atomic<uint64_t> last_ns;
+    // 限频期间被省略的次数
+    std::atomic<uint32_t> suppressed;
+
+    LogSite(LogLevel level, const char* format, const char* file, int line, uint32_t interval_ms)
+        : level(level), format(format), file(file), line(line),
+          interval_ns(static_cast<uint64_t>(interval_ms) * 1000000ULL), last_ns(0), suppressed(0) {}
+};
+
+// 参数类型
+enum class LogArgType : uint8_t {
+    INT,
+    UINT,
+    DOUBLE,
+    BOOL,
+    STRING
+};
+
+// 单个参数（按值拷贝）
+struct LogArg {
+    LogArgType type;
+    union {
+        int64_t i;
+        uint64_t u;
+        double d;
+        char s[LOG_STRING_MAX];
+    } value;
+};
+
+// 一条日志记录（环形缓冲区中的一个槽）
+struct LogRecord {
+    const LogSite* site;
+    uint64_t timestamp_ns;
+    uint32_t suppressed;
+    uint8_t arg_count;
+    LogArg args[LOG_MAX_ARGS];
+};
+
+// ====================== 参数编码 ======================
+namespace log_detail {
+
+inline void copyString(LogArg& arg, const char* str, size_t len)
+{
+    arg.type = LogArgType::STRING;
+    if (str == nullptr) {
+        str = "(null)";
+        len = 6;
+    }
+    if (len >= LOG_STRING_MAX) {
+        len = LOG_STRING_MAX - 1;
+    }
+    memcpy(arg.value.s, str, len);
+    arg.value.s[len] = '\0';
+}
+
+inline void encode(LogArg& arg, bool v) { arg.type = LogArgType::BOOL; arg.value.u = v ? 1 : 0; }
+inline void encode(LogArg& arg, const char* v) { copyString(arg, v, v ? strlen(v) : 0); }
+inline void encode(LogArg& arg, const std::string& v) { copyString(arg, v.data(), v.size()); }
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type
+encode(LogArg& arg, T v) { arg.type = LogArgType::INT; arg.value.i = static_cast<int64_t>(v); }
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value>::type
+encode(LogArg& arg, T v) { arg.type = LogArgType::UINT; arg.value.u = static_cast<uint64_t>(v); }
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value>::type
+encode(LogArg& arg, T v) { arg.type = LogArgType::DOUBLE; arg.value.d = static_cast<double>(v); }
+
+template <typename T>
+inline typename std::enable_if<std::is_enum<T>::value>::type
+encode(LogArg& arg, T v) { encode(arg, static_cast<typename std::underlying_type<T>::type>(v)); }
+
+inline void encodeAll(LogRecord&, int) {}
+
+template <typename T, typename... Rest>
+inline void encodeAll(LogRecord& record, int index, const T& first, const Rest&... rest)
+{
+    encode(record.args[index], first);
+    encodeAll(record, index + 1, rest...);
+}
+
+} // namespace log_detail
+
+/**
+ * @brief 异步日志器（进程内单例）
+ */
+class Logger {
+public:
+    // 每个线程环形缓冲区的槽数（必须是2的幂）
+    static const uint32_t RING_SIZE = 1024;
+
+    /**
+     * @brief 获取单例，第一次调用时启动后台输出线程
+     */
+    static Logger& instance();
+
+    /**
+     * @brief 设置全局日志级别，低于该级别的日志在热路径直接返回
+     */
+    static void setLevel(LogLevel level) { min_level.store(static_cast<uint8_t>(level), std::memory_order_relaxed); }
+    static LogLevel getLevel() { return static_cast<LogLevel>(min_level.load(std::memory_order_relaxed)); }
+
+    /**
+     * @brief 判断某级别是否需要输出
+     */
+    static bool enabled(LogLevel level)
+    {
+        return static_cast<uint8_t>(level) >= min_level.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 从字符串解析日志级别（debug/info/warn/error/off）
+     * @return 无法识别时返回 INFO
+     */
+    static LogLevel parseLevel(const std::string& name);
+
+    /**
+     * @brief 写入一条日志（由 LOG_* 宏调用）
+     * @note 无锁：只写本线程的环形缓冲区，缓冲区满时丢弃并计数
+     */
+    template <typename... Args>
+    void write(LogSite& site, const Args&... args)
+    {
+        static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "LOG_* 参数过多");
+
+        uint64_t now = timestampNs();
+        uint32_t suppressed = 0;
+        if (site.interval_ns != 0 && !admit(site, now, suppressed)) {
+            return;
+        }
+
+        LogRecord* record = acquire();
+        if (record == nullptr) {
+            return;
+        }
+        record->site = &site;
+        record->timestamp_ns = now;
+        record->suppressed = suppressed;
+        record->arg_count = static_cast<uint8_t>(sizeof...(Args));
+        log_detail::encodeAll(*record, 0, args...);
+        publish();
+    }
+
+    /**
+     * @brief 阻塞直到当前所有缓冲区中的日志都已输出
+     */
+    void flush();
+
+    /**
+     * @brief 因缓冲区满被丢弃的日志条数
+     */
+    uint64_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 格式化一条记录（后台线程使用，也供测试调用）
+     */
+    static std::string format(const LogRecord& record);
+
+    ~Logger();
+
+private:
+    struct ThreadBuffer;
+
+    Logger();
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    static std::atomic<uint8_t> min_level;
+    std::atomic<uint64_t> dropped;
+
+    static uint64_t timestampNs();
+    static bool admit(LogSite& site, uint64_t now, uint32_t& suppressed);
+
+    // 在本线程缓冲区中占一个槽，满时返回nullptr
+    LogRecord* acquire();
+    // 提交刚写好的槽
+    void publish();
+
+    // 后台线程主循环
+    void run();
+    // 输出所有缓冲区中的记录，返回输出条数
+    size_t drain();
+
+    struct Impl;
+    Impl* impl;
+};
+
+// ====================== 日志宏 ======================
+#define LOG_AT(level, interval_ms, fmt, ...)                                              \
+    do {                                                                                  \
+        if (Logger::enabled(level)) {                                                     \
+            static LogSite log_site_(level, fmt, __FILE__, __LINE__, interval_ms);        \
+            Logger::instance().write(log_site_, ##__VA_ARGS__);                           \
+        }                                                                                 \
+    } while (0)
+
+#define LOG_DEBUG(fmt, ...) LOG_AT(LogLevel::DEBUG, 0, fmt, ##__VA_ARGS__)
+#define LOG_INFO(fmt, ...)  LOG_AT(LogLevel::INFO,  0, fmt, ##__VA_ARGS__)
+#define LOG_WARN(fmt, ...)  LOG_AT(LogLevel::WARN,  0, fmt, ##__VA_ARGS__)
+#define LOG_ERROR(fmt, ...) LOG_AT(LogLevel::ERROR, 0, fmt, ##__VA_ARGS__)
+
+// 限频版本：同一调用点 ms 毫秒内最多输出一次
+#define LOG_DEBUG_EVERY(ms, fmt, ...) LOG_AT(LogLevel::DEBUG, ms, fmt, ##__VA_ARGS__)
+#define LOG_INFO_EVERY(ms, fmt, ...)  LOG_AT(LogLevel::INFO,  ms, fmt, ##__VA_ARGS__)
+#define LOG_WARN_EVERY(ms, fmt, ...)  LOG_AT(LogLevel::WARN,  ms, fmt, ##__VA_ARGS__)
+#define LOG_ERROR_EVERY(ms, fmt, ...) LOG_AT(LogLevel::ERROR, ms, fmt, ##__VA_ARGS__)
+
+#endif // UDP_ROS_BRIDGE_LOGGER_H
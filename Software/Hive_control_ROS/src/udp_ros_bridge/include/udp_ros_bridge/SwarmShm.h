@@ -0,0 +1,211 @@
+#ifndef UDP_ROS_BRIDGE_SWARM_SHM_H
+#define UDP_ROS_BRIDGE_SWARM_SHM_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file SwarmShm.h
+ * @brief 集群状态共享内存：桥接把整个集群的最新状态写进具名 POSIX 共享内存，
+ *        规划、GUI、语音等本机进程直接读，不经过 ROS 话题的序列化和 socket 拷贝
+ * @details 共享内存中是一个快照环（默认8个），每次发布写下一个槽并递增版本号：
+ *              [文件头 256][快照0][快照1]...[快照 N-1]
+ *              快照：[快照头 64][SwarmShmDrone x slot_count]
+ *          写者先把槽的版本号清零，写完数据后再写入新版本号，最后更新文件头中的最新版本号；
+ *          读者按最新版本号找到槽，拷贝前后各检查一次槽的版本号，不一致说明拷贝期间写者绕环一圈
+ *          写到了同一个槽，换最新的槽重试（最多 READ_ATTEMPTS 次，读者从不等待写者）。
+ *          每次发布后递增文件头中的通知字并 FUTEX_WAKE，读者用 wait() 在该字上 FUTEX_WAIT 等待变化。
+ *          读者只读映射，不能改动桥接的状态；写者退出时置关闭标志并唤醒所有读者。
+ *
+ *          读取示例（链接 udp_ros_bridge_shm）：
+ *              SwarmShmReader reader;
+ *              reader.open(SWARM_SHM_DEFAULT_NAME);
+ *              SwarmShmState state;
+ *              while (reader.wait(state.version, 1000)) {
+ *                  if (reader.read(state)) { ... state.drones ... }
+ *              }
+ */
+
+// 默认共享内存名（/dev/shm/hive_swarm_state）
+#define SWARM_SHM_DEFAULT_NAME "/hive_swarm_state"
+
+static const char SWARM_SHM_MAGIC[8] = {'H', 'I', 'V', 'E', 'S', 'H', 'M', '\0'};
+static const uint32_t SWARM_SHM_VERSION = 1;
+
+/**
+ * @brief 一架无人机的状态（40字节，与二进制帧同单位：位置厘米、姿态0.1度、电量百分比）
+ */
+struct SwarmShmDrone {
+    // 最近一次解码完成的时间（CLOCK_REALTIME纳秒），0表示还没有数据
+    uint64_t updated_ns;
+    float x;
+    float y;
+    float z;
+    int16_t roll;
+    int16_t pitch;
+    int16_t yaw;
+    // 注册表槽位
+    uint16_t slot;
+    uint8_t id;
+    uint8_t batt;
+    uint8_t reserved[6];
+};
+static_assert(sizeof(SwarmShmDrone) == 40, "SwarmShmDrone 布局变化需要升级 SWARM_SHM_VERSION");
+
+/**
+ * @brief 共享内存文件头
+ */
+struct SwarmShmHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    // 每个快照的无人机数上限
+    uint32_t slot_count;
+    // 快照环的槽数
+    uint32_t ring_depth;
+    // 每个快照（含快照头）的字节数
+    uint32_t snapshot_size;
+    uint32_t writer_pid;
+    uint64_t created_ns;
+    // 写者已关闭（桥接退出），读者应重新 open
+    alignas(64) std::atomic<uint32_t> closed;
+    // 最新快照的版本号，0表示还没有发布
+    alignas(64) std::atomic<uint64_t> latest;
+    // 通知字：每次发布加一，读者在此 FUTEX_WAIT
+    alignas(64) std::atomic<uint32_t> notify;
+    char padding[60];
+};
+static_assert(sizeof(SwarmShmHeader) == 256, "SwarmShmHeader 布局变化需要升级 SWARM_SHM_VERSION");
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+              "跨进程的原子变量必须无锁");
+
+/**
+ * @brief 快照头
+ */
+struct SwarmShmSnapshotHeader {
+    // 槽中快照的版本号，0表示正在写
+    std::atomic<uint64_t> version;
+    // 发布时间（CLOCK_REALTIME纳秒）
+    uint64_t publish_ns;
+    // 有效的无人机数（注册的无人机数）
+    uint32_t drone_count;
+    char padding[44];
+};
+static_assert(sizeof(SwarmShmSnapshotHeader) == 64, "SwarmShmSnapshotHeader 布局变化需要升级 SWARM_SHM_VERSION");
+
+/**
+ * @brief 读者拷贝出的一个快照
+ */
+struct SwarmShmState {
+    uint64_t version = 0;
+    uint64_t publish_ns = 0;
+    std::vector<SwarmShmDrone> drones;
+};
+
+/**
+ * @brief 写者（桥接进程，单线程调用）
+ */
+class SwarmShmWriter {
+public:
+    static const uint32_t DEFAULT_RING_DEPTH = 8;
+
+    SwarmShmWriter() = default;
+    ~SwarmShmWriter();
+
+    SwarmShmWriter(const SwarmShmWriter&) = delete;
+    SwarmShmWriter& operator=(const SwarmShmWriter&) = delete;
+
+    /**
+     * @brief 创建共享内存（同名的旧区域先删除，已打开的读者收到关闭标志）
+     * @param name 共享内存名，以 / 开头
+     * @param slot_count 每个快照的无人机数上限
+     * @param ring_depth 快照环槽数，至少2
+     * @return 失败返回false（已记录日志）
+     */
+    bool create(const std::string& name, uint32_t slot_count, uint32_t ring_depth = DEFAULT_RING_DEPTH);
+
+    /**
+     * @brief 开始写下一个快照，返回其无人机数组（slot_count 项），写完后调用 commit
+     * @return 未创建时返回空指针
+     */
+    SwarmShmDrone* begin();
+
+    /**
+     * @brief 发布 begin 返回的快照并唤醒等待的读者
+     * @param drone_count 有效的无人机数（不超过 slot_count）
+     * @param publish_ns 发布时间
+     * @return 新快照的版本号
+     */
+    uint64_t commit(uint32_t drone_count, uint64_t publish_ns);
+
+    /**
+     * @brief 置关闭标志、唤醒读者、删除共享内存
+     */
+    void close();
+
+    bool isOpen() const { return header != nullptr; }
+    uint32_t getSlotCount() const { return header != nullptr ? header->slot_count : 0; }
+    // 已发布的快照数（最新版本号）
+    uint64_t getVersion() const { return version; }
+
+private:
+    std::string name;
+    SwarmShmHeader* header = nullptr;
+    size_t size = 0;
+    uint64_t version = 0;
+    // begin 后尚未 commit 的槽
+    SwarmShmSnapshotHeader* writing = nullptr;
+};
+
+/**
+ * @brief 读者（其他进程），读取不加锁、不等待写者；同一对象不要在多个线程中同时使用
+ */
+class SwarmShmReader {
+public:
+    // 拷贝期间被写者覆盖时的最多尝试次数
+    static const int READ_ATTEMPTS = 4;
+
+    SwarmShmReader() = default;
+    ~SwarmShmReader();
+
+    SwarmShmReader(const SwarmShmReader&) = delete;
+    SwarmShmReader& operator=(const SwarmShmReader&) = delete;
+
+    /**
+     * @brief 只读映射共享内存
+     * @return 不存在（桥接未启动）或格式不符时返回false
+     */
+    bool open(const std::string& name = SWARM_SHM_DEFAULT_NAME);
+
+    /**
+     * @brief 拷贝最新快照
+     * @return 还没有快照、未打开，或 READ_ATTEMPTS 次拷贝都被写者覆盖时返回false
+     */
+    bool read(SwarmShmState& out) const;
+
+    /**
+     * @brief 等待比 seen_version 新的快照
+     * @param seen_version 已读到的版本号（第一次传0）
+     * @param timeout_ms 超时（毫秒），小于0表示一直等
+     * @return 有新快照返回true；超时、未打开或写者已关闭返回false
+     */
+    bool wait(uint64_t seen_version, int timeout_ms) const;
+
+    // 最新快照的版本号，0表示还没有
+    uint64_t getLatestVersion() const;
+    // 写者已关闭（桥接退出或重启），需要重新 open
+    bool isWriterClosed() const;
+    bool isOpen() const { return header != nullptr; }
+    uint32_t getSlotCount() const { return header != nullptr ? header->slot_count : 0; }
+
+    void close();
+
+private:
+    const SwarmShmHeader* header = nullptr;
+    size_t size = 0;
+};
+
+#endif // UDP_ROS_BRIDGE_SWARM_SHM_H
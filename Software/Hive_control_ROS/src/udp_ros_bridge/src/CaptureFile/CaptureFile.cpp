@@ -0,0 +1,237 @@
+#include "CaptureFile.h"
+#include "udp_ros_bridge/Logger.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+// 文件头中数据结束偏移的位置
+static const size_t DATA_END_OFFSET = 24;
+
+// 在磁盘上分配 [from, to) 并把文件扩展到 to，返回0或错误码；
+// 映射中只访问分配过的部分，磁盘满时在这里失败，而不是写映射时收到 SIGBUS
+static int reserve(int fd, size_t from, size_t to)
+{
+    return posix_fallocate(fd, static_cast<off_t>(from), static_cast<off_t>(to - from));
+}
+
+static uint64_t realtimeNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+// ====================== 写入 ======================
+CaptureWriter::~CaptureWriter()
+{
+    close();
+}
+
+bool CaptureWriter::open(const std::string& path, size_t max_bytes)
+{
+    close();
+    if (max_bytes < CAPTURE_HEADER_SIZE + CAPTURE_RECORD_HEADER_SIZE)
+    {
+        LOG_ERROR("抓包文件最大长度过小: {} 字节", max_bytes);
+        return false;
+    }
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        LOG_ERROR("无法创建抓包文件 {}: {}", path, strerror(errno));
+        return false;
+    }
+    // 按最大长度预留地址空间，文件本身随写入逐段扩展；只访问已分配的部分
+    void* mapping = mmap(nullptr, max_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        LOG_ERROR("映射抓包文件失败: {}", strerror(errno));
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    base = static_cast<uint8_t*>(mapping);
+    capacity = max_bytes;
+    limit = max_bytes;
+    size_t initial = GROW_BYTES < max_bytes ? GROW_BYTES : max_bytes;
+    int error = reserve(fd, 0, initial);
+    if (error != 0)
+    {
+        LOG_ERROR("分配抓包文件空间失败: {}", strerror(error));
+        close();
+        return false;
+    }
+    file_size = initial;
+
+    uint64_t created = realtimeNs();
+    uint32_t header_size = CAPTURE_HEADER_SIZE;
+    uint64_t data_end = CAPTURE_HEADER_SIZE;
+    memcpy(base, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC));
+    memcpy(base + 8, &CAPTURE_VERSION, 4);
+    memcpy(base + 12, &header_size, 4);
+    memcpy(base + 16, &created, 8);
+    memcpy(base + DATA_END_OFFSET, &data_end, 8);
+    used.store(CAPTURE_HEADER_SIZE, std::memory_order_relaxed);
+    records.store(0, std::memory_order_relaxed);
+    dropped.store(0, std::memory_order_relaxed);
+    LOG_INFO("开始抓包: {}（最大 {} MB）", path, max_bytes / (1024 * 1024));
+    return true;
+}
+
+bool CaptureWriter::append(uint64_t kernel_ns, const sockaddr_in& source, const uint8_t* data, size_t size)
+{
+    if (base == nullptr)
+    {
+        return false;
+    }
+    size_t offset = used.load(std::memory_order_relaxed);
+    size_t end = offset + CAPTURE_RECORD_HEADER_SIZE + size;
+    if (size > UINT16_MAX || end > limit)
+    {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (end > file_size)
+    {
+        size_t grown = file_size + GROW_BYTES;
+        grown = grown < end ? end : grown;
+        grown = grown > capacity ? capacity : grown;
+        int error = reserve(fd, file_size, grown);
+        if (error != 0)
+        {
+            // 磁盘满：停在已分配的长度，之后的记录直接计为丢弃，接收不受影响
+            limit = file_size;
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            LOG_ERROR("分配抓包文件空间失败，停止抓包（已写 {} 字节）: {}", offset, strerror(error));
+            return false;
+        }
+        file_size = grown;
+    }
+
+    uint8_t* out = base + offset;
+    uint32_t ip_be = source.sin_addr.s_addr;
+    uint16_t port = ntohs(source.sin_port);
+    uint16_t length = static_cast<uint16_t>(size);
+    memcpy(out, &kernel_ns, 8);
+    memcpy(out + 8, &ip_be, 4);
+    memcpy(out + 12, &port, 2);
+    memcpy(out + 14, &length, 2);
+    memcpy(out + CAPTURE_RECORD_HEADER_SIZE, data, size);
+    // 记录写完后再更新结束偏移，读者（包括崩溃后的读者）不会看到半条记录
+    uint64_t data_end = end;
+    memcpy(base + DATA_END_OFFSET, &data_end, 8);
+    used.store(end, std::memory_order_relaxed);
+    records.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void CaptureWriter::close()
+{
+    if (base != nullptr)
+    {
+        munmap(base, capacity);
+        base = nullptr;
+    }
+    if (fd >= 0)
+    {
+        if (ftruncate(fd, static_cast<off_t>(used.load(std::memory_order_relaxed))) != 0)
+        {
+            LOG_WARN("截断抓包文件失败: {}", strerror(errno));
+        }
+        ::close(fd);
+        fd = -1;
+    }
+    capacity = 0;
+    file_size = 0;
+    limit = 0;
+}
+
+// ====================== 读取 ======================
+CaptureReader::~CaptureReader()
+{
+    close();
+}
+
+bool CaptureReader::open(const std::string& path)
+{
+    close();
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < CAPTURE_HEADER_SIZE)
+    {
+        close();
+        return false;
+    }
+    size = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        close();
+        return false;
+    }
+    base = static_cast<const uint8_t*>(mapping);
+    // 顺序读取，提示内核预读
+    madvise(const_cast<uint8_t*>(base), size, MADV_SEQUENTIAL);
+
+    uint32_t version = 0;
+    uint32_t header_size = 0;
+    uint64_t end = 0;
+    memcpy(&version, base + 8, 4);
+    memcpy(&header_size, base + 12, 4);
+    memcpy(&created_ns, base + 16, 8);
+    memcpy(&end, base + DATA_END_OFFSET, 8);
+    if (memcmp(base, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC)) != 0 || version != CAPTURE_VERSION ||
+        header_size != CAPTURE_HEADER_SIZE)
+    {
+        close();
+        return false;
+    }
+    data_end = end < CAPTURE_HEADER_SIZE || end > size ? size : static_cast<size_t>(end);
+    offset = CAPTURE_HEADER_SIZE;
+    return true;
+}
+
+bool CaptureReader::next(CaptureRecord& record)
+{
+    if (base == nullptr || offset + CAPTURE_RECORD_HEADER_SIZE > data_end)
+    {
+        return false;
+    }
+    const uint8_t* in = base + offset;
+    memcpy(&record.kernel_ns, in, 8);
+    memcpy(&record.ip_be, in + 8, 4);
+    memcpy(&record.port, in + 12, 2);
+    memcpy(&record.length, in + 14, 2);
+    if (offset + CAPTURE_RECORD_HEADER_SIZE + record.length > data_end)
+    {
+        return false;
+    }
+    record.data = in + CAPTURE_RECORD_HEADER_SIZE;
+    offset += CAPTURE_RECORD_HEADER_SIZE + record.length;
+    return true;
+}
+
+void CaptureReader::close()
+{
+    if (base != nullptr)
+    {
+        munmap(const_cast<uint8_t*>(base), size);
+        base = nullptr;
+    }
+    if (fd >= 0)
+    {
+        ::close(fd);
+        fd = -1;
+    }
+    size = 0;
+    data_end = 0;
+    offset = 0;
+}
@@ -0,0 +1,134 @@
+#ifndef CAPTURE_FILE_H
+#define CAPTURE_FILE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <netinet/in.h>
+
+// ====================== 原始数据报抓包文件 ======================
+// 文件头32字节，之后是连续的记录，整数均为小端（本机字节序）：
+//   文件头：[魔数 "HIVECAP\0" 8][版本 4][文件头长度 4][创建时间 8][数据结束偏移 8]
+//   记录：  [内核时间戳 8][来源IP 4][来源端口 2][长度 2][数据报内容]
+// 时间戳为 CLOCK_REALTIME 纳秒（内核未提供时为接收线程被唤醒的时间），
+// 来源IP保持网络字节序（与 sockaddr_in::sin_addr.s_addr 相同），端口为主机字节序。
+// 数据结束偏移每写一条记录更新一次，进程崩溃后已写入的记录仍可读出
+static const char CAPTURE_MAGIC[8] = {'H', 'I', 'V', 'E', 'C', 'A', 'P', '\0'};
+static const uint32_t CAPTURE_VERSION = 1;
+static const size_t CAPTURE_HEADER_SIZE = 32;
+static const size_t CAPTURE_RECORD_HEADER_SIZE = 16;
+
+/**
+ * @brief 抓包文件中的一条记录
+ * @note data 指向映射的文件内容，CaptureReader 关闭后失效
+ */
+struct CaptureRecord {
+    uint64_t kernel_ns = 0;
+    // 来源IP（网络字节序）和端口（主机字节序）
+    uint32_t ip_be = 0;
+    uint16_t port = 0;
+    const uint8_t* data = nullptr;
+    uint16_t length = 0;
+};
+
+/**
+ * @brief 抓包文件写入（内存映射）
+ * @note 打开时按最大长度预留地址空间，文件按 GROW_BYTES 逐段用 posix_fallocate 扩展，写入只是 memcpy；
+ *       扩展时先在磁盘上分配好空间再写，磁盘满时扩展失败，而不是写到未分配的页上触发 SIGBUS。
+ *       只允许一个线程写（接收线程）。写满最大长度或磁盘满后停止抓包，丢弃新记录并计数，不影响接收。
+ *       关闭时把文件截断到实际长度
+ */
+class CaptureWriter {
+public:
+    // 文件每次扩展的字节数
+    static const size_t GROW_BYTES = 16 * 1024 * 1024;
+
+    CaptureWriter() = default;
+    ~CaptureWriter();
+
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    /**
+     * @brief 创建（覆盖）抓包文件
+     * @param path 文件路径
+     * @param max_bytes 文件最大长度（字节）
+     * @return 失败返回false（已记录日志）
+     */
+    bool open(const std::string& path, size_t max_bytes);
+
+    /**
+     * @brief 追加一个数据报
+     * @return 文件已满或未打开时返回false
+     */
+    bool append(uint64_t kernel_ns, const sockaddr_in& source, const uint8_t* data, size_t size);
+
+    /**
+     * @brief 截断到实际长度并关闭
+     */
+    void close();
+
+    bool isOpen() const { return base != nullptr; }
+    // 已写入的记录数
+    uint64_t getRecordCount() const { return records.load(std::memory_order_relaxed); }
+    // 已使用的文件长度（含文件头）
+    uint64_t getByteCount() const { return used.load(std::memory_order_relaxed); }
+    // 文件写满（或磁盘满）后丢弃的记录数
+    uint64_t getDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    int fd = -1;
+    uint8_t* base = nullptr;
+    size_t capacity = 0;
+    // 当前文件长度（已在磁盘上分配的部分）
+    size_t file_size = 0;
+    // 允许写到的位置：最大长度，磁盘满后缩到 file_size，不再尝试扩展
+    size_t limit = 0;
+    std::atomic<uint64_t> used{0};
+    std::atomic<uint64_t> records{0};
+    std::atomic<uint64_t> dropped{0};
+};
+
+/**
+ * @brief 抓包文件读取（只读内存映射）
+ */
+class CaptureReader {
+public:
+    CaptureReader() = default;
+    ~CaptureReader();
+
+    CaptureReader(const CaptureReader&) = delete;
+    CaptureReader& operator=(const CaptureReader&) = delete;
+
+    /**
+     * @brief 打开抓包文件并检查文件头
+     * @return 文件不存在或格式不符时返回false
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief 读下一条记录
+     * @return 读完或遇到不完整的记录时返回false
+     */
+    bool next(CaptureRecord& record);
+
+    // 回到第一条记录
+    void rewind() { offset = CAPTURE_HEADER_SIZE; }
+    // 文件创建时间（CLOCK_REALTIME纳秒）
+    uint64_t getCreatedNs() const { return created_ns; }
+    // 记录区的结束位置
+    size_t getDataEnd() const { return data_end; }
+
+    void close();
+
+private:
+    int fd = -1;
+    const uint8_t* base = nullptr;
+    size_t size = 0;
+    size_t data_end = 0;
+    size_t offset = 0;
+    uint64_t created_ns = 0;
+};
+
+#endif // CAPTURE_FILE_H
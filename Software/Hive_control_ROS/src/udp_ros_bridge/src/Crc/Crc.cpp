@@ -0,0 +1,165 @@
+#include "Crc.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CRC_X86 1
+#include <immintrin.h>
+#endif
+
+// ====================== 查表 ======================
+// 第k张表：某字节后面再跟k个0字节时对CRC的贡献，8张表一次处理8字节
+struct Crc16Tables {
+    uint16_t table[8][256];
+
+    Crc16Tables()
+    {
+        for (int i = 0; i < 256; i++)
+        {
+            uint16_t crc = static_cast<uint16_t>(i << 8);
+            for (int bit = 0; bit < 8; bit++)
+            {
+                crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+            }
+            table[0][i] = crc;
+        }
+        for (int k = 1; k < 8; k++)
+        {
+            for (int i = 0; i < 256; i++)
+            {
+                uint16_t prev = table[k - 1][i];
+                table[k][i] = static_cast<uint16_t>((prev << 8) ^ table[0][prev >> 8]);
+            }
+        }
+    }
+};
+
+struct Crc32cTables {
+    uint32_t table[8][256];
+
+    Crc32cTables()
+    {
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; bit++)
+            {
+                crc = (crc & 1) ? (crc >> 1) ^ 0x82F63B78u : crc >> 1;
+            }
+            table[0][i] = crc;
+        }
+        for (int k = 1; k < 8; k++)
+        {
+            for (int i = 0; i < 256; i++)
+            {
+                uint32_t prev = table[k - 1][i];
+                table[k][i] = (prev >> 8) ^ table[0][prev & 0xFF];
+            }
+        }
+    }
+};
+
+static const Crc16Tables& crc16Tables()
+{
+    static const Crc16Tables tables;
+    return tables;
+}
+
+static const Crc32cTables& crc32cTables()
+{
+    static const Crc32cTables tables;
+    return tables;
+}
+
+// ====================== CRC-16/CCITT ======================
+uint16_t crc16Ccitt(const uint8_t* data, size_t size)
+{
+    const uint16_t (*t)[256] = crc16Tables().table;
+    uint16_t crc = 0xFFFF;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        // 高位在前：CRC与前两个字节对齐，其余6字节直接查表
+        uint16_t head = static_cast<uint16_t>(crc ^ (data[i] << 8 | data[i + 1]));
+        crc = static_cast<uint16_t>(t[7][head >> 8] ^ t[6][head & 0xFF] ^
+                                    t[5][data[i + 2]] ^ t[4][data[i + 3]] ^
+                                    t[3][data[i + 4]] ^ t[2][data[i + 5]] ^
+                                    t[1][data[i + 6]] ^ t[0][data[i + 7]]);
+    }
+    for (; i < size; i++)
+    {
+        crc = static_cast<uint16_t>((crc << 8) ^ t[0][(crc >> 8) ^ data[i]]);
+    }
+    return crc;
+}
+
+// ====================== CRC-32C ======================
+uint32_t crc32cSoftware(const uint8_t* data, size_t size)
+{
+    const uint32_t (*t)[256] = crc32cTables().table;
+    uint32_t crc = 0xFFFFFFFFu;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        // 低位在前：CRC与前4个字节对齐
+        uint32_t low = crc ^ (static_cast<uint32_t>(data[i]) | static_cast<uint32_t>(data[i + 1]) << 8 |
+                              static_cast<uint32_t>(data[i + 2]) << 16 | static_cast<uint32_t>(data[i + 3]) << 24);
+        crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^
+              t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+              t[3][data[i + 4]] ^ t[2][data[i + 5]] ^
+              t[1][data[i + 6]] ^ t[0][data[i + 7]];
+    }
+    for (; i < size; i++)
+    {
+        crc = (crc >> 8) ^ t[0][(crc ^ data[i]) & 0xFF];
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+#ifdef CRC_X86
+__attribute__((target("sse4.2")))
+static uint32_t crc32cSse42(const uint8_t* data, size_t size)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+    size_t i = 0;
+#ifdef __x86_64__
+    uint64_t crc64 = crc;
+    for (; i + 8 <= size; i += 8)
+    {
+        uint64_t word;
+        __builtin_memcpy(&word, data + i, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+    }
+    crc = static_cast<uint32_t>(crc64);
+#endif
+    for (; i < size; i++)
+    {
+        crc = _mm_crc32_u8(crc, data[i]);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+#endif
+
+bool crc32cHardwareAvailable()
+{
+#ifdef CRC_X86
+    static const bool available = __builtin_cpu_supports("sse4.2");
+    return available;
+#else
+    return false;
+#endif
+}
+
+uint32_t crc32cHardware(const uint8_t* data, size_t size)
+{
+#ifdef CRC_X86
+    if (crc32cHardwareAvailable())
+    {
+        return crc32cSse42(data, size);
+    }
+#endif
+    return crc32cSoftware(data, size);
+}
+
+uint32_t crc32c(const uint8_t* data, size_t size)
+{
+    return crc32cHardware(data, size);
+}
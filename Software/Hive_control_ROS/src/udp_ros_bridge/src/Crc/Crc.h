@@ -0,0 +1,38 @@
+#ifndef CRC_H
+#define CRC_H
+
+#include <cstddef>
+#include <cstdint>
+
+// ====================== 帧校验CRC ======================
+// 与无人机端 System/CRC 使用相同的参数：
+//   CRC-16/CCITT-FALSE：多项式0x1021，初值0xFFFF，不反转，不异或输出
+//   CRC-32C(Castagnoli)：多项式0x1EDC6F41（反转0x82F63B78），初值和输出异或0xFFFFFFFF
+// 校验值 "123456789" -> CRC-16 0x29B1，CRC-32C 0xE3069283
+
+/**
+ * @brief CRC-16/CCITT-FALSE，slicing-by-8 查表
+ */
+uint16_t crc16Ccitt(const uint8_t* data, size_t size);
+
+/**
+ * @brief CRC-32C，CPU支持SSE4.2时使用crc32指令，否则slicing-by-8查表
+ */
+uint32_t crc32c(const uint8_t* data, size_t size);
+
+/**
+ * @brief CRC-32C 查表实现（不使用硬件指令）
+ */
+uint32_t crc32cSoftware(const uint8_t* data, size_t size);
+
+/**
+ * @brief CRC-32C 硬件指令实现，CPU不支持时退回查表
+ */
+uint32_t crc32cHardware(const uint8_t* data, size_t size);
+
+/**
+ * @brief CPU是否支持CRC-32C硬件指令（x86 SSE4.2）
+ */
+bool crc32cHardwareAvailable();
+
+#endif // CRC_H
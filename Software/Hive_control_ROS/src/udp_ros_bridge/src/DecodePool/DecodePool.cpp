@@ -0,0 +1,302 @@
+#include "DecodePool.h"
+#include <chrono>
+#include <string>
+
+// ====================== 构造与启停 ======================
+DecodePool::DecodePool(Ingress& ingress, DroneData<UdpPacket>& drones) : ingress(ingress), drones(drones)
+{
+    slot_count = drones.size();
+    if (slot_count > 0)
+    {
+        snapshots.reset(new SnapshotSlot[slot_count]);
+    }
+}
+
+DecodePool::~DecodePool()
+{
+    stop();
+}
+
+void DecodePool::start(int count)
+{
+    if (running.load())
+    {
+        return;
+    }
+    if (count < 1)
+    {
+        count = 1;
+    }
+    workers.clear();
+    for (int i = 0; i < count; i++)
+    {
+        workers.emplace_back(new Worker);
+    }
+    running.store(true);
+    for (int i = 0; i < count; i++)
+    {
+        workers[i]->thread = std::thread(&DecodePool::run, this, i);
+    }
+}
+
+void DecodePool::stop()
+{
+    if (!running.exchange(false))
+    {
+        return;
+    }
+    for (auto& worker : workers)
+    {
+        {
+            std::lock_guard<std::mutex> lock(worker->wake_mutex);
+        }
+        worker->wake.notify_one();
+        if (worker->thread.joinable())
+        {
+            worker->thread.join();
+        }
+    }
+}
+
+// ====================== 分发 ======================
+bool DecodePool::push(UdpPacket&& packet)
+{
+    if (workers.empty())
+    {
+        return false;
+    }
+    // 同一槽位始终交给同一线程，保证每架无人机按到达顺序解码；无效槽位交给0号线程计数后丢弃
+    size_t index = packet.slot >= 0 ? static_cast<size_t>(packet.slot) % workers.size() : 0;
+    Worker& worker = *workers[index];
+    if (!worker.queue.push(std::move(packet)))
+    {
+        queue_full.fetch_add(1, std::memory_order_relaxed);
+        while (true)
+        {
+            if (!running.load(std::memory_order_relaxed))
+            {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            if (worker.queue.push(std::move(packet)))
+            {
+                break;
+            }
+        }
+    }
+    // 与解码线程休眠前的检查配对：要么它看到新数据包，要么这里看到它在休眠
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (worker.sleeping.load(std::memory_order_relaxed))
+    {
+        std::lock_guard<std::mutex> lock(worker.wake_mutex);
+        worker.wake.notify_one();
+    }
+    return true;
+}
+
+// ====================== 解码线程 ======================
+void DecodePool::run(int index)
+{
+    Worker& worker = *workers[index];
+    std::string name = "bridge_decode" + std::to_string(index);
+    applyThreadPolicy(thread_policy, name.c_str());
+
+    UdpPacket packet;
+    int idle = 0;
+    while (running.load(std::memory_order_relaxed))
+    {
+        if (!worker.queue.pop(packet))
+        {
+            if (++idle < IDLE_SPINS)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            // 休眠：超时兜底，即使错过唤醒也只多等1毫秒
+            std::unique_lock<std::mutex> lock(worker.wake_mutex);
+            worker.sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (worker.queue.size() == 0 && running.load(std::memory_order_relaxed))
+            {
+                worker.wake.wait_for(lock, std::chrono::milliseconds(1));
+            }
+            worker.sleeping.store(false, std::memory_order_relaxed);
+            idle = 0;
+            continue;
+        }
+        idle = 0;
+
+        uint64_t start_ns = nowRealtimeNs();
+        if (pipeline_latency != nullptr && packet.kernel_ns != 0)
+        {
+            pipeline_latency->kernel_to_dequeue.record(static_cast<int64_t>(start_ns - packet.kernel_ns));
+        }
+        // 按开头字节识别格式，交给来源无人机对应的解码器；被序号窗口拒绝或解码失败的不发布、不录制
+        bool applied = ingress.route(packet, drones);
+        uint64_t end_ns = nowRealtimeNs();
+        if (applied)
+        {
+            publish(packet.slot, end_ns, packet.kernel_ns != 0 ? packet.kernel_ns : start_ns);
+        }
+        else
+        {
+            publishCounters(packet.slot);
+        }
+        if (pipeline_latency != nullptr)
+        {
+            pipeline_latency->dequeue_to_parse.record(static_cast<int64_t>(end_ns - start_ns));
+        }
+        worker.busy_ns.fetch_add(end_ns - start_ns, std::memory_order_relaxed);
+        worker.packets.fetch_add(1, std::memory_order_relaxed);
+        // 及时归还缓冲区
+        packet.buffer.reset();
+    }
+}
+
+void DecodePool::publish(int slot, uint64_t now_ns, uint64_t received_ns)
+{
+    if (slot < 0 || slot >= slot_count)
+    {
+        return;
+    }
+    DataProcessing& drone = drones[slot];
+    SnapshotSlot& target = snapshots[slot];
+    while (target.lock.test_and_set(std::memory_order_acquire))
+    {
+    }
+    DroneSnapshot& data = target.data;
+    data.id = drone.id;
+    data.roll = drone.roll;
+    data.pitch = drone.pitch;
+    data.yaw = drone.yaw;
+    data.x = drone.x;
+    data.y = drone.y;
+    data.z = drone.z;
+    data.batt = drone.batt;
+    for (int i = 0; i < 4; i++)
+    {
+        data.pid[i] = drone.pid[i];
+    }
+    data.updated_ns = now_ns;
+    data.received_ns = received_ns;
+    if (data.position_updates != drone.position_updates)
+    {
+        data.position_updates = drone.position_updates;
+        data.position_ns = received_ns;
+    }
+    if (data.attitude_updates != drone.attitude_updates)
+    {
+        data.attitude_updates = drone.attitude_updates;
+        data.attitude_ns = received_ns;
+    }
+    data.missing_base = drone.keyframes.missing_base;
+    data.updates++;
+    bool ack = drone.keyframes.ack_pending;
+    if (ack)
+    {
+        // 确认转交给发送线程，状态中的标志由解码线程自己清除
+        drone.keyframes.ack_pending = false;
+        target.ack_pending = true;
+        target.ack_id = drone.keyframes.ack_id;
+    }
+    target.lock.clear(std::memory_order_release);
+    // 解出关键帧立即通知上行线程，确认不等发布主循环
+    if (ack && ack_sink != nullptr)
+    {
+        ack_sink->notifyKeyframeAck(slot);
+    }
+
+    if (recorder != nullptr)
+    {
+        TelemetryRow row;
+        row.time_ns = now_ns;
+        row.slot = static_cast<uint16_t>(slot);
+        row.id = drone.id;
+        row.roll = drone.roll;
+        row.pitch = drone.pitch;
+        row.yaw = drone.yaw;
+        row.x = drone.x;
+        row.y = drone.y;
+        row.z = drone.z;
+        row.batt = drone.batt;
+        recorder->append(row);
+    }
+}
+
+void DecodePool::publishCounters(int slot)
+{
+    if (slot < 0 || slot >= slot_count)
+    {
+        return;
+    }
+    uint32_t missing_base = drones[slot].keyframes.missing_base;
+    SnapshotSlot& target = snapshots[slot];
+    while (target.lock.test_and_set(std::memory_order_acquire))
+    {
+    }
+    target.data.missing_base = missing_base;
+    target.lock.clear(std::memory_order_release);
+}
+
+// ====================== 读取 ======================
+bool DecodePool::snapshot(int slot, DroneSnapshot& out) const
+{
+    if (slot < 0 || slot >= slot_count)
+    {
+        return false;
+    }
+    const SnapshotSlot& source = snapshots[slot];
+    while (source.lock.test_and_set(std::memory_order_acquire))
+    {
+    }
+    out = source.data;
+    source.lock.clear(std::memory_order_release);
+    return true;
+}
+
+bool DecodePool::takeKeyframeAck(int slot, uint8_t& key_id)
+{
+    if (slot < 0 || slot >= slot_count)
+    {
+        return false;
+    }
+    SnapshotSlot& source = snapshots[slot];
+    while (source.lock.test_and_set(std::memory_order_acquire))
+    {
+    }
+    bool pending = source.ack_pending;
+    key_id = source.ack_id;
+    source.ack_pending = false;
+    source.lock.clear(std::memory_order_release);
+    return pending;
+}
+
+uint64_t DecodePool::getWorkerPacketCount(int worker) const
+{
+    return workers[worker]->packets.load(std::memory_order_relaxed);
+}
+
+uint64_t DecodePool::getWorkerBusyNs(int worker) const
+{
+    return workers[worker]->busy_ns.load(std::memory_order_relaxed);
+}
+
+size_t DecodePool::getQueueDepth() const
+{
+    size_t depth = 0;
+    for (const auto& worker : workers)
+    {
+        depth += worker->queue.size();
+    }
+    return depth;
+}
+
+uint64_t DecodePool::getDecodedCount() const
+{
+    uint64_t total = 0;
+    for (const auto& worker : workers)
+    {
+        total += worker->packets.load(std::memory_order_relaxed);
+    }
+    return total;
+}
@@ -0,0 +1,192 @@
+#ifndef DECODE_POOL_H
+#define DECODE_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../UDP/UDP.h"
+#include "../Ingress/Ingress.h"
+#include "../LatencyStats/LatencyStats.h"
+#include "../ThreadTuning/ThreadTuning.h"
+#include "../PacketPool/PacketPool.h"
+#include "../TelemetryRecorder/TelemetryRecorder.h"
+#include "../data_processing/data_processing.h"
+
+// ====================== 无人机状态快照 ======================
+/**
+ * @brief 一架无人机的最新状态，由解码线程写入，发布线程读取
+ */
+struct DroneSnapshot {
+    uint8_t id = 0;
+    int16_t roll = 0;
+    int16_t pitch = 0;
+    int16_t yaw = 0;
+    float x = 0;
+    float y = 0;
+    float z = 0;
+    uint8_t batt = 0;
+    DataProcessing::PID pid[4];
+    // 最近一次解码完成的时间（CLOCK_REALTIME纳秒），0表示还没有数据
+    uint64_t updated_ns = 0;
+    // 该数据包的接收时间：内核时间戳，内核未提供时为解码线程取出的时间（CLOCK_REALTIME纳秒）
+    uint64_t received_ns = 0;
+    // 紧凑遥测缺少关键帧而丢弃的增量帧数
+    uint32_t missing_base = 0;
+    // 快照累计更新次数（每个写入了状态的数据包加一，重复、过期和解码失败的不计），两次读取的差即该无人机的更新率
+    uint64_t updates = 0;
+    // 位置、姿态最近一次被写入的数据包的接收时间（同 received_ns），0表示还没有；
+    // 只含电池等其他字段的数据包不改变它们，按字段计算测量时间时用这两个而不是 received_ns
+    uint64_t position_ns = 0;
+    uint64_t attitude_ns = 0;
+    // 位置、姿态的累计写入次数（DataProcessing::position_updates/attitude_updates），变化即有新测量
+    uint64_t position_updates = 0;
+    uint64_t attitude_updates = 0;
+};
+
+/**
+ * @brief 关键帧确认去向
+ * @note 设置后解码线程解出关键帧即通知它（如 KeyframeUplink），由它取出确认发回无人机
+ */
+class KeyframeAckSink {
+public:
+    virtual ~KeyframeAckSink() = default;
+    /**
+     * @brief 某槽位有待回复的确认，在解码线程中调用，不得阻塞
+     */
+    virtual void notifyKeyframeAck(int slot) = 0;
+};
+
+// ====================== 并行解码 ======================
+/**
+ * @brief 按无人机分片的解码线程池
+ * @note 接收线程通过 PacketSink 把数据包直接交给本池，按来源槽位取模分到固定的解码线程，
+ *       同一架无人机的数据包始终由同一线程按到达顺序解码，序号窗口和状态各自只有一个写者。
+ *       解码线程直接写 DroneData 中对应的 DataProcessing，写入了状态的数据包解码后把状态拷进快照并录制；
+ *       其他线程（ROS发布、统计）只读快照，不碰 DataProcessing。
+ *       接收线程到每个解码线程是一个单生产者单消费者无锁队列，队列满时接收线程等待，
+ *       数据报留在内核缓冲区中
+ */
+class DecodePool : public PacketSink {
+public:
+    // 每个解码线程的队列容量（数据包个数）
+    static const size_t WORKER_QUEUE_CAPACITY = 8192;
+    // 队列空时先让出CPU的次数，之后休眠等待唤醒
+    static const int IDLE_SPINS = 64;
+
+    /**
+     * @brief 构造函数
+     * @param ingress 多格式接收入口（格式识别、序号窗口、解码统计）
+     * @param drones 每架无人机的状态，按槽位索引
+     */
+    DecodePool(Ingress& ingress, DroneData<UdpPacket>& drones);
+    ~DecodePool();
+
+    /**
+     * @brief 设置解码线程的调度策略，启动前调用
+     */
+    void setThreadPolicy(const ThreadPolicy& policy) { thread_policy = policy; }
+
+    /**
+     * @brief 设置流水线延迟统计，启动前调用
+     * @note 内核->出队记为解码线程取到数据包的时间，出队->解析记为单包解码耗时
+     */
+    void setPipelineLatency(PipelineLatency* latency) { pipeline_latency = latency; }
+
+    /**
+     * @brief 设置遥测记录，启动前调用
+     * @note 每包解码后由解码线程把状态追加为一行，为空时不记录
+     */
+    void setRecorder(TelemetryRecorder* telemetry_recorder) { recorder = telemetry_recorder; }
+
+    /**
+     * @brief 设置关键帧确认去向，启动前调用
+     * @note 为空时确认只留在快照中，由调用方自行 takeKeyframeAck()
+     */
+    void setAckSink(KeyframeAckSink* sink) { ack_sink = sink; }
+
+    /**
+     * @brief 启动解码线程
+     * @param workers 线程数，小于1时按1
+     */
+    void start(int workers);
+
+    /**
+     * @brief 停止并等待全部解码线程退出，队列中未解码的数据包被丢弃
+     */
+    void stop();
+
+    /**
+     * @brief 交给对应的解码线程（接收线程调用，单生产者）
+     * @return 停止时放弃并返回false
+     */
+    bool push(UdpPacket&& packet) override;
+
+    /**
+     * @brief 读取某槽位的状态快照（任意线程）
+     * @return 槽位无效时返回false
+     */
+    bool snapshot(int slot, DroneSnapshot& out) const;
+
+    /**
+     * @brief 取出某槽位待回复的关键帧确认
+     * @return 有待回复的确认时返回true并清除
+     */
+    bool takeKeyframeAck(int slot, uint8_t& key_id);
+
+    // 解码线程数
+    int getWorkerCount() const { return static_cast<int>(workers.size()); }
+    // 某解码线程解码的数据包数
+    uint64_t getWorkerPacketCount(int worker) const;
+    // 某解码线程解码耗时累计（纳秒）
+    uint64_t getWorkerBusyNs(int worker) const;
+    // 全部线程解码的数据包数
+    uint64_t getDecodedCount() const;
+    // 解码队列满、接收线程等待的次数
+    uint64_t getQueueFullCount() const { return queue_full.load(std::memory_order_relaxed); }
+    // 各解码队列中待解码的数据包总数
+    size_t getQueueDepth() const;
+
+private:
+    struct Worker {
+        SpscRing<UdpPacket> queue{WORKER_QUEUE_CAPACITY};
+        std::thread thread;
+        std::mutex wake_mutex;
+        std::condition_variable wake;
+        std::atomic<bool> sleeping{false};
+        std::atomic<uint64_t> packets{0};
+        std::atomic<uint64_t> busy_ns{0};
+    };
+
+    // 快照槽：自旋锁保护，写者每包持锁一次，只拷贝几十字节
+    struct alignas(64) SnapshotSlot {
+        mutable std::atomic_flag lock = ATOMIC_FLAG_INIT;
+        DroneSnapshot data;
+        bool ack_pending = false;
+        uint8_t ack_id = 0;
+    };
+
+    // 解码线程主循环
+    void run(int index);
+    // 把槽位的状态拷进快照并录制
+    void publish(int slot, uint64_t now_ns, uint64_t received_ns);
+    // 没有写入状态的数据包只刷新快照中的诊断计数，位姿、更新次数和录制都不变
+    void publishCounters(int slot);
+
+    Ingress& ingress;
+    DroneData<UdpPacket>& drones;
+    std::unique_ptr<SnapshotSlot[]> snapshots;
+    int slot_count = 0;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<bool> running{false};
+    std::atomic<uint64_t> queue_full{0};
+    ThreadPolicy thread_policy;
+    PipelineLatency* pipeline_latency = nullptr;
+    TelemetryRecorder* recorder = nullptr;
+    KeyframeAckSink* ack_sink = nullptr;
+};
+
+#endif // DECODE_POOL_H
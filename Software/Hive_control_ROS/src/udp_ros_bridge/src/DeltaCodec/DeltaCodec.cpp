@@ -0,0 +1,226 @@
+#include "DeltaCodec.h"
+#include "../FrameScanner/FrameScanner.h"
+
+// ====================== 采样字段 ======================
+int32_t TelemetrySample::field(int i) const
+{
+    switch (i)
+    {
+        case 0: return roll;
+        case 1: return pitch;
+        case 2: return yaw;
+        case 3: return x;
+        case 4: return y;
+        case 5: return z;
+        default: return batt;
+    }
+}
+
+void TelemetrySample::setField(int i, int32_t value)
+{
+    switch (i)
+    {
+        case 0: roll = static_cast<int16_t>(value); break;
+        case 1: pitch = static_cast<int16_t>(value); break;
+        case 2: yaw = static_cast<int16_t>(value); break;
+        case 3: x = value; break;
+        case 4: y = value; break;
+        case 5: z = value; break;
+        default: batt = static_cast<uint8_t>(value); break;
+    }
+}
+
+// ====================== varint ======================
+size_t writeVarint(uint32_t value, uint8_t* out)
+{
+    size_t n = 0;
+    while (value >= 0x80)
+    {
+        out[n++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = static_cast<uint8_t>(value);
+    return n;
+}
+
+size_t readVarint(const uint8_t* data, size_t size, uint32_t& value)
+{
+    uint32_t result = 0;
+    for (size_t i = 0; i < size && i < 5; i++)
+    {
+        result |= static_cast<uint32_t>(data[i] & 0x7F) << (7 * i);
+        if ((data[i] & 0x80) == 0)
+        {
+            value = result;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+// ====================== 编码 ======================
+static void writeKeyframe(uint8_t key_id, const TelemetrySample& sample, uint8_t* params)
+{
+    params[0] = key_id;
+    params[1] = static_cast<uint8_t>(sample.roll >> 8);
+    params[2] = static_cast<uint8_t>(sample.roll);
+    params[3] = static_cast<uint8_t>(sample.pitch >> 8);
+    params[4] = static_cast<uint8_t>(sample.pitch);
+    params[5] = static_cast<uint8_t>(sample.yaw >> 8);
+    params[6] = static_cast<uint8_t>(sample.yaw);
+    const int32_t position[3] = {sample.x, sample.y, sample.z};
+    for (int i = 0; i < 3; i++)
+    {
+        uint32_t value = static_cast<uint32_t>(position[i]);
+        params[7 + i * 4] = static_cast<uint8_t>(value >> 24);
+        params[8 + i * 4] = static_cast<uint8_t>(value >> 16);
+        params[9 + i * 4] = static_cast<uint8_t>(value >> 8);
+        params[10 + i * 4] = static_cast<uint8_t>(value);
+    }
+    params[19] = sample.batt;
+}
+
+DeltaEncoder::DeltaEncoder(uint16_t keyframe_interval, uint16_t resend_interval)
+    : keyframe_interval(keyframe_interval), resend_interval(resend_interval)
+{
+}
+
+uint8_t DeltaEncoder::encode(const TelemetrySample& sample, uint8_t* params, uint8_t& length)
+{
+    since_keyframe++;
+    // 没有基准、到了关键帧周期、或待确认的关键帧太久没有回音时发关键帧
+    bool keyframe = !has_base || since_keyframe >= keyframe_interval ||
+                    (pending && since_keyframe >= resend_interval);
+    if (!keyframe)
+    {
+        uint8_t buffer[DELTA_MAX_LENGTH];
+        uint8_t mask = 0;
+        size_t n = 2;
+        for (int i = 0; i < TELEMETRY_FIELD_COUNT; i++)
+        {
+            // 32位回绕相减，解码端按回绕相加还原
+            int32_t diff = static_cast<int32_t>(static_cast<uint32_t>(sample.field(i)) -
+                                                static_cast<uint32_t>(base.field(i)));
+            if (diff != 0)
+            {
+                mask |= 1 << i;
+                n += writeVarint(zigzagEncode(diff), buffer + n);
+            }
+        }
+        // 变化太大时增量不比关键帧短，直接发关键帧
+        if (n < KEYFRAME_LENGTH)
+        {
+            buffer[0] = base_id;
+            buffer[1] = mask;
+            for (size_t i = 0; i < n; i++)
+            {
+                params[i] = buffer[i];
+            }
+            length = static_cast<uint8_t>(n);
+            return FRAME_TYPE_DELTA;
+        }
+    }
+
+    // 每个关键帧（含重发）取新帧号，迟到的旧确认不会把不同的值当作基准；
+    // 跳过与基准占同一存储位置的帧号，地面的基准关键帧不会被覆盖
+    pending_id = next_id++;
+    if (has_base && pending_id % KEYFRAME_SLOTS == base_id % KEYFRAME_SLOTS)
+    {
+        pending_id = next_id++;
+    }
+    pending = true;
+    pending_sample = sample;
+    since_keyframe = 0;
+    writeKeyframe(pending_id, sample, params);
+    length = KEYFRAME_LENGTH;
+    return FRAME_TYPE_KEYFRAME;
+}
+
+void DeltaEncoder::onAck(uint8_t key_id)
+{
+    if (!pending || key_id != pending_id)
+    {
+        return;
+    }
+    has_base = true;
+    base_id = pending_id;
+    base = pending_sample;
+    pending = false;
+}
+
+// ====================== 解码 ======================
+static inline int32_t readInt32(const uint8_t* p)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(p[0]) << 24 | static_cast<uint32_t>(p[1]) << 16 |
+                                static_cast<uint32_t>(p[2]) << 8 | p[3]);
+}
+
+bool decodeKeyframe(const uint8_t* params, size_t length, DeltaKeyframes& keyframes, TelemetrySample& out)
+{
+    if (length < KEYFRAME_LENGTH)
+    {
+        return false;
+    }
+    uint8_t key_id = params[0];
+    out.roll = static_cast<int16_t>(params[1] << 8 | params[2]);
+    out.pitch = static_cast<int16_t>(params[3] << 8 | params[4]);
+    out.yaw = static_cast<int16_t>(params[5] << 8 | params[6]);
+    out.x = readInt32(params + 7);
+    out.y = readInt32(params + 11);
+    out.z = readInt32(params + 15);
+    out.batt = params[19];
+
+    int slot = key_id % KEYFRAME_SLOTS;
+    keyframes.samples[slot] = out;
+    keyframes.ids[slot] = key_id;
+    keyframes.valid |= 1 << slot;
+    keyframes.ack_pending = true;
+    keyframes.ack_id = key_id;
+    return true;
+}
+
+bool decodeDelta(const uint8_t* params, size_t length, DeltaKeyframes& keyframes, TelemetrySample& out)
+{
+    if (length < 2)
+    {
+        return false;
+    }
+    uint8_t key_id = params[0];
+    uint8_t mask = params[1];
+    int slot = key_id % KEYFRAME_SLOTS;
+    if (!(keyframes.valid & (1 << slot)) || keyframes.ids[slot] != key_id)
+    {
+        // 地面重启或关键帧丢失：等无人机重发关键帧
+        keyframes.missing_base++;
+        return false;
+    }
+
+    TelemetrySample sample = keyframes.samples[slot];
+    size_t offset = 2;
+    for (int i = 0; i < TELEMETRY_FIELD_COUNT; i++)
+    {
+        if (!(mask & (1 << i)))
+        {
+            continue;
+        }
+        uint32_t value;
+        size_t n = readVarint(params + offset, length - offset, value);
+        if (n == 0)
+        {
+            return false;
+        }
+        offset += n;
+        // 按32位回绕相加，与编码端的减法对应
+        sample.setField(i, static_cast<int32_t>(static_cast<uint32_t>(sample.field(i)) +
+                                                static_cast<uint32_t>(zigzagDecode(value))));
+    }
+    out = sample;
+    return true;
+}
+
+void buildKeyframeAck(uint8_t key_id, std::vector<uint8_t>& frame)
+{
+    frame.assign({FRAME_HEAD, FRAME_HEAD, FRAME_TYPE_KEYFRAME_ACK, 1, key_id});
+    frame.push_back(static_cast<uint8_t>(FRAME_TYPE_KEYFRAME_ACK + 1 + key_id));
+    frame.push_back(FRAME_TAIL);
+}
@@ -0,0 +1,148 @@
+#ifndef DELTA_CODEC_H
+#define DELTA_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ====================== 紧凑遥测编码 ======================
+// 姿态、位置、电池合成一帧发送，相对最近一次地面确认过的关键帧只发变化量：
+//   关键帧（类型0x08，20字节）：[关键帧号][roll:2][pitch:2][yaw:2][x:4][y:4][z:4][batt:1]，高位在前
+//   增量帧（类型0x09）：[关键帧号][字段掩码][变化字段的 zig-zag varint 差值...]
+//     掩码第0~6位依次为 roll, pitch, yaw, x, y, z, batt，未置位的字段与关键帧相同
+//   关键帧确认（类型0x0A，地面->无人机）：[关键帧号]
+// 无人机收到确认后才以该关键帧为基准发增量，因此地面一定持有增量帧引用的关键帧；
+// 定期发送新关键帧，一方面让差值保持很小，另一方面地面重启后能重新同步。
+// 与无人机端 UAV_ESP/System/DeltaCodec 保持一致。
+static const uint8_t FRAME_TYPE_KEYFRAME = 0x08;
+static const uint8_t FRAME_TYPE_DELTA = 0x09;
+static const uint8_t FRAME_TYPE_KEYFRAME_ACK = 0x0A;
+
+// 关键帧参数长度
+static const uint8_t KEYFRAME_LENGTH = 20;
+// 增量帧最长参数长度：帧号 + 掩码 + 3个16位字段(各3字节) + 3个32位字段(各5字节) + 电池(2字节)
+static const uint8_t DELTA_MAX_LENGTH = 2 + 3 * 3 + 3 * 5 + 2;
+// 字段数
+static const int TELEMETRY_FIELD_COUNT = 7;
+// 地面保存的关键帧数（按帧号低2位存放）
+static const int KEYFRAME_SLOTS = 4;
+
+/**
+ * @brief 一次遥测采样（定点数，与二进制帧中的整数一致）
+ */
+struct TelemetrySample {
+    int16_t roll = 0;
+    int16_t pitch = 0;
+    int16_t yaw = 0;
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t z = 0;
+    uint8_t batt = 0;
+
+    // 按掩码顺序取第i个字段
+    int32_t field(int i) const;
+    void setField(int i, int32_t value);
+};
+
+// ====================== varint ======================
+inline uint32_t zigzagEncode(int32_t value)
+{
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+inline int32_t zigzagDecode(uint32_t value)
+{
+    return static_cast<int32_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+/**
+ * @brief 写一个无符号varint（每字节7位，低位在前）
+ * @return 写入的字节数（1~5）
+ */
+size_t writeVarint(uint32_t value, uint8_t* out);
+
+/**
+ * @brief 读一个无符号varint
+ * @return 读取的字节数，数据不完整或超过5字节返回0
+ */
+size_t readVarint(const uint8_t* data, size_t size, uint32_t& value);
+
+// ====================== 编码 ======================
+/**
+ * @brief 增量编码器（无人机端的同一实现，地面端用于测试和回放工具）
+ */
+class DeltaEncoder {
+public:
+    /**
+     * @param keyframe_interval 每隔多少次采样发一个新关键帧
+     * @param resend_interval 关键帧未被确认时，隔多少次采样重发
+     */
+    explicit DeltaEncoder(uint16_t keyframe_interval = 50, uint16_t resend_interval = 10);
+
+    /**
+     * @brief 编码一次采样
+     * @param sample 采样
+     * @param params 输出参数区，至少 KEYFRAME_LENGTH 字节
+     * @param length 输出参数长度
+     * @return 帧类型（FRAME_TYPE_KEYFRAME 或 FRAME_TYPE_DELTA）
+     */
+    uint8_t encode(const TelemetrySample& sample, uint8_t* params, uint8_t& length);
+
+    /**
+     * @brief 收到地面的关键帧确认
+     */
+    void onAck(uint8_t key_id);
+
+    // 是否已有确认过的关键帧
+    bool hasBase() const { return has_base; }
+
+private:
+    uint16_t keyframe_interval;
+    uint16_t resend_interval;
+    // 已确认的基准关键帧
+    bool has_base = false;
+    uint8_t base_id = 0;
+    TelemetrySample base;
+    // 已发出、等待确认的关键帧
+    bool pending = false;
+    uint8_t pending_id = 0;
+    TelemetrySample pending_sample;
+    uint16_t since_keyframe = 0;
+    uint8_t next_id = 0;
+};
+
+// ====================== 解码 ======================
+/**
+ * @brief 单架无人机的关键帧存储和待回复的确认
+ * @note 只含POD成员，作为 DataProcessing 的成员随无人机数据一起存放
+ */
+struct DeltaKeyframes {
+    TelemetrySample samples[KEYFRAME_SLOTS];
+    uint8_t ids[KEYFRAME_SLOTS] = {};
+    // 第i位表示 samples[i] 有效
+    uint8_t valid = 0;
+    // 收到关键帧后需要回复确认
+    bool ack_pending = false;
+    uint8_t ack_id = 0;
+    // 引用了不存在的关键帧而丢弃的增量帧数
+    uint32_t missing_base = 0;
+};
+
+/**
+ * @brief 解码关键帧，保存并登记待回复的确认
+ * @return 参数长度不足返回false
+ */
+bool decodeKeyframe(const uint8_t* params, size_t length, DeltaKeyframes& keyframes, TelemetrySample& out);
+
+/**
+ * @brief 解码增量帧
+ * @return 参数不完整或引用的关键帧不存在时返回false
+ */
+bool decodeDelta(const uint8_t* params, size_t length, DeltaKeyframes& keyframes, TelemetrySample& out);
+
+/**
+ * @brief 组一个关键帧确认帧（加和校验，不带序号），发往无人机
+ */
+void buildKeyframeAck(uint8_t key_id, std::vector<uint8_t>& frame);
+
+#endif // DELTA_CODEC_H
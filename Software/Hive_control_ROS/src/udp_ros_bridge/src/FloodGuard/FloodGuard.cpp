@@ -0,0 +1,85 @@
+#include "FloodGuard.h"
+
+// ====================== 构造函数 ======================
+FloodGuard::FloodGuard(double rate, double burst) : rate(rate), burst(burst)
+{
+}
+
+// ====================== 设置限流参数 ======================
+void FloodGuard::setLimits(double rate, double burst)
+{
+    this->rate = rate;
+    this->burst = burst;
+}
+
+// ====================== 绑定注册表 ======================
+void FloodGuard::attach(const SwarmRegistry& registry)
+{
+    this->registry = &registry;
+    slot_count = registry.getDroneCount();
+    buckets.reset(new Bucket[slot_count > 0 ? slot_count : 1]);
+    for (int i = 0; i < slot_count; i++)
+    {
+        // 初始满桶，避免刚开始接收就误伤
+        buckets[i].tokens = burst;
+    }
+}
+
+// ====================== 放行判断 ======================
+bool FloodGuard::admit(const struct sockaddr_in& addr, uint64_t now_ns, int& slot)
+{
+    slot = registry != nullptr ? registry->findSlotByAddress(addr.sin_addr.s_addr, ntohs(addr.sin_port)) : -1;
+
+    if (slot < 0 || slot >= slot_count)
+    {
+        slot = -1;
+        // 注册未关闭时放行未知来源，关闭后直接丢弃
+        if (registration_closed.load(std::memory_order_acquire))
+        {
+            unknown_drops.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    Bucket& bucket = buckets[slot];
+
+    // 按经过的时间补充令牌，最多补满到桶容量
+    if (bucket.last_ns != 0 && now_ns > bucket.last_ns)
+    {
+        bucket.tokens += (now_ns - bucket.last_ns) * 1e-9 * rate;
+        if (bucket.tokens > burst)
+        {
+            bucket.tokens = burst;
+        }
+    }
+    bucket.last_ns = now_ns;
+
+    if (bucket.tokens < 1.0)
+    {
+        bucket.dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    bucket.tokens -= 1.0;
+    bucket.accepted.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+// ====================== 计数器 ======================
+uint64_t FloodGuard::getDropCount(int slot) const
+{
+    if (slot < 0 || slot >= slot_count)
+    {
+        return 0;
+    }
+    return buckets[slot].dropped.load(std::memory_order_relaxed);
+}
+
+uint64_t FloodGuard::getAcceptCount(int slot) const
+{
+    if (slot < 0 || slot >= slot_count)
+    {
+        return 0;
+    }
+    return buckets[slot].accepted.load(std::memory_order_relaxed);
+}
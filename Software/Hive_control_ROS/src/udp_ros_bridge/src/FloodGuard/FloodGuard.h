@@ -0,0 +1,79 @@
+#ifndef FLOOD_GUARD_H
+#define FLOOD_GUARD_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <netinet/in.h>
+#include "../SwarmRegistry/SwarmRegistry.h"
+
+/**
+ * @brief 按来源限流的接收端防洪
+ * @note 每架已注册无人机一个令牌桶，按注册表的地址索引定位；
+ *       注册关闭后，未注册地址的数据报在拷贝之前直接丢弃。
+ *       admit() 只由接收线程调用，计数器可由其他线程随时读取。
+ */
+class FloodGuard {
+public:
+    /**
+     * @brief 构造函数
+     * @param rate 每架无人机每秒允许的数据报数
+     * @param burst 令牌桶容量（允许的突发数据报数）
+     */
+    FloodGuard(double rate = 500.0, double burst = 100.0);
+
+    /**
+     * @brief 设置限流参数，下次 attach() 时生效
+     */
+    void setLimits(double rate, double burst);
+
+    /**
+     * @brief 绑定注册表并按当前无人机数量重建令牌桶
+     * @note 必须在接收线程停止时调用（注册阶段结束后）
+     */
+    void attach(const SwarmRegistry& registry);
+
+    /**
+     * @brief 关闭注册：此后未注册地址的数据报一律丢弃
+     */
+    void closeRegistration() { registration_closed.store(true, std::memory_order_release); }
+
+    /**
+     * @brief 判断一个数据报是否放行
+     * @param addr 来源地址
+     * @param now_ns 当前时间（纳秒）
+     * @param slot 输出：来源无人机槽位，未注册时为-1
+     * @return 放行返回true，限流或未注册丢弃返回false
+     */
+    bool admit(const struct sockaddr_in& addr, uint64_t now_ns, int& slot);
+
+    // 某槽位被限流丢弃的数据报数
+    uint64_t getDropCount(int slot) const;
+    // 某槽位放行的数据报数
+    uint64_t getAcceptCount(int slot) const;
+    // 来自未注册地址被丢弃的数据报数
+    uint64_t getUnknownDropCount() const { return unknown_drops.load(std::memory_order_relaxed); }
+    // 令牌桶数量（即注册时的无人机数量）
+    int getSlotCount() const { return slot_count; }
+
+private:
+    // 单个来源的令牌桶
+    struct Bucket {
+        // 当前令牌数
+        double tokens = 0;
+        // 上次补充令牌的时间（纳秒）
+        uint64_t last_ns = 0;
+        std::atomic<uint64_t> accepted{0};
+        std::atomic<uint64_t> dropped{0};
+    };
+
+    double rate;
+    double burst;
+    const SwarmRegistry* registry = nullptr;
+    std::unique_ptr<Bucket[]> buckets;
+    int slot_count = 0;
+    std::atomic<bool> registration_closed{false};
+    std::atomic<uint64_t> unknown_drops{0};
+};
+
+#endif // FLOOD_GUARD_H
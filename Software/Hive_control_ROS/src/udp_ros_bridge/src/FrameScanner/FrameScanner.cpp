@@ -0,0 +1,288 @@
+#include "FrameScanner.h"
+#include "../Crc/Crc.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define FRAME_SCANNER_X86 1
+#include <immintrin.h>
+#endif
+
+// 每次查找候选包头的块大小，候选偏移缓存保持在L1内
+static const size_t SCAN_BLOCK = 4096;
+
+// ====================== 标量实现 ======================
+static void findHeadersScalar(const uint8_t* data, size_t size, size_t begin, size_t end,
+                              std::vector<uint32_t>& offsets)
+{
+    for (size_t i = begin; i < end && i + 1 < size; i++)
+    {
+        if (data[i] == FRAME_HEAD && data[i + 1] == FRAME_HEAD)
+        {
+            offsets.push_back(static_cast<uint32_t>(i));
+        }
+    }
+}
+
+static uint8_t checksumScalar(const uint8_t* data, size_t size)
+{
+    uint8_t sum = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+        sum += data[i];
+    }
+    return sum;
+}
+
+#ifdef FRAME_SCANNER_X86
+// ====================== SSE2实现 ======================
+// 把比较结果的位掩码展开成偏移
+static inline void emitMask(uint32_t mask, size_t base, size_t end, std::vector<uint32_t>& offsets)
+{
+    while (mask != 0)
+    {
+        size_t pos = base + static_cast<size_t>(__builtin_ctz(mask));
+        if (pos >= end)
+        {
+            break;
+        }
+        offsets.push_back(static_cast<uint32_t>(pos));
+        mask &= mask - 1;
+    }
+}
+
+__attribute__((target("sse2")))
+static size_t findHeadersSse2(const uint8_t* data, size_t size, size_t begin, size_t end,
+                              std::vector<uint32_t>& offsets)
+{
+    const __m128i head = _mm_set1_epi8(static_cast<char>(FRAME_HEAD));
+    size_t i = begin;
+    // 同时比较 data[i..i+15] 和 data[i+1..i+16]，两者都是0xEE的位置即候选包头
+    for (; i < end && i + 17 <= size; i += 16)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 1));
+        __m128i hit = _mm_and_si128(_mm_cmpeq_epi8(a, head), _mm_cmpeq_epi8(b, head));
+        emitMask(static_cast<uint32_t>(_mm_movemask_epi8(hit)), i, end, offsets);
+    }
+    return i;
+}
+
+__attribute__((target("sse2")))
+static uint8_t checksumSse2(const uint8_t* data, size_t size, size_t readable)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i index = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m128i acc = zero;
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(v, zero));
+    }
+    // 剩余不足16字节：缓冲区允许时整块读取再屏蔽多余字节，否则逐字节
+    size_t rest = size - i;
+    if (rest != 0)
+    {
+        if (i + 16 <= readable)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            __m128i keep = _mm_cmplt_epi8(index, _mm_set1_epi8(static_cast<char>(rest)));
+            acc = _mm_add_epi64(acc, _mm_sad_epu8(_mm_and_si128(v, keep), zero));
+            rest = 0;
+        }
+    }
+    uint32_t sum = static_cast<uint32_t>(_mm_cvtsi128_si32(acc)) +
+                   static_cast<uint32_t>(_mm_extract_epi16(acc, 4));
+    return static_cast<uint8_t>(sum + checksumScalar(data + size - rest, rest));
+}
+
+// ====================== AVX2实现 ======================
+__attribute__((target("avx2")))
+static size_t findHeadersAvx2(const uint8_t* data, size_t size, size_t begin, size_t end,
+                              std::vector<uint32_t>& offsets)
+{
+    const __m256i head = _mm256_set1_epi8(static_cast<char>(FRAME_HEAD));
+    size_t i = begin;
+    for (; i < end && i + 33 <= size; i += 32)
+    {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 1));
+        __m256i hit = _mm256_and_si256(_mm256_cmpeq_epi8(a, head), _mm256_cmpeq_epi8(b, head));
+        emitMask(static_cast<uint32_t>(_mm256_movemask_epi8(hit)), i, end, offsets);
+    }
+    return i;
+}
+#endif
+
+// ====================== 构造函数 ======================
+FrameScanner::FrameScanner(Isa isa) : isa(isa)
+{
+    // 指定的实现CPU不支持时降级
+    Isa best = detectIsa();
+    if (static_cast<int>(this->isa) > static_cast<int>(best))
+    {
+        this->isa = best;
+    }
+    // 一个扫描块内的候选数不超过块大小，一次分配到位，之后扫描不再分配内存
+    candidates.reserve(SCAN_BLOCK);
+}
+
+// ====================== 指令集检测 ======================
+FrameScanner::Isa FrameScanner::detectIsa()
+{
+#ifdef FRAME_SCANNER_X86
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return Isa::AVX2;
+    }
+    if (__builtin_cpu_supports("sse2"))
+    {
+        return Isa::SSE2;
+    }
+#endif
+    return Isa::SCALAR;
+}
+
+const char* FrameScanner::isaName(Isa isa)
+{
+    switch (isa)
+    {
+        case Isa::AVX2:
+            return "avx2";
+        case Isa::SSE2:
+            return "sse2";
+        default:
+            return "scalar";
+    }
+}
+
+// ====================== 候选包头 ======================
+void FrameScanner::findHeadersRange(const uint8_t* data, size_t size, size_t begin, size_t end,
+                                    std::vector<uint32_t>& offsets) const
+{
+    size_t i = begin;
+#ifdef FRAME_SCANNER_X86
+    if (isa == Isa::AVX2)
+    {
+        i = findHeadersAvx2(data, size, i, end, offsets);
+    }
+    if (isa != Isa::SCALAR)
+    {
+        i = findHeadersSse2(data, size, i, end, offsets);
+    }
+#endif
+    // 缓冲区末尾不足一个向量的部分
+    findHeadersScalar(data, size, i, end, offsets);
+}
+
+size_t FrameScanner::findHeaders(const uint8_t* data, size_t size, std::vector<uint32_t>& offsets) const
+{
+    size_t before = offsets.size();
+    if (data != nullptr)
+    {
+        findHeadersRange(data, size, 0, size, offsets);
+    }
+    return offsets.size() - before;
+}
+
+// ====================== 校验和 ======================
+uint8_t FrameScanner::checksum(const uint8_t* data, size_t size, size_t readable) const
+{
+#ifdef FRAME_SCANNER_X86
+    if (isa != Isa::SCALAR)
+    {
+        return checksumSse2(data, size, readable);
+    }
+#endif
+    (void)readable;
+    return checksumScalar(data, size);
+}
+
+bool FrameScanner::verify(const uint8_t* check_data, size_t covered, size_t readable, uint8_t check) const
+{
+    const uint8_t* trailer = check_data + covered;
+    switch (check)
+    {
+        case FRAME_CHECK_SUM:
+            return checksum(check_data, covered, readable) == trailer[0];
+        case FRAME_CHECK_CRC16:
+            return crc16Ccitt(check_data, covered) == (trailer[0] << 8 | trailer[1]);
+        case FRAME_CHECK_CRC32C:
+            return crc32c(check_data, covered) ==
+                   (static_cast<uint32_t>(trailer[0]) << 24 | static_cast<uint32_t>(trailer[1]) << 16 |
+                    static_cast<uint32_t>(trailer[2]) << 8 | static_cast<uint32_t>(trailer[3]));
+        default:
+            return false;
+    }
+}
+
+// ====================== 扫描合法帧 ======================
+size_t FrameScanner::scan(const uint8_t* data, size_t size, std::vector<FrameView>& frames)
+{
+    frames.clear();
+    // 按最多可能的帧数预留，容量只随见过的最大缓冲区增长，不随内容（候选包头多少）变化
+    frames.reserve(size / FRAME_OVERHEAD + 1);
+    if (data == nullptr || size < FRAME_OVERHEAD)
+    {
+        skipped_bytes += size;
+        return 0;
+    }
+
+    // 下一帧允许开始的位置：落在上一合法帧内部的候选包头直接跳过
+    size_t cursor = 0;
+    for (size_t block = 0; block < size; block += SCAN_BLOCK)
+    {
+        size_t block_end = block + SCAN_BLOCK < size ? block + SCAN_BLOCK : size;
+        if (block_end <= cursor)
+        {
+            continue;
+        }
+        candidates.clear();
+        findHeadersRange(data, size, block > cursor ? block : cursor, block_end, candidates);
+
+        for (uint32_t offset : candidates)
+        {
+            if (offset < cursor)
+            {
+                continue;
+            }
+            // 候选帧至少要放得下固定字节
+            if (offset + FRAME_OVERHEAD > size)
+            {
+                framing_errors++;
+                continue;
+            }
+            uint8_t status = data[offset + 2];
+            uint8_t length = data[offset + 3];
+            size_t check_size = frameCheckSize(status);
+            size_t seq_size = frameSeqSize(status);
+            size_t frame_end = offset + 5 + seq_size + length + check_size;
+            if (check_size == 0 || frame_end > size || data[frame_end - 1] != FRAME_TAIL)
+            {
+                framing_errors++;
+                continue;
+            }
+            // 校验范围：状态位、长度、序号和全部参数
+            uint8_t check = status & FRAME_CHECK_MASK;
+            if (!verify(data + offset + 2, 2 + seq_size + length, size - offset - 2, check))
+            {
+                checksum_errors++;
+                continue;
+            }
+
+            skipped_bytes += offset - cursor;
+            FrameView frame;
+            frame.offset = offset;
+            frame.status = status & FRAME_TYPE_MASK;
+            frame.check = check;
+            frame.length = length;
+            frame.has_seq = seq_size != 0;
+            frame.seq = frame.has_seq ? static_cast<uint16_t>(data[offset + 4] << 8 | data[offset + 5]) : 0;
+            frame.params = data + offset + 4 + seq_size;
+            frames.push_back(frame);
+            frame_counts[check >> 6]++;
+            cursor = frame_end;
+        }
+    }
+    skipped_bytes += size - cursor;
+    return frames.size();
+}
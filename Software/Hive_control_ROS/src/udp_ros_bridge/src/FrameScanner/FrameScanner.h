@@ -0,0 +1,153 @@
+#ifndef FRAME_SCANNER_H
+#define FRAME_SCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ====================== 二进制帧格式 ======================
+// [0xEE][0xEE][状态位][数据长度]([序号高][序号低])[参数位1]...[参数位n][校验][0xFF]
+// 状态位高两位选择校验方式，第5位表示带序号，低5位为数据类型：
+//   00：校验位1字节 = (状态位 + 数据长度 + 序号 + 参数位1 + ... + 参数位n) & 0xFF
+//   01：CRC-16/CCITT，2字节高位在前
+//   10：CRC-32C，4字节高位在前
+// CRC的计算范围与加和校验相同（状态位、数据长度、序号和全部参数）
+// 序号为每架无人机的16位发送计数，数据长度不含序号；旧固件不带序号（第5位为0）
+static const uint8_t FRAME_HEAD = 0xEE;
+static const uint8_t FRAME_TAIL = 0xFF;
+// 除参数外的最少字节数：包头2 + 状态1 + 长度1 + 校验1 + 包尾1
+static const size_t FRAME_OVERHEAD = 6;
+
+static const uint8_t FRAME_CHECK_MASK = 0xC0;
+static const uint8_t FRAME_CHECK_SUM = 0x00;
+static const uint8_t FRAME_CHECK_CRC16 = 0x40;
+static const uint8_t FRAME_CHECK_CRC32C = 0x80;
+static const uint8_t FRAME_SEQ_FLAG = 0x20;
+static const size_t FRAME_SEQ_SIZE = 2;
+static const uint8_t FRAME_TYPE_MASK = 0x1F;
+
+/**
+ * @brief 状态位对应的校验字节数，未定义的校验方式返回0
+ */
+inline size_t frameCheckSize(uint8_t status)
+{
+    switch (status & FRAME_CHECK_MASK)
+    {
+        case FRAME_CHECK_SUM:
+            return 1;
+        case FRAME_CHECK_CRC16:
+            return 2;
+        case FRAME_CHECK_CRC32C:
+            return 4;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief 状态位对应的序号字节数
+ */
+inline size_t frameSeqSize(uint8_t status)
+{
+    return (status & FRAME_SEQ_FLAG) ? FRAME_SEQ_SIZE : 0;
+}
+
+/**
+ * @brief 缓冲区中一帧已校验通过的数据
+ * @note params 指向原缓冲区，缓冲区释放后失效
+ */
+struct FrameView {
+    // 帧在缓冲区中的起始偏移（包头位置）
+    uint32_t offset;
+    // 数据类型（状态位低5位）
+    uint8_t status;
+    // 校验方式（FRAME_CHECK_*）
+    uint8_t check;
+    // 参数长度
+    uint8_t length;
+    // 是否带序号
+    bool has_seq;
+    // 帧序号（has_seq 为false时为0）
+    uint16_t seq;
+    // 参数起始地址
+    const uint8_t* params;
+};
+
+/**
+ * @brief 二进制帧同步扫描器
+ * @note 先用SIMD在整段缓冲区中找出所有 0xEE 0xEE 候选包头，
+ *       再逐个检查长度、包尾和校验（加和校验用SIMD按16字节求和，CRC见 Crc.h）。
+ *       一个数据报含多帧、或读取拼接在一起的录制数据时都按同一方式处理；
+ *       候选帧校验失败时从下一个候选包头重新同步。
+ *       x86上运行时选择AVX2/SSE2，其他平台使用标量实现。
+ *       非线程安全：每个线程使用自己的扫描器。
+ */
+class FrameScanner {
+public:
+    // 指令集实现
+    enum class Isa { SCALAR, SSE2, AVX2 };
+
+    /**
+     * @brief 构造函数
+     * @param isa 使用的实现，默认按CPU支持情况自动选择
+     * @note 指定CPU不支持的指令集时自动降级
+     */
+    explicit FrameScanner(Isa isa = detectIsa());
+
+    // 当前CPU支持的最快实现
+    static Isa detectIsa();
+    // 实现名称
+    static const char* isaName(Isa isa);
+    // 本扫描器使用的实现
+    Isa getIsa() const { return isa; }
+
+    /**
+     * @brief 找出所有 0xEE 0xEE 候选包头
+     * @param data 缓冲区
+     * @param size 缓冲区字节数
+     * @param offsets 输出：候选包头偏移（追加，不清空）
+     * @return 本次找到的候选数量
+     */
+    size_t findHeaders(const uint8_t* data, size_t size, std::vector<uint32_t>& offsets) const;
+
+    /**
+     * @brief 扫描缓冲区中所有合法帧
+     * @param data 缓冲区
+     * @param size 缓冲区字节数
+     * @param frames 输出：合法帧（先清空）
+     * @return 合法帧数量
+     */
+    size_t scan(const uint8_t* data, size_t size, std::vector<FrameView>& frames);
+
+    /**
+     * @brief 计算一段字节的加和（低8位），即帧校验和
+     */
+    uint8_t checksum(const uint8_t* data, size_t size, size_t readable) const;
+
+    // 各校验方式通过的帧数
+    uint64_t getFrameCount(uint8_t check) const { return frame_counts[(check & FRAME_CHECK_MASK) >> 6]; }
+    // 校验和错误的候选帧数
+    uint64_t getChecksumErrorCount() const { return checksum_errors; }
+    // 包尾错误或长度越界的候选帧数
+    uint64_t getFramingErrorCount() const { return framing_errors; }
+    // 不属于任何合法帧、被跳过的字节数
+    uint64_t getSkippedBytes() const { return skipped_bytes; }
+
+private:
+    // 校验一帧：check_data 指向状态位，covered 为校验覆盖的字节数，readable 为可安全读取的字节数
+    bool verify(const uint8_t* check_data, size_t covered, size_t readable, uint8_t check) const;
+
+    // 在 [begin, end) 范围内找候选包头，读取不超过 size
+    void findHeadersRange(const uint8_t* data, size_t size, size_t begin, size_t end,
+                          std::vector<uint32_t>& offsets) const;
+
+    Isa isa;
+    // 候选包头缓存，按块复用，避免每次扫描分配内存
+    std::vector<uint32_t> candidates;
+    uint64_t checksum_errors = 0;
+    uint64_t framing_errors = 0;
+    uint64_t skipped_bytes = 0;
+    uint64_t frame_counts[4] = {0, 0, 0, 0};
+};
+
+#endif // FRAME_SCANNER_H
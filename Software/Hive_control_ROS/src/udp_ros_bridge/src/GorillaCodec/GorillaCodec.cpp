@@ -0,0 +1,318 @@
+#include "GorillaCodec.h"
+#include <cstring>
+
+// ====================== 位流 ======================
+namespace
+{
+
+/**
+ * @brief 高位在前的位写入，每次最多32位
+ */
+class BitWriter
+{
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out(out), start(out.size()) {}
+
+    void write(uint32_t value, int count)
+    {
+        acc = (acc << count) | value;
+        bits += count;
+        while (bits >= 8)
+        {
+            bits -= 8;
+            out.push_back(static_cast<uint8_t>(acc >> bits));
+        }
+    }
+
+    void write64(uint64_t value)
+    {
+        write(static_cast<uint32_t>(value >> 32), 32);
+        write(static_cast<uint32_t>(value), 32);
+    }
+
+    // 补齐最后一个字节，返回写入的字节数
+    size_t finish()
+    {
+        if (bits > 0)
+        {
+            out.push_back(static_cast<uint8_t>(acc << (8 - bits)));
+            bits = 0;
+        }
+        return out.size() - start;
+    }
+
+private:
+    std::vector<uint8_t>& out;
+    size_t start;
+    uint64_t acc = 0;
+    int bits = 0;
+};
+
+/**
+ * @brief 高位在前的位读取
+ * @note 缓冲区左对齐，一次按大端装入8字节；越界读取返回0并置错误标志
+ */
+class BitReader
+{
+public:
+    BitReader(const uint8_t* data, size_t size) : data(data), size(size) { refill(); }
+
+    // 读取 count 位（1~32）
+    uint32_t read(int count)
+    {
+        if (avail < count)
+        {
+            refill();
+            if (avail < count)
+            {
+                failed = true;
+                avail = 0;
+                return 0;
+            }
+        }
+        uint32_t value = static_cast<uint32_t>(buffer >> (64 - count));
+        buffer <<= count;
+        avail -= count;
+        return value;
+    }
+
+    uint64_t read64()
+    {
+        uint64_t high = read(32);
+        return (high << 32) | read(32);
+    }
+
+    // 读取连续的1（至多 limit 个）及其后的0，返回1的个数
+    int readOnes(int limit)
+    {
+        if (avail < limit + 1)
+        {
+            refill();
+        }
+        // 取反后数前导零即为前缀中1的个数
+        int ones = __builtin_clzll(~buffer | (1ULL << (63 - limit)));
+        int used = ones < limit ? ones + 1 : limit;
+        if (avail < used)
+        {
+            failed = true;
+            avail = 0;
+            return 0;
+        }
+        buffer <<= used;
+        avail -= used;
+        return ones;
+    }
+
+    bool ok() const { return !failed; }
+
+private:
+    void refill()
+    {
+        if (pos + 8 <= size)
+        {
+            // 整字装入：多装入的不足一字节的位与下次装入的位相同，按位或不改变结果
+            uint64_t word;
+            memcpy(&word, data + pos, 8);
+            word = __builtin_bswap64(word);
+            buffer |= avail < 64 ? word >> avail : 0;
+            int take = (63 - avail) >> 3;
+            pos += take;
+            avail += take * 8;
+            return;
+        }
+        while (avail <= 56 && pos < size)
+        {
+            buffer |= static_cast<uint64_t>(data[pos++]) << (56 - avail);
+            avail += 8;
+        }
+    }
+
+    const uint8_t* data;
+    size_t size;
+    size_t pos = 0;
+    uint64_t buffer = 0;
+    int avail = 0;
+    bool failed = false;
+};
+
+inline uint64_t zigzag64(int64_t value)
+{
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t unzigzag64(uint64_t value)
+{
+    return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+// 二阶差分的分桶：前缀中1的个数 -> 数值位数
+const int DOD_BITS[5] = {0, 7, 14, 24, 32};
+
+} // namespace
+
+// ====================== 整数列 ======================
+template <typename T>
+size_t gorillaEncodeInts(const T* values, size_t count, std::vector<uint8_t>& out)
+{
+    BitWriter writer(out);
+    if (count == 0)
+    {
+        return 0;
+    }
+    // 按无符号64位回绕相减，窄类型先做符号/零扩展
+    uint64_t prev = static_cast<uint64_t>(static_cast<int64_t>(values[0]));
+    uint64_t prev_delta = 0;
+    writer.write64(prev);
+    for (size_t i = 1; i < count; i++)
+    {
+        uint64_t value = static_cast<uint64_t>(static_cast<int64_t>(values[i]));
+        uint64_t delta = value - prev;
+        uint64_t zz = zigzag64(static_cast<int64_t>(delta - prev_delta));
+        prev = value;
+        prev_delta = delta;
+        if (zz == 0)
+        {
+            writer.write(0, 1);
+        }
+        else if (zz < (1ULL << 7))
+        {
+            writer.write(0x2, 2);
+            writer.write(static_cast<uint32_t>(zz), 7);
+        }
+        else if (zz < (1ULL << 14))
+        {
+            writer.write(0x6, 3);
+            writer.write(static_cast<uint32_t>(zz), 14);
+        }
+        else if (zz < (1ULL << 24))
+        {
+            writer.write(0xE, 4);
+            writer.write(static_cast<uint32_t>(zz), 24);
+        }
+        else if (zz < (1ULL << 32))
+        {
+            writer.write(0x1E, 5);
+            writer.write(static_cast<uint32_t>(zz), 32);
+        }
+        else
+        {
+            writer.write(0x1F, 5);
+            writer.write64(zz);
+        }
+    }
+    return writer.finish();
+}
+
+template <typename T>
+bool gorillaDecodeInts(const uint8_t* data, size_t size, size_t count, T* values)
+{
+    if (count == 0)
+    {
+        return true;
+    }
+    BitReader reader(data, size);
+    uint64_t prev = reader.read64();
+    uint64_t delta = 0;
+    values[0] = static_cast<T>(prev);
+    for (size_t i = 1; i < count; i++)
+    {
+        int ones = reader.readOnes(5);
+        if (ones > 0)
+        {
+            uint64_t zz = ones < 5 ? reader.read(DOD_BITS[ones]) : reader.read64();
+            delta += static_cast<uint64_t>(unzigzag64(zz));
+        }
+        prev += delta;
+        values[i] = static_cast<T>(prev);
+    }
+    return reader.ok();
+}
+
+template size_t gorillaEncodeInts<uint64_t>(const uint64_t*, size_t, std::vector<uint8_t>&);
+template size_t gorillaEncodeInts<uint16_t>(const uint16_t*, size_t, std::vector<uint8_t>&);
+template size_t gorillaEncodeInts<int16_t>(const int16_t*, size_t, std::vector<uint8_t>&);
+template size_t gorillaEncodeInts<uint8_t>(const uint8_t*, size_t, std::vector<uint8_t>&);
+template bool gorillaDecodeInts<uint64_t>(const uint8_t*, size_t, size_t, uint64_t*);
+template bool gorillaDecodeInts<uint16_t>(const uint8_t*, size_t, size_t, uint16_t*);
+template bool gorillaDecodeInts<int16_t>(const uint8_t*, size_t, size_t, int16_t*);
+template bool gorillaDecodeInts<uint8_t>(const uint8_t*, size_t, size_t, uint8_t*);
+
+// ====================== 浮点列 ======================
+size_t gorillaEncodeFloats(const float* values, size_t count, std::vector<uint8_t>& out)
+{
+    BitWriter writer(out);
+    if (count == 0)
+    {
+        return 0;
+    }
+    uint32_t prev;
+    memcpy(&prev, &values[0], 4);
+    writer.write(prev, 32);
+    // 上一个有效位窗口，初始为不可复用
+    int window_leading = 33;
+    int window_trailing = 0;
+    for (size_t i = 1; i < count; i++)
+    {
+        uint32_t value;
+        memcpy(&value, &values[i], 4);
+        uint32_t bits = value ^ prev;
+        prev = value;
+        if (bits == 0)
+        {
+            writer.write(0, 1);
+            continue;
+        }
+        int leading = __builtin_clz(bits);
+        int trailing = __builtin_ctz(bits);
+        leading = leading > 31 ? 31 : leading;
+        if (leading >= window_leading && trailing >= window_trailing)
+        {
+            writer.write(0x2, 2);
+            writer.write(bits >> window_trailing, 32 - window_leading - window_trailing);
+            continue;
+        }
+        int length = 32 - leading - trailing;
+        writer.write(0x3, 2);
+        writer.write(static_cast<uint32_t>(leading), 5);
+        writer.write(static_cast<uint32_t>(length - 1), 5);
+        writer.write(bits >> trailing, length);
+        window_leading = leading;
+        window_trailing = trailing;
+    }
+    return writer.finish();
+}
+
+bool gorillaDecodeFloats(const uint8_t* data, size_t size, size_t count, float* values)
+{
+    if (count == 0)
+    {
+        return true;
+    }
+    BitReader reader(data, size);
+    uint32_t prev = reader.read(32);
+    memcpy(&values[0], &prev, 4);
+    int window_leading = 0;
+    int window_trailing = 0;
+    for (size_t i = 1; i < count; i++)
+    {
+        int ones = reader.readOnes(2);
+        if (ones == 1)
+        {
+            int length = 32 - window_leading - window_trailing;
+            prev ^= reader.read(length) << window_trailing;
+        }
+        else if (ones == 2)
+        {
+            window_leading = static_cast<int>(reader.read(5));
+            int length = static_cast<int>(reader.read(5)) + 1;
+            window_trailing = 32 - window_leading - length;
+            if (window_trailing < 0)
+            {
+                return false;
+            }
+            prev ^= reader.read(length) << window_trailing;
+        }
+        memcpy(&values[i], &prev, 4);
+    }
+    return reader.ok();
+}
@@ -0,0 +1,51 @@
+#ifndef GORILLA_CODEC_H
+#define GORILLA_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ====================== Gorilla 列压缩 ======================
+// 参照 Facebook Gorilla 的时间序列压缩，按列整块编码，位流高位在前：
+//   整数列（时间戳、槽位、姿态等定点字段）：首值64位原样，之后写二阶差分（delta-of-delta）的 zig-zag 值，
+//     前缀 '0' 表示0，'10'+7位，'110'+14位，'1110'+24位，'11110'+32位，'11111'+64位。
+//     纳秒时间戳带解码抖动，桶比论文（按秒计时）放宽
+//   浮点列：首值32位原样，之后写与前一值的异或：'0' 表示相同；
+//     '10' 表示有效位落在上一个窗口内，只写窗口内的位；
+//     '11'+5位前导零个数+5位有效位长度减1，再写有效位
+// 相邻样本越接近，二阶差分和异或结果的有效位越少。编码结果不含长度，解码时由调用者给出个数。
+
+/**
+ * @brief 编码整数列（二阶差分）
+ * @param values 输入
+ * @param count 个数
+ * @param out 输出，追加写入
+ * @return 写入的字节数
+ */
+template <typename T>
+size_t gorillaEncodeInts(const T* values, size_t count, std::vector<uint8_t>& out);
+
+/**
+ * @brief 解码整数列
+ * @param data 编码数据
+ * @param size 编码数据长度
+ * @param count 要解码的个数
+ * @param values 输出，至少 count 个
+ * @return 数据不完整时返回false
+ */
+template <typename T>
+bool gorillaDecodeInts(const uint8_t* data, size_t size, size_t count, T* values);
+
+/**
+ * @brief 编码浮点列（异或）
+ * @return 写入的字节数
+ */
+size_t gorillaEncodeFloats(const float* values, size_t count, std::vector<uint8_t>& out);
+
+/**
+ * @brief 解码浮点列
+ * @return 数据不完整时返回false
+ */
+bool gorillaDecodeFloats(const uint8_t* data, size_t size, size_t count, float* values);
+
+#endif // GORILLA_CODEC_H
@@ -0,0 +1,183 @@
+#include "Ingress.h"
+#include <chrono>
+#include <string_view>
+
+// 识别 key=value 时键名最多检查的字节数（已知最长键名 pid0_kp 为7字节）
+static const size_t MAX_KEY_PROBE = 32;
+
+// ====================== 数据报格式识别 ======================
+const char* payloadFormatName(PayloadFormat format)
+{
+    switch (format)
+    {
+        case PayloadFormat::BINARY:
+            return "binary";
+        case PayloadFormat::JSON:
+            return "json";
+        case PayloadFormat::KEY_VALUE:
+            return "key_value";
+        case PayloadFormat::UNKNOWN:
+            return "unknown";
+    }
+    return "unknown";
+}
+
+static bool isKeyStart(uint8_t c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+static bool isKeyChar(uint8_t c)
+{
+    return isKeyStart(c) || (c >= '0' && c <= '9');
+}
+
+static bool isBlank(uint8_t c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+PayloadFormat classifyPayload(const uint8_t* data, size_t size)
+{
+    if (data == nullptr || size == 0)
+    {
+        return PayloadFormat::UNKNOWN;
+    }
+    // 二进制帧头不允许前导字节
+    if (size >= 2 && data[0] == FRAME_HEAD && data[1] == FRAME_HEAD)
+    {
+        return PayloadFormat::BINARY;
+    }
+
+    size_t limit = size < MAX_KEY_PROBE ? size : MAX_KEY_PROBE;
+    size_t i = 0;
+    while (i < limit && isBlank(data[i]))
+    {
+        i++;
+    }
+    if (i == limit)
+    {
+        return PayloadFormat::UNKNOWN;
+    }
+    if (data[i] == '{')
+    {
+        return PayloadFormat::JSON;
+    }
+
+    // 标识符 + 可选空白 + '='
+    if (!isKeyStart(data[i]))
+    {
+        return PayloadFormat::UNKNOWN;
+    }
+    while (i < limit && isKeyChar(data[i]))
+    {
+        i++;
+    }
+    while (i < limit && isBlank(data[i]))
+    {
+        i++;
+    }
+    return i < limit && data[i] == '=' ? PayloadFormat::KEY_VALUE : PayloadFormat::UNKNOWN;
+}
+
+// ====================== 统一入口 ======================
+Ingress::Ingress(int drone_count)
+{
+    if (drone_count > 0)
+    {
+        windows.reset(new SequenceWindow[drone_count]);
+        slot_bytes.reset(new std::atomic<uint64_t>[drone_count]);
+        for (int i = 0; i < drone_count; i++)
+        {
+            slot_bytes[i].store(0, std::memory_order_relaxed);
+        }
+        slot_count = drone_count;
+    }
+}
+
+PayloadFormat Ingress::decode(const uint8_t* data, size_t size, DataProcessing& drone, SequenceWindow* window)
+{
+    PayloadFormat format = classifyPayload(data, size);
+    FormatStats& entry = stats[static_cast<int>(format)];
+    entry.packets.fetch_add(1, std::memory_order_relaxed);
+    entry.bytes.fetch_add(size, std::memory_order_relaxed);
+
+    // 文本格式直接在接收缓冲区上按 string_view 解析，不拷贝
+    std::string_view text(reinterpret_cast<const char*>(data), size);
+    auto start = std::chrono::steady_clock::now();
+    bool ok = false;
+    ParseResult result;
+    switch (format)
+    {
+        case PayloadFormat::BINARY:
+            ok = drone.ParseData(data, size, window) != 0;
+            break;
+        case PayloadFormat::JSON:
+            result = drone.ParseJson(text);
+            ok = result.ok();
+            break;
+        case PayloadFormat::KEY_VALUE:
+            result = drone.ParseData(text);
+            ok = result.ok();
+            break;
+        case PayloadFormat::UNKNOWN:
+            break;
+    }
+    if (format != PayloadFormat::UNKNOWN)
+    {
+        entry.decode_latency.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+    if (!ok)
+    {
+        entry.errors.fetch_add(1, std::memory_order_relaxed);
+        if (!result.ok())
+        {
+            parse_errors[static_cast<int>(result.status)].fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    return format;
+}
+
+bool Ingress::route(const UdpPacket& packet, DroneData<UdpPacket>& drones)
+{
+    if (packet.empty())
+    {
+        return false;
+    }
+    if (packet.slot < 0 || packet.slot >= drones.size())
+    {
+        unrouted.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    SequenceWindow* window = nullptr;
+    if (packet.slot < slot_count)
+    {
+        window = &windows[packet.slot];
+        slot_bytes[packet.slot].fetch_add(packet.size(), std::memory_order_relaxed);
+    }
+    DataProcessing& drone = drones[packet.slot];
+    uint64_t updates = drone.updates;
+    decode(packet.data(), packet.size(), drone, window);
+    return drone.updates != updates;
+}
+
+uint64_t Ingress::getPacketCount(PayloadFormat format) const
+{
+    return stats[static_cast<int>(format)].packets.load(std::memory_order_relaxed);
+}
+
+uint64_t Ingress::getByteCount(PayloadFormat format) const
+{
+    return stats[static_cast<int>(format)].bytes.load(std::memory_order_relaxed);
+}
+
+uint64_t Ingress::getErrorCount(PayloadFormat format) const
+{
+    return stats[static_cast<int>(format)].errors.load(std::memory_order_relaxed);
+}
+
+LatencyHistogram& Ingress::getDecodeLatency(PayloadFormat format)
+{
+    return stats[static_cast<int>(format)].decode_latency;
+}
@@ -0,0 +1,116 @@
+#ifndef INGRESS_H
+#define INGRESS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "../UDP/UDP.h"
+#include "../LatencyStats/LatencyStats.h"
+#include "../data_processing/data_processing.h"
+#include "../SequenceWindow/SequenceWindow.h"
+
+// ====================== 数据报格式识别 ======================
+/**
+ * @brief 数据报负载格式
+ * @note 集群中固件版本不一，同一端口上三种格式混发
+ */
+enum class PayloadFormat : uint8_t {
+    // 二进制帧：0xEE 0xEE 开头
+    BINARY,
+    // JSON对象：'{' 开头（允许前导空白）
+    JSON,
+    // 文本 key=value：标识符后紧跟 '='
+    KEY_VALUE,
+    // 无法识别，直接丢弃
+    UNKNOWN,
+};
+
+// 格式种类数（含 UNKNOWN）
+constexpr int PAYLOAD_FORMAT_COUNT = 4;
+
+/**
+ * @brief 格式名称，用于日志
+ */
+const char* payloadFormatName(PayloadFormat format);
+
+/**
+ * @brief 按数据报开头几个字节判断格式
+ * @note 只看开头，最多读取 32 字节，不校验内容；内容错误由各解码器统计
+ */
+PayloadFormat classifyPayload(const uint8_t* data, size_t size);
+
+// ====================== 统一入口 ======================
+/**
+ * @brief 多格式接收入口：识别每个数据报的格式，在原缓冲区上直接交给对应解码器
+ * @note 按 UdpPacket::slot（FloodGuard 给出的注册表下标）写入对应无人机的数据；
+ *       每架无人机一个序号窗口，二进制帧的重复、过期和乱序在写入前处理（见 SequenceWindow）；
+ *       每种格式分别统计数据报数、字节数、解码失败数和解码耗时，每个槽位另计字节数。
+ *       计数器都是原子量，可由统计线程随时读取
+ */
+class Ingress {
+public:
+    /**
+     * @brief 构造函数
+     * @param drone_count 无人机槽位数，每个槽位一个序号窗口
+     */
+    explicit Ingress(int drone_count = 0);
+
+    /**
+     * @brief 识别并解码一个数据报
+     * @param data 数据报内容
+     * @param size 字节数
+     * @param drone 写入目标
+     * @param window 来源无人机的序号窗口，为空时不检查序号
+     * @return 识别出的格式
+     */
+    PayloadFormat decode(const uint8_t* data, size_t size, DataProcessing& drone,
+                         SequenceWindow* window = nullptr);
+
+    /**
+     * @brief 按来源槽位把数据报交给对应无人机
+     * @return 数据报写入了无人机状态时返回true；来源槽位无效（未注册或超出处理器数量）、
+     *         解码失败、帧全部被序号窗口拒绝（重复、过期）时返回false，调用方据此决定是否发布和录制
+     */
+    bool route(const UdpPacket& packet, DroneData<UdpPacket>& drones);
+
+    // 某格式的数据报数
+    uint64_t getPacketCount(PayloadFormat format) const;
+    // 某格式的字节数
+    uint64_t getByteCount(PayloadFormat format) const;
+    // 某格式解码失败的数据报数（二进制：没有一帧通过校验；文本/JSON：ParseResult 有错误）
+    uint64_t getErrorCount(PayloadFormat format) const;
+    // 文本/JSON格式按第一个错误类型统计的解码失败数
+    uint64_t getParseErrorCount(ParseStatus status) const
+    {
+        return parse_errors[static_cast<int>(status)].load(std::memory_order_relaxed);
+    }
+    // 某格式的单包解码耗时
+    LatencyHistogram& getDecodeLatency(PayloadFormat format);
+    // 来源槽位无效而丢弃的数据报数
+    uint64_t getUnroutedCount() const { return unrouted.load(std::memory_order_relaxed); }
+    // 序号窗口数量
+    int getSlotCount() const { return slot_count; }
+    // 某槽位的序号窗口（丢包、乱序、重复统计）
+    const SequenceWindow& getSequenceWindow(int slot) const { return windows[slot]; }
+    // 某槽位累计收到的字节数（各格式合计），用于统计每架无人机的链路占用
+    uint64_t getSlotByteCount(int slot) const { return slot_bytes[slot].load(std::memory_order_relaxed); }
+
+private:
+    // 单个格式的统计
+    struct FormatStats {
+        std::atomic<uint64_t> packets{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> errors{0};
+        LatencyHistogram decode_latency;
+    };
+
+    FormatStats stats[PAYLOAD_FORMAT_COUNT];
+    std::atomic<uint64_t> parse_errors[PARSE_STATUS_COUNT] = {};
+    std::atomic<uint64_t> unrouted{0};
+    std::unique_ptr<SequenceWindow[]> windows;
+    std::unique_ptr<std::atomic<uint64_t>[]> slot_bytes;
+    int slot_count = 0;
+};
+
+#endif // INGRESS_H
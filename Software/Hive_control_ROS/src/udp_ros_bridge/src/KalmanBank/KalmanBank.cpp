@@ -0,0 +1,434 @@
+#include "KalmanBank.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define KALMAN_BANK_X86 1
+#endif
+
+// 数组长度补齐到16个float（一个缓存行），AVX2循环没有尾部
+static const size_t LANES = 16;
+
+// ====================== 向量化内核 ======================
+// 内核写成普通循环，由各指令集版本内联后分别向量化；循环体内没有分支和函数调用。
+// 向量化需要 -O3，CMakeLists.txt 对本文件固定了 -O3
+
+/**
+ * @brief 按周期回绕到 [-period/2, period/2]，用于新息（周期为0时 inv_period=0，不改变）
+ */
+__attribute__((always_inline)) static inline float wrapSymmetric(float x, float inv_period, float period)
+{
+    float wrap = x * inv_period;
+    return x - static_cast<float>(static_cast<int>(wrap + std::copysign(0.5f, wrap))) * period;
+}
+
+/**
+ * @brief 负数（含-0）返回1，否则返回0
+ * @note 取符号位代替浮点比较：默认的 -ftrapping-math 下循环里的浮点比较不会被改写成选择，阻止向量化
+ */
+__attribute__((always_inline)) static inline float signBit(float x)
+{
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    return static_cast<float>(bits >> 31);
+}
+
+/**
+ * @brief 按周期回绕到 [lower, lower + period)（周期为0时 inv_period=0，不改变）
+ * @note 截断取整后按符号位修正为向下取整；略小于 lower 的值加一个周期后
+ *       可能舍入成 lower + period，此时再减一个周期
+ */
+__attribute__((always_inline)) static inline float wrapPeriod(float x, float inv_period, float period, float lower)
+{
+    float wrap = (x - lower) * inv_period;
+    float turns = static_cast<float>(static_cast<int>(wrap));
+    turns -= signBit(wrap - turns);
+    float result = x - turns * period;
+    return result - (1.0f - signBit(result - (lower + period))) * period;
+}
+
+/**
+ * @brief 逐架计算预测间隔和掩码，推进滤波器时间
+ */
+__attribute__((always_inline)) static inline void prepareBody(size_t n, double* __restrict time,
+                                                             const double* __restrict measure_time,
+                                                             const float* __restrict has, float* __restrict initialized,
+                                                             float* __restrict first, float* __restrict dt)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        // 掩码为0/1，用乘法代替选择；没有新测量的目标时间就是当前时间（间隔为0）
+        double h = has[i];
+        double target = measure_time[i] * h + time[i] * (1.0 - h);
+        // 乱序的旧测量不回退时间，按零间隔更新
+        float forward = std::max(static_cast<float>(target - time[i]), 0.0f);
+        time[i] = std::max(target, time[i]);
+        // 首次测量不预测（间隔为0），只记下时间
+        dt[i] = forward * initialized[i];
+        first[i] = has[i] * (1.0f - initialized[i]);
+        initialized[i] = std::max(initialized[i], has[i]);
+    }
+}
+
+/**
+ * @brief 一个轴的预测+更新
+ * @param q 白噪声加速度的谱密度（单位²/秒³）
+ * @param r 测量方差
+ * @param p11_init 首次测量时的速度方差
+ * @param period 回绕周期（0表示不回绕）
+ * @param lower 回绕后状态的下界（新息总是回绕到 [-period/2, period/2]）
+ */
+__attribute__((always_inline)) static inline void axisBody(size_t n, float* __restrict p_, float* __restrict v_,
+                                                          float* __restrict p00_, float* __restrict p01_,
+                                                          float* __restrict p11_, const float* __restrict z_,
+                                                          const float* __restrict dt, const float* __restrict has,
+                                                          const float* __restrict first, float q, float r,
+                                                          float p11_init, float period, float lower)
+{
+    const float inv_period = period > 0 ? 1.0f / period : 0.0f;
+    for (size_t i = 0; i < n; i++)
+    {
+        // 预测：匀速模型，过程噪声为白噪声加速度
+        float d = dt[i];
+        float d2 = d * d;
+        float v = v_[i];
+        float p = p_[i] + v * d;
+        float p01 = p01_[i];
+        float p11 = p11_[i];
+        float p00 = p00_[i] + d * (2.0f * p01 + d * p11) + q * d2 * d * (1.0f / 3.0f);
+        p01 = p01 + d * p11 + q * d2 * 0.5f;
+        p11 = p11 + q * d;
+
+        // 更新：新息按周期对称回绕，更新后的状态回绕到 [lower, lower + period)
+        float z = z_[i];
+        float y = wrapSymmetric(z - p, inv_period, period);
+        float m = has[i];
+        float inv_s = 1.0f / (p00 + r);
+        float k0 = p00 * inv_s * m;
+        float k1 = p01 * inv_s * m;
+        p += k0 * y;
+        v += k1 * y;
+        p11 -= k1 * p01;
+        p01 -= k0 * p01;
+        p00 -= k0 * p00;
+        p = wrapPeriod(p, inv_period, period, lower);
+
+        // 首次测量：位置取测量值，速度为0
+        float f = first[i];
+        float keep = 1.0f - f;
+        p_[i] = p * keep + z * f;
+        v_[i] = v * keep;
+        p00_[i] = p00 * keep + r * f;
+        p01_[i] = p01 * keep;
+        p11_[i] = p11 * keep + p11_init * f;
+    }
+}
+
+/**
+ * @brief 逐架计算外推时长：状态时间到 now_s，截断到 [0, max_horizon]，未初始化的为0
+ */
+__attribute__((always_inline)) static inline void horizonBody(size_t n, double now_s, const double* __restrict time,
+                                                             const float* __restrict initialized, float max_horizon,
+                                                             float* __restrict horizon)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        float ahead = std::min(std::max(static_cast<float>(now_s - time[i]), 0.0f), max_horizon);
+        horizon[i] = ahead * initialized[i];
+    }
+}
+
+/**
+ * @brief 一个轴按匀速外推
+ */
+__attribute__((always_inline)) static inline void extrapolateBody(size_t n, const float* __restrict p_,
+                                                                 const float* __restrict v_,
+                                                                 const float* __restrict horizon,
+                                                                 float* __restrict out, float period, float lower)
+{
+    // 位置轴不回绕，省掉取整
+    if (period <= 0)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            out[i] = p_[i] + v_[i] * horizon[i];
+        }
+        return;
+    }
+    const float inv_period = 1.0f / period;
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = wrapPeriod(p_[i] + v_[i] * horizon[i], inv_period, period, lower);
+    }
+}
+
+static void prepareGeneric(size_t n, double* time, const double* measure_time, const float* has,
+                           float* initialized, float* first, float* dt)
+{
+    prepareBody(n, time, measure_time, has, initialized, first, dt);
+}
+
+static void axisGeneric(size_t n, const KalmanBank::AxisState& s, const float* dt, const float* has,
+                        const float* first, float q, float r, float p11_init, float period, float lower)
+{
+    axisBody(n, s.p, s.v, s.p00, s.p01, s.p11, s.z, dt, has, first, q, r, p11_init, period, lower);
+}
+
+static void horizonGeneric(size_t n, double now_s, const double* time, const float* initialized, float max_horizon,
+                           float* horizon)
+{
+    horizonBody(n, now_s, time, initialized, max_horizon, horizon);
+}
+
+static void extrapolateGeneric(size_t n, const KalmanBank::AxisState& s, const float* horizon, float period,
+                               float lower)
+{
+    extrapolateBody(n, s.p, s.v, horizon, s.predicted, period, lower);
+}
+
+#ifdef KALMAN_BANK_X86
+__attribute__((target("avx2,fma")))
+static void prepareAvx2(size_t n, double* time, const double* measure_time, const float* has,
+                        float* initialized, float* first, float* dt)
+{
+    prepareBody(n, time, measure_time, has, initialized, first, dt);
+}
+
+__attribute__((target("avx2,fma")))
+static void axisAvx2(size_t n, const KalmanBank::AxisState& s, const float* dt, const float* has,
+                     const float* first, float q, float r, float p11_init, float period, float lower)
+{
+    axisBody(n, s.p, s.v, s.p00, s.p01, s.p11, s.z, dt, has, first, q, r, p11_init, period, lower);
+}
+
+__attribute__((target("avx2,fma")))
+static void horizonAvx2(size_t n, double now_s, const double* time, const float* initialized, float max_horizon,
+                        float* horizon)
+{
+    horizonBody(n, now_s, time, initialized, max_horizon, horizon);
+}
+
+__attribute__((target("avx2,fma")))
+static void extrapolateAvx2(size_t n, const KalmanBank::AxisState& s, const float* horizon, float period,
+                               float lower)
+{
+    extrapolateBody(n, s.p, s.v, horizon, s.predicted, period, lower);
+}
+#endif
+
+// 姿态为0.1度，按3600回绕
+static float axisPeriod(int axis)
+{
+    return axis >= KalmanBank::AXIS_ROLL ? 3600.0f : 0.0f;
+}
+
+// 回绕后的取值范围与原始遥测一致：横滚、俯仰为 [-1800, 1800)，偏航为 [0, 3600)
+static float axisLower(int axis)
+{
+    if (axis == KalmanBank::AXIS_YAW)
+    {
+        return 0.0f;
+    }
+    return axis >= KalmanBank::AXIS_ROLL ? -1800.0f : 0.0f;
+}
+
+// ====================== 构造 ======================
+KalmanBank::KalmanBank(int drone_count, Isa isa) : drone_count(drone_count < 0 ? 0 : drone_count), isa(isa)
+{
+    // 指定的实现CPU不支持时降级
+    Isa best = detectIsa();
+    if (static_cast<int>(this->isa) > static_cast<int>(best))
+    {
+        this->isa = best;
+    }
+    padded = (static_cast<size_t>(this->drone_count) + LANES - 1) / LANES * LANES;
+    if (padded == 0)
+    {
+        padded = LANES;
+    }
+    // 每轴8个数组，多分配一个缓存行用于对齐
+    const size_t arrays = AXIS_COUNT * ARRAYS_PER_AXIS;
+    storage.reset(new float[arrays * padded + LANES]());
+    float* base = storage.get();
+    base += (LANES - (reinterpret_cast<uintptr_t>(base) / sizeof(float)) % LANES) % LANES;
+    for (int axis = 0; axis < AXIS_COUNT; axis++)
+    {
+        AxisState& s = state[axis];
+        float* arrays_of_axis[ARRAYS_PER_AXIS];
+        for (int k = 0; k < ARRAYS_PER_AXIS; k++)
+        {
+            arrays_of_axis[k] = base + (static_cast<size_t>(axis) * ARRAYS_PER_AXIS + k) * padded;
+        }
+        s.p = arrays_of_axis[0];
+        s.v = arrays_of_axis[1];
+        s.p00 = arrays_of_axis[2];
+        s.p01 = arrays_of_axis[3];
+        s.p11 = arrays_of_axis[4];
+        s.z = arrays_of_axis[5];
+        s.predicted = arrays_of_axis[6];
+        s.has = arrays_of_axis[7];
+        noise[axis] = defaultNoise(static_cast<Axis>(axis));
+    }
+    time.reset(new double[padded]());
+    measure_time.reset(new double[padded]());
+    has_measure.reset(new float[padded]());
+    initialized.reset(new float[padded]());
+    first.reset(new float[padded]());
+    dt.reset(new float[padded]());
+    horizon.reset(new float[padded]());
+}
+
+KalmanBank::~KalmanBank() = default;
+
+// ====================== 参数 ======================
+KalmanBank::AxisNoise KalmanBank::defaultNoise(Axis axis)
+{
+    // 谱密度平方根，即无测量1秒后速度的标准差：位置约1m/s，姿态约30°/s；定位噪声约5cm，姿态测量噪声约1°
+    if (axis <= AXIS_Z)
+    {
+        return AxisNoise{100.0f, 5.0f, 200.0f};
+    }
+    return AxisNoise{300.0f, 10.0f, 300.0f};
+}
+
+void KalmanBank::setNoise(Axis axis, const AxisNoise& value)
+{
+    noise[axis] = value;
+}
+
+// ====================== 测量与步进 ======================
+void KalmanBank::setMeasurement(int slot, const float z[AXIS_COUNT], double time_s, unsigned axes)
+{
+    if (slot < 0 || slot >= drone_count || (axes & ALL_AXES) == 0)
+    {
+        return;
+    }
+    // 首次测量初始化全部轴
+    if (initialized[slot] == 0)
+    {
+        axes = ALL_AXES;
+    }
+    for (int axis = 0; axis < AXIS_COUNT; axis++)
+    {
+        if (axes & (1u << axis))
+        {
+            state[axis].z[slot] = z[axis];
+            state[axis].has[slot] = 1.0f;
+        }
+    }
+    measure_time[slot] = time_s;
+    has_measure[slot] = 1.0f;
+}
+
+void KalmanBank::step()
+{
+    // 补齐部分的掩码恒为0，一起处理不影响结果
+    size_t n = padded;
+#ifdef KALMAN_BANK_X86
+    bool avx2 = isa == Isa::AVX2;
+#else
+    bool avx2 = false;
+#endif
+    float* has = has_measure.get();
+    if (avx2)
+    {
+#ifdef KALMAN_BANK_X86
+        prepareAvx2(n, time.get(), measure_time.get(), has, initialized.get(), first.get(), dt.get());
+#endif
+    }
+    else
+    {
+        prepareGeneric(n, time.get(), measure_time.get(), has, initialized.get(), first.get(), dt.get());
+    }
+    for (int axis = 0; axis < AXIS_COUNT; axis++)
+    {
+        const AxisNoise& axis_noise = noise[axis];
+        float q = axis_noise.accel_std * axis_noise.accel_std;
+        float r = axis_noise.measure_std * axis_noise.measure_std;
+        float p11_init = axis_noise.initial_velocity_std * axis_noise.initial_velocity_std;
+        float period = axisPeriod(axis);
+        float lower = axisLower(axis);
+        if (avx2)
+        {
+#ifdef KALMAN_BANK_X86
+            axisAvx2(n, state[axis], dt.get(), state[axis].has, first.get(), q, r, p11_init, period, lower);
+#endif
+        }
+        else
+        {
+            axisGeneric(n, state[axis], dt.get(), state[axis].has, first.get(), q, r, p11_init, period, lower);
+        }
+        memset(state[axis].has, 0, n * sizeof(float));
+    }
+    memset(has, 0, n * sizeof(float));
+}
+
+void KalmanBank::extrapolate(double now_s, float max_horizon_s)
+{
+    size_t n = padded;
+#ifdef KALMAN_BANK_X86
+    bool avx2 = isa == Isa::AVX2;
+#else
+    bool avx2 = false;
+#endif
+    float max_horizon = std::max(max_horizon_s, 0.0f);
+    if (avx2)
+    {
+#ifdef KALMAN_BANK_X86
+        horizonAvx2(n, now_s, time.get(), initialized.get(), max_horizon, horizon.get());
+        for (int axis = 0; axis < AXIS_COUNT; axis++)
+        {
+            extrapolateAvx2(n, state[axis], horizon.get(), axisPeriod(axis), axisLower(axis));
+        }
+#endif
+    }
+    else
+    {
+        horizonGeneric(n, now_s, time.get(), initialized.get(), max_horizon, horizon.get());
+        for (int axis = 0; axis < AXIS_COUNT; axis++)
+        {
+            extrapolateGeneric(n, state[axis], horizon.get(), axisPeriod(axis), axisLower(axis));
+        }
+    }
+}
+
+void KalmanBank::reset(int slot)
+{
+    if (slot < 0 || slot >= drone_count)
+    {
+        return;
+    }
+    initialized[slot] = 0.0f;
+    has_measure[slot] = 0.0f;
+    time[slot] = 0.0;
+    for (int axis = 0; axis < AXIS_COUNT; axis++)
+    {
+        AxisState& s = state[axis];
+        s.p[slot] = s.v[slot] = s.p00[slot] = s.p01[slot] = s.p11[slot] = s.predicted[slot] = s.has[slot] = 0.0f;
+    }
+}
+
+// ====================== 指令集检测 ======================
+KalmanBank::Isa KalmanBank::detectIsa()
+{
+#ifdef KALMAN_BANK_X86
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    {
+        return Isa::AVX2;
+    }
+#endif
+    return Isa::GENERIC;
+}
+
+const char* KalmanBank::isaName(Isa isa)
+{
+    switch (isa)
+    {
+        case Isa::AVX2:
+            return "avx2";
+        case Isa::GENERIC:
+            return "generic";
+    }
+    return "unknown";
+}
@@ -0,0 +1,166 @@
+#ifndef KALMAN_BANK_H
+#define KALMAN_BANK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// ====================== 集群卡尔曼滤波 ======================
+/**
+ * @brief 地面站按无人机批量运行的卡尔曼滤波器组
+ * @note 每架无人机6个轴（x y z roll pitch yaw），每轴一个独立的匀速模型滤波器，状态为[位置, 速度]，
+ *       协方差为2x2对称阵（3个数）。与机载 KalmanFilter（F=H=I、对角噪声，实际也是6个独立的标量滤波）
+ *       相比多了速度状态，并按每架无人机各自的采样间隔预测，适应不规则到达的遥测。
+ *       状态按结构体数组（SoA）存放：每轴每个量一段连续数组，step() 对整个集群逐轴做一遍预测+更新，
+ *       循环体无分支（有无新测量用掩码选择），编译器按无人机方向向量化；运行时按CPU选择AVX2或通用版本。
+ *       extrapolate() 同样一遍把所有估计外推到指定时刻，用于补偿遥测延迟、填补两次采样之间的空档。
+ *       单位与 DroneSnapshot 相同：位置为厘米，姿态为0.1度，速度为每秒。姿态按3600回绕，
+ *       估计和外推的取值范围与原始遥测一致：横滚、俯仰为 [-1800, 1800)，偏航为 [0, 3600)
+ */
+class KalmanBank {
+public:
+    // 指令集，按性能从低到高排列
+    enum class Isa {
+        // 按编译目标向量化（x86-64 为SSE2）
+        GENERIC,
+        // AVX2+FMA，一次处理8架
+        AVX2,
+    };
+
+    enum Axis {
+        AXIS_X,
+        AXIS_Y,
+        AXIS_Z,
+        AXIS_ROLL,
+        AXIS_PITCH,
+        AXIS_YAW,
+        AXIS_COUNT,
+    };
+
+    // setMeasurement() 的轴掩码
+    static const unsigned POSITION_AXES = (1u << AXIS_X) | (1u << AXIS_Y) | (1u << AXIS_Z);
+    static const unsigned ATTITUDE_AXES = (1u << AXIS_ROLL) | (1u << AXIS_PITCH) | (1u << AXIS_YAW);
+    static const unsigned ALL_AXES = POSITION_AXES | ATTITUDE_AXES;
+
+    /**
+     * @brief 一个轴的噪声参数
+     */
+    struct AxisNoise {
+        // 过程噪声：白噪声加速度谱密度的平方根（单位/秒^1.5），q = accel_std²，
+        // 无测量时速度方差每秒增加 q（1秒后速度标准差为 accel_std 单位/秒）
+        float accel_std;
+        // 测量噪声标准差
+        float measure_std;
+        // 首次测量时速度的标准差
+        float initial_velocity_std;
+    };
+
+    /**
+     * @param drone_count 无人机数（槽位数）
+     * @param isa 使用的指令集，CPU不支持时降级
+     */
+    explicit KalmanBank(int drone_count, Isa isa = detectIsa());
+    ~KalmanBank();
+
+    KalmanBank(const KalmanBank&) = delete;
+    KalmanBank& operator=(const KalmanBank&) = delete;
+
+    /**
+     * @brief 设置一个轴的噪声参数（默认值见 defaultNoise）
+     */
+    void setNoise(Axis axis, const AxisNoise& noise);
+    static AxisNoise defaultNoise(Axis axis);
+
+    /**
+     * @brief 登记某架无人机本周期的测量，下次 step() 时使用
+     * @param slot 槽位
+     * @param z 各轴测量值（只读 axes 中的轴）
+     * @param time_s 测量时间（秒，与 extrapolate() 的时间同一基准）
+     * @param axes 本次测量到的轴（按 1 << Axis 的掩码），其余轴在 step() 中只预测到 time_s、不更新
+     * @note 同一周期内多次登记时测量时间取最后一次，各轴的值按轴保留最后一次；
+     *       未初始化的无人机首次测量总是初始化全部轴，z 的各轴都应有效
+     */
+    void setMeasurement(int slot, const float z[AXIS_COUNT], double time_s, unsigned axes = ALL_AXES);
+
+    /**
+     * @brief 对整个集群做一遍预测和更新
+     * @note 有新测量的无人机全部轴预测到测量时间，测量到的轴再更新，没有测量的保持不变（状态时间仍为上次测量时间）；
+     *       测量早于滤波器时间（乱序）时不回退，只按零间隔更新。首次测量直接初始化
+     */
+    void step();
+
+    /**
+     * @brief 把整个集群的估计按匀速外推到 now_s，结果用 getPredicted() 读取
+     * @param now_s 目标时间（秒）
+     * @param max_horizon_s 最长外推时长，超过时按该时长外推（长时间没有数据的无人机不会一直沿速度飞出去）
+     * @note 只读滤波状态，不改变它；可以在两次 step() 之间按任意频率调用
+     */
+    void extrapolate(double now_s, float max_horizon_s);
+
+    /**
+     * @brief 某架无人机的状态是否已初始化
+     */
+    bool isInitialized(int slot) const { return initialized[slot] != 0; }
+
+    /**
+     * @brief 重置某架无人机，下次测量重新初始化（如无人机重启）
+     */
+    void reset(int slot);
+
+    // 估计值：位置、速度、位置方差，以及状态对应的时间
+    float getPosition(Axis axis, int slot) const { return state[axis].p[slot]; }
+    float getVelocity(Axis axis, int slot) const { return state[axis].v[slot]; }
+    float getVariance(Axis axis, int slot) const { return state[axis].p00[slot]; }
+    double getTime(int slot) const { return time[slot]; }
+    // 最近一次 extrapolate() 的结果及外推时长（秒）
+    float getPredicted(Axis axis, int slot) const { return state[axis].predicted[slot]; }
+    float getHorizon(int slot) const { return horizon[slot]; }
+
+    int size() const { return drone_count; }
+    Isa getIsa() const { return isa; }
+
+    /**
+     * @brief 检测CPU支持的最高指令集
+     */
+    static Isa detectIsa();
+    static const char* isaName(Isa isa);
+
+    /**
+     * @brief 一个轴的SoA状态，各数组长度为补齐后的槽位数
+     */
+    struct AxisState {
+        float* p;
+        float* v;
+        float* p00;
+        float* p01;
+        float* p11;
+        // 本周期的测量值
+        float* z;
+        // 外推结果
+        float* predicted;
+        // 本周期该轴是否有测量（1/0）
+        float* has;
+    };
+
+private:
+    static const int ARRAYS_PER_AXIS = 8;
+
+    int drone_count;
+    // 补齐到向量宽度整数倍的长度
+    size_t padded;
+    Isa isa;
+    AxisNoise noise[AXIS_COUNT];
+    AxisState state[AXIS_COUNT];
+    // 一次分配全部数组（按缓存行对齐）
+    std::unique_ptr<float[]> storage;
+    std::unique_ptr<double[]> time;
+    std::unique_ptr<double[]> measure_time;
+    // 每周期的逐架掩码（任一轴有测量为1）和预测间隔
+    std::unique_ptr<float[]> has_measure;
+    std::unique_ptr<float[]> initialized;
+    std::unique_ptr<float[]> first;
+    std::unique_ptr<float[]> dt;
+    std::unique_ptr<float[]> horizon;
+};
+
+#endif // KALMAN_BANK_H
@@ -0,0 +1,105 @@
+#include "KeyframeUplink.h"
+#include <chrono>
+#include "../DeltaCodec/DeltaCodec.h"
+
+// ====================== 启停 ======================
+KeyframeUplink::~KeyframeUplink()
+{
+    stop();
+}
+
+void KeyframeUplink::start(UDP& socket, const std::vector<ClientAddress>& slot_addresses)
+{
+    if (running.load())
+    {
+        return;
+    }
+    udp = &socket;
+    addresses = slot_addresses;
+    slot_count = static_cast<int>(addresses.size());
+    pending.reset(new std::atomic<bool>[slot_count > 0 ? slot_count : 1]);
+    for (int i = 0; i < slot_count; i++)
+    {
+        pending[i].store(false, std::memory_order_relaxed);
+    }
+    running.store(true);
+    thread = std::thread(&KeyframeUplink::run, this);
+}
+
+void KeyframeUplink::stop()
+{
+    if (!running.exchange(false))
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex);
+    }
+    wake.notify_one();
+    if (thread.joinable())
+    {
+        thread.join();
+    }
+}
+
+// ====================== 通知 ======================
+void KeyframeUplink::notifyKeyframeAck(int slot)
+{
+    if (slot < 0 || slot >= slot_count)
+    {
+        return;
+    }
+    pending[slot].store(true, std::memory_order_release);
+    signaled.store(true, std::memory_order_release);
+    // 与上行线程休眠前的检查配对：要么它看到新确认，要么这里看到它在休眠
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping.load(std::memory_order_relaxed))
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex);
+        wake.notify_one();
+    }
+}
+
+// ====================== 上行线程 ======================
+void KeyframeUplink::run()
+{
+    applyThreadPolicy(thread_policy, "bridge_uplink");
+    std::vector<uint8_t> ack;
+    uint8_t key_id = 0;
+    while (running.load(std::memory_order_relaxed))
+    {
+        if (!signaled.exchange(false, std::memory_order_acquire))
+        {
+            // 休眠：超时兜底，即使错过唤醒也只晚 IDLE_WAIT_MS
+            std::unique_lock<std::mutex> lock(wake_mutex);
+            sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!signaled.load(std::memory_order_relaxed) && running.load(std::memory_order_relaxed))
+            {
+                wake.wait_for(lock, std::chrono::milliseconds(IDLE_WAIT_MS));
+            }
+            sleeping.store(false, std::memory_order_relaxed);
+            continue;
+        }
+        for (int slot = 0; slot < slot_count; slot++)
+        {
+            if (!pending[slot].load(std::memory_order_relaxed) || !pending[slot].exchange(false, std::memory_order_acquire))
+            {
+                continue;
+            }
+            if (!pool.takeKeyframeAck(slot, key_id))
+            {
+                continue;
+            }
+            buildKeyframeAck(key_id, ack);
+            if (udp->sendTo(ack, addresses[slot].ip, addresses[slot].port))
+            {
+                sent.fetch_add(1, std::memory_order_relaxed);
+            }
+            else
+            {
+                send_errors.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef KEYFRAME_UPLINK_H
+#define KEYFRAME_UPLINK_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../UDP/UDP.h"
+#include "../DecodePool/DecodePool.h"
+#include "../ThreadTuning/ThreadTuning.h"
+
+// ====================== 关键帧确认上行 ======================
+/**
+ * @brief 向无人机回复紧凑遥测的关键帧确认
+ * @note 独立线程：解码线程解出关键帧后通过 notifyKeyframeAck() 唤醒它，它从快照中取出确认立即发回，
+ *       不等发布主循环。无人机收到确认后才以该关键帧为基准发增量，确认越早到，增量帧越早变小；
+ *       确认晚于下一个关键帧时，基准总是旧的，增量帧一直接近关键帧大小。
+ *       同一槽位连续多个关键帧在一次唤醒内只发最新的确认
+ */
+class KeyframeUplink : public KeyframeAckSink {
+public:
+    // 错过唤醒时的兜底等待（毫秒）
+    static const int IDLE_WAIT_MS = 10;
+
+    explicit KeyframeUplink(DecodePool& pool) : pool(pool) {}
+    ~KeyframeUplink();
+
+    KeyframeUplink(const KeyframeUplink&) = delete;
+    KeyframeUplink& operator=(const KeyframeUplink&) = delete;
+
+    /**
+     * @brief 设置上行线程的调度策略，启动前调用
+     */
+    void setThreadPolicy(const ThreadPolicy& policy) { thread_policy = policy; }
+
+    /**
+     * @brief 启动上行线程，须在解码线程池启动前调用
+     * @param udp 发送用的socket（与接收共用端口，无人机按来源端口认出地面站）
+     * @param addresses 各槽位无人机的地址（注册表顺序），决定槽位数
+     */
+    void start(UDP& udp, const std::vector<ClientAddress>& addresses);
+
+    /**
+     * @brief 停止上行线程，未发出的确认被丢弃（无人机会重发关键帧）
+     */
+    void stop();
+
+    /**
+     * @brief 登记待发的确认并唤醒上行线程（解码线程调用）
+     */
+    void notifyKeyframeAck(int slot) override;
+
+    bool isRunning() const { return running.load(std::memory_order_relaxed); }
+    // 已发出的确认数
+    uint64_t getSentCount() const { return sent.load(std::memory_order_relaxed); }
+    // 发送失败的确认数
+    uint64_t getSendErrorCount() const { return send_errors.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+
+    DecodePool& pool;
+    UDP* udp = nullptr;
+    std::vector<ClientAddress> addresses;
+    // 各槽位是否有待发的确认：解码线程置位，上行线程清除
+    std::unique_ptr<std::atomic<bool>[]> pending;
+    int slot_count = 0;
+    std::thread thread;
+    std::mutex wake_mutex;
+    std::condition_variable wake;
+    std::atomic<bool> sleeping{false};
+    std::atomic<bool> signaled{false};
+    std::atomic<bool> running{false};
+    ThreadPolicy thread_policy;
+    std::atomic<uint64_t> sent{0};
+    std::atomic<uint64_t> send_errors{0};
+};
+
+#endif // KEYFRAME_UPLINK_H
@@ -0,0 +1,134 @@
+#include "LatencyStats.h"
+#include <time.h>
+#include <cstdio>
+
+// ====================== 当前时间 ======================
+uint64_t nowRealtimeNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+// ====================== 构造函数 ======================
+LatencyHistogram::LatencyHistogram()
+{
+    for (int i = 0; i < BUCKET_COUNT; i++)
+    {
+        buckets[i].store(0, std::memory_order_relaxed);
+        cumulative_buckets[i].store(0, std::memory_order_relaxed);
+    }
+    total.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    maximum.store(0, std::memory_order_relaxed);
+    cumulative_total.store(0, std::memory_order_relaxed);
+    cumulative_sum.store(0, std::memory_order_relaxed);
+}
+
+// ====================== 分桶 ======================
+int LatencyHistogram::bucketIndex(uint64_t value)
+{
+    // 小于 2*SUB_BUCKETS 的值直接作下标；更大的值按最高位定区间，再取最高位后 SUB_BITS 位定子桶
+    if (value < 2 * SUB_BUCKETS)
+    {
+        return static_cast<int>(value);
+    }
+    int shift = 63 - __builtin_clzll(value) - SUB_BITS;
+    int index = (shift + 1) * SUB_BUCKETS + static_cast<int>((value >> shift) & (SUB_BUCKETS - 1));
+    return index < BUCKET_COUNT ? index : BUCKET_COUNT - 1;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(int index)
+{
+    if (index < 2 * SUB_BUCKETS)
+    {
+        return static_cast<uint64_t>(index) + 1;
+    }
+    int shift = index / SUB_BUCKETS - 1;
+    uint64_t sub = static_cast<uint64_t>(index % SUB_BUCKETS);
+    return (SUB_BUCKETS + sub + 1) << shift;
+}
+
+// ====================== 记录延迟 ======================
+void LatencyHistogram::record(int64_t ns)
+{
+    uint64_t value = ns > 0 ? static_cast<uint64_t>(ns) : 0;
+
+    buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+
+    // 更新最大值（只有更大时才写）
+    uint64_t current = maximum.load(std::memory_order_relaxed);
+    while (value > current &&
+           !maximum.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+// ====================== 百分位 ======================
+uint64_t LatencyHistogram::percentile(double p) const
+{
+    uint64_t n = count();
+    if (n == 0)
+    {
+        return 0;
+    }
+
+    uint64_t target = static_cast<uint64_t>(p * n);
+    if (target >= n)
+    {
+        target = n - 1;
+    }
+
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++)
+    {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen > target)
+        {
+            // 返回桶上界，但不超过实际最大值
+            uint64_t upper = bucketUpperBound(i);
+            uint64_t top = max();
+            return upper < top ? upper : top;
+        }
+    }
+    return max();
+}
+
+// ====================== 平均值 ======================
+uint64_t LatencyHistogram::mean() const
+{
+    uint64_t n = count();
+    return n == 0 ? 0 : sum.load(std::memory_order_relaxed) / n;
+}
+
+// ====================== 摘要 ======================
+std::string LatencyHistogram::summary() const
+{
+    char line[160];
+    snprintf(line, sizeof(line), "n=%llu avg=%.1fus p50=%.1fus p99=%.1fus max=%.1fus",
+             static_cast<unsigned long long>(count()),
+             mean() / 1000.0,
+             percentile(0.50) / 1000.0,
+             percentile(0.99) / 1000.0,
+             max() / 1000.0);
+    return line;
+}
+
+// ====================== 清空窗口 ======================
+void LatencyHistogram::reset()
+{
+    // 交换出窗口内的值再并入累计值，期间并发 record() 的样本留在新窗口里
+    for (int i = 0; i < BUCKET_COUNT; i++)
+    {
+        uint64_t n = buckets[i].exchange(0, std::memory_order_relaxed);
+        if (n != 0)
+        {
+            cumulative_buckets[i].fetch_add(n, std::memory_order_relaxed);
+        }
+    }
+    cumulative_total.fetch_add(total.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+    cumulative_sum.fetch_add(sum.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+    maximum.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,113 @@
+#ifndef LATENCY_STATS_H
+#define LATENCY_STATS_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// ====================== 时间工具 ======================
+/**
+ * @brief 获取当前时间（CLOCK_REALTIME，纳秒）
+ * @note 与SO_TIMESTAMPNS内核时间戳使用同一时钟，可直接相减
+ */
+uint64_t nowRealtimeNs();
+
+/**
+ * @brief 延迟直方图
+ * @note HDR式对数-线性分桶：每个2的幂区间再等分 SUB_BUCKETS 份，小于 2*SUB_BUCKETS 纳秒的值逐个成桶，
+ *       百分位的相对误差不超过 1/SUB_BUCKETS（12.5%）。record() 只做几次原子加，可在接收/发布热路径上调用。
+ *       reset() 只清空统计窗口（百分位、最大值）：窗口内的桶计数、样本数和总和并入累计值，累计值从不清零，
+ *       供 Prometheus 的 _bucket/_sum/_count 使用；并入用原子交换，与 record() 并发时不丢样本
+ */
+class LatencyHistogram {
+public:
+    // 每个2的幂区间的子桶数（2^SUB_BITS）
+    static const int SUB_BITS = 3;
+    static const int SUB_BUCKETS = 1 << SUB_BITS;
+    // 覆盖到 2^40 ns（约18分钟），足够覆盖所有合理延迟，更大的值计入最后一个桶
+    static const int MAX_BITS = 40;
+    static const int BUCKET_COUNT = (MAX_BITS - SUB_BITS + 1) * SUB_BUCKETS;
+
+    LatencyHistogram();
+
+    /**
+     * @brief 记录一次延迟
+     * @param ns 延迟（纳秒），负值（时钟回拨）按0计
+     */
+    void record(int64_t ns);
+
+    /**
+     * @brief 估算百分位延迟
+     * @param p 百分位 (0~1)
+     * @return 对应桶的上界（纳秒），无样本时返回0
+     */
+    uint64_t percentile(double p) const;
+
+    // 窗口内的样本数量
+    uint64_t count() const { return total.load(std::memory_order_relaxed); }
+    // 最大延迟（纳秒）
+    uint64_t max() const { return maximum.load(std::memory_order_relaxed); }
+    // 平均延迟（纳秒）
+    uint64_t mean() const;
+    // 窗口内的延迟总和（纳秒）
+    uint64_t sumNs() const { return sum.load(std::memory_order_relaxed); }
+
+    // 第 index 个桶窗口内的样本数和上界（纳秒，不含）
+    uint64_t bucketCount(int index) const { return buckets[index].load(std::memory_order_relaxed); }
+    static uint64_t bucketUpperBound(int index);
+    // 值所在的桶
+    static int bucketIndex(uint64_t value);
+
+    // 自创建以来的累计值（不受 reset() 影响）；与 reset() 在同一线程读取时单调不减
+    uint64_t cumulativeCount() const
+    {
+        return cumulative_total.load(std::memory_order_relaxed) + count();
+    }
+    uint64_t cumulativeSumNs() const { return cumulative_sum.load(std::memory_order_relaxed) + sumNs(); }
+    uint64_t cumulativeBucketCount(int index) const
+    {
+        return cumulative_buckets[index].load(std::memory_order_relaxed) + bucketCount(index);
+    }
+
+    /**
+     * @brief 格式化为一行摘要: "n=.. avg=..us p50=..us p99=..us max=..us"
+     */
+    std::string summary() const;
+
+    /**
+     * @brief 清空统计窗口，窗口内的样本并入累计值
+     */
+    void reset();
+
+private:
+    std::atomic<uint64_t> buckets[BUCKET_COUNT];
+    std::atomic<uint64_t> total;
+    std::atomic<uint64_t> sum;
+    std::atomic<uint64_t> maximum;
+    // 已清空窗口的累计值，只在 reset() 中写
+    std::atomic<uint64_t> cumulative_buckets[BUCKET_COUNT];
+    std::atomic<uint64_t> cumulative_total;
+    std::atomic<uint64_t> cumulative_sum;
+};
+
+/**
+ * @brief 桥接流水线各阶段延迟
+ * @note 内核→出队：网络栈 + UDP消息队列中的等待时间
+ *       出队→解析：解析本身及同批次前面数据包的排队时间
+ *       解析→发布：数据写入状态后到发布到ROS的时间
+ */
+struct PipelineLatency {
+    LatencyHistogram kernel_to_dequeue;
+    LatencyHistogram dequeue_to_parse;
+    LatencyHistogram parse_to_publish;
+
+    // 清空所有阶段
+    void reset()
+    {
+        kernel_to_dequeue.reset();
+        dequeue_to_parse.reset();
+        parse_to_publish.reset();
+    }
+};
+
+#endif // LATENCY_STATS_H
@@ -0,0 +1,268 @@
+#include "udp_ros_bridge/Logger.h"
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <time.h>
+
+// 全局日志级别，默认INFO
+std::atomic<uint8_t> Logger::min_level(static_cast<uint8_t>(LogLevel::INFO));
+
+// ====================== 线程缓冲区 ======================
+// 单生产者（所属线程）单消费者（后台线程）环形缓冲区
+struct Logger::ThreadBuffer {
+    LogRecord slots[RING_SIZE];
+    // 生产者写位置，只由所属线程修改
+    std::atomic<uint32_t> head;
+    // 填充，避免读写位置落在同一缓存行上互相失效
+    char padding[64];
+    // 消费者读位置，只由后台线程修改
+    std::atomic<uint32_t> tail;
+    // 所属线程已退出，缓冲区读空后可释放
+    std::atomic<bool> retired;
+
+    ThreadBuffer() : head(0), tail(0), retired(false) {}
+};
+
+struct Logger::Impl {
+    // 只在注册新线程和后台遍历时加锁，热路径不碰
+    std::mutex buffers_mutex;
+    std::vector<ThreadBuffer*> buffers;
+    // 保证同一时间只有一个消费者（后台线程或flush调用者）
+    std::mutex drain_mutex;
+    std::thread worker;
+    std::atomic<bool> running;
+    // 格式化输出缓存，复用避免每批重新分配
+    std::string output;
+
+    Impl() : running(true) {}
+};
+
+// 本线程的缓冲区指针（第一次写日志时注册），线程退出时把缓冲区标记为可回收
+static thread_local struct LocalBuffer {
+    void* buffer = nullptr;
+    std::atomic<bool>* retired = nullptr;
+    ~LocalBuffer()
+    {
+        if (retired != nullptr) {
+            retired->store(true, std::memory_order_release);
+        }
+    }
+} local_buffer;
+
+// ====================== 单例 ======================
+Logger& Logger::instance()
+{
+    static Logger logger;
+    return logger;
+}
+
+// ====================== 构造/析构 ======================
+Logger::Logger() : dropped(0), impl(new Impl)
+{
+    impl->worker = std::thread(&Logger::run, this);
+}
+
+Logger::~Logger()
+{
+    impl->running.store(false, std::memory_order_release);
+    if (impl->worker.joinable()) {
+        impl->worker.join();
+    }
+    drain();
+    for (ThreadBuffer* buffer : impl->buffers) {
+        delete buffer;
+    }
+    delete impl;
+}
+
+// ====================== 日志级别解析 ======================
+LogLevel Logger::parseLevel(const std::string& name)
+{
+    if (name == "debug") return LogLevel::DEBUG;
+    if (name == "info")  return LogLevel::INFO;
+    if (name == "warn")  return LogLevel::WARN;
+    if (name == "error") return LogLevel::ERROR;
+    if (name == "off")   return LogLevel::OFF;
+    return LogLevel::INFO;
+}
+
+// ====================== 时间戳 ======================
+uint64_t Logger::timestampNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+// ====================== 限频判断 ======================
+bool Logger::admit(LogSite& site, uint64_t now, uint32_t& suppressed)
+{
+    uint64_t last = site.last_ns.load(std::memory_order_relaxed);
+    if (last != 0 && now - last < site.interval_ns) {
+        site.suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    // 多个线程同时到期时只放行一个
+    if (!site.last_ns.compare_exchange_strong(last, now, std::memory_order_relaxed)) {
+        site.suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+    return true;
+}
+
+// ====================== 占用槽位 ======================
+LogRecord* Logger::acquire()
+{
+    ThreadBuffer* buffer = static_cast<ThreadBuffer*>(local_buffer.buffer);
+    if (buffer == nullptr) {
+        // 本线程第一次写日志，注册缓冲区（只发生一次）
+        buffer = new ThreadBuffer;
+        {
+            std::lock_guard<std::mutex> lock(impl->buffers_mutex);
+            impl->buffers.push_back(buffer);
+        }
+        local_buffer.buffer = buffer;
+        local_buffer.retired = &buffer->retired;
+    }
+
+    uint32_t head = buffer->head.load(std::memory_order_relaxed);
+    uint32_t tail = buffer->tail.load(std::memory_order_acquire);
+    if (head - tail >= RING_SIZE) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    return &buffer->slots[head & (RING_SIZE - 1)];
+}
+
+// ====================== 提交槽位 ======================
+void Logger::publish()
+{
+    ThreadBuffer* buffer = static_cast<ThreadBuffer*>(local_buffer.buffer);
+    uint32_t head = buffer->head.load(std::memory_order_relaxed);
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+// ====================== 格式化 ======================
+static void appendArg(std::string& out, const LogArg& arg)
+{
+    char text[32];
+    switch (arg.type) {
+        case LogArgType::INT:
+            snprintf(text, sizeof(text), "%lld", static_cast<long long>(arg.value.i));
+            out += text;
+            break;
+        case LogArgType::UINT:
+            snprintf(text, sizeof(text), "%llu", static_cast<unsigned long long>(arg.value.u));
+            out += text;
+            break;
+        case LogArgType::DOUBLE:
+            snprintf(text, sizeof(text), "%g", arg.value.d);
+            out += text;
+            break;
+        case LogArgType::BOOL:
+            out += arg.value.u ? "true" : "false";
+            break;
+        case LogArgType::STRING:
+            out += arg.value.s;
+            break;
+    }
+}
+
+std::string Logger::format(const LogRecord& record)
+{
+    static const char* level_names[] = {"DEBUG", "INFO", "WARN", "ERROR", "OFF"};
+
+    std::string out;
+    // 时间前缀 [级别] 时:分:秒.毫秒
+    time_t seconds = static_cast<time_t>(record.timestamp_ns / 1000000000ULL);
+    unsigned millis = static_cast<unsigned>((record.timestamp_ns / 1000000ULL) % 1000);
+    struct tm local;
+    localtime_r(&seconds, &local);
+    char prefix[48];
+    snprintf(prefix, sizeof(prefix), "[%s] %02d:%02d:%02d.%03u ",
+             level_names[static_cast<int>(record.site->level)],
+             local.tm_hour, local.tm_min, local.tm_sec, millis);
+    out += prefix;
+
+    // 依次替换 {} 占位符，多余的占位符原样保留
+    int next_arg = 0;
+    for (const char* p = record.site->format; *p != '\0'; p++) {
+        if (p[0] == '{' && p[1] == '}' && next_arg < record.arg_count) {
+            appendArg(out, record.args[next_arg++]);
+            p++;
+        } else {
+            out += *p;
+        }
+    }
+
+    if (record.suppressed != 0) {
+        out += " (重复 ";
+        out += std::to_string(record.suppressed);
+        out += " 次已省略)";
+    }
+    return out;
+}
+
+// ====================== 输出缓冲区内容 ======================
+size_t Logger::drain()
+{
+    std::lock_guard<std::mutex> drain_lock(impl->drain_mutex);
+
+    std::vector<ThreadBuffer*> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(impl->buffers_mutex);
+        snapshot = impl->buffers;
+    }
+
+    size_t written = 0;
+    std::string& output = impl->output;
+    output.clear();
+    for (ThreadBuffer* buffer : snapshot) {
+        uint32_t tail = buffer->tail.load(std::memory_order_relaxed);
+        uint32_t head = buffer->head.load(std::memory_order_acquire);
+        for (; tail != head; tail++) {
+            output += format(buffer->slots[tail & (RING_SIZE - 1)]);
+            output += '\n';
+            written++;
+        }
+        buffer->tail.store(tail, std::memory_order_release);
+    }
+    if (!output.empty()) {
+        fwrite(output.data(), 1, output.size(), stdout);
+        fflush(stdout);
+    }
+
+    // 回收已退出线程的空缓冲区
+    std::lock_guard<std::mutex> lock(impl->buffers_mutex);
+    for (size_t i = 0; i < impl->buffers.size();) {
+        ThreadBuffer* buffer = impl->buffers[i];
+        if (buffer->retired.load(std::memory_order_acquire) &&
+            buffer->tail.load(std::memory_order_relaxed) == buffer->head.load(std::memory_order_acquire)) {
+            delete buffer;
+            impl->buffers[i] = impl->buffers.back();
+            impl->buffers.pop_back();
+        } else {
+            i++;
+        }
+    }
+    return written;
+}
+
+// ====================== 后台线程 ======================
+void Logger::run()
+{
+    while (impl->running.load(std::memory_order_acquire)) {
+        if (drain() == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    }
+}
+
+// ====================== 刷新 ======================
+void Logger::flush()
+{
+    drain();
+}
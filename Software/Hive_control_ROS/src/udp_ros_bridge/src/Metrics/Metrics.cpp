@@ -0,0 +1,306 @@
+#include "Metrics.h"
+#include <cmath>
+#include <cstdio>
+#include <unistd.h>
+
+const double MetricsRegistry::QUANTILES[4] = {0.50, 0.90, 0.99, 1.0};
+
+namespace
+{
+// 标签值转义：反斜杠、双引号和换行
+std::string escapeLabel(const std::string& value)
+{
+    std::string out;
+    out.reserve(value.size());
+    for (char c : value)
+    {
+        if (c == '\\' || c == '"')
+        {
+            out.push_back('\\');
+            out.push_back(c);
+        }
+        else if (c == '\n')
+        {
+            out += "\\n";
+        }
+        else
+        {
+            out.push_back(c);
+        }
+    }
+    return out;
+}
+
+// 在标签后追加一个标签，如 {a="1"} + quantile -> {a="1",quantile="0.5"}
+std::string withLabel(const std::string& labels, const char* key, const char* value)
+{
+    std::string extra = std::string(key) + "=\"" + value + "\"";
+    if (labels.empty())
+    {
+        return "{" + extra + "}";
+    }
+    return labels.substr(0, labels.size() - 1) + "," + extra + "}";
+}
+
+void appendLine(std::string& out, const std::string& name, const std::string& labels, double value)
+{
+    char number[32];
+    if (std::isinf(value))
+    {
+        snprintf(number, sizeof(number), "%s", value > 0 ? "+Inf" : "-Inf");
+    }
+    else
+    {
+        snprintf(number, sizeof(number), "%.17g", value);
+    }
+    out += name;
+    out += labels;
+    out.push_back(' ');
+    out += number;
+    out.push_back('\n');
+}
+
+std::string formatNumber(double value)
+{
+    char text[32];
+    snprintf(text, sizeof(text), "%.6g", value);
+    return text;
+}
+
+const char* typeName(MetricType type)
+{
+    switch (type)
+    {
+        case MetricType::COUNTER: return "counter";
+        case MetricType::GAUGE: return "gauge";
+        case MetricType::LATENCY: return "histogram";
+    }
+    return "untyped";
+}
+}
+
+// ====================== 指标 ======================
+Metric& Metric::label(const std::string& key, const std::string& value)
+{
+    labels = withLabel(labels, key.c_str(), escapeLabel(value).c_str());
+    return *this;
+}
+
+Metric& Metric::group(const std::string& name)
+{
+    group_name = name;
+    return *this;
+}
+
+Metric& Metric::warnAbove(double threshold)
+{
+    warn_above = threshold;
+    has_warn = true;
+    return *this;
+}
+
+bool Metric::isWarning() const
+{
+    if (!has_warn)
+    {
+        return false;
+    }
+    switch (type)
+    {
+        case MetricType::COUNTER: return rate > warn_above;
+        case MetricType::GAUGE: return value > warn_above;
+        case MetricType::LATENCY: return quantiles[2] > warn_above;
+    }
+    return false;
+}
+
+// ====================== 注册 ======================
+Metric& MetricsRegistry::add(MetricType type, const std::string& name, const std::string& help)
+{
+    std::string full = prefix.empty() ? name : prefix + "_" + name;
+    auto it = family_index.find(full);
+    if (it == family_index.end())
+    {
+        it = family_index.emplace(full, families.size()).first;
+        families.push_back(Family{full, help, type, {}});
+    }
+    metrics.emplace_back(new Metric());
+    Metric& metric = *metrics.back();
+    metric.type = type;
+    metric.name = full;
+    families[it->second].members.push_back(&metric);
+    return metric;
+}
+
+Metric& MetricsRegistry::counter(const std::string& name, const std::string& help)
+{
+    Metric& metric = add(MetricType::COUNTER, name, help);
+    metric.owned.reset(new MetricCounter());
+    MetricCounter* owned = metric.owned.get();
+    metric.read = [owned]() { return static_cast<double>(owned->get()); };
+    return metric;
+}
+
+Metric& MetricsRegistry::counter(const std::string& name, const std::string& help, std::function<double()> read)
+{
+    Metric& metric = add(MetricType::COUNTER, name, help);
+    metric.read = std::move(read);
+    return metric;
+}
+
+Metric& MetricsRegistry::gauge(const std::string& name, const std::string& help, std::function<double()> read)
+{
+    Metric& metric = add(MetricType::GAUGE, name, help);
+    metric.read = std::move(read);
+    return metric;
+}
+
+Metric& MetricsRegistry::latency(const std::string& name, const std::string& help, const LatencyHistogram& histogram)
+{
+    Metric& metric = add(MetricType::LATENCY, name, help);
+    metric.histogram = &histogram;
+    return metric;
+}
+
+// ====================== 采样 ======================
+void MetricsRegistry::sample(uint64_t now_ns)
+{
+    double elapsed = last_sample_ns != 0 && now_ns > last_sample_ns ? (now_ns - last_sample_ns) / 1e9 : 0;
+    last_sample_ns = now_ns;
+    for (const auto& entry : metrics)
+    {
+        Metric& metric = *entry;
+        if (metric.type == MetricType::LATENCY)
+        {
+            const LatencyHistogram& histogram = *metric.histogram;
+            metric.value = static_cast<double>(histogram.count());
+            for (int i = 0; i < 3; i++)
+            {
+                metric.quantiles[i] = histogram.percentile(QUANTILES[i]) / 1e9;
+            }
+            metric.quantiles[3] = histogram.max() / 1e9;
+            // 累计分桶：LatencyHistogram 的桶上界不含，2的幂边界正好落在桶边界上
+            metric.latency_buckets.assign(HISTOGRAM_BOUNDS, 0);
+            uint64_t below = 0;
+            int bound = 0;
+            for (int i = 0; i < LatencyHistogram::BUCKET_COUNT; i++)
+            {
+                while (bound < HISTOGRAM_BOUNDS &&
+                       LatencyHistogram::bucketUpperBound(i) > (1ULL << (HISTOGRAM_FIRST_BIT + bound)))
+                {
+                    metric.latency_buckets[bound++] = static_cast<double>(below);
+                }
+                below += histogram.cumulativeBucketCount(i);
+            }
+            while (bound < HISTOGRAM_BOUNDS)
+            {
+                metric.latency_buckets[bound++] = static_cast<double>(below);
+            }
+            // _count 取分桶合计，与 +Inf 桶一致
+            metric.latency_count = static_cast<double>(below);
+            metric.latency_sum = histogram.cumulativeSumNs() / 1e9;
+            continue;
+        }
+        metric.value = metric.read();
+        if (metric.type == MetricType::COUNTER)
+        {
+            // 计数被清零（如模块重建）时按从0开始计
+            double delta = metric.value >= metric.previous ? metric.value - metric.previous : metric.value;
+            metric.rate = metric.sampled && elapsed > 0 ? delta / elapsed : 0;
+            metric.previous = metric.value;
+        }
+        metric.sampled = true;
+    }
+}
+
+// ====================== 导出 ======================
+std::string MetricsRegistry::renderPrometheus() const
+{
+    std::string out;
+    out.reserve(metrics.size() * 64);
+    for (const Family& family : families)
+    {
+        out += "# HELP " + family.name + " " + family.help + "\n";
+        out += "# TYPE " + family.name + " " + typeName(family.type) + "\n";
+        for (const Metric* metric : family.members)
+        {
+            if (metric->type != MetricType::LATENCY)
+            {
+                appendLine(out, metric->name, metric->labels, metric->value);
+                continue;
+            }
+            // 只导出累计值：窗口内的分位数会随统计窗口清空而回落，不能当 Prometheus 的计数用
+            for (int i = 0; i < HISTOGRAM_BOUNDS && i < static_cast<int>(metric->latency_buckets.size()); i++)
+            {
+                char bound[32];
+                snprintf(bound, sizeof(bound), "%.10g", static_cast<double>(1ULL << (HISTOGRAM_FIRST_BIT + i)) / 1e9);
+                appendLine(out, metric->name + "_bucket", withLabel(metric->labels, "le", bound),
+                           metric->latency_buckets[i]);
+            }
+            appendLine(out, metric->name + "_bucket", withLabel(metric->labels, "le", "+Inf"), metric->latency_count);
+            appendLine(out, metric->name + "_sum", metric->labels, metric->latency_sum);
+            appendLine(out, metric->name + "_count", metric->labels, metric->latency_count);
+        }
+    }
+    return out;
+}
+
+bool MetricsRegistry::writePrometheus(const std::string& path) const
+{
+    std::string text = renderPrometheus();
+    std::string temp = path + ".tmp";
+    FILE* file = fopen(temp.c_str(), "w");
+    if (file == nullptr)
+    {
+        return false;
+    }
+    bool ok = fwrite(text.data(), 1, text.size(), file) == text.size();
+    ok = fclose(file) == 0 && ok;
+    if (!ok || rename(temp.c_str(), path.c_str()) != 0)
+    {
+        unlink(temp.c_str());
+        return false;
+    }
+    return true;
+}
+
+std::vector<MetricGroup> MetricsRegistry::groups() const
+{
+    std::vector<MetricGroup> result;
+    std::unordered_map<std::string, size_t> index;
+    for (const auto& entry : metrics)
+    {
+        const Metric& metric = *entry;
+        if (metric.group_name.empty())
+        {
+            continue;
+        }
+        auto it = index.find(metric.group_name);
+        if (it == index.end())
+        {
+            it = index.emplace(metric.group_name, result.size()).first;
+            result.push_back(MetricGroup{metric.group_name, false, {}});
+        }
+        MetricGroup& group = result[it->second];
+        group.warning = group.warning || metric.isWarning();
+        // 键去掉公共前缀
+        std::string key = metric.name.substr(prefix.empty() ? 0 : prefix.size() + 1) + metric.labels;
+        std::string text;
+        switch (metric.type)
+        {
+            case MetricType::COUNTER:
+                text = formatNumber(metric.value) + "（" + formatNumber(metric.rate) + "/s）";
+                break;
+            case MetricType::GAUGE:
+                text = formatNumber(metric.value);
+                break;
+            case MetricType::LATENCY:
+                text = "n=" + formatNumber(metric.value) + " p50=" + formatNumber(metric.quantiles[0] * 1e6) +
+                       "us p99=" + formatNumber(metric.quantiles[2] * 1e6) + "us max=" +
+                       formatNumber(metric.quantiles[3] * 1e6) + "us";
+                break;
+        }
+        group.values.emplace_back(key, text);
+    }
+    return result;
+}
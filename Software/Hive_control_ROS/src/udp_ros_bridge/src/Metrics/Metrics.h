@@ -0,0 +1,203 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "../LatencyStats/LatencyStats.h"
+
+// ====================== 指标 ======================
+
+enum class MetricType {
+    // 单调递增的计数，导出时附带两次采样之间的速率
+    COUNTER,
+    // 瞬时值
+    GAUGE,
+    // 延迟直方图：Prometheus 导出自启动以来的累计分桶（histogram 类型的 _bucket/_sum/_count），
+    // 诊断只显示统计窗口内的 p50/p99/max（窗口随 LatencyHistogram::reset() 清空）
+    LATENCY,
+};
+
+/**
+ * @brief 热路径计数器
+ * @note 独占一个缓存行，add() 只做一次 relaxed 原子加；只有一个线程写时可用 addSingleWriter() 省掉读改写
+ */
+class alignas(64) MetricCounter {
+public:
+    void add(uint64_t n = 1) { value.fetch_add(n, std::memory_order_relaxed); }
+    void addSingleWriter(uint64_t n = 1)
+    {
+        value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+    uint64_t get() const { return value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> value{0};
+};
+
+/**
+ * @brief 已注册的一个指标（一个指标名加一组标签）
+ * @note 注册时可链式设置标签、诊断分组和告警阈值
+ */
+class Metric {
+public:
+    /**
+     * @brief 追加一个标签
+     */
+    Metric& label(const std::string& key, const std::string& value);
+
+    /**
+     * @brief 诊断分组：同组指标汇成一条 DiagnosticStatus，不设置时不进诊断
+     */
+    Metric& group(const std::string& name);
+
+    /**
+     * @brief 告警阈值：计数的速率、瞬时值或延迟p99（秒）超过阈值时所在分组为 WARN
+     */
+    Metric& warnAbove(double threshold);
+
+    // 自有计数器（用 MetricsRegistry::counter() 注册时有效）
+    MetricCounter& counter() { return *owned; }
+
+    MetricType getType() const { return type; }
+    const std::string& getName() const { return name; }
+    // Prometheus 格式的标签，如 {format="json"}，没有标签时为空
+    const std::string& getLabels() const { return labels; }
+    const std::string& getGroup() const { return group_name; }
+    // 最近一次 MetricsRegistry::sample() 的值：计数为累计值，瞬时值为当前值，延迟为窗口内的样本数
+    double getValue() const { return value; }
+    // 计数两次采样之间的每秒增量
+    double getRate() const { return rate; }
+    // 延迟在统计窗口内的 p50/p90/p99/max（秒）
+    const double* getQuantiles() const { return quantiles; }
+    // 延迟自启动以来的累计样本数和总和（秒），不随统计窗口清空
+    double getLatencyCount() const { return latency_count; }
+    double getLatencySum() const { return latency_sum; }
+    bool isWarning() const;
+
+private:
+    friend class MetricsRegistry;
+
+    MetricType type = MetricType::COUNTER;
+    std::string name;
+    std::string labels;
+    std::string group_name;
+    double warn_above = 0;
+    bool has_warn = false;
+    // 数据来源：自有计数器、读取函数或延迟直方图
+    std::unique_ptr<MetricCounter> owned;
+    std::function<double()> read;
+    const LatencyHistogram* histogram = nullptr;
+    // 采样结果
+    double value = 0;
+    double rate = 0;
+    double previous = 0;
+    bool sampled = false;
+    double quantiles[4] = {0, 0, 0, 0};
+    double latency_count = 0;
+    double latency_sum = 0;
+    // 累计分桶：小于 2^(HISTOGRAM_FIRST_BIT+i) 纳秒的样本数
+    std::vector<double> latency_buckets;
+};
+
+/**
+ * @brief 诊断分组：一组指标的汇总
+ */
+struct MetricGroup {
+    std::string name;
+    bool warning = false;
+    // 键值对，键为指标名加标签
+    std::vector<std::pair<std::string, std::string>> values;
+};
+
+/**
+ * @brief 指标注册表
+ * @note 启动时在主线程注册，之后注册表结构不再变化；热路径只碰 MetricCounter 或各模块已有的原子计数，
+ *       导出（采样、生成文本）在发布主循环中进行，开销与热路径无关。
+ *       各模块已有的计数不在热路径上再加一份，而是注册读取函数，采样时读出
+ */
+class MetricsRegistry {
+public:
+    // 延迟在诊断中显示的分位点
+    static const double QUANTILES[4];
+    // 延迟导出到 Prometheus 的分桶上界：2^10 ~ 2^30 纳秒（约1微秒到1.07秒）逐个2的幂，
+    // 与 LatencyHistogram 的桶边界重合，累计数是精确的
+    static const int HISTOGRAM_FIRST_BIT = 10;
+    static const int HISTOGRAM_BOUNDS = 21;
+
+    /**
+     * @param prefix 指标名前缀，如 "udp_ros_bridge"
+     */
+    explicit MetricsRegistry(const std::string& prefix) : prefix(prefix) {}
+
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    /**
+     * @brief 注册自有计数器，热路径通过 Metric::counter() 计数
+     */
+    Metric& counter(const std::string& name, const std::string& help);
+
+    /**
+     * @brief 注册由读取函数给出累计值的计数
+     */
+    Metric& counter(const std::string& name, const std::string& help, std::function<double()> read);
+
+    /**
+     * @brief 注册由读取函数给出的瞬时值
+     */
+    Metric& gauge(const std::string& name, const std::string& help, std::function<double()> read);
+
+    /**
+     * @brief 注册延迟直方图（直方图须比注册表活得久）
+     */
+    Metric& latency(const std::string& name, const std::string& help, const LatencyHistogram& histogram);
+
+    /**
+     * @brief 采样所有指标，计数的速率按与上次采样的间隔计算
+     * @param now_ns 当前时间（纳秒，任意单调时钟）
+     */
+    void sample(uint64_t now_ns);
+
+    /**
+     * @brief 按 Prometheus 文本格式输出最近一次采样
+     */
+    std::string renderPrometheus() const;
+
+    /**
+     * @brief 把 Prometheus 文本写到文件（先写临时文件再改名，读者不会读到半个文件）
+     * @return 写入失败返回false
+     */
+    bool writePrometheus(const std::string& path) const;
+
+    /**
+     * @brief 按诊断分组汇总最近一次采样，分组按首次注册的顺序
+     */
+    std::vector<MetricGroup> groups() const;
+
+    size_t size() const { return metrics.size(); }
+
+private:
+    struct Family {
+        std::string name;
+        std::string help;
+        MetricType type;
+        std::vector<Metric*> members;
+    };
+
+    Metric& add(MetricType type, const std::string& name, const std::string& help);
+
+    std::string prefix;
+    // Metric 地址在注册后不变，热路径可以直接持有引用
+    std::vector<std::unique_ptr<Metric>> metrics;
+    std::vector<Family> families;
+    std::unordered_map<std::string, size_t> family_index;
+    uint64_t last_sample_ns = 0;
+};
+
+#endif // METRICS_H
@@ -0,0 +1,104 @@
+#include "PacketPool.h"
+#include <new>
+
+// 缓存行大小，块按此对齐，相邻块的引用计数不共享缓存行
+static const size_t CACHE_LINE = 64;
+
+// ====================== 句柄 ======================
+void PacketRef::reset()
+{
+    if (buffer == nullptr)
+    {
+        return;
+    }
+    // 最后一个句柄负责归还，acq_rel 保证其他线程对数据的读写都在归还之前完成
+    if (buffer->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        if (buffer->pool != nullptr)
+        {
+            buffer->pool->release(buffer);
+        }
+        else
+        {
+            buffer->~PacketBuffer();
+            ::operator delete(buffer);
+        }
+    }
+    buffer = nullptr;
+}
+
+// ====================== 缓冲区池 ======================
+PacketPool::PacketPool(size_t initial_slabs, size_t slab_size, size_t grow_slabs)
+    : slab_size(slab_size), grow_slabs(grow_slabs > 0 ? grow_slabs : 1)
+{
+    stride = (sizeof(PacketBuffer) + slab_size + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+    if (initial_slabs > 0)
+    {
+        grow(initial_slabs);
+    }
+    // 预分配不算扩容
+    grow_count.store(0, std::memory_order_relaxed);
+}
+
+PacketPool::~PacketPool()
+{
+    // 块内存由 chunks 释放，PacketBuffer 只含平凡成员，不需要逐个析构
+}
+
+void PacketPool::grow(size_t count)
+{
+    // 多申请一个缓存行用于对齐
+    std::unique_ptr<uint8_t[]> chunk(new uint8_t[count * stride + CACHE_LINE]);
+    uintptr_t base = (reinterpret_cast<uintptr_t>(chunk.get()) + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+    for (size_t i = 0; i < count; i++)
+    {
+        PacketBuffer* buffer = new (reinterpret_cast<void*>(base + i * stride)) PacketBuffer;
+        buffer->pool = this;
+        buffer->capacity = static_cast<uint32_t>(slab_size);
+        buffer->next = local_free;
+        local_free = buffer;
+    }
+    chunks.push_back(std::move(chunk));
+    slab_count.fetch_add(count, std::memory_order_relaxed);
+    grow_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+PacketRef PacketPool::acquire(size_t size)
+{
+    if (size > slab_size)
+    {
+        // 超长数据报（如IP分片重组后的大包）单独分配，释放时直接交还系统
+        oversize_count.fetch_add(1, std::memory_order_relaxed);
+        PacketBuffer* buffer = new (::operator new(sizeof(PacketBuffer) + size)) PacketBuffer;
+        buffer->capacity = static_cast<uint32_t>(size);
+        buffer->refs.store(1, std::memory_order_relaxed);
+        return PacketRef(buffer);
+    }
+
+    if (local_free == nullptr)
+    {
+        // 一次取走其他线程归还的全部缓冲区
+        local_free = remote_free.exchange(nullptr, std::memory_order_acquire);
+        if (local_free == nullptr)
+        {
+            grow(grow_slabs);
+        }
+    }
+    PacketBuffer* buffer = local_free;
+    local_free = buffer->next;
+    buffer->next = nullptr;
+    buffer->refs.store(1, std::memory_order_relaxed);
+    in_use.fetch_add(1, std::memory_order_relaxed);
+    return PacketRef(buffer);
+}
+
+void PacketPool::release(PacketBuffer* buffer)
+{
+    in_use.fetch_sub(1, std::memory_order_relaxed);
+    PacketBuffer* head = remote_free.load(std::memory_order_relaxed);
+    do
+    {
+        buffer->next = head;
+    } while (!remote_free.compare_exchange_weak(head, buffer, std::memory_order_release,
+                                                std::memory_order_relaxed));
+}
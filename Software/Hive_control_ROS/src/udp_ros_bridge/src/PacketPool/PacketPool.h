@@ -0,0 +1,207 @@
+#ifndef PACKET_POOL_H
+#define PACKET_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+class PacketPool;
+
+// ====================== 数据包缓冲区 ======================
+/**
+ * @brief 池中的一块数据包缓冲区，头部之后紧跟数据区
+ * @note 引用计数放在缓冲区头部（侵入式），句柄只有一个指针大小，
+ *       接收、解析、录制、重发各阶段持有同一块缓冲区，不拷贝数据
+ */
+struct PacketBuffer {
+    // 持有该缓冲区的句柄数
+    std::atomic<uint32_t> refs{0};
+    // 所属的池，nullptr表示超出块大小而单独分配
+    PacketPool* pool = nullptr;
+    // 空闲链表指针
+    PacketBuffer* next = nullptr;
+    // 数据区容量（字节）
+    uint32_t capacity = 0;
+
+    uint8_t* data() { return reinterpret_cast<uint8_t*>(this + 1); }
+};
+
+/**
+ * @brief 数据包缓冲区句柄（侵入式引用计数）
+ * @note 拷贝增加引用，析构减少引用，最后一个句柄释放时缓冲区无锁地归还到池中；
+ *       可以在任意线程拷贝和释放
+ */
+class PacketRef {
+public:
+    PacketRef() = default;
+    // 接管一块引用计数已为1的缓冲区（由 PacketPool::acquire 调用）
+    explicit PacketRef(PacketBuffer* buffer) : buffer(buffer) {}
+    PacketRef(const PacketRef& other) : buffer(other.buffer)
+    {
+        if (buffer != nullptr)
+        {
+            buffer->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    PacketRef(PacketRef&& other) noexcept : buffer(other.buffer) { other.buffer = nullptr; }
+    PacketRef& operator=(PacketRef other) noexcept
+    {
+        std::swap(buffer, other.buffer);
+        return *this;
+    }
+    ~PacketRef() { reset(); }
+
+    // 放弃持有，最后一个句柄把缓冲区还给池
+    void reset();
+
+    uint8_t* data() const { return buffer != nullptr ? buffer->data() : nullptr; }
+    size_t capacity() const { return buffer != nullptr ? buffer->capacity : 0; }
+    // 当前引用数（仅用于测试和统计）
+    uint32_t useCount() const { return buffer != nullptr ? buffer->refs.load(std::memory_order_relaxed) : 0; }
+    explicit operator bool() const { return buffer != nullptr; }
+
+private:
+    PacketBuffer* buffer = nullptr;
+};
+
+// ====================== 缓冲区池 ======================
+/**
+ * @brief 固定大小（按MTU）的数据包缓冲区池
+ * @note 取用只在一个线程（接收线程）中进行，空闲链表归该线程私有，不加锁；
+ *       其他线程释放的缓冲区压入无锁归还栈，取用线程本地链表空了时一次取走整个归还栈。
+ *       池不够用时按块扩容，扩容和超长数据报会分配内存并计数，稳定运行后两者都应为0增长。
+ *       所有句柄必须在池析构前释放
+ */
+class PacketPool {
+public:
+    // 块大小：以太网MTU 1500 字节取整
+    static const size_t SLAB_SIZE = 1536;
+    // 每次扩容的块数
+    static const size_t GROW_SLABS = 256;
+
+    /**
+     * @brief 构造函数
+     * @param initial_slabs 预分配的块数
+     * @param slab_size 每块数据区大小（字节）
+     * @param grow_slabs 池不够用时每次扩容的块数（大块时应取小值）
+     */
+    explicit PacketPool(size_t initial_slabs = 1024, size_t slab_size = SLAB_SIZE, size_t grow_slabs = GROW_SLABS);
+    ~PacketPool();
+
+    PacketPool(const PacketPool&) = delete;
+    PacketPool& operator=(const PacketPool&) = delete;
+
+    /**
+     * @brief 取一块至少 size 字节的缓冲区
+     * @note 只能由一个线程调用；size 超过块大小时单独分配（计入超长计数）
+     */
+    PacketRef acquire(size_t size);
+
+    // 每块数据区大小
+    size_t getSlabSize() const { return slab_size; }
+    // 池中的块总数
+    size_t getSlabCount() const { return slab_count.load(std::memory_order_relaxed); }
+    // 正被句柄持有的块数
+    size_t getInUseCount() const { return in_use.load(std::memory_order_relaxed); }
+    // 扩容次数
+    uint64_t getGrowCount() const { return grow_count.load(std::memory_order_relaxed); }
+    // 超长数据报单独分配的次数
+    uint64_t getOversizeCount() const { return oversize_count.load(std::memory_order_relaxed); }
+
+private:
+    friend class PacketRef;
+
+    // 任意线程归还一块缓冲区（无锁）
+    void release(PacketBuffer* buffer);
+    // 新增 count 块，挂到取用线程的空闲链表上
+    void grow(size_t count);
+
+    size_t slab_size;
+    size_t grow_slabs;
+    // 相邻两块的间距（头部 + 数据区，按缓存行对齐）
+    size_t stride;
+    // 取用线程私有的空闲链表
+    PacketBuffer* local_free = nullptr;
+    // 其他线程归还的缓冲区（无锁栈，只压入和整体取走，没有ABA问题）
+    std::atomic<PacketBuffer*> remote_free{nullptr};
+    // 已分配的内存块，池析构时释放
+    std::vector<std::unique_ptr<uint8_t[]>> chunks;
+    std::atomic<size_t> slab_count{0};
+    std::atomic<size_t> in_use{0};
+    std::atomic<uint64_t> grow_count{0};
+    std::atomic<uint64_t> oversize_count{0};
+};
+
+// ====================== 单生产者单消费者环形队列 ======================
+/**
+ * @brief 定长无锁环形队列，一个线程写入、一个线程读出
+ * @note 槽位在构造时一次分配，收发过程中不分配内存；容量取2的幂
+ */
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity)
+    {
+        size_t size = 1;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+        slots.reset(new T[size]);
+        mask = size - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // 生产者写入，队列满时返回false且不移动 item
+    bool push(T&& item)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) > mask)
+        {
+            return false;
+        }
+        slots[h & mask] = std::move(item);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 消费者读出，队列空时返回false
+    bool pop(T& item)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        // 移走后槽位里不再持有资源（如缓冲区引用）
+        item = std::move(slots[t & mask]);
+        slots[t & mask] = T();
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 先读消费者位置：任意线程调用时都不会因读到旧的写位置而下溢
+    size_t size() const
+    {
+        size_t t = tail.load(std::memory_order_acquire);
+        return head.load(std::memory_order_acquire) - t;
+    }
+    size_t capacity() const { return mask + 1; }
+
+private:
+    std::unique_ptr<T[]> slots;
+    size_t mask = 0;
+    // 生产者写位置
+    std::atomic<size_t> head{0};
+    // 填充，避免读写位置落在同一缓存行上互相失效
+    char padding[64];
+    // 消费者读位置
+    std::atomic<size_t> tail{0};
+};
+
+#endif // PACKET_POOL_H
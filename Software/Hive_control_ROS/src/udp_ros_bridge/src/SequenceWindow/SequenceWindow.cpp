@@ -0,0 +1,102 @@
+#include "SequenceWindow.h"
+
+// ====================== 窗口判定 ======================
+void SequenceWindow::restart(uint16_t seq, uint32_t fields)
+{
+    started = true;
+    highest = seq;
+    bitmap = 1;
+    rejects = 0;
+    applied_mask = 0;
+    markApplied(seq, fields);
+}
+
+void SequenceWindow::markApplied(uint16_t seq, uint32_t fields)
+{
+    applied_mask |= fields;
+    while (fields != 0)
+    {
+        last_applied[__builtin_ctz(fields)] = seq;
+        fields &= fields - 1;
+    }
+}
+
+bool SequenceWindow::hasNewer(uint16_t seq, uint32_t fields) const
+{
+    fields &= applied_mask;
+    while (fields != 0)
+    {
+        if (static_cast<int16_t>(static_cast<uint16_t>(seq - last_applied[__builtin_ctz(fields)])) <= 0)
+        {
+            return true;
+        }
+        fields &= fields - 1;
+    }
+    return false;
+}
+
+SequenceWindow::Verdict SequenceWindow::accept(uint16_t seq, uint32_t fields)
+{
+    bump(received);
+    if (!started)
+    {
+        restart(seq, fields);
+        return Verdict::ACCEPT;
+    }
+
+    // 16位序号回绕：按有符号差值判断先后
+    int16_t ahead = static_cast<int16_t>(static_cast<uint16_t>(seq - highest));
+    if (ahead > 0)
+    {
+        // 新帧：中间跳过的序号先记为丢失
+        bitmap = ahead < WINDOW_SIZE ? (bitmap << ahead) | 1 : 1;
+        highest = seq;
+        if (ahead > 1)
+        {
+            bump(lost, static_cast<uint64_t>(ahead - 1));
+        }
+        rejects = 0;
+        markApplied(seq, fields);
+        return Verdict::ACCEPT;
+    }
+
+    int behind = -ahead;
+    Verdict verdict;
+    if (behind >= WINDOW_SIZE)
+    {
+        verdict = Verdict::STALE;
+    }
+    else if (bitmap & (1ull << behind))
+    {
+        verdict = Verdict::DUPLICATE;
+    }
+    else
+    {
+        // 迟到帧补上了空缺
+        bitmap |= 1ull << behind;
+        bump(reordered);
+        if (lost.load(std::memory_order_relaxed) != 0)
+        {
+            bump(lost, static_cast<uint64_t>(-1));
+        }
+        rejects = 0;
+        // 写入的任一字段组已有更新的数据时不再覆盖（一帧的字段整体写入，不能只写一部分）
+        if (hasNewer(seq, fields))
+        {
+            bump(stale);
+            return Verdict::STALE;
+        }
+        markApplied(seq, fields);
+        return Verdict::REORDERED;
+    }
+
+    bump(verdict == Verdict::DUPLICATE ? duplicates : stale);
+    if (++rejects >= RESYNC_THRESHOLD)
+    {
+        // 连续被拒：无人机重启后序号从头开始，以当前帧重建窗口
+        bump(resyncs);
+        restart(seq, fields);
+        return Verdict::ACCEPT;
+    }
+    return verdict;
+}
@@ -0,0 +1,101 @@
+#ifndef SEQUENCE_WINDOW_H
+#define SEQUENCE_WINDOW_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief 单架无人机的帧序号滑动窗口
+ * @note 序号为16位，每发一帧加1（各数据类型共用）。窗口记录最新序号之前64帧的到达情况：
+ *       - 重复帧（窗口内已收到）丢弃；
+ *       - 比窗口更旧的帧按过期丢弃；
+ *       - 窗口内迟到的帧只有比它写入的每个字段组最后一次写入的帧都新时才写入：
+ *         字段组由调用方按帧写入的字段给出（见 frameFieldGroups），关键帧、增量帧和旧格式姿态帧
+ *         写同一组姿态，迟到的旧关键帧不会覆盖增量帧写入的新姿态；不相干字段的迟到帧（如PID）照常写入。
+ *       丢包数在序号跳跃时累加，迟到帧补上空缺时再减回。
+ *       连续 RESYNC_THRESHOLD 帧被判为重复/过期时认为无人机重启、序号从头开始，重建窗口。
+ *       accept() 只由解析线程调用；计数器为原子量，统计线程可随时读取。
+ */
+class SequenceWindow {
+public:
+    // 窗口长度（帧）
+    static const int WINDOW_SIZE = 64;
+    // 字段组数（位掩码的位数）
+    static const int FIELD_GROUP_COUNT = 32;
+    // 连续多少帧被拒绝后重建窗口
+    static const int RESYNC_THRESHOLD = 16;
+
+    /**
+     * @brief 判定结果
+     */
+    enum class Verdict : uint8_t {
+        // 按序到达（或跳过了若干帧），写入
+        ACCEPT,
+        // 迟到但它写入的各字段组中没有更新的数据，写入
+        REORDERED,
+        // 重复帧，丢弃
+        DUPLICATE,
+        // 过期帧（早于窗口，或它写入的某个字段组已有更新的数据），丢弃
+        STALE,
+    };
+
+    /**
+     * @brief 判定一帧是否写入
+     * @param seq 帧序号
+     * @param fields 该帧写入的字段组（第i位为第i组），为0时迟到帧总是写入
+     */
+    Verdict accept(uint16_t seq, uint32_t fields);
+
+    /**
+     * @brief 判定结果是否应写入数据
+     */
+    static bool shouldApply(Verdict verdict) { return verdict == Verdict::ACCEPT || verdict == Verdict::REORDERED; }
+
+    // 带序号的帧总数
+    uint64_t getReceivedCount() const { return received.load(std::memory_order_relaxed); }
+    // 估计丢失的帧数（序号空缺且未在窗口内补上）
+    uint64_t getLostCount() const { return lost.load(std::memory_order_relaxed); }
+    // 迟到的帧数（不论是否写入）
+    uint64_t getReorderedCount() const { return reordered.load(std::memory_order_relaxed); }
+    // 重复帧数
+    uint64_t getDuplicateCount() const { return duplicates.load(std::memory_order_relaxed); }
+    // 过期丢弃的帧数
+    uint64_t getStaleCount() const { return stale.load(std::memory_order_relaxed); }
+    // 重建窗口次数（无人机重启）
+    uint64_t getResyncCount() const { return resyncs.load(std::memory_order_relaxed); }
+
+private:
+    // 以 seq 为最新帧重新开始
+    void restart(uint16_t seq, uint32_t fields);
+    // 登记 fields 中各字段组最后写入的序号
+    void markApplied(uint16_t seq, uint32_t fields);
+    // fields 中是否有字段组已写入比 seq 新（或相同）的数据
+    bool hasNewer(uint16_t seq, uint32_t fields) const;
+
+    // 单写者计数：避免原子加的总线锁
+    static void bump(std::atomic<uint64_t>& counter, uint64_t n = 1)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    bool started = false;
+    // 最新序号
+    uint16_t highest = 0;
+    // 第i位表示序号 highest-i 已收到
+    uint64_t bitmap = 0;
+    // 连续被拒绝的帧数
+    int rejects = 0;
+    // 各字段组最后写入的序号
+    uint16_t last_applied[FIELD_GROUP_COUNT] = {};
+    // 各字段组是否写入过
+    uint32_t applied_mask = 0;
+
+    std::atomic<uint64_t> received{0};
+    std::atomic<uint64_t> lost{0};
+    std::atomic<uint64_t> reordered{0};
+    std::atomic<uint64_t> duplicates{0};
+    std::atomic<uint64_t> stale{0};
+    std::atomic<uint64_t> resyncs{0};
+};
+
+#endif // SEQUENCE_WINDOW_H
@@ -0,0 +1,172 @@
+#include "SwarmPredictor.h"
+#include "../LatencyStats/LatencyStats.h"
+#include <algorithm>
+#include <time.h>
+
+namespace
+{
+// 消息的各数组统一改变长度（容量在启动时已预留，不会重新分配）
+void resizeArrays(udp_ros_bridge::swarm_prediction& msg, size_t count)
+{
+    msg.id.resize(count);
+    msg.x.resize(count);
+    msg.y.resize(count);
+    msg.z.resize(count);
+    msg.roll.resize(count);
+    msg.pitch.resize(count);
+    msg.yaw.resize(count);
+    msg.vx.resize(count);
+    msg.vy.resize(count);
+    msg.vz.resize(count);
+    msg.horizon.resize(count);
+    msg.age.resize(count);
+}
+}
+
+// ====================== 启停 ======================
+SwarmPredictor::~SwarmPredictor()
+{
+    stop();
+}
+
+void SwarmPredictor::start(ros::NodeHandle& nh, const std::vector<uint8_t>& drone_ids, const std::string& frame,
+                           double rate_hz, double link_latency_s, double max_horizon)
+{
+    if (running.load() || rate_hz <= 0)
+    {
+        return;
+    }
+    ids = drone_ids;
+    period_ns = static_cast<uint64_t>(1e9 / rate_hz);
+    link_latency_ns = link_latency_s > 0 ? static_cast<uint64_t>(link_latency_s * 1e9) : 0;
+    max_horizon_s = max_horizon > 0 ? static_cast<float>(max_horizon) : 0.0f;
+    base_ns = nowRealtimeNs();
+    bank.reset(new KalmanBank(static_cast<int>(ids.size())));
+    isa = bank->getIsa();
+    seen_position.assign(ids.size(), 0);
+    seen_attitude.assign(ids.size(), 0);
+
+    pub = nh.advertise<udp_ros_bridge::swarm_prediction>("swarm_prediction", 1);
+    msg = udp_ros_bridge::swarm_prediction();
+    msg.header.frame_id = frame;
+    resizeArrays(msg, ids.size());
+    running.store(true);
+    thread = std::thread(&SwarmPredictor::run, this);
+}
+
+void SwarmPredictor::stop()
+{
+    if (running.exchange(false) && thread.joinable())
+    {
+        thread.join();
+    }
+}
+
+// ====================== 预测线程 ======================
+void SwarmPredictor::run()
+{
+    applyThreadPolicy(thread_policy, "bridge_predict");
+    timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    while (running.load(std::memory_order_relaxed))
+    {
+        uint64_t next_ns = static_cast<uint64_t>(next.tv_nsec) + period_ns;
+        next.tv_sec += static_cast<time_t>(next_ns / 1000000000ULL);
+        next.tv_nsec = static_cast<long>(next_ns % 1000000000ULL);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr);
+
+        uint64_t cycle_start = nowRealtimeNs();
+        collect();
+        bank->step();
+        // 外推到本周期开始的时刻，与消息时间戳一致
+        bank->extrapolate(toSeconds(cycle_start), max_horizon_s);
+        if (fill(cycle_start) > 0)
+        {
+            pub.publish(msg);
+            publish_count.fetch_add(1, std::memory_order_relaxed);
+        }
+        last_cycle_ns.store(nowRealtimeNs() - cycle_start, std::memory_order_relaxed);
+    }
+}
+
+void SwarmPredictor::collect()
+{
+    float z[KalmanBank::AXIS_COUNT];
+    uint64_t measured = 0;
+    for (size_t slot = 0; slot < ids.size(); slot++)
+    {
+        if (!pool.snapshot(static_cast<int>(slot), snap))
+        {
+            continue;
+        }
+        // 首次测量要初始化全部轴，位置和姿态都收到过之后才开始登记
+        if (snap.position_updates == 0 || snap.attitude_updates == 0)
+        {
+            continue;
+        }
+        unsigned axes = 0;
+        uint64_t measured_ns = 0;
+        if (snap.position_updates != seen_position[slot])
+        {
+            seen_position[slot] = snap.position_updates;
+            axes |= KalmanBank::POSITION_AXES;
+            measured_ns = snap.position_ns;
+        }
+        if (snap.attitude_updates != seen_attitude[slot])
+        {
+            seen_attitude[slot] = snap.attitude_updates;
+            axes |= KalmanBank::ATTITUDE_AXES;
+            // 同一周期两组都变化时滤波器只有一个测量时间，取较新的
+            measured_ns = std::max(measured_ns, snap.attitude_ns);
+        }
+        if (axes == 0)
+        {
+            continue;
+        }
+        z[KalmanBank::AXIS_X] = snap.x;
+        z[KalmanBank::AXIS_Y] = snap.y;
+        z[KalmanBank::AXIS_Z] = snap.z;
+        z[KalmanBank::AXIS_ROLL] = snap.roll;
+        z[KalmanBank::AXIS_PITCH] = snap.pitch;
+        z[KalmanBank::AXIS_YAW] = snap.yaw;
+        bank->setMeasurement(static_cast<int>(slot), z, toSeconds(measured_ns - link_latency_ns), axes);
+        measured++;
+    }
+    measurement_count.fetch_add(measured, std::memory_order_relaxed);
+}
+
+size_t SwarmPredictor::fill(uint64_t now_ns)
+{
+    const KalmanBank& filters = *bank;
+    double now_s = toSeconds(now_ns);
+    msg.header.stamp.fromNSec(now_ns);
+    resizeArrays(msg, ids.size());
+    size_t count = 0;
+    double horizon_sum = 0;
+    for (size_t slot = 0; slot < ids.size(); slot++)
+    {
+        int s = static_cast<int>(slot);
+        if (!filters.isInitialized(s))
+        {
+            continue;
+        }
+        msg.id[count] = ids[slot];
+        msg.x[count] = filters.getPredicted(KalmanBank::AXIS_X, s);
+        msg.y[count] = filters.getPredicted(KalmanBank::AXIS_Y, s);
+        msg.z[count] = filters.getPredicted(KalmanBank::AXIS_Z, s);
+        msg.roll[count] = filters.getPredicted(KalmanBank::AXIS_ROLL, s);
+        msg.pitch[count] = filters.getPredicted(KalmanBank::AXIS_PITCH, s);
+        msg.yaw[count] = filters.getPredicted(KalmanBank::AXIS_YAW, s);
+        msg.vx[count] = filters.getVelocity(KalmanBank::AXIS_X, s);
+        msg.vy[count] = filters.getVelocity(KalmanBank::AXIS_Y, s);
+        msg.vz[count] = filters.getVelocity(KalmanBank::AXIS_Z, s);
+        msg.horizon[count] = filters.getHorizon(s);
+        msg.age[count] = static_cast<float>(now_s - filters.getTime(s));
+        horizon_sum += filters.getHorizon(s);
+        count++;
+    }
+    resizeArrays(msg, count);
+    mean_horizon_ns.store(count > 0 ? static_cast<uint64_t>(horizon_sum / count * 1e9) : 0,
+                          std::memory_order_relaxed);
+    return count;
+}
@@ -0,0 +1,103 @@
+#ifndef SWARM_PREDICTOR_H
+#define SWARM_PREDICTOR_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ros/ros.h"
+#include "udp_ros_bridge/swarm_prediction.h"
+#include "../DecodePool/DecodePool.h"
+#include "../KalmanBank/KalmanBank.h"
+#include "../ThreadTuning/ThreadTuning.h"
+
+// ====================== 集群状态预测 ======================
+
+/**
+ * @brief 地面站延迟补偿：把每架无人机的位姿外推到当前时刻，按固定频率发布（话题 swarm_prediction）
+ * @note 独立线程，每周期读一遍解码线程池的快照，位置或姿态有新数据的无人机把测量交给 KalmanBank，
+ *       只登记变化了的那组轴，测量时间取写入它的数据包的接收时间（DroneSnapshot::position_ns/attitude_ns）
+ *       减去链路单程延迟；只含电池等字段的数据包不产生测量。整个集群一遍预测+更新，再一遍外推到本周期时刻。
+ *       地面侧的延迟（内核→解码→本线程读取）由时间戳实测、随外推一并补偿；无线链路的单程延迟
+ *       地面测不到（遥测不带机载时钟），由 link_latency 给出估计值。
+ *       两次遥测之间由外推填补；外推时长不超过 max_horizon，长时间没有数据的无人机停在上限处，
+ *       由消息的 age 字段判断数据是否过时。滤波器组只由本线程访问，消息数组在启动时按槽位数预留
+ */
+class SwarmPredictor {
+public:
+    explicit SwarmPredictor(const DecodePool& pool) : pool(pool) {}
+    ~SwarmPredictor();
+
+    SwarmPredictor(const SwarmPredictor&) = delete;
+    SwarmPredictor& operator=(const SwarmPredictor&) = delete;
+
+    /**
+     * @brief 设置预测线程的调度策略，启动前调用
+     */
+    void setThreadPolicy(const ThreadPolicy& policy) { thread_policy = policy; }
+
+    /**
+     * @brief 广播话题并启动预测线程
+     * @param nh 节点句柄
+     * @param ids 各槽位的无人机编号（注册表顺序），决定预测的槽位数
+     * @param frame 坐标系（消息头）
+     * @param rate_hz 发布频率，不大于0时不启动
+     * @param link_latency_s 无线链路单程延迟估计（秒）
+     * @param max_horizon_s 最长外推时长（秒）
+     */
+    void start(ros::NodeHandle& nh, const std::vector<uint8_t>& ids, const std::string& frame, double rate_hz,
+               double link_latency_s, double max_horizon_s);
+
+    /**
+     * @brief 停止预测线程
+     */
+    void stop();
+
+    bool isRunning() const { return running.load(std::memory_order_relaxed); }
+    // 已发布的预测消息数
+    uint64_t getPublishCount() const { return publish_count.load(std::memory_order_relaxed); }
+    // 交给滤波器的测量数（每架无人机每周期最多一次，位置和姿态同周期变化时算一次）
+    uint64_t getMeasurementCount() const { return measurement_count.load(std::memory_order_relaxed); }
+    // 最近一个周期的耗时（纳秒）
+    uint64_t getLastCycleNs() const { return last_cycle_ns.load(std::memory_order_relaxed); }
+    // 最近一个周期各无人机外推时长的平均值（纳秒）
+    uint64_t getMeanHorizonNs() const { return mean_horizon_ns.load(std::memory_order_relaxed); }
+    // 滤波器组使用的指令集（启动后有效）
+    KalmanBank::Isa getIsa() const { return isa; }
+
+private:
+    void run();
+    // 读一遍快照，把新数据登记为测量
+    void collect();
+    // 填充外推结果，返回有数据的无人机数
+    size_t fill(uint64_t now_ns);
+
+    // 相对启动时刻的秒数（double 精度足够，也避免外推时大数相减）
+    double toSeconds(uint64_t ns) const { return static_cast<int64_t>(ns - base_ns) / 1e9; }
+
+    const DecodePool& pool;
+    ros::Publisher pub;
+    std::vector<uint8_t> ids;
+    std::unique_ptr<KalmanBank> bank;
+    // 各槽位上次登记时快照中位置、姿态的写入次数，变化了才是新测量
+    std::vector<uint64_t> seen_position;
+    std::vector<uint64_t> seen_attitude;
+    DroneSnapshot snap;
+    udp_ros_bridge::swarm_prediction msg;
+    uint64_t base_ns = 0;
+    uint64_t period_ns = 0;
+    uint64_t link_latency_ns = 0;
+    float max_horizon_s = 0;
+    KalmanBank::Isa isa = KalmanBank::detectIsa();
+    std::thread thread;
+    std::atomic<bool> running{false};
+    ThreadPolicy thread_policy;
+    std::atomic<uint64_t> publish_count{0};
+    std::atomic<uint64_t> measurement_count{0};
+    std::atomic<uint64_t> last_cycle_ns{0};
+    std::atomic<uint64_t> mean_horizon_ns{0};
+};
+
+#endif // SWARM_PREDICTOR_H
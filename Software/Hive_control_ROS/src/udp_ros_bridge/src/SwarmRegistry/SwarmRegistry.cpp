@@ -1,5 +1,6 @@
 #include "SwarmRegistry.h"
 #include <stdexcept>
+#include <arpa/inet.h>
 
 //  ==================扩容函数==================
 // 参数一：扩容倍数
@@ -22,7 +23,7 @@ void SwarmRegistry::recapacity(int new_capacity )
 }
 
 
-DroneInfo& SwarmRegistry::operator[](int index)
+SwarmRegistry::DroneInfo& SwarmRegistry::operator[](int index)
 {
     if (index < 0 || index >= count)
     {
@@ -31,7 +32,7 @@ DroneInfo& SwarmRegistry::operator[](int index)
     return this->drone_info_cache[index];
 }
 
-DroneInfo& SwarmRegistry::operator[](int index) const
+SwarmRegistry::DroneInfo& SwarmRegistry::operator[](int index) const
 {
     if (index < 0 || index >= count)
     {
@@ -41,7 +42,8 @@ DroneInfo& SwarmRegistry::operator[](int index) const
 }
 
 // ================== 拷贝构造函数 ==================
-SwarmRegistry::SwarmRegistry(const SwarmRegistry& other) : capacity(other.capacity), count(other.count), count_id(other.count_id)
+SwarmRegistry::SwarmRegistry(const SwarmRegistry& other) : count_id(other.count_id), capacity(other.capacity), count(other.count), address_index(other.address_index),
+    rejected_count(other.rejected_count), duplicate_count(other.duplicate_count), lookup_miss_count(other.getLookupMissCount())
 {
     // 分配新的缓存数组并拷贝内容
     this->drone_info_cache = new DroneInfo[this->capacity];
@@ -66,6 +68,10 @@ SwarmRegistry& SwarmRegistry::operator=(const SwarmRegistry& other)
     this->capacity = other.capacity;
     this->count = other.count;
     this->count_id = other.count_id;
+    this->address_index = other.address_index;
+    this->rejected_count = other.rejected_count;
+    this->duplicate_count = other.duplicate_count;
+    this->lookup_miss_count.store(other.getLookupMissCount(), std::memory_order_relaxed);
     this->drone_info_cache = new DroneInfo[this->capacity];
     for (int i = 0; i < this->count; ++i)
     {
@@ -76,20 +82,23 @@ SwarmRegistry& SwarmRegistry::operator=(const SwarmRegistry& other)
 // ================== 注册无人机 ==================
 uint8_t SwarmRegistry::registerDrone(const std::string& ip, int port)
 {
-    // 输入验证：IP非空，端口号有效范围(1-65535)
-    if (ip.empty() || port <= 0 || port > 65535) 
+    // 输入验证：IP为点分十进制IPv4，端口号有效范围(1-65535)
+    // 接收线程只按数值地址查槽位，解析不了的地址注册了也收不到数据
+    struct in_addr addr;
+    if (ip.empty() || port <= 0 || port > 65535 || inet_pton(AF_INET, ip.c_str(), &addr) != 1)
     {
+        rejected_count++;
         // 返回一个无效ID
         return ERROR_ID;
     }
 
-    // 检查是否已经注册（防止重复注册）
-    for (int i = 0; i < count; i++)
+    // 检查是否已经注册（防止重复注册），按地址索引查找，不逐个比较
+    uint64_t key = addressKey(addr.s_addr, static_cast<uint16_t>(port));
+    auto it = address_index.find(key);
+    if (it != address_index.end())
     {
-        if (drone_info_cache[i].ip == ip && drone_info_cache[i].port == port)
-        {
-            return drone_info_cache[i].id;  // 返回现有ID
-        }
+        duplicate_count++;
+        return drone_info_cache[it->second].id;  // 返回现有ID
     }
 
     if (count >= capacity)
@@ -99,6 +108,8 @@ uint8_t SwarmRegistry::registerDrone(const std::string& ip, int port)
     drone_info_cache[count].ip = ip;
     drone_info_cache[count].port = port;
     drone_info_cache[count].id = count_id++;
+    // 记录地址索引，接收线程按来源地址查槽位
+    address_index[key] = count;
     // 返回无人机新注册的ID
     return drone_info_cache[count++].id;
 }
@@ -131,9 +142,11 @@ void SwarmRegistry::removeDroneInfo(uint8_t id)
     }
     // 更新数量
     count--;
+    // 后面的无人机下标前移了，重建地址索引
+    rebuildAddressIndex();
 }
 // ================== 获取无人机信息 ==================
-DroneInfo* SwarmRegistry::getDroneInfo(uint8_t id)
+SwarmRegistry::DroneInfo* SwarmRegistry::getDroneInfo(uint8_t id)
 {
 
     for (int i = 0; i < count; i++)
@@ -144,4 +157,30 @@ DroneInfo* SwarmRegistry::getDroneInfo(uint8_t id)
         }
     }
     return nullptr;
+}
+
+// ================== 重建地址索引 ==================
+void SwarmRegistry::rebuildAddressIndex()
+{
+    address_index.clear();
+    for (int i = 0; i < count; i++)
+    {
+        struct in_addr addr;
+        if (inet_pton(AF_INET, drone_info_cache[i].ip.c_str(), &addr) == 1)
+        {
+            address_index[addressKey(addr.s_addr, static_cast<uint16_t>(drone_info_cache[i].port))] = i;
+        }
+    }
+}
+
+// ================== 按地址查找槽位 ==================
+int SwarmRegistry::findSlotByAddress(uint32_t ip_be, uint16_t port) const
+{
+    auto it = address_index.find(addressKey(ip_be, port));
+    if (it == address_index.end())
+    {
+        lookup_miss_count.fetch_add(1, std::memory_order_relaxed);
+        return -1;
+    }
+    return it->second;
 }
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <atomic>
+#include <unordered_map>
 
 #define ERROR_ID 0xFF
 
@@ -28,10 +30,19 @@ private:
     int count = 0;
     // 无人机信息缓存
     DroneInfo* drone_info_cache;
+    // 地址索引：addressKey(IP, 端口) -> 缓存下标
+    std::unordered_map<uint64_t, int> address_index;
+    // 注册被拒绝（地址无效）和重复注册的次数（只在注册线程上修改）
+    uint64_t rejected_count = 0;
+    uint64_t duplicate_count = 0;
+    // 按地址查不到槽位的次数（接收线程上修改，只在未命中时计数）
+    mutable std::atomic<uint64_t> lookup_miss_count{0};
     //  ==================扩容函数==================
     // 参数一：扩容倍数
     // 参数二：默认扩容倍数为2
     void recapacity(int new_capacity = 2);
+    //  ==================重建地址索引==================
+    void rebuildAddressIndex();
 public:
     // ================== 构造函数 ==================
     SwarmRegistry()
@@ -74,6 +85,22 @@ public:
     // ================== 获取无人机信息 ==================
     DroneInfo* getDroneInfo(uint8_t id);
 
+    // ================== 地址索引 ==================
+    // 地址键：网络字节序IPv4地址和主机字节序端口拼成一个64位整数
+    static uint64_t addressKey(uint32_t ip_be, uint16_t port)
+    {
+        return (static_cast<uint64_t>(ip_be) << 16) | port;
+    }
+    // 按地址查找缓存下标（即无人机槽位），未注册返回-1
+    // 参数一：网络字节序IPv4地址（sockaddr_in::sin_addr.s_addr）
+    // 参数二：主机字节序端口号
+    int findSlotByAddress(uint32_t ip_be, uint16_t port) const;
+
+
+    // ================== 统计 ==================
+    uint64_t getRejectedCount() const { return rejected_count; }
+    uint64_t getDuplicateCount() const { return duplicate_count; }
+    uint64_t getLookupMissCount() const { return lookup_miss_count.load(std::memory_order_relaxed); }
 
     // ================== 获取无人机数量 ==================
     int getDroneCount() const{return count;} 
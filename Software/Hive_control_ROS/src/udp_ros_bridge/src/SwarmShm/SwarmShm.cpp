@@ -0,0 +1,285 @@
+#include "udp_ros_bridge/SwarmShm.h"
+#include "udp_ros_bridge/Logger.h"
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+// ====================== 布局 ======================
+// 快照 index 在映射区中的位置
+static size_t snapshotOffset(const SwarmShmHeader* header, uint64_t index)
+{
+    return header->header_size + static_cast<size_t>(index) * header->snapshot_size;
+}
+
+static size_t snapshotSize(uint32_t slot_count)
+{
+    return sizeof(SwarmShmSnapshotHeader) + static_cast<size_t>(slot_count) * sizeof(SwarmShmDrone);
+}
+
+// 共享内存中的futex（不加 FUTEX_PRIVATE_FLAG，跨进程）
+static uint32_t* futexWord(const SwarmShmHeader* header)
+{
+    return reinterpret_cast<uint32_t*>(const_cast<std::atomic<uint32_t>*>(&header->notify));
+}
+
+static void futexWakeAll(const SwarmShmHeader* header)
+{
+    syscall(SYS_futex, futexWord(header), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+static uint64_t realtimeNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+// ====================== 写者 ======================
+SwarmShmWriter::~SwarmShmWriter()
+{
+    close();
+}
+
+bool SwarmShmWriter::create(const std::string& shm_name, uint32_t slot_count, uint32_t ring_depth)
+{
+    close();
+    if (slot_count == 0 || ring_depth < 2) {
+        LOG_ERROR("集群状态共享内存参数无效：{} 架，环 {} 槽", slot_count, ring_depth);
+        return false;
+    }
+    int old_fd = shm_open(shm_name.c_str(), O_RDWR, 0);
+    if (old_fd >= 0) {
+        struct stat st;
+        // 旧区域可能还有读者映射着：先置关闭标志让它们重新打开，再删除名字
+        if (fstat(old_fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(SwarmShmHeader)) {
+            void* old = mmap(nullptr, sizeof(SwarmShmHeader), PROT_READ | PROT_WRITE, MAP_SHARED, old_fd, 0);
+            if (old != MAP_FAILED) {
+                SwarmShmHeader* old_header = static_cast<SwarmShmHeader*>(old);
+                old_header->closed.store(1, std::memory_order_release);
+                futexWakeAll(old_header);
+                munmap(old, sizeof(SwarmShmHeader));
+            }
+        }
+        ::close(old_fd);
+        shm_unlink(shm_name.c_str());
+    }
+
+    int fd = shm_open(shm_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        LOG_ERROR("无法创建集群状态共享内存 {}: {}", shm_name, strerror(errno));
+        return false;
+    }
+    size_t total = sizeof(SwarmShmHeader) + ring_depth * snapshotSize(slot_count);
+    if (ftruncate(fd, static_cast<off_t>(total)) != 0) {
+        LOG_ERROR("设置集群状态共享内存长度失败: {}", strerror(errno));
+        ::close(fd);
+        shm_unlink(shm_name.c_str());
+        return false;
+    }
+    void* mapping = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        LOG_ERROR("映射集群状态共享内存失败: {}", strerror(errno));
+        shm_unlink(shm_name.c_str());
+        return false;
+    }
+
+    // ftruncate 后内容全为0（版本号0即“没有快照”），只需填文件头；魔数最后写，读者看到魔数时其余字段已就绪
+    header = static_cast<SwarmShmHeader*>(mapping);
+    size = total;
+    name = shm_name;
+    version = 0;
+    header->version = SWARM_SHM_VERSION;
+    header->header_size = sizeof(SwarmShmHeader);
+    header->slot_count = slot_count;
+    header->ring_depth = ring_depth;
+    header->snapshot_size = static_cast<uint32_t>(snapshotSize(slot_count));
+    header->writer_pid = static_cast<uint32_t>(getpid());
+    header->created_ns = realtimeNs();
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(header->magic, SWARM_SHM_MAGIC, sizeof(SWARM_SHM_MAGIC));
+    LOG_INFO("集群状态共享内存 {}：{} 架，环 {} 槽，{} KB", shm_name, slot_count, ring_depth, total / 1024);
+    return true;
+}
+
+SwarmShmDrone* SwarmShmWriter::begin()
+{
+    if (header == nullptr) {
+        return nullptr;
+    }
+    // 下一个版本写在 version+1 对应的槽；环至少2槽，不会覆盖最新快照
+    uint8_t* slot = reinterpret_cast<uint8_t*>(header) + snapshotOffset(header, (version + 1) % header->ring_depth);
+    writing = reinterpret_cast<SwarmShmSnapshotHeader*>(slot);
+    writing->version.store(0, std::memory_order_relaxed);
+    // 版本号清零必须先于数据写入被读者看到
+    std::atomic_thread_fence(std::memory_order_release);
+    return reinterpret_cast<SwarmShmDrone*>(slot + sizeof(SwarmShmSnapshotHeader));
+}
+
+uint64_t SwarmShmWriter::commit(uint32_t drone_count, uint64_t publish_ns)
+{
+    if (header == nullptr || writing == nullptr) {
+        return version;
+    }
+    version++;
+    writing->publish_ns = publish_ns;
+    writing->drone_count = drone_count < header->slot_count ? drone_count : header->slot_count;
+    writing->version.store(version, std::memory_order_release);
+    writing = nullptr;
+    header->latest.store(version, std::memory_order_release);
+    header->notify.fetch_add(1, std::memory_order_release);
+    futexWakeAll(header);
+    return version;
+}
+
+void SwarmShmWriter::close()
+{
+    if (header == nullptr) {
+        return;
+    }
+    header->closed.store(1, std::memory_order_release);
+    header->notify.fetch_add(1, std::memory_order_release);
+    futexWakeAll(header);
+    munmap(header, size);
+    shm_unlink(name.c_str());
+    header = nullptr;
+    writing = nullptr;
+    size = 0;
+}
+
+// ====================== 读者 ======================
+SwarmShmReader::~SwarmShmReader()
+{
+    close();
+}
+
+bool SwarmShmReader::open(const std::string& shm_name)
+{
+    close();
+    int fd = shm_open(shm_name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(SwarmShmHeader)) {
+        ::close(fd);
+        return false;
+    }
+    size_t total = static_cast<size_t>(st.st_size);
+    void* mapping = mmap(nullptr, total, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    const SwarmShmHeader* candidate = static_cast<const SwarmShmHeader*>(mapping);
+    bool valid = memcmp(candidate->magic, SWARM_SHM_MAGIC, sizeof(SWARM_SHM_MAGIC)) == 0;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    valid = valid && candidate->version == SWARM_SHM_VERSION && candidate->header_size == sizeof(SwarmShmHeader) &&
+            candidate->ring_depth >= 2 && candidate->snapshot_size == snapshotSize(candidate->slot_count) &&
+            snapshotOffset(candidate, candidate->ring_depth) <= total;
+    if (!valid) {
+        munmap(mapping, total);
+        return false;
+    }
+    header = candidate;
+    size = total;
+    return true;
+}
+
+bool SwarmShmReader::read(SwarmShmState& out) const
+{
+    if (header == nullptr) {
+        return false;
+    }
+    for (int attempt = 0; attempt < READ_ATTEMPTS; attempt++) {
+        uint64_t latest = header->latest.load(std::memory_order_acquire);
+        if (latest == 0) {
+            return false;
+        }
+        const uint8_t* slot = reinterpret_cast<const uint8_t*>(header) +
+                              snapshotOffset(header, latest % header->ring_depth);
+        const SwarmShmSnapshotHeader* snapshot = reinterpret_cast<const SwarmShmSnapshotHeader*>(slot);
+        if (snapshot->version.load(std::memory_order_acquire) != latest) {
+            continue;
+        }
+        uint32_t count = snapshot->drone_count;
+        count = count < header->slot_count ? count : header->slot_count;
+        out.publish_ns = snapshot->publish_ns;
+        out.drones.resize(count);
+        memcpy(out.drones.data(), slot + sizeof(SwarmShmSnapshotHeader), count * sizeof(SwarmShmDrone));
+        // 拷贝完成后再检查一次：版本号没变说明拷贝期间写者没有进入这个槽
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (snapshot->version.load(std::memory_order_relaxed) == latest) {
+            out.version = latest;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SwarmShmReader::wait(uint64_t seen_version, int timeout_ms) const
+{
+    if (header == nullptr) {
+        return false;
+    }
+    timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    if (timeout_ms >= 0) {
+        deadline.tv_sec += timeout_ms / 1000;
+        deadline.tv_nsec += (timeout_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+    }
+    while (true) {
+        // 先取通知字再看版本号：两者之间若有发布，通知字已变，FUTEX_WAIT 立即返回
+        uint32_t word = header->notify.load(std::memory_order_acquire);
+        if (header->latest.load(std::memory_order_acquire) != seen_version) {
+            return true;
+        }
+        if (header->closed.load(std::memory_order_acquire) != 0) {
+            return false;
+        }
+        timespec remaining;
+        const timespec* timeout = nullptr;
+        if (timeout_ms >= 0) {
+            timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            int64_t left_ns = (deadline.tv_sec - now.tv_sec) * 1000000000LL + (deadline.tv_nsec - now.tv_nsec);
+            if (left_ns <= 0) {
+                return false;
+            }
+            remaining.tv_sec = static_cast<time_t>(left_ns / 1000000000LL);
+            remaining.tv_nsec = static_cast<long>(left_ns % 1000000000LL);
+            timeout = &remaining;
+        }
+        syscall(SYS_futex, futexWord(header), FUTEX_WAIT, word, timeout, nullptr, 0);
+    }
+}
+
+uint64_t SwarmShmReader::getLatestVersion() const
+{
+    return header != nullptr ? header->latest.load(std::memory_order_acquire) : 0;
+}
+
+bool SwarmShmReader::isWriterClosed() const
+{
+    return header == nullptr || header->closed.load(std::memory_order_acquire) != 0;
+}
+
+void SwarmShmReader::close()
+{
+    if (header != nullptr) {
+        munmap(const_cast<SwarmShmHeader*>(header), size);
+        header = nullptr;
+        size = 0;
+    }
+}
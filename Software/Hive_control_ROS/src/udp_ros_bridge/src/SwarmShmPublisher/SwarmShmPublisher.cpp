@@ -0,0 +1,84 @@
+#include "SwarmShmPublisher.h"
+#include <time.h>
+
+// ====================== 启停 ======================
+SwarmShmPublisher::~SwarmShmPublisher()
+{
+    stop();
+}
+
+bool SwarmShmPublisher::start(const std::string& name, int count, int rate_hz)
+{
+    if (running.load())
+    {
+        return true;
+    }
+    count = count < 1 ? 1 : count;
+    if (!writer.create(name, static_cast<uint32_t>(count)))
+    {
+        return false;
+    }
+    drone_count = count;
+    period_ns = 1000000000ULL / static_cast<uint64_t>(rate_hz < 1 ? 1 : rate_hz);
+    running.store(true);
+    thread = std::thread(&SwarmShmPublisher::run, this);
+    return true;
+}
+
+void SwarmShmPublisher::stop()
+{
+    if (running.exchange(false) && thread.joinable())
+    {
+        thread.join();
+    }
+    writer.close();
+}
+
+// ====================== 发布线程 ======================
+void SwarmShmPublisher::run()
+{
+    applyThreadPolicy(thread_policy, "bridge_shm");
+    timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    // 上次发布时各槽位中最新的更新时间，没有变化就不发布
+    uint64_t published_ns = 0;
+    DroneSnapshot snap;
+    while (running.load(std::memory_order_relaxed))
+    {
+        uint64_t next_ns = static_cast<uint64_t>(next.tv_nsec) + period_ns;
+        next.tv_sec += static_cast<time_t>(next_ns / 1000000000ULL);
+        next.tv_nsec = static_cast<long>(next_ns % 1000000000ULL);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr);
+
+        SwarmShmDrone* drones = writer.begin();
+        uint64_t newest_ns = 0;
+        for (int slot = 0; slot < drone_count; slot++)
+        {
+            SwarmShmDrone& drone = drones[slot];
+            if (!pool.snapshot(slot, snap))
+            {
+                snap = DroneSnapshot();
+            }
+            drone.updated_ns = snap.updated_ns;
+            drone.x = snap.x;
+            drone.y = snap.y;
+            drone.z = snap.z;
+            drone.roll = snap.roll;
+            drone.pitch = snap.pitch;
+            drone.yaw = snap.yaw;
+            drone.slot = static_cast<uint16_t>(slot);
+            drone.id = snap.id;
+            drone.batt = snap.batt;
+            newest_ns = snap.updated_ns > newest_ns ? snap.updated_ns : newest_ns;
+        }
+        if (newest_ns == published_ns)
+        {
+            // 没有提交的环槽下一周期重写，读者看不到
+            idle.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        published_ns = newest_ns;
+        writer.commit(static_cast<uint32_t>(drone_count), nowRealtimeNs());
+        published.fetch_add(1, std::memory_order_relaxed);
+    }
+}
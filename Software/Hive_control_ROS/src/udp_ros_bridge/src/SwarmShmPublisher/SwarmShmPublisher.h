@@ -0,0 +1,68 @@
+#ifndef SWARM_SHM_PUBLISHER_H
+#define SWARM_SHM_PUBLISHER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include "udp_ros_bridge/SwarmShm.h"
+#include "../DecodePool/DecodePool.h"
+#include "../ThreadTuning/ThreadTuning.h"
+
+// ====================== 集群状态共享内存发布 ======================
+/**
+ * @brief 按固定频率把解码线程池的状态快照整体写进共享内存（SwarmShm.h）
+ * @note 独立线程，每周期读一遍各槽位快照写进下一个环槽；周期内没有任何无人机更新时不发布，
+ *       读者只在状态变化时被唤醒。ROS 话题仍由主循环发布，两者互不影响
+ */
+class SwarmShmPublisher {
+public:
+    // 默认发布频率：无人机50Hz上报时状态最多晚10毫秒
+    static const int DEFAULT_RATE_HZ = 100;
+
+    explicit SwarmShmPublisher(const DecodePool& pool) : pool(pool) {}
+    ~SwarmShmPublisher();
+
+    SwarmShmPublisher(const SwarmShmPublisher&) = delete;
+    SwarmShmPublisher& operator=(const SwarmShmPublisher&) = delete;
+
+    /**
+     * @brief 设置发布线程的调度策略，启动前调用
+     */
+    void setThreadPolicy(const ThreadPolicy& policy) { thread_policy = policy; }
+
+    /**
+     * @brief 创建共享内存并启动发布线程
+     * @param name 共享内存名
+     * @param drone_count 发布的槽位数（注册的无人机数）
+     * @param rate_hz 发布频率，小于1时按1
+     * @return 共享内存创建失败返回false
+     */
+    bool start(const std::string& name, int drone_count, int rate_hz = DEFAULT_RATE_HZ);
+
+    /**
+     * @brief 停止发布线程并删除共享内存
+     */
+    void stop();
+
+    bool isRunning() const { return running.load(std::memory_order_relaxed); }
+    // 已发布的快照数
+    uint64_t getPublishCount() const { return published.load(std::memory_order_relaxed); }
+    // 周期内没有更新而跳过的次数
+    uint64_t getIdleCount() const { return idle.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+
+    const DecodePool& pool;
+    SwarmShmWriter writer;
+    std::thread thread;
+    std::atomic<bool> running{false};
+    int drone_count = 0;
+    uint64_t period_ns = 0;
+    ThreadPolicy thread_policy;
+    std::atomic<uint64_t> published{0};
+    std::atomic<uint64_t> idle{0};
+};
+
+#endif // SWARM_SHM_PUBLISHER_H
@@ -0,0 +1,239 @@
+#include "SwarmViz.h"
+#include "../LatencyStats/LatencyStats.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <time.h>
+#include "sensor_msgs/PointField.h"
+
+namespace
+{
+// 位置单位为厘米，姿态单位为0.1度
+const float CM_TO_M = 0.01f;
+const double DECIDEG_TO_RAD = M_PI / 1800.0;
+// 两种输出都停用时线程的检查周期
+const uint64_t IDLE_PERIOD_NS = 100000000ULL;
+
+uint64_t monotonicNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+uint64_t periodNs(double rate_hz)
+{
+    return rate_hz > 0 ? static_cast<uint64_t>(1e9 / rate_hz) : 0;
+}
+
+void addField(sensor_msgs::PointCloud2& cloud, const char* name, uint32_t offset, uint8_t datatype)
+{
+    sensor_msgs::PointField field;
+    field.name = name;
+    field.offset = offset;
+    field.datatype = datatype;
+    field.count = 1;
+    cloud.fields.push_back(field);
+}
+
+// 欧拉角（ZYX顺序，弧度）转四元数
+void setRotation(geometry_msgs::Quaternion& q, double roll, double pitch, double yaw)
+{
+    double cr = std::cos(roll * 0.5);
+    double sr = std::sin(roll * 0.5);
+    double cp = std::cos(pitch * 0.5);
+    double sp = std::sin(pitch * 0.5);
+    double cy = std::cos(yaw * 0.5);
+    double sy = std::sin(yaw * 0.5);
+    q.w = cr * cp * cy + sr * sp * sy;
+    q.x = sr * cp * cy - cr * sp * sy;
+    q.y = cr * sp * cy + sr * cp * sy;
+    q.z = cr * cp * sy - sr * sp * cy;
+}
+}
+
+// ====================== 启停 ======================
+SwarmVizPublisher::~SwarmVizPublisher()
+{
+    stop();
+}
+
+void SwarmVizPublisher::start(ros::NodeHandle& nh, int drone_count,
+                              const std::string& frame, double cloud_rate_hz, double tf_rate_hz)
+{
+    if (running.load())
+    {
+        return;
+    }
+    cloud_period_ns = periodNs(cloud_rate_hz);
+    tf_period_ns = periodNs(tf_rate_hz);
+    if (cloud_period_ns == 0 && tf_period_ns == 0)
+    {
+        return;
+    }
+    slot_count = drone_count > 0 ? static_cast<size_t>(drone_count) : 0;
+    frame_id = frame;
+    size_t count = slot_count;
+    snapshots.assign(count, DroneSnapshot());
+    slots.assign(count, 0);
+
+    if (cloud_period_ns > 0)
+    {
+        cloud_pub = nh.advertise<sensor_msgs::PointCloud2>("swarm_cloud", 1);
+        cloud = sensor_msgs::PointCloud2();
+        cloud.header.frame_id = frame;
+        cloud.height = 1;
+        cloud.is_bigendian = false;
+        cloud.is_dense = true;
+        cloud.point_step = POINT_STEP;
+        addField(cloud, "x", 0, sensor_msgs::PointField::FLOAT32);
+        addField(cloud, "y", 4, sensor_msgs::PointField::FLOAT32);
+        addField(cloud, "z", 8, sensor_msgs::PointField::FLOAT32);
+        addField(cloud, "slot", 12, sensor_msgs::PointField::UINT16);
+        addField(cloud, "batt", 14, sensor_msgs::PointField::UINT8);
+        addField(cloud, "health", 15, sensor_msgs::PointField::UINT8);
+        cloud.data.reserve(count * POINT_STEP);
+    }
+    if (tf_period_ns > 0)
+    {
+        tf_pub = nh.advertise<tf2_msgs::TFMessage>("/tf", 10);
+        child_frames.resize(count);
+        tf_sent_ns.assign(count, 0);
+        for (size_t slot = 0; slot < count; slot++)
+        {
+            child_frames[slot] = "drone_" + std::to_string(slot);
+        }
+        tf.transforms.reserve(count);
+    }
+    running.store(true);
+    thread = std::thread(&SwarmVizPublisher::run, this);
+}
+
+void SwarmVizPublisher::stop()
+{
+    if (running.exchange(false) && thread.joinable())
+    {
+        thread.join();
+    }
+}
+
+// ====================== 发布线程 ======================
+void SwarmVizPublisher::run()
+{
+    applyThreadPolicy(thread_policy, "bridge_viz");
+    uint64_t now = monotonicNs();
+    uint64_t next_cloud = cloud_period_ns > 0 ? now : UINT64_MAX;
+    uint64_t next_tf = tf_period_ns > 0 ? now : UINT64_MAX;
+    while (running.load(std::memory_order_relaxed))
+    {
+        // 睡到较早的截止时间，但每 IDLE_PERIOD_NS 检查一次停止标志
+        uint64_t wake = std::min(std::min(next_cloud, next_tf), monotonicNs() + IDLE_PERIOD_NS);
+        timespec ts;
+        ts.tv_sec = static_cast<time_t>(wake / 1000000000ULL);
+        ts.tv_nsec = static_cast<long>(wake % 1000000000ULL);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr);
+
+        now = monotonicNs();
+        bool cloud_due = now >= next_cloud;
+        bool tf_due = now >= next_tf;
+        if (!cloud_due && !tf_due)
+        {
+            continue;
+        }
+        uint64_t cycle_start = now;
+        size_t count = collect();
+        if (cloud_due)
+        {
+            fillCloud(count);
+            cloud_pub.publish(cloud);
+            cloud_count.fetch_add(1, std::memory_order_relaxed);
+            // 落后超过一个周期时不补发
+            next_cloud += cloud_period_ns;
+            next_cloud = next_cloud < now ? now + cloud_period_ns : next_cloud;
+        }
+        if (tf_due && count > 0 && fillTf(count) > 0)
+        {
+            tf_pub.publish(tf);
+            tf_count.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (tf_due)
+        {
+            next_tf += tf_period_ns;
+            next_tf = next_tf < now ? now + tf_period_ns : next_tf;
+        }
+        last_cycle_ns.store(monotonicNs() - cycle_start, std::memory_order_relaxed);
+    }
+}
+
+size_t SwarmVizPublisher::collect()
+{
+    size_t count = 0;
+    for (size_t slot = 0; slot < slot_count; slot++)
+    {
+        DroneSnapshot& snap = snapshots[count];
+        if (!pool.snapshot(static_cast<int>(slot), snap) || snap.updated_ns == 0)
+        {
+            continue;
+        }
+        slots[count] = static_cast<int>(slot);
+        count++;
+    }
+    return count;
+}
+
+void SwarmVizPublisher::fillCloud(size_t count)
+{
+    uint64_t now_ns = nowRealtimeNs();
+    cloud.header.stamp = ros::Time::now();
+    cloud.width = static_cast<uint32_t>(count);
+    cloud.row_step = cloud.width * POINT_STEP;
+    // 容量在启动时已预留，resize 不会重新分配
+    cloud.data.resize(cloud.row_step);
+    uint8_t* point = cloud.data.data();
+    for (size_t i = 0; i < count; i++, point += POINT_STEP)
+    {
+        const DroneSnapshot& snap = snapshots[i];
+        float xyz[3] = {snap.x * CM_TO_M, snap.y * CM_TO_M, snap.z * CM_TO_M};
+        memcpy(point, xyz, sizeof(xyz));
+        uint16_t slot = static_cast<uint16_t>(slots[i]);
+        memcpy(point + 12, &slot, sizeof(slot));
+        point[14] = snap.batt;
+        uint8_t health = DRONE_HEALTH_OK;
+        if (now_ns > snap.updated_ns && now_ns - snap.updated_ns > STALE_NS)
+        {
+            health = DRONE_HEALTH_STALE;
+        }
+        else if (snap.batt < LOW_BATTERY_PERCENT)
+        {
+            health = DRONE_HEALTH_LOW_BATTERY;
+        }
+        point[15] = health;
+    }
+}
+
+size_t SwarmVizPublisher::fillTf(size_t count)
+{
+    // 坐标系名都在短字符串范围内，赋值不分配内存；容量在启动时已预留
+    tf.transforms.resize(count);
+    size_t filled = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        const DroneSnapshot& snap = snapshots[i];
+        if (snap.updated_ns == tf_sent_ns[slots[i]])
+        {
+            continue;
+        }
+        tf_sent_ns[slots[i]] = snap.updated_ns;
+        geometry_msgs::TransformStamped& transform = tf.transforms[filled++];
+        transform.header.frame_id = frame_id;
+        transform.header.stamp.fromNSec(snap.updated_ns);
+        transform.child_frame_id = child_frames[slots[i]];
+        transform.transform.translation.x = snap.x * CM_TO_M;
+        transform.transform.translation.y = snap.y * CM_TO_M;
+        transform.transform.translation.z = snap.z * CM_TO_M;
+        setRotation(transform.transform.rotation, snap.roll * DECIDEG_TO_RAD, snap.pitch * DECIDEG_TO_RAD,
+                    snap.yaw * DECIDEG_TO_RAD);
+    }
+    tf.transforms.resize(filled);
+    return filled;
+}
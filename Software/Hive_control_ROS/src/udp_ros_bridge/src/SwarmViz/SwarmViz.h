@@ -0,0 +1,111 @@
+#ifndef SWARM_VIZ_H
+#define SWARM_VIZ_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ros/ros.h"
+#include "sensor_msgs/PointCloud2.h"
+#include "tf2_msgs/TFMessage.h"
+#include "../DecodePool/DecodePool.h"
+#include "../ThreadTuning/ThreadTuning.h"
+
+// ====================== 集群可视化输出 ======================
+
+/**
+ * @brief 点云 health 字段的取值（数值越大越需要关注，rviz 按该字段着色）
+ */
+enum DroneHealth : uint8_t {
+    DRONE_HEALTH_OK = 0,
+    // 电量低于 LOW_BATTERY_PERCENT
+    DRONE_HEALTH_LOW_BATTERY = 1,
+    // 超过 STALE_NS 没有收到数据
+    DRONE_HEALTH_STALE = 2,
+};
+
+/**
+ * @brief 把整个集群按固定频率发布为一个 PointCloud2 和一个批量 TFMessage
+ * @note 独立线程，点云和TF各有自己的频率，与遥测上报频率无关；每周期只读一遍解码线程池的快照，
+ *       每种输出只发一条消息，消息对象和子坐标系名在启动时分配好，周期内不再分配内存。
+ *       点云每点16字节：x y z（米，float32）、slot（uint16）、batt（百分比）、health（uint8）；
+ *       无人机一律用注册表槽位号标识（uint8 编号超过255架会回绕，0xFF 又是 ERROR_ID），
+ *       TF 的子坐标系为 drone_<slot>，时间戳取该无人机最近一次解码的时间。还没有数据的无人机不输出；
+ *       TF 只输出上次发出之后有新数据的无人机（同一时间戳重复发送会让 tf2 报 TF_REPEATED_DATA），
+ *       本周期没有任何无人机更新时不发TF消息
+ */
+class SwarmVizPublisher {
+public:
+    // 点云每点字节数
+    static const uint32_t POINT_STEP = 16;
+    static const int LOW_BATTERY_PERCENT = 20;
+    static const uint64_t STALE_NS = 1000000000ULL;
+
+    explicit SwarmVizPublisher(const DecodePool& pool) : pool(pool) {}
+    ~SwarmVizPublisher();
+
+    SwarmVizPublisher(const SwarmVizPublisher&) = delete;
+    SwarmVizPublisher& operator=(const SwarmVizPublisher&) = delete;
+
+    /**
+     * @brief 设置发布线程的调度策略，启动前调用
+     */
+    void setThreadPolicy(const ThreadPolicy& policy) { thread_policy = policy; }
+
+    /**
+     * @brief 广播话题并启动发布线程
+     * @param nh 节点句柄（点云发布到 swarm_cloud，TF 发布到 /tf）
+     * @param drone_count 发布的槽位数（注册表前 drone_count 个槽位）
+     * @param frame 父坐标系（点云和TF共用）
+     * @param cloud_rate_hz 点云频率，不大于0时不发布点云
+     * @param tf_rate_hz TF频率，不大于0时不发布TF
+     */
+    void start(ros::NodeHandle& nh, int drone_count, const std::string& frame,
+               double cloud_rate_hz, double tf_rate_hz);
+
+    /**
+     * @brief 停止发布线程
+     */
+    void stop();
+
+    bool isRunning() const { return running.load(std::memory_order_relaxed); }
+    // 已发布的点云和TF消息数
+    uint64_t getCloudCount() const { return cloud_count.load(std::memory_order_relaxed); }
+    uint64_t getTfCount() const { return tf_count.load(std::memory_order_relaxed); }
+    // 最近一个周期填充并发布消息的耗时（纳秒）
+    uint64_t getLastCycleNs() const { return last_cycle_ns.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    // 读一遍快照，返回有数据的槽位数
+    size_t collect();
+    void fillCloud(size_t count);
+    // 只填有新数据的无人机，返回填入的变换数
+    size_t fillTf(size_t count);
+
+    const DecodePool& pool;
+    ros::Publisher cloud_pub;
+    ros::Publisher tf_pub;
+    size_t slot_count = 0;
+    std::string frame_id;
+    // 本周期有数据的快照及其槽位
+    std::vector<DroneSnapshot> snapshots;
+    std::vector<int> slots;
+    // 各槽位的子坐标系名，启动时生成
+    std::vector<std::string> child_frames;
+    // 各槽位上次发出的TF时间戳（updated_ns），相同则不再发
+    std::vector<uint64_t> tf_sent_ns;
+    sensor_msgs::PointCloud2 cloud;
+    tf2_msgs::TFMessage tf;
+    uint64_t cloud_period_ns = 0;
+    uint64_t tf_period_ns = 0;
+    std::thread thread;
+    std::atomic<bool> running{false};
+    ThreadPolicy thread_policy;
+    std::atomic<uint64_t> cloud_count{0};
+    std::atomic<uint64_t> tf_count{0};
+    std::atomic<uint64_t> last_cycle_ns{0};
+};
+
+#endif // SWARM_VIZ_H
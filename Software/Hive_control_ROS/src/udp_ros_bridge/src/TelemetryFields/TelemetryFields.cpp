@@ -0,0 +1,595 @@
+#include "TelemetryFields.h"
+#include "../data_processing/data_processing.h"
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cstdlib>
+#include <cstddef>
+#include <cstring>
+
+// ====================== 字段描述 ======================
+namespace {
+
+// 字段数值类型
+enum class FieldKind : uint8_t { U8, I16, F32 };
+
+// 字段名、类型及其在 DataProcessing 中的偏移
+struct FieldDesc {
+    std::string_view name;
+    FieldKind kind;
+    uint16_t offset;
+};
+
+#define TELEMETRY_FIELD(name, kind, member) {name, FieldKind::kind, offsetof(DataProcessing, member)}
+
+// 字段表：新增字段只需在这里加一行，哈希在编译期重新生成
+constexpr FieldDesc FIELDS[] = {
+    TELEMETRY_FIELD("id", U8, id),
+    TELEMETRY_FIELD("roll", I16, roll),
+    TELEMETRY_FIELD("pitch", I16, pitch),
+    TELEMETRY_FIELD("yaw", I16, yaw),
+    TELEMETRY_FIELD("x", F32, x),
+    TELEMETRY_FIELD("y", F32, y),
+    TELEMETRY_FIELD("z", F32, z),
+    TELEMETRY_FIELD("batt", U8, batt),
+    TELEMETRY_FIELD("pid0_kp", U8, pid[0].kp),
+    TELEMETRY_FIELD("pid0_ki", U8, pid[0].ki),
+    TELEMETRY_FIELD("pid0_kd", U8, pid[0].kd),
+    TELEMETRY_FIELD("pid1_kp", U8, pid[1].kp),
+    TELEMETRY_FIELD("pid1_ki", U8, pid[1].ki),
+    TELEMETRY_FIELD("pid1_kd", U8, pid[1].kd),
+    TELEMETRY_FIELD("pid2_kp", U8, pid[2].kp),
+    TELEMETRY_FIELD("pid2_ki", U8, pid[2].ki),
+    TELEMETRY_FIELD("pid2_kd", U8, pid[2].kd),
+    TELEMETRY_FIELD("pid3_kp", U8, pid[3].kp),
+    TELEMETRY_FIELD("pid3_ki", U8, pid[3].ki),
+    TELEMETRY_FIELD("pid3_kd", U8, pid[3].kd),
+};
+
+#undef TELEMETRY_FIELD
+constexpr int FIELD_COUNT = sizeof(FIELDS) / sizeof(FIELDS[0]);
+static_assert(FIELD_COUNT <= 32, "ParseResult::written 是32位掩码");
+
+// ====================== 编译期完美哈希 ======================
+// 键名前8个字节按小端拼成64位整数，与长度一起做乘法哈希取高6位；
+// 编译期搜索一个让所有字段落到不同槽位的乘数
+constexpr uint32_t HASH_BITS = 6;
+constexpr uint32_t HASH_TABLE_SIZE = 1u << HASH_BITS;
+
+constexpr uint64_t keyWord(std::string_view key)
+{
+    uint64_t word = 0;
+    for (size_t i = 0; i < key.size() && i < 8; i++)
+    {
+        word |= static_cast<uint64_t>(static_cast<uint8_t>(key[i])) << (8 * i);
+    }
+    return word;
+}
+
+constexpr uint32_t hashSlot(uint64_t word, size_t length, uint64_t seed)
+{
+    return static_cast<uint32_t>(((word ^ length) * seed) >> (64 - HASH_BITS));
+}
+
+constexpr uint64_t findHashSeed()
+{
+    // 从一个奇数开始按黄金分割常数步进，依次尝试
+    uint64_t seed = 0x9E3779B97F4A7C15ull;
+    for (int attempt = 0; attempt < 100000; attempt++, seed += 0x9E3779B97F4A7C16ull)
+    {
+        bool used[HASH_TABLE_SIZE] = {};
+        bool collision = false;
+        for (const FieldDesc& field : FIELDS)
+        {
+            uint32_t slot = hashSlot(keyWord(field.name), field.name.size(), seed);
+            if (used[slot])
+            {
+                collision = true;
+                break;
+            }
+            used[slot] = true;
+        }
+        if (!collision)
+        {
+            return seed;
+        }
+    }
+    return 0;
+}
+
+constexpr uint64_t HASH_SEED = findHashSeed();
+static_assert(HASH_SEED != 0, "字段表找不到无冲突的哈希乘数，请增大 HASH_BITS");
+
+// 槽位 -> 字段编号，空槽为-1
+constexpr std::array<int8_t, HASH_TABLE_SIZE> buildHashTable()
+{
+    std::array<int8_t, HASH_TABLE_SIZE> table{};
+    for (auto& slot : table)
+    {
+        slot = -1;
+    }
+    for (int i = 0; i < FIELD_COUNT; i++)
+    {
+        table[hashSlot(keyWord(FIELDS[i].name), FIELDS[i].name.size(), HASH_SEED)] = static_cast<int8_t>(i);
+    }
+    return table;
+}
+
+constexpr std::array<int8_t, HASH_TABLE_SIZE> HASH_TABLE = buildHashTable();
+
+// 各字段键名的 keyWord，运行时比较一次整数即可确认命中（不超过8字节的键名）
+constexpr std::array<uint64_t, FIELD_COUNT> buildFieldWords()
+{
+    std::array<uint64_t, FIELD_COUNT> words{};
+    for (int i = 0; i < FIELD_COUNT; i++)
+    {
+        words[i] = keyWord(FIELDS[i].name);
+    }
+    return words;
+}
+
+constexpr std::array<uint64_t, FIELD_COUNT> FIELD_WORDS = buildFieldWords();
+
+// ====================== 按8字节处理 ======================
+// 键名和数字都很短（通常不超过8个字符），一次读入8个字节用位运算找分隔符、转换数字，
+// 避免逐字节循环在变长字段上的分支预测失败
+constexpr uint64_t BYTES_01 = 0x0101010101010101ull;
+constexpr uint64_t BYTES_80 = 0x8080808080808080ull;
+
+// 读取8个字节，低地址在低位（与 keyWord() 一致）
+inline uint64_t loadWord(const char* p)
+{
+    uint64_t word;
+    memcpy(&word, p, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+    return word;
+}
+
+// 等于c的字节最高位置1（只保证最低的命中位准确，够用来找第一个分隔符）
+inline uint64_t matchBytes(uint64_t word, char c)
+{
+    uint64_t v = word ^ (BYTES_01 * static_cast<uint8_t>(c));
+    return (v - BYTES_01) & ~v & BYTES_80;
+}
+
+// 不是 '0'~'9' 的字节最高位置1
+inline uint64_t nonDigitBytes(uint64_t word)
+{
+    uint64_t x = word ^ (BYTES_01 * '0');
+    return (((x & 0x7F7F7F7F7F7F7F7Full) + 0x7676767676767676ull) | x) & BYTES_80;
+}
+
+// 前 n 个字节（1~8个ASCII数字）转成整数
+inline uint32_t digitsValue(uint64_t word, int n)
+{
+    // 左移后低位补0，相当于前导0，统一按8位数字转换
+    uint64_t v = (word & 0x0F0F0F0F0F0F0F0Full) << (8 * (8 - n));
+    v = (v * 10 + (v >> 8)) & 0x00FF00FF00FF00FFull;
+    v = (v * 100 + (v >> 16)) & 0x0000FFFF0000FFFFull;
+    return static_cast<uint32_t>(v * 10000 + (v >> 32));
+}
+
+// 从 p 开始连续数字的个数，剩余不足8字节或数字超过7位时返回-1（走逐字节路径）
+inline int countDigits(const char* p, const char* end, uint64_t& word)
+{
+    if (end - p < 8)
+    {
+        return -1;
+    }
+    word = loadWord(p);
+    uint64_t mask = nonDigitBytes(word);
+    if (mask == 0)
+    {
+        return -1;
+    }
+    return __builtin_ctzll(mask) >> 3;
+}
+
+inline uint64_t loadKeyWord(const char* key, size_t length, const char* limit)
+{
+    if (length >= 8 || limit - key >= 8)
+    {
+        uint64_t word = loadWord(key);
+        return length >= 8 ? word : word & ((1ull << (8 * length)) - 1);
+    }
+    return keyWord(std::string_view(key, length));
+}
+
+/**
+ * @brief 查表确认键名，未知键名返回-1
+ * @param word 键名前8个字节（keyWord）
+ */
+inline int lookupField(uint64_t word, const char* key, size_t length)
+{
+    int index = HASH_TABLE[hashSlot(word, length, HASH_SEED)];
+    if (index < 0 || FIELDS[index].name.size() != length || FIELD_WORDS[index] != word)
+    {
+        return -1;
+    }
+    // 超过8字节的键名还要比较剩余部分
+    if (length > 8 && memcmp(FIELDS[index].name.data() + 8, key + 8, length - 8) != 0)
+    {
+        return -1;
+    }
+    return index;
+}
+
+// ====================== 数值解析 ======================
+inline bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+inline const char* skipBlank(const char* p, const char* end)
+{
+    while (p < end && isBlank(*p))
+    {
+        p++;
+    }
+    return p;
+}
+
+// 跳过正负号，返回是否为负
+inline bool skipSign(const char*& p, const char* end)
+{
+    if (p < end && (*p == '-' || *p == '+'))
+    {
+        return *p++ == '-';
+    }
+    return false;
+}
+
+// 10的幂，float可精确表示
+constexpr float POW10[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f};
+
+/**
+ * @brief 从 p 开始解析十进制整数，next 返回数字之后的位置
+ */
+__attribute__((always_inline)) inline ParseStatus parseInteger(const char* p, const char* end, int64_t min, int64_t max, int64_t& out, const char*& next)
+{
+    bool negative = skipSign(p, end);
+
+    uint64_t value = 0;
+    uint64_t word = 0;
+    int count = countDigits(p, end, word);
+    if (count >= 0)
+    {
+        // 快速路径：8字节内遇到非数字
+        if (count > 0)
+        {
+            value = digitsValue(word, count);
+        }
+        p += count;
+    }
+    else
+    {
+        count = 0;
+        while (p < end && static_cast<unsigned>(*p - '0') < 10)
+        {
+            value = value * 10 + static_cast<unsigned>(*p - '0');
+            p++;
+            // 超过18位必然越界，提前结束避免uint64溢出
+            if (++count > 18)
+            {
+                while (p < end && static_cast<unsigned>(*p - '0') < 10)
+                {
+                    p++;
+                }
+                next = p;
+                return ParseStatus::OUT_OF_RANGE;
+            }
+        }
+    }
+    next = p;
+    if (count == 0)
+    {
+        return ParseStatus::INVALID_NUMBER;
+    }
+    int64_t signed_value = negative ? -static_cast<int64_t>(value) : static_cast<int64_t>(value);
+    if (signed_value < min || signed_value > max)
+    {
+        return ParseStatus::OUT_OF_RANGE;
+    }
+    out = signed_value;
+    return ParseStatus::OK;
+}
+
+/**
+ * @brief 从 p 开始解析浮点数，next 返回数字之后的位置
+ */
+ParseStatus parseFloat(const char* p, const char* end, float& out, const char*& next)
+{
+    bool negative = skipSign(p, end);
+
+    // 快速路径：不超过7位有效数字、没有指数的十进制小数。
+    // 尾数和10的幂都能被float精确表示，一次除法得到正确舍入的结果
+    uint64_t word = 0;
+    int int_digits = countDigits(p, end, word);
+    if (int_digits > 0)
+    {
+        uint32_t mantissa = digitsValue(word, int_digits);
+        const char* q = p + int_digits;
+        int frac_digits = 0;
+        if (q < end && *q == '.')
+        {
+            frac_digits = countDigits(q + 1, end, word);
+            if (frac_digits > 0 && int_digits + frac_digits <= 7)
+            {
+                mantissa = mantissa * static_cast<uint32_t>(POW10[frac_digits]) + digitsValue(word, frac_digits);
+                q += 1 + frac_digits;
+            }
+            else
+            {
+                frac_digits = -1;
+            }
+        }
+        if (frac_digits >= 0 && int_digits <= 7 && (q == end || (*q != 'e' && *q != 'E')))
+        {
+            float value = static_cast<float>(mantissa) / POW10[frac_digits];
+            out = negative ? -value : value;
+            next = q;
+            return ParseStatus::OK;
+        }
+    }
+
+    // 一般路径（from_chars 不接受前导 '+'，只把 '-' 还回去）
+    if (negative)
+    {
+        p--;
+    }
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    float value = 0;
+    std::from_chars_result result = std::from_chars(p, end, value);
+    next = result.ptr;
+    if (result.ec == std::errc::result_out_of_range)
+    {
+        return ParseStatus::OUT_OF_RANGE;
+    }
+    if (result.ec != std::errc())
+    {
+        return ParseStatus::INVALID_NUMBER;
+    }
+    out = value;
+    return ParseStatus::OK;
+#else
+    // 旧版libstdc++（GCC 11以前）没有浮点 from_chars：拷到栈上补 '\0' 后用 strtof
+    char buffer[64];
+    size_t length = 0;
+    while (p + length < end && length < sizeof(buffer) - 1 && p[length] != ',' && !isBlank(p[length]))
+    {
+        buffer[length] = p[length];
+        length++;
+    }
+    buffer[length] = '\0';
+    char* parsed_end = buffer;
+    errno = 0;
+    float value = strtof(buffer, &parsed_end);
+    next = p + (parsed_end - buffer);
+    if (parsed_end == buffer)
+    {
+        return ParseStatus::INVALID_NUMBER;
+    }
+    if (errno == ERANGE)
+    {
+        return ParseStatus::OUT_OF_RANGE;
+    }
+    out = value;
+    return ParseStatus::OK;
+#endif
+}
+
+/**
+ * @brief 解析 [p, end) 开头的数值并写入字段，next 返回数值之后的位置
+ */
+__attribute__((always_inline)) inline ParseStatus storeField(DataProcessing& target, const FieldDesc& desc, const char* p, const char* end,
+                       const char*& next)
+{
+    char* address = reinterpret_cast<char*>(&target) + desc.offset;
+    int64_t integer = 0;
+    ParseStatus status;
+    switch (desc.kind)
+    {
+        case FieldKind::U8:
+            status = parseInteger(p, end, 0, 255, integer, next);
+            if (status == ParseStatus::OK)
+            {
+                *reinterpret_cast<uint8_t*>(address) = static_cast<uint8_t>(integer);
+            }
+            return status;
+        case FieldKind::I16:
+            status = parseInteger(p, end, -32768, 32767, integer, next);
+            if (status == ParseStatus::OK)
+            {
+                int16_t value = static_cast<int16_t>(integer);
+                memcpy(address, &value, sizeof(value));
+            }
+            return status;
+        default:
+        {
+            float value = 0;
+            status = parseFloat(p, end, value, next);
+            if (status == ParseStatus::OK)
+            {
+                memcpy(address, &value, sizeof(value));
+            }
+            return status;
+        }
+    }
+}
+
+} // namespace
+
+// ====================== 解析结果 ======================
+const char* parseStatusName(ParseStatus status)
+{
+    switch (status)
+    {
+        case ParseStatus::OK:
+            return "ok";
+        case ParseStatus::MISSING_VALUE:
+            return "missing_value";
+        case ParseStatus::EMPTY_KEY:
+            return "empty_key";
+        case ParseStatus::INVALID_NUMBER:
+            return "invalid_number";
+        case ParseStatus::OUT_OF_RANGE:
+            return "out_of_range";
+        case ParseStatus::SYNTAX_ERROR:
+            return "syntax_error";
+    }
+    return "unknown";
+}
+
+void ParseResult::fail(ParseStatus error, uint32_t offset)
+{
+    if (status == ParseStatus::OK)
+    {
+        status = error;
+        error_offset = offset;
+    }
+    errors++;
+}
+
+// ====================== 字段查找 ======================
+int findTelemetryField(std::string_view key)
+{
+    if (key.empty())
+    {
+        return -1;
+    }
+    const char* limit = key.data() + key.size();
+    return lookupField(loadKeyWord(key.data(), key.size(), limit), key.data(), key.size());
+}
+
+// ====================== 字段赋值 ======================
+ParseStatus setTelemetryField(DataProcessing& target, int field, std::string_view value)
+{
+    if (field < 0 || field >= FIELD_COUNT)
+    {
+        return ParseStatus::EMPTY_KEY;
+    }
+    const char* end = value.data() + value.size();
+    const char* next = nullptr;
+    ParseStatus status = storeField(target, FIELDS[field], skipBlank(value.data(), end), end, next);
+    // 数值后只允许空白
+    if (status == ParseStatus::OK && skipBlank(next, end) != end)
+    {
+        return ParseStatus::INVALID_NUMBER;
+    }
+    return status;
+}
+
+// ====================== key=value 解析 ======================
+ParseResult parseKeyValue(std::string_view text, DataProcessing& target)
+{
+    ParseResult result;
+    const char* const base = text.data();
+    const char* const end = base + text.size();
+    const char* p = base;
+
+    while (p < end)
+    {
+        const char* item = p;
+        p = skipBlank(p, end);
+
+        // 读键名：先在8字节内找 '=' 或 ','，找不到再逐字节
+        const char* key = p;
+        uint64_t key_word = 0;
+        bool have_word = false;
+        if (end - p >= 8)
+        {
+            uint64_t word = loadWord(p);
+            uint64_t stop = matchBytes(word, '=') | matchBytes(word, ',');
+            if (stop != 0)
+            {
+                size_t length = __builtin_ctzll(stop) >> 3;
+                key_word = length == 0 ? 0 : word & (~0ull >> (64 - 8 * length));
+                p += length;
+                have_word = true;
+            }
+        }
+        if (!have_word)
+        {
+            while (p < end && *p != '=' && *p != ',')
+            {
+                p++;
+            }
+        }
+        // 键名后的空白（键名中间有空白时查表会失败，按未知键处理）
+        const char* key_end = p;
+        while (key_end > key && isBlank(key_end[-1]))
+        {
+            key_end--;
+            have_word = false;
+        }
+        size_t key_length = static_cast<size_t>(key_end - key);
+
+        if (p == end || *p == ',')
+        {
+            // 空字段（",,"或结尾换行）直接跳过，有内容但没有 '=' 记为错误
+            if (key_length != 0)
+            {
+                result.fail(ParseStatus::MISSING_VALUE, static_cast<uint32_t>(item - base));
+            }
+            p = p < end ? p + 1 : end;
+            continue;
+        }
+
+        // 此时 *p == '='
+        const char* value = skipBlank(p + 1, end);
+        const char* next = value;
+        ParseStatus status = ParseStatus::OK;
+        if (key_length == 0)
+        {
+            status = ParseStatus::EMPTY_KEY;
+            next = end;
+        }
+        else
+        {
+            if (!have_word)
+            {
+                key_word = loadKeyWord(key, key_length, end);
+            }
+            int index = lookupField(key_word, key, key_length);
+            if (index < 0)
+            {
+                result.unknown++;
+                next = end;
+            }
+            else
+            {
+                status = storeField(target, FIELDS[index], value, end, next);
+                // 数值后只允许空白，然后是 ',' 或结尾
+                if (status == ParseStatus::OK && next < end && *next != ',')
+                {
+                    next = skipBlank(next, end);
+                    if (next < end && *next != ',')
+                    {
+                        status = ParseStatus::INVALID_NUMBER;
+                    }
+                }
+                if (status == ParseStatus::OK)
+                {
+                    result.fields++;
+                    result.written |= 1u << index;
+                }
+            }
+        }
+
+        if (status != ParseStatus::OK)
+        {
+            result.fail(status, static_cast<uint32_t>((status == ParseStatus::EMPTY_KEY ? item : value) - base));
+        }
+
+        // 跳到下一个字段；正常情况下 next 已经停在 ',' 上
+        if (next >= end || *next != ',')
+        {
+            const void* comma = memchr(value, ',', static_cast<size_t>(end - value));
+            next = comma != nullptr ? static_cast<const char*>(comma) : end;
+        }
+        p = next < end ? next + 1 : end;
+    }
+    return result;
+}
@@ -0,0 +1,87 @@
+#ifndef TELEMETRY_FIELDS_H
+#define TELEMETRY_FIELDS_H
+
+#include <cstdint>
+#include <string_view>
+
+class DataProcessing;
+
+// ====================== 解析结果 ======================
+/**
+ * @brief 文本遥测解析状态
+ */
+enum class ParseStatus : uint8_t {
+    OK,
+    // 字段缺少 '='
+    MISSING_VALUE,
+    // 键名为空
+    EMPTY_KEY,
+    // 值不是合法数字（含多余字符）
+    INVALID_NUMBER,
+    // 数值超出字段类型范围
+    OUT_OF_RANGE,
+    // 格式错误（JSON等结构化格式使用）
+    SYNTAX_ERROR,
+};
+// 状态数量
+const int PARSE_STATUS_COUNT = 6;
+
+/**
+ * @brief 解析状态名称，用于日志
+ */
+const char* parseStatusName(ParseStatus status);
+
+/**
+ * @brief 一次文本解析的结果
+ * @note 出错的字段被跳过，其余字段照常写入；status/error_offset 记录第一个错误
+ */
+struct ParseResult {
+    // 第一个错误的类型
+    ParseStatus status = ParseStatus::OK;
+    // 第一个错误在输入中的字节偏移
+    uint32_t error_offset = 0;
+    // 成功写入的字段数
+    uint16_t fields = 0;
+    // 成功写入的字段按字段编号（findTelemetryField）的位掩码
+    uint32_t written = 0;
+    // 未知键名（忽略）的字段数
+    uint16_t unknown = 0;
+    // 出错的字段数
+    uint16_t errors = 0;
+
+    bool ok() const { return status == ParseStatus::OK; }
+    // 记录一个错误，只保留第一个错误的位置
+    void fail(ParseStatus error, uint32_t offset);
+};
+
+// ====================== 字段表 ======================
+// 支持的字段：id, roll, pitch, yaw, x, y, z, batt, pid0_kp ~ pid3_kd
+// 键名到字段的映射是编译期生成的完美哈希，查找只需一次哈希和一次比较
+
+/**
+ * @brief 按键名查找字段
+ * @return 字段编号，未知键名返回-1
+ */
+int findTelemetryField(std::string_view key);
+
+// 字段编号按上面的顺序：id=0, roll/pitch/yaw=1~3, x/y/z=4~6, batt=7, pid0_kp~pid3_kd=8~19
+// ParseResult::written 中姿态、位置字段的位
+static const uint32_t TELEMETRY_ATTITUDE_FIELDS = 0x0Eu;
+static const uint32_t TELEMETRY_POSITION_FIELDS = 0x70u;
+
+/**
+ * @brief 把文本数值写入字段
+ * @param target 目标无人机数据
+ * @param field findTelemetryField() 返回的字段编号
+ * @param value 数值文本，整数字段用整数，x/y/z为浮点数
+ * @return 数值非法或越界时返回对应错误，字段保持原值
+ */
+ParseStatus setTelemetryField(DataProcessing& target, int field, std::string_view value);
+
+/**
+ * @brief 解析 "key1=value1,key2=value2,..." 格式的遥测文本
+ * @note 单次遍历，不分配内存，不抛异常；未知键名忽略
+ */
+ParseResult parseKeyValue(std::string_view text, DataProcessing& target);
+
+#endif // TELEMETRY_FIELDS_H
@@ -0,0 +1,465 @@
+#include "TelemetryJson.h"
+#include "../data_processing/data_processing.h"
+#include <cstring>
+
+// ====================== JSON扫描 ======================
+namespace {
+
+/**
+ * @brief 在原始字节上顺序读取JSON记号
+ * @note 只做遥测解码需要的部分：字符串不做转义还原（带转义的键名按未知键处理），
+ *       数字只校验语法并返回原文，由 setTelemetryField() 转换
+ */
+class JsonReader
+{
+public:
+    explicit JsonReader(std::string_view text)
+        : base_(text.data()), p_(text.data()), end_(text.data() + text.size())
+    {
+    }
+
+    const char* position() const { return p_; }
+    uint32_t offset(const char* at) const { return static_cast<uint32_t>(at - base_); }
+
+    // 出错位置（第一次出错时记录）
+    bool failed() const { return error_ != nullptr; }
+    const char* errorPosition() const { return error_; }
+
+    void skipSpace()
+    {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\r' || *p_ == '\n'))
+        {
+            p_++;
+        }
+    }
+
+    // 跳过空白后，若下一个字符是 c 则读掉并返回true
+    bool consume(char c)
+    {
+        skipSpace();
+        if (p_ < end_ && *p_ == c)
+        {
+            p_++;
+            return true;
+        }
+        return false;
+    }
+
+    // 跳过空白后，下一个字符必须是 c
+    bool expect(char c)
+    {
+        if (consume(c))
+        {
+            return true;
+        }
+        return fail();
+    }
+
+    // 跳过空白后看下一个字符，到结尾返回 '\0'
+    char peek()
+    {
+        skipSpace();
+        return p_ < end_ ? *p_ : '\0';
+    }
+
+    /**
+     * @brief 读取字符串，out 为引号内的原文
+     * @param escaped 字符串中是否有转义
+     */
+    bool readString(std::string_view& out, bool& escaped)
+    {
+        if (!expect('"'))
+        {
+            return false;
+        }
+        const char* start = p_;
+        escaped = false;
+        while (p_ < end_)
+        {
+            char c = *p_;
+            if (c == '"')
+            {
+                out = std::string_view(start, static_cast<size_t>(p_ - start));
+                p_++;
+                return true;
+            }
+            if (c == '\\')
+            {
+                // \uXXXX 的4个十六进制字符不会是引号或反斜杠，按普通字符继续扫描即可
+                escaped = true;
+                p_++;
+            }
+            p_++;
+        }
+        return fail();
+    }
+
+    // 读取 "key" :
+    bool readKey(std::string_view& key, bool& escaped)
+    {
+        return readString(key, escaped) && expect(':');
+    }
+
+    /**
+     * @brief 读取一个数字，out 为数字原文
+     * @note 按JSON语法校验：-?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+     */
+    bool readNumber(std::string_view& out)
+    {
+        skipSpace();
+        const char* start = p_;
+        if (p_ < end_ && *p_ == '-')
+        {
+            p_++;
+        }
+        if (p_ < end_ && *p_ == '0')
+        {
+            p_++;
+        }
+        else if (!skipDigits())
+        {
+            return fail();
+        }
+        if (p_ < end_ && *p_ == '.')
+        {
+            p_++;
+            if (!skipDigits())
+            {
+                return fail();
+            }
+        }
+        if (p_ < end_ && (*p_ == 'e' || *p_ == 'E'))
+        {
+            p_++;
+            if (p_ < end_ && (*p_ == '+' || *p_ == '-'))
+            {
+                p_++;
+            }
+            if (!skipDigits())
+            {
+                return fail();
+            }
+        }
+        out = std::string_view(start, static_cast<size_t>(p_ - start));
+        return true;
+    }
+
+    /**
+     * @brief 跳过任意一个值（含嵌套对象和数组）
+     */
+    bool skipValue(int depth)
+    {
+        if (depth > TELEMETRY_JSON_MAX_DEPTH)
+        {
+            return fail();
+        }
+        std::string_view text;
+        bool escaped = false;
+        switch (peek())
+        {
+            case '{':
+                p_++;
+                if (consume('}'))
+                {
+                    return true;
+                }
+                do
+                {
+                    if (!readKey(text, escaped) || !skipValue(depth + 1))
+                    {
+                        return false;
+                    }
+                } while (consume(','));
+                return expect('}');
+            case '[':
+                p_++;
+                if (consume(']'))
+                {
+                    return true;
+                }
+                do
+                {
+                    if (!skipValue(depth + 1))
+                    {
+                        return false;
+                    }
+                } while (consume(','));
+                return expect(']');
+            case '"':
+                return readString(text, escaped);
+            case 't':
+                return readLiteral("true", 4);
+            case 'f':
+                return readLiteral("false", 5);
+            case 'n':
+                return readLiteral("null", 4);
+            default:
+                return readNumber(text);
+        }
+    }
+
+private:
+    const char* base_;
+    const char* p_;
+    const char* end_;
+    const char* error_ = nullptr;
+
+    bool fail()
+    {
+        if (error_ == nullptr)
+        {
+            error_ = p_;
+        }
+        return false;
+    }
+
+    // 至少一位数字
+    bool skipDigits()
+    {
+        const char* start = p_;
+        while (p_ < end_ && static_cast<unsigned>(*p_ - '0') < 10)
+        {
+            p_++;
+        }
+        return p_ != start;
+    }
+
+    bool readLiteral(const char* literal, size_t length)
+    {
+        if (static_cast<size_t>(end_ - p_) >= length && memcmp(p_, literal, length) == 0)
+        {
+            p_ += length;
+            return true;
+        }
+        return fail();
+    }
+};
+
+// 键值对格式PID字段 pidN_kX 在 flat_values 中的位置，不是PID字段返回-1
+int flatPidSlot(std::string_view key)
+{
+    if (key.size() != 7 || key.compare(0, 3, "pid") != 0 || key[3] < '0' || key[3] > '3')
+    {
+        return -1;
+    }
+    int base = (key[3] - '0') * 3;
+    switch (key[6])
+    {
+        case 'p':
+            return base;
+        case 'i':
+            return base + 1;
+        default:
+            return base + 2;
+    }
+}
+
+/**
+ * @brief 读取一个数值并写入字段；值不是数字时跳过并记为错误
+ */
+bool decodeField(JsonReader& reader, DataProcessing& target, int field, ParseResult& result)
+{
+    if (reader.peek() == '-' || static_cast<unsigned>(reader.peek() - '0') < 10)
+    {
+        std::string_view number;
+        if (!reader.readNumber(number))
+        {
+            return false;
+        }
+        ParseStatus status = setTelemetryField(target, field, number);
+        if (status == ParseStatus::OK)
+        {
+            result.fields++;
+            result.written |= 1u << field;
+        }
+        else
+        {
+            result.fail(status, reader.offset(number.data()));
+        }
+        return true;
+    }
+    // 字符串、布尔、null、对象等
+    const char* value = reader.position();
+    if (!reader.skipValue(1))
+    {
+        return false;
+    }
+    result.fail(ParseStatus::INVALID_NUMBER, reader.offset(value));
+    return true;
+}
+
+/**
+ * @brief 解码数组格式的PID参数："pid": [{"kp":1,"ki":2,"kd":3}, ...]
+ * @note 最多处理4个电机，多余元素和非对象元素跳过
+ */
+bool decodePidArray(JsonReader& reader, DataProcessing& target, ParseResult& result)
+{
+    if (!reader.expect('['))
+    {
+        return false;
+    }
+    if (reader.consume(']'))
+    {
+        return true;
+    }
+    // 复用字段表：把 kp/ki/kd 拼成 pidN_kX 查找
+    char name[] = {'p', 'i', 'd', '0', '_', 'k', 'p'};
+    for (int index = 0;; index++)
+    {
+        if (index >= 4 || reader.peek() != '{')
+        {
+            if (!reader.skipValue(2))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            reader.consume('{');
+            if (!reader.consume('}'))
+            {
+                do
+                {
+                    std::string_view key;
+                    bool escaped = false;
+                    if (!reader.readKey(key, escaped))
+                    {
+                        return false;
+                    }
+                    int field = -1;
+                    if (!escaped && key.size() == 2 && key[0] == 'k')
+                    {
+                        name[3] = static_cast<char>('0' + index);
+                        name[6] = key[1];
+                        field = findTelemetryField(std::string_view(name, sizeof(name)));
+                    }
+                    if (field < 0)
+                    {
+                        result.unknown++;
+                        if (!reader.skipValue(3))
+                        {
+                            return false;
+                        }
+                    }
+                    else if (!decodeField(reader, target, field, result))
+                    {
+                        return false;
+                    }
+                } while (reader.consume(','));
+                if (!reader.expect('}'))
+                {
+                    return false;
+                }
+            }
+        }
+        if (!reader.consume(','))
+        {
+            return reader.expect(']');
+        }
+    }
+}
+
+/**
+ * @brief 解码顶层对象，写入 target
+ */
+bool decodeObject(JsonReader& reader, DataProcessing& target, ParseResult& result)
+{
+    // 键值对格式的PID先记下数值原文，整条消息读完且没有数组格式时再写入
+    std::string_view flat_values[12];
+    int flat_fields[12];
+    bool pid_array = false;
+
+    if (!reader.expect('{'))
+    {
+        return false;
+    }
+    if (!reader.consume('}'))
+    {
+        do
+        {
+            std::string_view key;
+            bool escaped = false;
+            if (!reader.readKey(key, escaped))
+            {
+                return false;
+            }
+            int field = escaped ? -1 : findTelemetryField(key);
+            int slot = field < 0 ? -1 : flatPidSlot(key);
+
+            if (field < 0 && !escaped && key == "pid" && reader.peek() == '[')
+            {
+                if (!decodePidArray(reader, target, result))
+                {
+                    return false;
+                }
+                pid_array = true;
+            }
+            else if (field < 0)
+            {
+                result.unknown++;
+                if (!reader.skipValue(1))
+                {
+                    return false;
+                }
+            }
+            else if (slot >= 0 && (reader.peek() == '-' || static_cast<unsigned>(reader.peek() - '0') < 10))
+            {
+                if (!reader.readNumber(flat_values[slot]))
+                {
+                    return false;
+                }
+                flat_fields[slot] = field;
+            }
+            else if (!decodeField(reader, target, field, result))
+            {
+                return false;
+            }
+        } while (reader.consume(','));
+        if (!reader.expect('}'))
+        {
+            return false;
+        }
+    }
+
+    if (!pid_array)
+    {
+        for (int slot = 0; slot < 12; slot++)
+        {
+            if (flat_values[slot].data() == nullptr)
+            {
+                continue;
+            }
+            ParseStatus status = setTelemetryField(target, flat_fields[slot], flat_values[slot]);
+            if (status == ParseStatus::OK)
+            {
+                result.fields++;
+            }
+            else
+            {
+                result.fail(status, reader.offset(flat_values[slot].data()));
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+// ====================== JSON遥测解码 ======================
+ParseResult parseTelemetryJson(std::string_view json, DataProcessing& target)
+{
+    // 先写到副本上，整条消息语法正确才提交；DataProcessing 只有几十字节，拷贝开销可以忽略
+    DataProcessing decoded = target;
+    ParseResult result;
+    JsonReader reader(json);
+    if (!decodeObject(reader, decoded, result))
+    {
+        // 格式错误时已写入的字段作废，只报告错误位置
+        ParseResult error;
+        error.fail(ParseStatus::SYNTAX_ERROR, reader.offset(reader.errorPosition()));
+        return error;
+    }
+    // 顶层对象之后的内容（如结尾的换行或 '\0'）忽略，与 jsoncpp 默认行为一致
+    target = decoded;
+    return result;
+}
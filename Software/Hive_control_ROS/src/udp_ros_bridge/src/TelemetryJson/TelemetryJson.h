@@ -0,0 +1,33 @@
+#ifndef TELEMETRY_JSON_H
+#define TELEMETRY_JSON_H
+
+#include "../TelemetryFields/TelemetryFields.h"
+#include <cstdint>
+#include <string_view>
+
+class DataProcessing;
+
+// ====================== JSON遥测解码 ======================
+// 直接扫描数据报中的JSON文本，边读边写入无人机数据，不构建 Json::Value。
+// 字段名和数值复用 findTelemetryField() / setTelemetryField()，与 key=value 格式保持一致。
+//
+// 支持的两种PID格式（与 DataProcessing::ParseData(const Json::Value&) 相同）：
+//   1. 数组格式:   "pid": [{"kp":1,"ki":2,"kd":3}, ...]
+//   2. 键值对格式: "pid0_kp":1, "pid0_ki":2, "pid0_kd":3, ...
+// 同一条消息里同时出现时以数组格式为准，键值对格式的PID字段被忽略。
+
+// JSON嵌套深度上限，超过按格式错误处理
+constexpr int TELEMETRY_JSON_MAX_DEPTH = 32;
+
+/**
+ * @brief 解码一条JSON格式的遥测消息
+ * @param json 数据报内容，顶层必须是对象
+ * @param target 目标无人机数据
+ * @return 解析结果；未知键名及其值（含嵌套对象/数组）被跳过，
+ *         类型不符或越界的字段跳过并记入 errors
+ * @note 不分配内存，不抛异常。JSON格式错误（SYNTAX_ERROR）时 target 保持不变，
+ *       不会写入半条消息
+ */
+ParseResult parseTelemetryJson(std::string_view json, DataProcessing& target);
+
+#endif // TELEMETRY_JSON_H
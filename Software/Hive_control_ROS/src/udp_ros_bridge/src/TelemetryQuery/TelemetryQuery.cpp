@@ -0,0 +1,625 @@
+#include "TelemetryQuery.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+// ====================== 条件 ======================
+static const char* COLUMN_NAMES[TELEMETRY_COLUMN_COUNT] = {"time", "slot", "roll", "pitch", "yaw",
+                                                           "x",    "y",    "z",    "id",    "batt"};
+
+const char* telemetryColumnName(int column)
+{
+    return column >= 0 && column < TELEMETRY_COLUMN_COUNT ? COLUMN_NAMES[column] : "?";
+}
+
+bool parsePredicate(const std::string& text, ColumnPredicate& out)
+{
+    size_t op_begin = text.find_first_of("<>=!");
+    if (op_begin == std::string::npos || op_begin == 0)
+    {
+        return false;
+    }
+    std::string name = text.substr(0, op_begin);
+    size_t op_end = op_begin + 1;
+    if (op_end < text.size() && text[op_end] == '=')
+    {
+        op_end++;
+    }
+    std::string op = text.substr(op_begin, op_end - op_begin);
+    std::string value = text.substr(op_end);
+
+    int column = -1;
+    for (int c = TELEMETRY_SLOT; c < TELEMETRY_COLUMN_COUNT; c++)
+    {
+        if (name == COLUMN_NAMES[c])
+        {
+            column = c;
+        }
+    }
+    if (column < 0 || value.empty())
+    {
+        return false;
+    }
+    if (op == "<") out.op = CompareOp::LESS;
+    else if (op == "<=") out.op = CompareOp::LESS_EQUAL;
+    else if (op == ">") out.op = CompareOp::GREATER;
+    else if (op == ">=") out.op = CompareOp::GREATER_EQUAL;
+    else if (op == "=" || op == "==") out.op = CompareOp::EQUAL;
+    else if (op == "!=") out.op = CompareOp::NOT_EQUAL;
+    else return false;
+
+    char* end = nullptr;
+    float number = strtof(value.c_str(), &end);
+    if (end == value.c_str() || *end != '\0')
+    {
+        return false;
+    }
+    out.column = static_cast<TelemetryColumn>(column);
+    out.value = number;
+    return true;
+}
+
+// ====================== 过滤 ======================
+namespace
+{
+
+/**
+ * @brief 计数器（多个工作线程累加）
+ */
+struct ScanCounters
+{
+    std::atomic<uint64_t> chunks{0};
+    std::atomic<uint64_t> chunks_pruned{0};
+    std::atomic<uint64_t> chunks_filtered{0};
+    std::atomic<uint64_t> rows_scanned{0};
+    std::atomic<uint64_t> rows_matched{0};
+
+    TelemetryScanStats snapshot() const
+    {
+        TelemetryScanStats stats;
+        stats.chunks = chunks.load();
+        stats.chunks_pruned = chunks_pruned.load();
+        stats.chunks_filtered = chunks_filtered.load();
+        stats.rows_scanned = rows_scanned.load();
+        stats.rows_matched = rows_matched.load();
+        return stats;
+    }
+};
+
+/**
+ * @brief 每个工作线程的缓冲，块与块之间复用
+ */
+struct ScanWorker
+{
+    std::vector<uint64_t> buffer;
+    std::vector<uint8_t> selected;
+    std::vector<uint32_t> rows;
+    // 槽位查找表，扫描指定了槽位时使用
+    std::vector<uint8_t> wanted;
+};
+
+/**
+ * @brief 按块统计区判断条件是否可能满足
+ * @note 比较写成“确定不满足”的形式，统计值为 NaN 时不跳过
+ */
+bool canMatch(const TelemetryChunkInfo& info, const ColumnPredicate& predicate)
+{
+    if (!info.has_stats)
+    {
+        return true;
+    }
+    float min = info.min[predicate.column];
+    float max = info.max[predicate.column];
+    float value = predicate.value;
+    switch (predicate.op)
+    {
+        case CompareOp::LESS: return !(min >= value);
+        case CompareOp::LESS_EQUAL: return !(min > value);
+        case CompareOp::GREATER: return !(max <= value);
+        case CompareOp::GREATER_EQUAL: return !(max < value);
+        case CompareOp::EQUAL: return !(value < min || value > max);
+        case CompareOp::NOT_EQUAL: return !(min == value && max == value);
+    }
+    return true;
+}
+
+// 对整列做同一种比较，结果写入（first）或与进选择向量；循环体无分支，可向量化
+template <typename T, typename Compare>
+void filterColumn(const T* values, size_t count, float threshold, bool first, uint8_t* selected, Compare compare)
+{
+    if (first)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            selected[i] = compare(static_cast<float>(values[i]), threshold);
+        }
+        return;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        selected[i] &= compare(static_cast<float>(values[i]), threshold);
+    }
+}
+
+template <typename T>
+void filterColumn(const T* values, size_t count, const ColumnPredicate& predicate, bool first, uint8_t* selected)
+{
+    float value = predicate.value;
+    switch (predicate.op)
+    {
+        case CompareOp::LESS:
+            filterColumn(values, count, value, first, selected, [](float a, float b) { return a < b; });
+            break;
+        case CompareOp::LESS_EQUAL:
+            filterColumn(values, count, value, first, selected, [](float a, float b) { return a <= b; });
+            break;
+        case CompareOp::GREATER:
+            filterColumn(values, count, value, first, selected, [](float a, float b) { return a > b; });
+            break;
+        case CompareOp::GREATER_EQUAL:
+            filterColumn(values, count, value, first, selected, [](float a, float b) { return a >= b; });
+            break;
+        case CompareOp::EQUAL:
+            filterColumn(values, count, value, first, selected, [](float a, float b) { return a == b; });
+            break;
+        case CompareOp::NOT_EQUAL:
+            filterColumn(values, count, value, first, selected, [](float a, float b) { return a != b; });
+            break;
+    }
+}
+
+void filterPredicate(const TelemetryColumns& columns, const ColumnPredicate& predicate, bool first,
+                     uint8_t* selected)
+{
+    size_t count = columns.rows;
+    switch (predicate.column)
+    {
+        case TELEMETRY_SLOT: filterColumn(columns.slot, count, predicate, first, selected); break;
+        case TELEMETRY_ROLL: filterColumn(columns.roll, count, predicate, first, selected); break;
+        case TELEMETRY_PITCH: filterColumn(columns.pitch, count, predicate, first, selected); break;
+        case TELEMETRY_YAW: filterColumn(columns.yaw, count, predicate, first, selected); break;
+        case TELEMETRY_X: filterColumn(columns.x, count, predicate, first, selected); break;
+        case TELEMETRY_Y: filterColumn(columns.y, count, predicate, first, selected); break;
+        case TELEMETRY_Z: filterColumn(columns.z, count, predicate, first, selected); break;
+        case TELEMETRY_ID: filterColumn(columns.id, count, predicate, first, selected); break;
+        case TELEMETRY_BATT: filterColumn(columns.batt, count, predicate, first, selected); break;
+        default: break;
+    }
+}
+
+void filterTime(const uint64_t* time, size_t count, uint64_t begin_ns, uint64_t end_ns, bool first,
+                uint8_t* selected)
+{
+    if (first)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            selected[i] = (time[i] >= begin_ns) & (time[i] <= end_ns);
+        }
+        return;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        selected[i] &= (time[i] >= begin_ns) & (time[i] <= end_ns);
+    }
+}
+
+// 选择向量转为行号列表（无分支写法）
+size_t compact(const uint8_t* selected, size_t count, uint32_t* rows)
+{
+    size_t matched = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        rows[matched] = static_cast<uint32_t>(i);
+        matched += selected[i];
+    }
+    return matched;
+}
+
+// 把第二次读取的列并入
+void mergeColumns(TelemetryColumns& into, const TelemetryColumns& from)
+{
+    into.time = from.time != nullptr ? from.time : into.time;
+    into.slot = from.slot != nullptr ? from.slot : into.slot;
+    into.roll = from.roll != nullptr ? from.roll : into.roll;
+    into.pitch = from.pitch != nullptr ? from.pitch : into.pitch;
+    into.yaw = from.yaw != nullptr ? from.yaw : into.yaw;
+    into.x = from.x != nullptr ? from.x : into.x;
+    into.y = from.y != nullptr ? from.y : into.y;
+    into.z = from.z != nullptr ? from.z : into.z;
+    into.id = from.id != nullptr ? from.id : into.id;
+    into.batt = from.batt != nullptr ? from.batt : into.batt;
+}
+
+/**
+ * @brief 扫描一个块：统计区剪枝、读条件列、过滤、读其余列、回调
+ */
+void scanChunk(const TelemetryRecordReader& reader, const TelemetryScan& scan, size_t chunk, int worker,
+               ScanWorker& state, ScanCounters& counters, const TelemetryQuery::BatchCallback& callback)
+{
+    const TelemetryChunkInfo& info = reader.getChunkInfo(chunk);
+    if (info.t_max < scan.begin_ns || info.t_min > scan.end_ns)
+    {
+        return;
+    }
+    counters.chunks.fetch_add(1, std::memory_order_relaxed);
+    bool possible = true;
+    for (const ColumnPredicate& predicate : scan.predicates)
+    {
+        possible = possible && canMatch(info, predicate);
+    }
+    if (possible && !scan.slots.empty() && info.has_stats)
+    {
+        possible = false;
+        for (uint16_t slot : scan.slots)
+        {
+            possible = possible || (slot >= info.min[TELEMETRY_SLOT] && slot <= info.max[TELEMETRY_SLOT]);
+        }
+    }
+    if (!possible)
+    {
+        counters.chunks_pruned.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // 第一次读取：条件涉及的列
+    bool whole_range = info.t_min >= scan.begin_ns && info.t_max <= scan.end_ns;
+    uint32_t filter_mask = 0;
+    for (const ColumnPredicate& predicate : scan.predicates)
+    {
+        filter_mask |= 1u << predicate.column;
+    }
+    filter_mask |= whole_range ? 0 : 1u << TELEMETRY_TIME;
+    filter_mask |= scan.slots.empty() ? 0 : 1u << TELEMETRY_SLOT;
+    TelemetryColumns columns;
+    if (filter_mask != 0 && !reader.readChunk(chunk, filter_mask, state.buffer, columns))
+    {
+        return;
+    }
+    size_t count = info.rows;
+    columns.rows = count;
+    counters.rows_scanned.fetch_add(count, std::memory_order_relaxed);
+    state.rows.resize(count);
+    size_t matched = count;
+    if (filter_mask == 0)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            state.rows[i] = static_cast<uint32_t>(i);
+        }
+    }
+    else
+    {
+        state.selected.resize(count);
+        uint8_t* selected = state.selected.data();
+        bool first = true;
+        if (!whole_range)
+        {
+            filterTime(columns.time, count, scan.begin_ns, scan.end_ns, first, selected);
+            first = false;
+        }
+        if (!scan.slots.empty())
+        {
+            const uint8_t* wanted = state.wanted.data();
+            for (size_t i = 0; i < count; i++)
+            {
+                selected[i] = first ? wanted[columns.slot[i]] : selected[i] & wanted[columns.slot[i]];
+            }
+            first = false;
+        }
+        for (const ColumnPredicate& predicate : scan.predicates)
+        {
+            filterPredicate(columns, predicate, first, selected);
+            first = false;
+        }
+        matched = compact(selected, count, state.rows.data());
+    }
+    if (matched == 0)
+    {
+        counters.chunks_filtered.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // 第二次读取：回调需要、过滤时还没读的列
+    uint32_t rest_mask = scan.columns & ~filter_mask;
+    if (rest_mask != 0)
+    {
+        TelemetryColumns rest;
+        if (!reader.readChunk(chunk, rest_mask, state.buffer, rest))
+        {
+            return;
+        }
+        mergeColumns(columns, rest);
+    }
+    counters.rows_matched.fetch_add(matched, std::memory_order_relaxed);
+    callback(worker, columns, state.rows.data(), matched);
+}
+
+void prepareWorker(const TelemetryScan& scan, ScanWorker& state)
+{
+    if (!scan.slots.empty())
+    {
+        state.wanted.assign(65536, 0);
+        for (uint16_t slot : scan.slots)
+        {
+            state.wanted[slot] = 1;
+        }
+    }
+}
+
+} // namespace
+
+// ====================== 扫描 ======================
+TelemetryScanStats TelemetryQuery::scan(const TelemetryScan& scan, int threads, const BatchCallback& callback) const
+{
+    size_t first = 0;
+    size_t last = 0;
+    reader.findChunks(scan.begin_ns, scan.end_ns, first, last);
+    threads = threads < 1 ? 1 : threads;
+    threads = static_cast<size_t>(threads) > last - first ? static_cast<int>(std::max<size_t>(1, last - first))
+                                                          : threads;
+    ScanCounters counters;
+    std::atomic<size_t> next{first};
+    auto run = [&](int worker) {
+        ScanWorker state;
+        prepareWorker(scan, state);
+        for (size_t chunk = next.fetch_add(1); chunk < last; chunk = next.fetch_add(1))
+        {
+            scanChunk(reader, scan, chunk, worker, state, counters, callback);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (int i = 1; i < threads; i++)
+    {
+        pool.emplace_back(run, i);
+    }
+    run(0);
+    for (std::thread& thread : pool)
+    {
+        thread.join();
+    }
+    return counters.snapshot();
+}
+
+// ====================== 最近距离 ======================
+namespace
+{
+
+struct Sample
+{
+    uint64_t time_ns;
+    float x;
+    float y;
+    float z;
+    uint16_t slot;
+    uint8_t id;
+    uint32_t bin;
+};
+
+// 每段的时长（取分格宽度的整数倍）
+const uint64_t SLICE_NS = 10ULL * 1000000000ULL;
+
+/**
+ * @brief 一个工作线程在各段之间复用的状态
+ */
+struct ApproachWorker
+{
+    ScanWorker scan;
+    std::vector<Sample> samples;
+    std::vector<Sample> sorted;
+    std::vector<uint32_t> bin_counts;
+    // 每个槽位在当前格中的样本下标，-1 表示没有
+    std::vector<int32_t> slot_sample;
+    // 上一格按x排好的点，作为本格插入排序的初始顺序
+    std::vector<uint16_t> order;
+    std::vector<Sample> points;
+    TelemetryApproach best;
+};
+
+// 原子地把共享最小值降到 value
+void lowerShared(std::atomic<float>& shared, float value)
+{
+    float current = shared.load(std::memory_order_relaxed);
+    while (value < current && !shared.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+/**
+ * @brief 处理一格：每架无人机取最后一个样本，按x插入排序后扫描线找最近的一对
+ */
+void closestInBin(const Sample* samples, size_t count, ApproachWorker& state, std::atomic<float>& shared)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        state.slot_sample[samples[i].slot] = static_cast<int32_t>(i);
+    }
+    // 上一格出现过的无人机按上一格的顺序放入，新出现的放在后面
+    state.points.clear();
+    for (uint16_t slot : state.order)
+    {
+        int32_t index = state.slot_sample[slot];
+        if (index >= 0)
+        {
+            state.points.push_back(samples[index]);
+            state.slot_sample[slot] = -2;
+        }
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        if (state.slot_sample[samples[i].slot] == static_cast<int32_t>(i))
+        {
+            state.points.push_back(samples[i]);
+        }
+        state.slot_sample[samples[i].slot] = -1;
+    }
+    std::vector<Sample>& points = state.points;
+    // 相邻两格位置变化很小，插入排序接近线性
+    for (size_t i = 1; i < points.size(); i++)
+    {
+        Sample point = points[i];
+        size_t j = i;
+        while (j > 0 && points[j - 1].x > point.x)
+        {
+            points[j] = points[j - 1];
+            j--;
+        }
+        points[j] = point;
+    }
+    state.order.clear();
+    for (const Sample& point : points)
+    {
+        state.order.push_back(point.slot);
+    }
+
+    float best = std::min(state.best.found ? state.best.distance : std::numeric_limits<float>::infinity(),
+                          shared.load(std::memory_order_relaxed));
+    for (size_t i = 1; i < points.size(); i++)
+    {
+        const Sample& a = points[i];
+        for (size_t j = i; j-- > 0 && a.x - points[j].x < best;)
+        {
+            const Sample& b = points[j];
+            float dy = a.y - b.y;
+            float dz = a.z - b.z;
+            if (std::fabs(dy) >= best || std::fabs(dz) >= best)
+            {
+                continue;
+            }
+            float dx = a.x - b.x;
+            float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+            if (distance < best)
+            {
+                best = distance;
+                state.best.found = true;
+                state.best.distance = distance;
+                state.best.time_ns = std::max(a.time_ns, b.time_ns);
+                state.best.slot_a = std::min(a.slot, b.slot);
+                state.best.slot_b = std::max(a.slot, b.slot);
+                state.best.id_a = a.slot < b.slot ? a.id : b.id;
+                state.best.id_b = a.slot < b.slot ? b.id : a.id;
+                lowerShared(shared, distance);
+            }
+        }
+    }
+}
+
+} // namespace
+
+TelemetryApproach TelemetryQuery::closestApproach(const TelemetryScan& scan, uint64_t bin_ns, int threads,
+                                                  TelemetryScanStats* stats) const
+{
+    TelemetryApproach result;
+    uint64_t begin_ns = std::max(scan.begin_ns, reader.getBeginNs());
+    uint64_t end_ns = std::min(scan.end_ns, reader.getEndNs());
+    if (reader.getChunkCount() == 0 || begin_ns > end_ns || bin_ns == 0)
+    {
+        return result;
+    }
+    uint64_t bins_per_slice = std::max<uint64_t>(1, SLICE_NS / bin_ns);
+    uint64_t slice_ns = bins_per_slice * bin_ns;
+    size_t slices = static_cast<size_t>((end_ns - begin_ns) / slice_ns + 1);
+    threads = threads < 1 ? 1 : threads;
+    threads = static_cast<size_t>(threads) > slices ? static_cast<int>(slices) : threads;
+
+    TelemetryScan slice_scan = scan;
+    slice_scan.columns = (1u << TELEMETRY_TIME) | (1u << TELEMETRY_SLOT) | (1u << TELEMETRY_X) |
+                         (1u << TELEMETRY_Y) | (1u << TELEMETRY_Z) | (1u << TELEMETRY_ID);
+    ScanCounters counters;
+    std::atomic<size_t> next{0};
+    std::atomic<float> shared{std::numeric_limits<float>::infinity()};
+    std::vector<ApproachWorker> workers(threads);
+
+    auto run = [&](int worker) {
+        ApproachWorker& state = workers[worker];
+        prepareWorker(slice_scan, state.scan);
+        state.slot_sample.assign(65536, -1);
+        TelemetryScan local = slice_scan;
+        for (size_t slice = next.fetch_add(1); slice < slices; slice = next.fetch_add(1))
+        {
+            // 段内的样本按格号计数排序；跨块的格在同一段内完整
+            local.begin_ns = begin_ns + slice * slice_ns;
+            local.end_ns = std::min(end_ns, local.begin_ns + slice_ns - 1);
+            state.samples.clear();
+            size_t first = 0;
+            size_t last = 0;
+            reader.findChunks(local.begin_ns, local.end_ns, first, last);
+            uint64_t slice_begin = local.begin_ns;
+            auto collect = [&](int, const TelemetryColumns& columns, const uint32_t* rows, size_t count) {
+                for (size_t k = 0; k < count; k++)
+                {
+                    uint32_t i = rows[k];
+                    if (std::isnan(columns.x[i]) || std::isnan(columns.y[i]) || std::isnan(columns.z[i]))
+                    {
+                        continue;
+                    }
+                    Sample sample;
+                    sample.time_ns = columns.time[i];
+                    sample.x = columns.x[i];
+                    sample.y = columns.y[i];
+                    sample.z = columns.z[i];
+                    sample.slot = columns.slot[i];
+                    sample.id = columns.id[i];
+                    sample.bin = static_cast<uint32_t>((sample.time_ns - slice_begin) / bin_ns);
+                    state.samples.push_back(sample);
+                }
+            };
+            for (size_t chunk = first; chunk < last; chunk++)
+            {
+                scanChunk(reader, local, chunk, worker, state.scan, counters, collect);
+            }
+
+            state.bin_counts.assign(bins_per_slice + 1, 0);
+            for (const Sample& sample : state.samples)
+            {
+                state.bin_counts[sample.bin + 1]++;
+            }
+            for (size_t b = 1; b < state.bin_counts.size(); b++)
+            {
+                state.bin_counts[b] += state.bin_counts[b - 1];
+            }
+            state.sorted.resize(state.samples.size());
+            std::vector<uint32_t> cursor(state.bin_counts.begin(), state.bin_counts.end() - 1);
+            for (const Sample& sample : state.samples)
+            {
+                state.sorted[cursor[sample.bin]++] = sample;
+            }
+            for (size_t b = 0; b < bins_per_slice; b++)
+            {
+                size_t from = state.bin_counts[b];
+                size_t to = state.bin_counts[b + 1];
+                if (to - from >= 2)
+                {
+                    closestInBin(state.sorted.data() + from, to - from, state, shared);
+                }
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    for (int i = 1; i < threads; i++)
+    {
+        pool.emplace_back(run, i);
+    }
+    run(0);
+    for (std::thread& thread : pool)
+    {
+        thread.join();
+    }
+
+    for (const ApproachWorker& state : workers)
+    {
+        if (state.best.found && (!result.found || state.best.distance < result.distance))
+        {
+            result = state.best;
+        }
+    }
+    if (stats != nullptr)
+    {
+        *stats = counters.snapshot();
+    }
+    return result;
+}
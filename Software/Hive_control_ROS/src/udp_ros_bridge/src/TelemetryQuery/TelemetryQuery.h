@@ -0,0 +1,131 @@
+#ifndef TELEMETRY_QUERY_H
+#define TELEMETRY_QUERY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "../TelemetryRecorder/TelemetryRecorder.h"
+
+// ====================== 遥测记录查询 ======================
+
+/**
+ * @brief 比较运算
+ */
+enum class CompareOp {
+    LESS,
+    LESS_EQUAL,
+    GREATER,
+    GREATER_EQUAL,
+    EQUAL,
+    NOT_EQUAL,
+};
+
+/**
+ * @brief 列条件：column op value，列值按 float 比较（时间列不能用作条件，时间用扫描范围给出）
+ */
+struct ColumnPredicate {
+    TelemetryColumn column = TELEMETRY_BATT;
+    CompareOp op = CompareOp::LESS;
+    float value = 0;
+};
+
+/**
+ * @brief 列名（time slot roll pitch yaw x y z id batt）
+ */
+const char* telemetryColumnName(int column);
+
+/**
+ * @brief 解析 "batt<20"、"z>=150"、"id!=3" 形式的条件
+ * @return 列名或运算符无法识别、数值无效、列为时间时返回false
+ */
+bool parsePredicate(const std::string& text, ColumnPredicate& out);
+
+/**
+ * @brief 一次扫描的范围、过滤条件和需要的列
+ */
+struct TelemetryScan {
+    // 时间范围（含两端）
+    uint64_t begin_ns = 0;
+    uint64_t end_ns = UINT64_MAX;
+    // 槽位，为空表示全部
+    std::vector<uint16_t> slots;
+    // 各条件同时满足
+    std::vector<ColumnPredicate> predicates;
+    // 回调用到的列（掩码）
+    uint32_t columns = TELEMETRY_ALL_COLUMNS;
+};
+
+/**
+ * @brief 扫描统计
+ */
+struct TelemetryScanStats {
+    // 时间范围覆盖的块数
+    uint64_t chunks = 0;
+    // 按统计区跳过的块数（未读取）
+    uint64_t chunks_pruned = 0;
+    // 过滤后没有行、其余列未解码的块数
+    uint64_t chunks_filtered = 0;
+    // 参与过滤的行数与通过的行数
+    uint64_t rows_scanned = 0;
+    uint64_t rows_matched = 0;
+};
+
+/**
+ * @brief 两架无人机的最近距离
+ */
+struct TelemetryApproach {
+    bool found = false;
+    uint64_t time_ns = 0;
+    uint16_t slot_a = 0;
+    uint16_t slot_b = 0;
+    uint8_t id_a = 0;
+    uint8_t id_b = 0;
+    // 与记录中的位置同单位（二进制帧为厘米）
+    float distance = 0;
+};
+
+/**
+ * @brief 遥测记录的多线程列式扫描
+ * @note 条件下推：先按时间索引选块，再用块统计区跳过不可能满足条件的块；
+ *       读块时先只读（压缩块只解码）条件涉及的列，逐列生成选择向量，没有行通过时不读其余列。
+ *       过滤循环对整列做同一种比较，编译器可向量化。块由多个线程分取，回调在工作线程中调用
+ */
+class TelemetryQuery {
+public:
+    /**
+     * @brief 回调：一个块中通过过滤的行
+     * @param worker 工作线程号（0 ~ threads-1），用于按线程分开累计
+     * @param columns 块的列（请求的列和条件涉及的列有效）
+     * @param rows 通过的行号，升序
+     * @param count 行数
+     */
+    using BatchCallback =
+        std::function<void(int worker, const TelemetryColumns& columns, const uint32_t* rows, size_t count)>;
+
+    explicit TelemetryQuery(const TelemetryRecordReader& reader) : reader(reader) {}
+
+    /**
+     * @brief 扫描
+     * @param threads 线程数，小于1时按1
+     * @return 扫描统计
+     */
+    TelemetryScanStats scan(const TelemetryScan& scan, int threads, const BatchCallback& callback) const;
+
+    /**
+     * @brief 任意两架无人机的最近距离
+     * @note 时间轴按 bin_ns 分格，同一格内每架无人机取最后一个样本，格内用按x排序的扫描线找最近的一对。
+     *       时间轴分段交给多个线程，各段共享当前最小距离用于剪枝
+     * @param scan 范围和条件（如 z>100 排除地面上的无人机），columns 不用设置
+     * @param bin_ns 分格宽度，一般取上报周期
+     * @param stats 可选，输出扫描统计
+     */
+    TelemetryApproach closestApproach(const TelemetryScan& scan, uint64_t bin_ns, int threads,
+                                      TelemetryScanStats* stats = nullptr) const;
+
+private:
+    const TelemetryRecordReader& reader;
+};
+
+#endif // TELEMETRY_QUERY_H
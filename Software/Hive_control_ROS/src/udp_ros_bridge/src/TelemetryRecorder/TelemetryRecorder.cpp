@@ -0,0 +1,916 @@
+#include "TelemetryRecorder.h"
+#include "../GorillaCodec/GorillaCodec.h"
+#include "udp_ros_bridge/Logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+// 文件头中数据结束偏移的位置
+static const size_t DATA_END_OFFSET = 24;
+
+// 每列每个值的字节数
+static const size_t COLUMN_WIDTH[TELEMETRY_COLUMN_COUNT] = {8, 2, 2, 2, 2, 4, 4, 4, 1, 1};
+
+// 压缩块中列长度目录的大小（10个u32，补齐到8字节对齐）
+static const size_t COMPRESSED_DIRECTORY_SIZE = 48;
+
+/**
+ * @brief 计算原样列布局中各列的偏移，返回总长度
+ * @param rows 行数
+ * @param start 第一列相对块起点的偏移
+ */
+static size_t chunkLayout(size_t rows, size_t start, size_t offsets[TELEMETRY_COLUMN_COUNT])
+{
+    size_t offset = start;
+    for (int c = 0; c < TELEMETRY_COLUMN_COUNT; c++)
+    {
+        offsets[c] = offset;
+        offset += (rows * COLUMN_WIDTH[c] + 7) / 8 * 8;
+    }
+    return offset;
+}
+
+/**
+ * @brief 一行中各列的值（转为 float，供统计区使用；时间列不用）
+ */
+static void rowValues(const TelemetryRow& row, float values[TELEMETRY_COLUMN_COUNT])
+{
+    values[TELEMETRY_TIME] = 0;
+    values[TELEMETRY_SLOT] = static_cast<float>(row.slot);
+    values[TELEMETRY_ROLL] = static_cast<float>(row.roll);
+    values[TELEMETRY_PITCH] = static_cast<float>(row.pitch);
+    values[TELEMETRY_YAW] = static_cast<float>(row.yaw);
+    values[TELEMETRY_X] = row.x;
+    values[TELEMETRY_Y] = row.y;
+    values[TELEMETRY_Z] = row.z;
+    values[TELEMETRY_ID] = static_cast<float>(row.id);
+    values[TELEMETRY_BATT] = static_cast<float>(row.batt);
+}
+
+/**
+ * @brief 按 order 的顺序把行写成原样列布局，并统计各列的最小、最大值
+ * @param columns 列布局起点，offsets 相对于它
+ */
+static void writeColumns(const std::vector<TelemetryRow>& pending, const std::vector<uint32_t>& order,
+                         const size_t offsets[TELEMETRY_COLUMN_COUNT], uint8_t* columns,
+                         float min[TELEMETRY_COLUMN_COUNT], float max[TELEMETRY_COLUMN_COUNT])
+{
+    uint8_t* time_col = columns + offsets[TELEMETRY_TIME];
+    uint8_t* slot_col = columns + offsets[TELEMETRY_SLOT];
+    uint8_t* roll_col = columns + offsets[TELEMETRY_ROLL];
+    uint8_t* pitch_col = columns + offsets[TELEMETRY_PITCH];
+    uint8_t* yaw_col = columns + offsets[TELEMETRY_YAW];
+    uint8_t* x_col = columns + offsets[TELEMETRY_X];
+    uint8_t* y_col = columns + offsets[TELEMETRY_Y];
+    uint8_t* z_col = columns + offsets[TELEMETRY_Z];
+    uint8_t* id_col = columns + offsets[TELEMETRY_ID];
+    uint8_t* batt_col = columns + offsets[TELEMETRY_BATT];
+    rowValues(pending[order[0]], min);
+    rowValues(pending[order[0]], max);
+    float current[TELEMETRY_COLUMN_COUNT];
+    for (size_t i = 0; i < pending.size(); i++)
+    {
+        const TelemetryRow& row = pending[order[i]];
+        memcpy(time_col + i * 8, &row.time_ns, 8);
+        memcpy(slot_col + i * 2, &row.slot, 2);
+        memcpy(roll_col + i * 2, &row.roll, 2);
+        memcpy(pitch_col + i * 2, &row.pitch, 2);
+        memcpy(yaw_col + i * 2, &row.yaw, 2);
+        memcpy(x_col + i * 4, &row.x, 4);
+        memcpy(y_col + i * 4, &row.y, 4);
+        memcpy(z_col + i * 4, &row.z, 4);
+        id_col[i] = row.id;
+        batt_col[i] = row.batt;
+        rowValues(row, current);
+        for (int c = TELEMETRY_SLOT; c < TELEMETRY_COLUMN_COUNT; c++)
+        {
+            // NaN 不参与统计
+            min[c] = current[c] < min[c] ? current[c] : min[c];
+            max[c] = current[c] > max[c] ? current[c] : max[c];
+        }
+    }
+}
+
+// 重启点表中每项的大小：段首行时间8 + 槽位2 + 保留2 + 段首行号4 + 各列偏移 10x4
+static const size_t RESTART_POINT_SIZE = 56;
+
+/**
+ * @brief 编码一列中的 count 个值（按列类型选整数或浮点编码）
+ * @return 写入的字节数
+ */
+static size_t encodeColumn(int c, const uint8_t* values, size_t count, std::vector<uint8_t>& out)
+{
+    switch (c)
+    {
+        case TELEMETRY_TIME: return gorillaEncodeInts(reinterpret_cast<const uint64_t*>(values), count, out);
+        case TELEMETRY_SLOT: return gorillaEncodeInts(reinterpret_cast<const uint16_t*>(values), count, out);
+        case TELEMETRY_ROLL:
+        case TELEMETRY_PITCH:
+        case TELEMETRY_YAW: return gorillaEncodeInts(reinterpret_cast<const int16_t*>(values), count, out);
+        case TELEMETRY_X:
+        case TELEMETRY_Y:
+        case TELEMETRY_Z: return gorillaEncodeFloats(reinterpret_cast<const float*>(values), count, out);
+        default: return gorillaEncodeInts(values, count, out);
+    }
+}
+
+/**
+ * @brief 解码一列中的 count 个值
+ * @return 数据不完整时返回false
+ */
+static bool decodeColumn(int c, const uint8_t* in, size_t size, size_t count, uint8_t* values)
+{
+    switch (c)
+    {
+        case TELEMETRY_TIME: return gorillaDecodeInts(in, size, count, reinterpret_cast<uint64_t*>(values));
+        case TELEMETRY_SLOT: return gorillaDecodeInts(in, size, count, reinterpret_cast<uint16_t*>(values));
+        case TELEMETRY_ROLL:
+        case TELEMETRY_PITCH:
+        case TELEMETRY_YAW: return gorillaDecodeInts(in, size, count, reinterpret_cast<int16_t*>(values));
+        case TELEMETRY_X:
+        case TELEMETRY_Y:
+        case TELEMETRY_Z: return gorillaDecodeFloats(in, size, count, reinterpret_cast<float*>(values));
+        default: return gorillaDecodeInts(in, size, count, values);
+    }
+}
+
+// 重启点表中第 i 项的字段
+static uint64_t restartTime(const uint8_t* table, size_t i)
+{
+    uint64_t time;
+    memcpy(&time, table + i * RESTART_POINT_SIZE, 8);
+    return time;
+}
+
+static uint16_t restartSlot(const uint8_t* table, size_t i)
+{
+    uint16_t slot;
+    memcpy(&slot, table + i * RESTART_POINT_SIZE + 8, 2);
+    return slot;
+}
+
+static uint32_t restartRow(const uint8_t* table, size_t i)
+{
+    uint32_t row;
+    memcpy(&row, table + i * RESTART_POINT_SIZE + 12, 4);
+    return row;
+}
+
+static uint32_t restartOffset(const uint8_t* table, size_t i, int c)
+{
+    uint32_t offset;
+    memcpy(&offset, table + i * RESTART_POINT_SIZE + 16 + c * 4, 4);
+    return offset;
+}
+
+/**
+ * @brief 逐列 Gorilla 编码，每 restart_rows 行重新开始一段，每列补齐到8字节
+ * @param columns 原样列布局（8字节对齐）
+ * @param restarts 输出重启点表，每段一项
+ */
+static void encodeColumns(const uint8_t* columns, size_t rows, const size_t offsets[TELEMETRY_COLUMN_COUNT],
+                          size_t restart_rows, std::vector<uint8_t>& out, uint32_t lengths[TELEMETRY_COLUMN_COUNT],
+                          std::vector<uint8_t>& restarts)
+{
+    size_t segments = (rows + restart_rows - 1) / restart_rows;
+    restarts.assign(segments * RESTART_POINT_SIZE, 0);
+    for (size_t s = 0; s < segments; s++)
+    {
+        uint8_t* point = restarts.data() + s * RESTART_POINT_SIZE;
+        uint32_t row = static_cast<uint32_t>(s * restart_rows);
+        memcpy(point, columns + offsets[TELEMETRY_TIME] + row * COLUMN_WIDTH[TELEMETRY_TIME], 8);
+        memcpy(point + 8, columns + offsets[TELEMETRY_SLOT] + row * COLUMN_WIDTH[TELEMETRY_SLOT], 2);
+        memcpy(point + 12, &row, 4);
+    }
+    for (int c = 0; c < TELEMETRY_COLUMN_COUNT; c++)
+    {
+        size_t column_start = out.size();
+        for (size_t s = 0; s < segments; s++)
+        {
+            size_t row = s * restart_rows;
+            size_t count = std::min(restart_rows, rows - row);
+            uint32_t offset = static_cast<uint32_t>(out.size() - column_start);
+            memcpy(restarts.data() + s * RESTART_POINT_SIZE + 16 + c * 4, &offset, 4);
+            encodeColumn(c, columns + offsets[c] + row * COLUMN_WIDTH[c], count, out);
+        }
+        lengths[c] = static_cast<uint32_t>(out.size() - column_start);
+        out.resize((out.size() + 7) / 8 * 8, 0);
+    }
+}
+
+/**
+ * @brief 把压缩块中选定的列解码成原样列布局
+ * @param data 列长度目录起点
+ * @param size 目录、重启点表加编码数据的长度
+ * @param mask 要解码的列
+ * @param columns 输出（8字节对齐，按 offsets 布局）；只写入解码的段所在的行
+ * @param restart_count 重启点数，0表示每列整列一段
+ * @param first_segment 与 last_segment 给出要解码的段 [first, last)，没有重启点时忽略
+ * @return 数据不完整时返回false
+ */
+static bool decodeColumns(const uint8_t* data, size_t size, size_t rows, uint32_t mask,
+                          const size_t offsets[TELEMETRY_COLUMN_COUNT], uint8_t* columns, size_t restart_count,
+                          size_t first_segment, size_t last_segment)
+{
+    uint32_t lengths[TELEMETRY_COLUMN_COUNT];
+    memcpy(lengths, data, sizeof(lengths));
+    const uint8_t* table = data + COMPRESSED_DIRECTORY_SIZE;
+    size_t offset = COMPRESSED_DIRECTORY_SIZE + restart_count * RESTART_POINT_SIZE;
+    for (int c = 0; c < TELEMETRY_COLUMN_COUNT; c++)
+    {
+        if (offset + lengths[c] > size)
+        {
+            return false;
+        }
+        const uint8_t* in = data + offset;
+        uint8_t* column = columns + offsets[c];
+        offset += (lengths[c] + 7) / 8 * 8;
+        if ((mask & (1u << c)) == 0)
+        {
+            continue;
+        }
+        if (restart_count == 0)
+        {
+            if (!decodeColumn(c, in, lengths[c], rows, column))
+            {
+                return false;
+            }
+            continue;
+        }
+        for (size_t s = first_segment; s < last_segment; s++)
+        {
+            size_t row = restartRow(table, s);
+            size_t next_row = s + 1 < restart_count ? restartRow(table, s + 1) : rows;
+            size_t begin = restartOffset(table, s, c);
+            size_t end = s + 1 < restart_count ? restartOffset(table, s + 1, c) : lengths[c];
+            if (next_row < row || next_row > rows || end < begin || end > lengths[c] ||
+                !decodeColumn(c, in + begin, end - begin, next_row - row, column + row * COLUMN_WIDTH[c]))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 重启点表中第一个段首 (槽位, 时间) 不小于（upper 为真时大于）给定值的段
+ */
+static size_t findRestart(const uint8_t* table, size_t count, uint16_t slot, uint64_t time, bool upper)
+{
+    size_t lo = 0;
+    size_t hi = count;
+    while (lo < hi)
+    {
+        size_t mid = (lo + hi) / 2;
+        uint16_t s = restartSlot(table, mid);
+        uint64_t t = restartTime(table, mid);
+        bool before = s < slot || (s == slot && (upper ? t <= time : t < time));
+        if (before)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * @brief 按原样列布局设置选定列的指针
+ */
+static void pointColumns(const uint8_t* columns, size_t rows, uint32_t mask,
+                         const size_t offsets[TELEMETRY_COLUMN_COUNT], TelemetryColumns& out)
+{
+    out.rows = rows;
+    auto pick = [&](int c) { return (mask & (1u << c)) != 0 ? columns + offsets[c] : nullptr; };
+    out.time = reinterpret_cast<const uint64_t*>(pick(TELEMETRY_TIME));
+    out.slot = reinterpret_cast<const uint16_t*>(pick(TELEMETRY_SLOT));
+    out.roll = reinterpret_cast<const int16_t*>(pick(TELEMETRY_ROLL));
+    out.pitch = reinterpret_cast<const int16_t*>(pick(TELEMETRY_PITCH));
+    out.yaw = reinterpret_cast<const int16_t*>(pick(TELEMETRY_YAW));
+    out.x = reinterpret_cast<const float*>(pick(TELEMETRY_X));
+    out.y = reinterpret_cast<const float*>(pick(TELEMETRY_Y));
+    out.z = reinterpret_cast<const float*>(pick(TELEMETRY_Z));
+    out.id = pick(TELEMETRY_ID);
+    out.batt = pick(TELEMETRY_BATT);
+}
+
+static uint64_t realtimeNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+// ====================== 写入 ======================
+TelemetryRecorder::~TelemetryRecorder()
+{
+    close();
+}
+
+bool TelemetryRecorder::open(const std::string& path, size_t max_bytes, size_t rows_per_chunk,
+                             TelemetryEncoding column_encoding)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    closeLocked();
+    chunk_rows = rows_per_chunk > 0 ? rows_per_chunk : DEFAULT_CHUNK_ROWS;
+    encoding = column_encoding;
+    size_t offsets[TELEMETRY_COLUMN_COUNT];
+    if (max_bytes < TELEMETRY_HEADER_SIZE + chunkLayout(1, TELEMETRY_CHUNK_HEADER_SIZE + TELEMETRY_CHUNK_STATS_SIZE,
+                                                        offsets))
+    {
+        LOG_ERROR("遥测记录文件最大长度过小: {} 字节", max_bytes);
+        return false;
+    }
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        LOG_ERROR("无法创建遥测记录文件 {}: {}", path, strerror(errno));
+        return false;
+    }
+    void* mapping = mmap(nullptr, max_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        LOG_ERROR("映射遥测记录文件失败: {}", strerror(errno));
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    base = static_cast<uint8_t*>(mapping);
+    capacity = max_bytes;
+    limit = max_bytes;
+    size_t initial = GROW_BYTES < max_bytes ? GROW_BYTES : max_bytes;
+    int error = posix_fallocate(fd, 0, static_cast<off_t>(initial));
+    if (error != 0)
+    {
+        LOG_ERROR("分配遥测记录文件空间失败: {}", strerror(error));
+        closeLocked();
+        return false;
+    }
+    file_size = initial;
+
+    uint64_t created = realtimeNs();
+    uint32_t header_size = TELEMETRY_HEADER_SIZE;
+    uint64_t data_end = TELEMETRY_HEADER_SIZE;
+    memcpy(base, TELEMETRY_FILE_MAGIC, sizeof(TELEMETRY_FILE_MAGIC));
+    memcpy(base + 8, &TELEMETRY_FILE_VERSION, 4);
+    memcpy(base + 12, &header_size, 4);
+    memcpy(base + 16, &created, 8);
+    memcpy(base + DATA_END_OFFSET, &data_end, 8);
+    used = TELEMETRY_HEADER_SIZE;
+    pending.clear();
+    pending.reserve(chunk_rows);
+    order.resize(chunk_rows);
+    rows = 0;
+    chunks = 0;
+    dropped = 0;
+    LOG_INFO("开始记录遥测: {}（最大 {} MB，每块 {} 行，{}）", path, max_bytes / (1024 * 1024), chunk_rows,
+             encoding == TelemetryEncoding::GORILLA ? "Gorilla 压缩" : "不压缩");
+    return true;
+}
+
+bool TelemetryRecorder::append(const TelemetryRow& row)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (base == nullptr)
+    {
+        return false;
+    }
+    pending.push_back(row);
+    rows++;
+    if (pending.size() >= chunk_rows)
+    {
+        return sealLocked();
+    }
+    return true;
+}
+
+bool TelemetryRecorder::reserveLocked(size_t end)
+{
+    if (end > limit)
+    {
+        return false;
+    }
+    if (end > file_size)
+    {
+        size_t grown = file_size + GROW_BYTES;
+        grown = grown < end ? end : grown;
+        grown = grown > capacity ? capacity : grown;
+        // 先在磁盘上分配再经映射写入：稀疏扩展在磁盘满时会让第一次写入收到 SIGBUS
+        int error = posix_fallocate(fd, static_cast<off_t>(file_size), static_cast<off_t>(grown - file_size));
+        if (error != 0)
+        {
+            limit = file_size;
+            LOG_ERROR("分配遥测记录文件空间失败，之后的块丢弃（已写 {} 字节）: {}", used, strerror(error));
+            return false;
+        }
+        file_size = grown;
+    }
+    return true;
+}
+
+bool TelemetryRecorder::sealLocked()
+{
+    size_t count = pending.size();
+    if (count == 0)
+    {
+        return true;
+    }
+
+    // 按槽位计数排序（稳定），同一槽位内保持追加顺序即时间顺序
+    uint16_t max_slot = 0;
+    uint64_t t_min = UINT64_MAX;
+    uint64_t t_max = 0;
+    for (const TelemetryRow& row : pending)
+    {
+        max_slot = row.slot > max_slot ? row.slot : max_slot;
+        t_min = row.time_ns < t_min ? row.time_ns : t_min;
+        t_max = row.time_ns > t_max ? row.time_ns : t_max;
+    }
+    slot_counts.assign(static_cast<size_t>(max_slot) + 2, 0);
+    for (const TelemetryRow& row : pending)
+    {
+        slot_counts[row.slot + 1]++;
+    }
+    for (size_t s = 1; s < slot_counts.size(); s++)
+    {
+        slot_counts[s] += slot_counts[s - 1];
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        order[slot_counts[pending[i].slot]++] = static_cast<uint32_t>(i);
+    }
+
+    const size_t data_offset = TELEMETRY_CHUNK_HEADER_SIZE + TELEMETRY_CHUNK_STATS_SIZE;
+    size_t offsets[TELEMETRY_COLUMN_COUNT];
+    size_t chunk_bytes = chunkLayout(count, data_offset, offsets);
+    float min[TELEMETRY_COLUMN_COUNT];
+    float max[TELEMETRY_COLUMN_COUNT];
+    uint32_t lengths[TELEMETRY_COLUMN_COUNT];
+    if (encoding == TelemetryEncoding::GORILLA)
+    {
+        // 先按原样布局排进暂存区，再逐列编码；块长度编码后才知道
+        size_t staged_offsets[TELEMETRY_COLUMN_COUNT];
+        size_t staged_bytes = chunkLayout(count, 0, staged_offsets);
+        staging.resize(staged_bytes / 8);
+        uint8_t* columns = reinterpret_cast<uint8_t*>(staging.data());
+        writeColumns(pending, order, staged_offsets, columns, min, max);
+        encoded.clear();
+        encodeColumns(columns, count, staged_offsets, RESTART_ROWS, encoded, lengths, restarts);
+        chunk_bytes = data_offset + COMPRESSED_DIRECTORY_SIZE + restarts.size() + encoded.size();
+    }
+    size_t end = used + chunk_bytes;
+    if (!reserveLocked(end))
+    {
+        dropped += count;
+        pending.clear();
+        return false;
+    }
+
+    uint8_t* chunk = base + used;
+    if (encoding == TelemetryEncoding::GORILLA)
+    {
+        uint8_t* directory = chunk + data_offset;
+        memset(directory, 0, COMPRESSED_DIRECTORY_SIZE);
+        memcpy(directory, lengths, sizeof(lengths));
+        memcpy(directory + COMPRESSED_DIRECTORY_SIZE, restarts.data(), restarts.size());
+        memcpy(directory + COMPRESSED_DIRECTORY_SIZE + restarts.size(), encoded.data(), encoded.size());
+    }
+    else
+    {
+        writeColumns(pending, order, offsets, chunk, min, max);
+    }
+
+    uint32_t magic = TELEMETRY_CHUNK_MAGIC;
+    uint32_t row_count = static_cast<uint32_t>(count);
+    uint64_t bytes = chunk_bytes;
+    uint32_t slot_span = static_cast<uint32_t>(max_slot) + 1;
+    uint32_t encoding_id = static_cast<uint32_t>(encoding);
+    uint32_t stats_size = TELEMETRY_CHUNK_STATS_SIZE;
+    uint32_t restart_count =
+        encoding == TelemetryEncoding::GORILLA ? static_cast<uint32_t>(restarts.size() / RESTART_POINT_SIZE) : 0;
+    memset(chunk, 0, data_offset);
+    memcpy(chunk, &magic, 4);
+    memcpy(chunk + 4, &row_count, 4);
+    memcpy(chunk + 8, &t_min, 8);
+    memcpy(chunk + 16, &t_max, 8);
+    memcpy(chunk + 24, &bytes, 8);
+    memcpy(chunk + 32, &slot_span, 4);
+    memcpy(chunk + 36, &encoding_id, 4);
+    memcpy(chunk + 40, &stats_size, 4);
+    memcpy(chunk + 44, &restart_count, 4);
+    uint8_t* stats = chunk + TELEMETRY_CHUNK_HEADER_SIZE;
+    for (int c = TELEMETRY_SLOT; c < TELEMETRY_COLUMN_COUNT; c++)
+    {
+        memcpy(stats + (c - TELEMETRY_SLOT) * 8, &min[c], 4);
+        memcpy(stats + (c - TELEMETRY_SLOT) * 8 + 4, &max[c], 4);
+    }
+
+    // 块写完后再更新结束偏移
+    used = end;
+    uint64_t data_end = end;
+    memcpy(base + DATA_END_OFFSET, &data_end, 8);
+    chunks++;
+    pending.clear();
+    return true;
+}
+
+void TelemetryRecorder::flush()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (base != nullptr)
+    {
+        sealLocked();
+    }
+}
+
+bool TelemetryRecorder::flushOlderThan(uint64_t now_ns, uint64_t max_age_ns)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (base == nullptr || pending.empty() || now_ns < pending.front().time_ns + max_age_ns)
+    {
+        return false;
+    }
+    return sealLocked();
+}
+
+void TelemetryRecorder::close()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    closeLocked();
+}
+
+void TelemetryRecorder::closeLocked()
+{
+    if (base != nullptr)
+    {
+        sealLocked();
+        munmap(base, capacity);
+        base = nullptr;
+    }
+    if (fd >= 0)
+    {
+        if (ftruncate(fd, static_cast<off_t>(used)) != 0)
+        {
+            LOG_WARN("截断遥测记录文件失败: {}", strerror(errno));
+        }
+        ::close(fd);
+        fd = -1;
+    }
+    capacity = 0;
+    file_size = 0;
+    limit = 0;
+}
+
+uint64_t TelemetryRecorder::getRowCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return rows;
+}
+
+uint64_t TelemetryRecorder::getChunkCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return chunks;
+}
+
+uint64_t TelemetryRecorder::getByteCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return used;
+}
+
+uint64_t TelemetryRecorder::getDroppedCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return dropped;
+}
+
+// ====================== 读取与查询 ======================
+TelemetryRecordReader::~TelemetryRecordReader()
+{
+    close();
+}
+
+bool TelemetryRecordReader::open(const std::string& path)
+{
+    close();
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < TELEMETRY_HEADER_SIZE)
+    {
+        close();
+        return false;
+    }
+    size = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        close();
+        return false;
+    }
+    base = static_cast<const uint8_t*>(mapping);
+    // 查询是随机访问，不需要预读
+    madvise(const_cast<uint8_t*>(base), size, MADV_RANDOM);
+
+    uint32_t version = 0;
+    uint32_t header_size = 0;
+    uint64_t data_end = 0;
+    memcpy(&version, base + 8, 4);
+    memcpy(&header_size, base + 12, 4);
+    memcpy(&data_end, base + DATA_END_OFFSET, 8);
+    if (memcmp(base, TELEMETRY_FILE_MAGIC, sizeof(TELEMETRY_FILE_MAGIC)) != 0 || version == 0 ||
+        version > TELEMETRY_FILE_VERSION || header_size != TELEMETRY_HEADER_SIZE)
+    {
+        close();
+        return false;
+    }
+    size_t end = data_end < TELEMETRY_HEADER_SIZE || data_end > size ? size : static_cast<size_t>(data_end);
+
+    // 沿块头建立索引，只读每块的块头和统计区
+    size_t offset = TELEMETRY_HEADER_SIZE;
+    while (offset + TELEMETRY_CHUNK_HEADER_SIZE <= end)
+    {
+        const uint8_t* chunk = base + offset;
+        uint32_t magic;
+        ChunkIndex entry;
+        uint64_t bytes;
+        uint32_t encoding_id;
+        uint32_t stats_size;
+        memcpy(&magic, chunk, 4);
+        memcpy(&entry.info.rows, chunk + 4, 4);
+        memcpy(&entry.info.t_min, chunk + 8, 8);
+        memcpy(&entry.info.t_max, chunk + 16, 8);
+        memcpy(&bytes, chunk + 24, 8);
+        memcpy(&encoding_id, chunk + 36, 4);
+        memcpy(&stats_size, chunk + 40, 4);
+        // 版本4之前此处为保留字段（0），压缩块整列一段
+        memcpy(&entry.restart_count, chunk + 44, 4);
+        entry.encoding = static_cast<TelemetryEncoding>(encoding_id);
+        entry.data_offset = TELEMETRY_CHUNK_HEADER_SIZE + stats_size;
+        // 原样块的长度由行数确定；压缩块只能检查不超过文件
+        size_t offsets[TELEMETRY_COLUMN_COUNT];
+        bool length_ok = entry.encoding == TelemetryEncoding::RAW
+                             ? bytes == chunkLayout(entry.info.rows, entry.data_offset, offsets)
+                             : entry.encoding == TelemetryEncoding::GORILLA &&
+                                   entry.restart_count <= entry.info.rows &&
+                                   bytes >= entry.data_offset + COMPRESSED_DIRECTORY_SIZE +
+                                                static_cast<uint64_t>(entry.restart_count) * RESTART_POINT_SIZE;
+        bool stats_ok = stats_size == 0 || stats_size == TELEMETRY_CHUNK_STATS_SIZE;
+        if (magic != TELEMETRY_CHUNK_MAGIC || entry.info.rows == 0 || !stats_ok || !length_ok ||
+            offset + bytes > end)
+        {
+            LOG_WARN("遥测记录文件在偏移 {} 处损坏，之后的数据被忽略", offset);
+            break;
+        }
+        entry.info.has_stats = stats_size != 0;
+        const uint8_t* stats = chunk + TELEMETRY_CHUNK_HEADER_SIZE;
+        for (int c = TELEMETRY_SLOT; entry.info.has_stats && c < TELEMETRY_COLUMN_COUNT; c++)
+        {
+            memcpy(&entry.info.min[c], stats + (c - TELEMETRY_SLOT) * 8, 4);
+            memcpy(&entry.info.max[c], stats + (c - TELEMETRY_SLOT) * 8 + 4, 4);
+        }
+        entry.offset = offset;
+        entry.bytes = static_cast<size_t>(bytes);
+        index.push_back(entry);
+        row_count += entry.info.rows;
+        offset += bytes;
+    }
+
+    // 多个解码线程交替追加，相邻块的时间范围可能略有重叠；用前缀最大值和后缀最小值保证单调
+    uint64_t running_max = 0;
+    for (ChunkIndex& entry : index)
+    {
+        running_max = entry.info.t_max > running_max ? entry.info.t_max : running_max;
+        entry.prefix_max = running_max;
+    }
+    uint64_t running_min = UINT64_MAX;
+    for (size_t i = index.size(); i-- > 0;)
+    {
+        running_min = index[i].info.t_min < running_min ? index[i].info.t_min : running_min;
+        index[i].suffix_min = running_min;
+    }
+    return true;
+}
+
+void TelemetryRecordReader::findChunks(uint64_t begin_ns, uint64_t end_ns, size_t& first, size_t& last) const
+{
+    // 首个可能含 begin_ns 之后数据的块，到首个最早时间晚于 end_ns 的块为止
+    auto lower = std::lower_bound(index.begin(), index.end(), begin_ns,
+                                  [](const ChunkIndex& entry, uint64_t t) { return entry.prefix_max < t; });
+    auto upper = std::upper_bound(lower, index.end(), end_ns,
+                                  [](uint64_t t, const ChunkIndex& entry) { return t < entry.suffix_min; });
+    first = static_cast<size_t>(lower - index.begin());
+    last = begin_ns > end_ns ? first : static_cast<size_t>(upper - index.begin());
+}
+
+bool TelemetryRecordReader::readChunk(size_t chunk, uint32_t columns, std::vector<uint64_t>& buffer,
+                                      TelemetryColumns& out) const
+{
+    if (base == nullptr || chunk >= index.size())
+    {
+        return false;
+    }
+    const ChunkIndex& entry = index[chunk];
+    const uint8_t* start = base + entry.offset;
+    size_t offsets[TELEMETRY_COLUMN_COUNT];
+    if (entry.encoding == TelemetryEncoding::RAW)
+    {
+        chunkLayout(entry.info.rows, entry.data_offset, offsets);
+        pointColumns(start, entry.info.rows, columns, offsets, out);
+        return true;
+    }
+    size_t decoded_bytes = chunkLayout(entry.info.rows, 0, offsets);
+    if (buffer.size() < decoded_bytes / 8)
+    {
+        buffer.resize(decoded_bytes / 8);
+    }
+    uint8_t* decoded_columns = reinterpret_cast<uint8_t*>(buffer.data());
+    if (!decodeColumns(start + entry.data_offset, entry.bytes - entry.data_offset, entry.info.rows, columns, offsets,
+                       decoded_columns, entry.restart_count, 0, entry.restart_count))
+    {
+        LOG_WARN_EVERY(1000, "遥测记录文件偏移 {} 处的压缩块无法解码", entry.offset);
+        return false;
+    }
+    pointColumns(decoded_columns, entry.info.rows, columns, offsets, out);
+    return true;
+}
+
+void TelemetryRecordReader::readRows(const TelemetryColumns& columns, size_t first, size_t last, uint64_t begin_ns,
+                                     uint64_t end_ns, std::vector<TelemetryRow>& out) const
+{
+    // 同一槽位内时间有序：二分找到起点
+    const uint64_t* lo = std::lower_bound(columns.time + first, columns.time + last, begin_ns);
+    for (size_t i = static_cast<size_t>(lo - columns.time); i < last; i++)
+    {
+        if (columns.time[i] > end_ns)
+        {
+            break;
+        }
+        TelemetryRow row;
+        row.time_ns = columns.time[i];
+        row.slot = columns.slot[i];
+        row.roll = columns.roll[i];
+        row.pitch = columns.pitch[i];
+        row.yaw = columns.yaw[i];
+        row.x = columns.x[i];
+        row.y = columns.y[i];
+        row.z = columns.z[i];
+        row.id = columns.id[i];
+        row.batt = columns.batt[i];
+        out.push_back(row);
+    }
+}
+
+void TelemetryRecordReader::querySegments(size_t chunk, uint64_t begin_ns, uint64_t end_ns,
+                                          const std::vector<uint16_t>& slots, std::vector<TelemetryRow>& out) const
+{
+    const ChunkIndex& entry = index[chunk];
+    const uint8_t* data = base + entry.offset + entry.data_offset;
+    size_t size = entry.bytes - entry.data_offset;
+    const uint8_t* table = data + COMPRESSED_DIRECTORY_SIZE;
+    size_t count = entry.restart_count;
+    size_t rows = entry.info.rows;
+    size_t offsets[TELEMETRY_COLUMN_COUNT];
+    size_t decoded_bytes = chunkLayout(rows, 0, offsets);
+    if (decoded.size() < decoded_bytes / 8)
+    {
+        decoded.resize(decoded_bytes / 8);
+    }
+    // 缓冲区只写入部分段，不再是完整的一块
+    decoded_chunk = SIZE_MAX;
+    uint8_t* decoded_columns = reinterpret_cast<uint8_t*>(decoded.data());
+    TelemetryColumns columns;
+    pointColumns(decoded_columns, rows, TELEMETRY_ALL_COLUMNS, offsets, columns);
+    for (uint16_t slot : slots)
+    {
+        // 含 (slot, begin) 的段可能从前一段开始；段首大于 (slot, end) 的段不必解码
+        size_t first = findRestart(table, count, slot, begin_ns, false);
+        first = first > 0 ? first - 1 : 0;
+        size_t last = findRestart(table, count, slot, end_ns, true);
+        if (first >= last)
+        {
+            continue;
+        }
+        if (!decodeColumns(data, size, rows, TELEMETRY_ALL_COLUMNS, offsets, decoded_columns, count, first, last))
+        {
+            LOG_WARN_EVERY(1000, "遥测记录文件偏移 {} 处的压缩块无法解码", entry.offset);
+            return;
+        }
+        size_t row_begin = restartRow(table, first);
+        size_t row_end = last < count ? restartRow(table, last) : rows;
+        auto range = std::equal_range(columns.slot + row_begin, columns.slot + row_end, slot);
+        if (range.first < range.second)
+        {
+            readRows(columns, static_cast<size_t>(range.first - columns.slot),
+                     static_cast<size_t>(range.second - columns.slot), begin_ns, end_ns, out);
+        }
+    }
+}
+
+size_t TelemetryRecordReader::query(uint64_t begin_ns, uint64_t end_ns, const std::vector<uint16_t>& slots,
+                                    std::vector<TelemetryRow>& out) const
+{
+    size_t before = out.size();
+    size_t first = 0;
+    size_t last = 0;
+    findChunks(begin_ns, end_ns, first, last);
+    for (size_t c = first; c < last; c++)
+    {
+        const TelemetryChunkInfo& info = index[c].info;
+        if (info.t_max < begin_ns || info.t_min > end_ns)
+        {
+            continue;
+        }
+        // 指定了槽位时，有重启点的压缩块只解码相关的段
+        if (!slots.empty() && index[c].encoding == TelemetryEncoding::GORILLA && index[c].restart_count > 0 &&
+            decoded_chunk != c)
+        {
+            querySegments(c, begin_ns, end_ns, slots, out);
+            continue;
+        }
+        // 压缩块解码后缓存，连续查询同一块时不再解码
+        TelemetryColumns columns;
+        if (index[c].encoding == TelemetryEncoding::RAW || decoded_chunk != c)
+        {
+            decoded_chunk = SIZE_MAX;
+            if (!readChunk(c, TELEMETRY_ALL_COLUMNS, decoded, columns))
+            {
+                continue;
+            }
+            decoded_chunk = index[c].encoding == TelemetryEncoding::RAW ? SIZE_MAX : c;
+        }
+        else
+        {
+            size_t offsets[TELEMETRY_COLUMN_COUNT];
+            chunkLayout(info.rows, 0, offsets);
+            pointColumns(reinterpret_cast<const uint8_t*>(decoded.data()), info.rows, TELEMETRY_ALL_COLUMNS, offsets,
+                         columns);
+        }
+
+        if (slots.empty())
+        {
+            // 全部无人机：逐个槽位段读取，段的边界沿槽位列找
+            size_t row = 0;
+            while (row < info.rows)
+            {
+                size_t next = static_cast<size_t>(
+                    std::upper_bound(columns.slot + row, columns.slot + info.rows, columns.slot[row]) - columns.slot);
+                readRows(columns, row, next, begin_ns, end_ns, out);
+                row = next;
+            }
+            continue;
+        }
+        for (uint16_t slot : slots)
+        {
+            // 槽位列有序：二分找到该无人机的行段
+            auto range = std::equal_range(columns.slot, columns.slot + info.rows, slot);
+            if (range.first < range.second)
+            {
+                readRows(columns, static_cast<size_t>(range.first - columns.slot),
+                         static_cast<size_t>(range.second - columns.slot), begin_ns, end_ns, out);
+            }
+        }
+    }
+    return out.size() - before;
+}
+
+uint64_t TelemetryRecordReader::getBeginNs() const
+{
+    return index.empty() ? 0 : index.front().suffix_min;
+}
+
+uint64_t TelemetryRecordReader::getEndNs() const
+{
+    return index.empty() ? 0 : index.back().prefix_max;
+}
+
+void TelemetryRecordReader::close()
+{
+    if (base != nullptr)
+    {
+        munmap(const_cast<uint8_t*>(base), size);
+        base = nullptr;
+    }
+    if (fd >= 0)
+    {
+        ::close(fd);
+        fd = -1;
+    }
+    size = 0;
+    row_count = 0;
+    index.clear();
+    decoded_chunk = SIZE_MAX;
+}
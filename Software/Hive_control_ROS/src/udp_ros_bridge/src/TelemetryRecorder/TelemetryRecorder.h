@@ -0,0 +1,304 @@
+#ifndef TELEMETRY_RECORDER_H
+#define TELEMETRY_RECORDER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// ====================== 列式遥测记录文件 ======================
+// 文件头32字节，之后是连续的数据块（chunk），整数均为小端（本机字节序）：
+//   文件头：[魔数 "HIVETLM\0" 8][版本 4][文件头长度 4][创建时间 8][数据结束偏移 8]
+//   块头：  [魔数 "CHNK" 4][行数 4][最早时间 8][最晚时间 8][块长度 8][槽位数 4][编码 4][统计区长度 4][重启点数 4]
+//   统计区：槽位到batt各列的 [最小值 float][最大值 float]，补齐到8字节（版本3起，之前的版本长度为0）
+//   原样块：[块头 48][统计区][时间列][槽位列][roll列][pitch列][yaw列][x列][y列][z列][id列][batt列]
+//   压缩块：[块头 48][统计区][各列压缩后的长度 10x4，补齐到48][重启点表 56xN][各列的 Gorilla 编码，顺序同上]
+//   重启点：[段首行时间 8][段首行槽位 2][保留 2][段首行号 4][各列本段编码相对该列起点的字节偏移 10x4]
+// 每列连续存放一个字段，按8字节对齐；块内的行按 (槽位, 时间) 排序，
+// 同一架无人机的记录在块内连续，按槽位和时间都可以二分查找。
+// 压缩块每 RESTART_ROWS 行重新开始编码（版本4起；之前的版本重启点数为0，整列只能从头解码），
+// 重启点表按 (槽位, 时间) 有序，按槽位查询时只解码包含该槽位的段。
+// 统计区供查询跳过不可能满足条件的块。
+// 数据结束偏移在每个块写完后更新，进程崩溃时只丢失未封块的数据
+static const char TELEMETRY_FILE_MAGIC[8] = {'H', 'I', 'V', 'E', 'T', 'L', 'M', '\0'};
+static const uint32_t TELEMETRY_FILE_VERSION = 4;
+static const size_t TELEMETRY_HEADER_SIZE = 32;
+static const size_t TELEMETRY_CHUNK_HEADER_SIZE = 48;
+static const size_t TELEMETRY_CHUNK_STATS_SIZE = 80;
+static const uint32_t TELEMETRY_CHUNK_MAGIC = 0x4B4E4843; // "CHNK"
+
+/**
+ * @brief 数据块的列编码
+ */
+enum class TelemetryEncoding : uint32_t {
+    // 定长原样存放，查询直接读映射区
+    RAW = 0,
+    // 整数列二阶差分、浮点列异或（见 GorillaCodec），仿真集群约为原样的40%；
+    // 按槽位查询时只解码重启点之间的相关段，查询全部无人机时整块解码
+    GORILLA = 1,
+};
+
+/**
+ * @brief 列的顺序（块内存放顺序，也用作列掩码的位号）
+ */
+enum TelemetryColumn {
+    TELEMETRY_TIME = 0,
+    TELEMETRY_SLOT,
+    TELEMETRY_ROLL,
+    TELEMETRY_PITCH,
+    TELEMETRY_YAW,
+    TELEMETRY_X,
+    TELEMETRY_Y,
+    TELEMETRY_Z,
+    TELEMETRY_ID,
+    TELEMETRY_BATT,
+    TELEMETRY_COLUMN_COUNT
+};
+static const uint32_t TELEMETRY_ALL_COLUMNS = (1u << TELEMETRY_COLUMN_COUNT) - 1;
+
+/**
+ * @brief 一行遥测记录（一架无人机一次解码后的状态）
+ */
+struct TelemetryRow {
+    // 解码完成时间（CLOCK_REALTIME纳秒）
+    uint64_t time_ns = 0;
+    // 注册表槽位
+    uint16_t slot = 0;
+    uint8_t id = 0;
+    int16_t roll = 0;
+    int16_t pitch = 0;
+    int16_t yaw = 0;
+    float x = 0;
+    float y = 0;
+    float z = 0;
+    uint8_t batt = 0;
+};
+
+/**
+ * @brief 一个块的各列（按块内行号索引），只有读取时请求的列有效，其余为空指针
+ */
+struct TelemetryColumns {
+    size_t rows = 0;
+    const uint64_t* time = nullptr;
+    const uint16_t* slot = nullptr;
+    const int16_t* roll = nullptr;
+    const int16_t* pitch = nullptr;
+    const int16_t* yaw = nullptr;
+    const float* x = nullptr;
+    const float* y = nullptr;
+    const float* z = nullptr;
+    const uint8_t* id = nullptr;
+    const uint8_t* batt = nullptr;
+};
+
+/**
+ * @brief 块的索引信息
+ */
+struct TelemetryChunkInfo {
+    uint32_t rows = 0;
+    uint64_t t_min = 0;
+    uint64_t t_max = 0;
+    // 有统计区时 min/max 有效（时间列不用，见 t_min/t_max）
+    bool has_stats = false;
+    float min[TELEMETRY_COLUMN_COUNT] = {};
+    float max[TELEMETRY_COLUMN_COUNT] = {};
+};
+
+/**
+ * @brief 列式遥测记录（内存映射，追加写入）
+ * @note 记录先按行放进内存中的当前块，满 chunk_rows 行后按槽位计数排序、按列写进映射区（封块）；
+ *       未封块的行查询不到、进程崩溃时丢失，行数少的集群由调用方定期 flushOlderThan() 按时间封块。
+ *       文件按最大长度预留地址空间，按 GROW_BYTES 逐段用 posix_fallocate 在磁盘上分配后扩展，
+ *       磁盘满时分配失败，停在已分配的长度，之后的块计为丢弃，而不是写映射时收到 SIGBUS。
+ *       append 可由多个解码线程调用（互斥锁保护，临界区只是拷贝一行；封块时多拷贝一个块）。
+ *       同一槽位只由一个解码线程写入，块内每架无人机的记录保持时间顺序
+ */
+class TelemetryRecorder {
+public:
+    // 默认每块行数：1000架无人机50Hz时约每80毫秒封一块
+    static const size_t DEFAULT_CHUNK_ROWS = 4096;
+    // 压缩时的每块行数：同一架无人机在块内的连续样本越多，差分越小；1000架时每架约65行
+    static const size_t COMPRESSED_CHUNK_ROWS = 65536;
+    // 压缩块每隔多少行设一个重启点：单点查询最多解码两段，重启点表和每段重新写首值约增加5%的长度
+    static const size_t RESTART_ROWS = 128;
+    // 文件每次扩展的字节数
+    static const size_t GROW_BYTES = 16 * 1024 * 1024;
+
+    TelemetryRecorder() = default;
+    ~TelemetryRecorder();
+
+    TelemetryRecorder(const TelemetryRecorder&) = delete;
+    TelemetryRecorder& operator=(const TelemetryRecorder&) = delete;
+
+    /**
+     * @brief 创建（覆盖）记录文件
+     * @param path 文件路径
+     * @param max_bytes 文件最大长度（字节）
+     * @param chunk_rows 每块行数
+     * @param encoding 列编码
+     * @return 失败返回false（已记录日志）
+     */
+    bool open(const std::string& path, size_t max_bytes, size_t chunk_rows = DEFAULT_CHUNK_ROWS,
+              TelemetryEncoding encoding = TelemetryEncoding::RAW);
+
+    /**
+     * @brief 追加一行
+     * @return 文件已满或未打开时返回false
+     */
+    bool append(const TelemetryRow& row);
+
+    /**
+     * @brief 封存当前块（不足一块也写入）
+     */
+    void flush();
+
+    /**
+     * @brief 当前块最早的一行早于 now_ns - max_age_ns 时封存（不足一块也写入）
+     * @param now_ns 当前时间（CLOCK_REALTIME纳秒，与行时间同一时钟）
+     * @param max_age_ns 未封块的行最长停留时间
+     * @return 封存了一块时返回true
+     * @note 压缩块按 COMPRESSED_CHUNK_ROWS 封块时，十几架无人机要几分钟才攒满一块，由主循环每秒调用一次
+     */
+    bool flushOlderThan(uint64_t now_ns, uint64_t max_age_ns);
+
+    /**
+     * @brief 封存当前块，截断到实际长度并关闭
+     */
+    void close();
+
+    bool isOpen() const { return base != nullptr; }
+    // 已追加的行数（含未封块的）
+    uint64_t getRowCount() const;
+    // 已封存的块数
+    uint64_t getChunkCount() const;
+    // 已使用的文件长度
+    uint64_t getByteCount() const;
+    // 文件写满（或磁盘满）后丢弃的行数
+    uint64_t getDroppedCount() const;
+
+private:
+    // 把当前块写进映射区，调用者持有锁
+    bool sealLocked();
+    void closeLocked();
+    // 确保文件长度覆盖到 end，不够时在磁盘上分配并扩展；磁盘满时不再扩展
+    bool reserveLocked(size_t end);
+
+    mutable std::mutex mutex;
+    int fd = -1;
+    uint8_t* base = nullptr;
+    size_t capacity = 0;
+    // 已在磁盘上分配的长度
+    size_t file_size = 0;
+    // 允许写到的位置：最大长度，磁盘满后缩到 file_size
+    size_t limit = 0;
+    size_t used = 0;
+    size_t chunk_rows = DEFAULT_CHUNK_ROWS;
+    TelemetryEncoding encoding = TelemetryEncoding::RAW;
+    // 当前块（按行暂存）和封块时的排序暂存
+    std::vector<TelemetryRow> pending;
+    std::vector<uint32_t> order;
+    std::vector<uint32_t> slot_counts;
+    // 压缩时先按列排进 staging，再编码到 encoded，重启点表写进 restarts
+    std::vector<uint64_t> staging;
+    std::vector<uint8_t> encoded;
+    std::vector<uint8_t> restarts;
+    uint64_t rows = 0;
+    uint64_t chunks = 0;
+    uint64_t dropped = 0;
+};
+
+/**
+ * @brief 列式遥测记录读取与查询
+ * @note 打开时沿块头建立稀疏时间索引（每块一项，只读块头和统计区），
+ *       按时间范围二分定位首块，块内按槽位和时间二分，查询只读相关的列片段。
+ *       query 把压缩块解码到内部缓冲区：指定了槽位时按重启点表只解码相关的段，
+ *       查询全部无人机时整块解码并缓存最近一块；同一读取对象的 query 不能并发；
+ *       readChunk 使用调用者的缓冲区，可由多个线程同时调用
+ */
+class TelemetryRecordReader {
+public:
+    TelemetryRecordReader() = default;
+    ~TelemetryRecordReader();
+
+    TelemetryRecordReader(const TelemetryRecordReader&) = delete;
+    TelemetryRecordReader& operator=(const TelemetryRecordReader&) = delete;
+
+    /**
+     * @brief 打开记录文件并建立时间索引
+     * @return 文件不存在或格式不符时返回false
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief 查询时间范围内指定无人机的记录
+     * @param begin_ns 起始时间（含）
+     * @param end_ns 结束时间（含）
+     * @param slots 槽位列表，为空表示全部
+     * @param out 输出，追加写入；同一块内按槽位、时间排列，块与块之间按时间先后
+     * @return 输出的行数
+     */
+    size_t query(uint64_t begin_ns, uint64_t end_ns, const std::vector<uint16_t>& slots,
+                 std::vector<TelemetryRow>& out) const;
+
+    /**
+     * @brief 时间范围可能覆盖的块 [first, last)
+     * @note 区间内个别块的时间范围可能不相交，调用者再按 getChunkInfo 判断
+     */
+    void findChunks(uint64_t begin_ns, uint64_t end_ns, size_t& first, size_t& last) const;
+
+    /**
+     * @brief 读取一个块的部分列
+     * @param chunk 块号
+     * @param columns 列掩码（1 << TelemetryColumn），压缩块只解码这些列
+     * @param buffer 解码缓冲区（原样块不使用）；同一块分几次读取不同列时传同一个缓冲区，之前解码的列保持有效
+     * @param out 输出各列指针
+     * @return 块号无效或数据损坏时返回false
+     */
+    bool readChunk(size_t chunk, uint32_t columns, std::vector<uint64_t>& buffer, TelemetryColumns& out) const;
+
+    size_t getChunkCount() const { return index.size(); }
+    const TelemetryChunkInfo& getChunkInfo(size_t chunk) const { return index[chunk].info; }
+    uint64_t getRowCount() const { return row_count; }
+    // 记录中的最早和最晚时间
+    uint64_t getBeginNs() const;
+    uint64_t getEndNs() const;
+
+    void close();
+
+private:
+    // 稀疏时间索引，每块一项
+    struct ChunkIndex {
+        TelemetryChunkInfo info;
+        size_t offset;
+        size_t bytes;
+        // 列数据（原样列或压缩目录）相对块起点的偏移
+        size_t data_offset;
+        TelemetryEncoding encoding;
+        // 压缩块的重启点数（0表示整列一段）
+        uint32_t restart_count;
+        // 本块及之前各块的最晚时间（单调不减，用于二分定位首块）
+        uint64_t prefix_max;
+        // 本块及之后各块的最早时间（单调不减，用于判断何时停止）
+        uint64_t suffix_min;
+    };
+
+    // 读取块内 [first, last) 行中时间在范围内的行
+    void readRows(const TelemetryColumns& columns, size_t first, size_t last, uint64_t begin_ns, uint64_t end_ns,
+                  std::vector<TelemetryRow>& out) const;
+    // 按重启点只解码指定槽位所在的段并读取（有重启点的压缩块）
+    void querySegments(size_t chunk, uint64_t begin_ns, uint64_t end_ns, const std::vector<uint16_t>& slots,
+                       std::vector<TelemetryRow>& out) const;
+
+    int fd = -1;
+    const uint8_t* base = nullptr;
+    size_t size = 0;
+    uint64_t row_count = 0;
+    std::vector<ChunkIndex> index;
+    // query 最近解码的块
+    mutable std::vector<uint64_t> decoded;
+    mutable size_t decoded_chunk = SIZE_MAX;
+};
+
+#endif // TELEMETRY_RECORDER_H
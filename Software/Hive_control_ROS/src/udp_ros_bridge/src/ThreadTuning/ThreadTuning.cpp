@@ -0,0 +1,110 @@
+#include "ThreadTuning.h"
+#include "udp_ros_bridge/Logger.h"
+#include <pthread.h>
+#include <sched.h>
+#include <cstring>
+#include <time.h>
+
+// ====================== 应用调度策略 ======================
+bool applyThreadPolicy(const ThreadPolicy& policy, const char* name)
+{
+    bool ok = true;
+    pthread_t self = pthread_self();
+
+    if (name != nullptr)
+    {
+        // 线程名最长15字节，超出部分截断
+        char short_name[16];
+        strncpy(short_name, name, sizeof(short_name) - 1);
+        short_name[sizeof(short_name) - 1] = '\0';
+        pthread_setname_np(self, short_name);
+    }
+
+    // 绑核
+    if (!policy.cpus.empty())
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : policy.cpus)
+        {
+            if (cpu >= 0 && cpu < CPU_SETSIZE)
+            {
+                CPU_SET(cpu, &set);
+            }
+        }
+        int err = pthread_setaffinity_np(self, sizeof(set), &set);
+        if (err != 0)
+        {
+            LOG_WARN("线程 {} 绑核失败: {}", name, strerror(err));
+            ok = false;
+        }
+    }
+
+    // 实时优先级
+    if (policy.priority > 0)
+    {
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = policy.priority;
+        int err = pthread_setschedparam(self, SCHED_FIFO, &param);
+        if (err != 0)
+        {
+            LOG_WARN("线程 {} 设置SCHED_FIFO优先级 {} 失败: {}（需要CAP_SYS_NICE）",
+                     name, policy.priority, strerror(err));
+            ok = false;
+        }
+    }
+
+    LOG_INFO("线程 {} 调度策略: cpus={} fifo优先级={} busy_poll={}us",
+             name, formatCpuList(policy.cpus), policy.priority, policy.busy_poll_us);
+    return ok;
+}
+
+// ====================== CPU列表格式化 ======================
+std::string formatCpuList(const std::vector<int>& cpus)
+{
+    if (cpus.empty())
+    {
+        return "any";
+    }
+    std::string text;
+    for (size_t i = 0; i < cpus.size(); i++)
+    {
+        if (i != 0)
+        {
+            text += ',';
+        }
+        text += std::to_string(cpus[i]);
+    }
+    return text;
+}
+
+// ====================== 单调时钟 ======================
+static uint64_t nowMonotonicNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+// ====================== 唤醒延迟探针 ======================
+WakeupProbe::WakeupProbe(uint64_t period_ns) : period_ns(period_ns)
+{
+}
+
+void WakeupProbe::onWakeup()
+{
+    uint64_t now = nowMonotonicNs();
+    if (next_deadline_ns != 0)
+    {
+        int64_t late = static_cast<int64_t>(now - next_deadline_ns);
+        if (late >= 0 && static_cast<uint64_t>(late) < period_ns)
+        {
+            latency.record(late);
+            next_deadline_ns += period_ns;
+            return;
+        }
+    }
+    // 第一次唤醒或上一周期超时（循环体本身跑超了），重新对齐
+    next_deadline_ns = now + period_ns;
+}
@@ -0,0 +1,78 @@
+#ifndef THREAD_TUNING_H
+#define THREAD_TUNING_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../LatencyStats/LatencyStats.h"
+
+/**
+ * @brief 单个工作线程的调度策略
+ * @note 默认值表示不做任何修改（沿用系统调度）
+ */
+struct ThreadPolicy {
+    // 允许运行的CPU编号，空表示不绑核
+    std::vector<int> cpus;
+    // SCHED_FIFO优先级(1~99)，0表示保持SCHED_OTHER
+    int priority = 0;
+    // socket忙轮询时间（微秒，SO_BUSY_POLL），0表示关闭；只对收发socket的线程有意义
+    int busy_poll_us = 0;
+};
+
+/**
+ * @brief 桥接各工作线程的调度策略
+ * @note 接收：UDP接收线程；解析：数据解析；发布：ROS发布主循环；上行：向无人机回复关键帧确认（KeyframeUplink）；
+ *       共享内存：集群状态共享内存发布线程；可视化：点云和TF发布线程；预测：延迟补偿外推线程
+ */
+struct BridgeThreadPolicies {
+    ThreadPolicy receive;
+    ThreadPolicy parse;
+    ThreadPolicy publish;
+    ThreadPolicy uplink;
+    ThreadPolicy shm;
+    ThreadPolicy viz;
+    ThreadPolicy predict;
+};
+
+/**
+ * @brief 把调度策略应用到当前线程
+ * @param policy 调度策略
+ * @param name 线程名（显示在top/ps中，最长15字节）
+ * @return 全部设置成功返回true；权限不足等失败只打印警告，线程照常运行
+ * @note SCHED_FIFO需要root或CAP_SYS_NICE（或 ulimit -r）
+ */
+bool applyThreadPolicy(const ThreadPolicy& policy, const char* name);
+
+/**
+ * @brief 把CPU列表格式化为 "0,2,3"，空列表为 "any"
+ */
+std::string formatCpuList(const std::vector<int>& cpus);
+
+/**
+ * @brief 周期线程调度延迟探针
+ * @note 记录线程每次周期性唤醒比预定时刻晚了多少，
+ *       反映绑核/优先级设置在当前机器上的实际效果
+ */
+class WakeupProbe {
+public:
+    /**
+     * @param period_ns 唤醒周期（纳秒）
+     */
+    explicit WakeupProbe(uint64_t period_ns);
+
+    /**
+     * @brief 每次唤醒后调用一次
+     */
+    void onWakeup();
+
+    // 唤醒延迟直方图
+    LatencyHistogram& histogram() { return latency; }
+
+private:
+    uint64_t period_ns;
+    // 下一次预定唤醒时刻（CLOCK_MONOTONIC纳秒），0表示还没开始
+    uint64_t next_deadline_ns = 0;
+    LatencyHistogram latency;
+};
+
+#endif // THREAD_TUNING_H
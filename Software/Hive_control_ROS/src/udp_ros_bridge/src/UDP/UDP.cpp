@@ -1,18 +1,45 @@
 #include "UDP.h"
-#include <iostream>
+#include "udp_ros_bridge/Logger.h"
+#include "../FloodGuard/FloodGuard.h"
+#include "../CaptureFile/CaptureFile.h"
+#include "../LatencyStats/LatencyStats.h"
 #include <unistd.h>
 #include <cstring>
 #include <thread>
+#include <chrono>
+#include <time.h>
+#include <netinet/udp.h>
+#include <linux/sock_diag.h>
+
+// 旧版本头文件中没有UDP_GRO定义（Linux 5.0+）
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+
+// 单次接收缓冲区大小：GRO合并后最大为一个64KB的超级包
+static const size_t RECEIVE_BUFFER_SIZE = 65536;
+// 接收块大小：内核直接写入池中的接收块，一块依次容纳多次接收，剩余空间不足一次最大接收时换下一块
+static const size_t RECEIVE_BLOCK_SIZE = 4 * RECEIVE_BUFFER_SIZE;
+// 预分配的接收块数和每次扩容的块数
+static const size_t RECEIVE_POOL_BLOCKS = 8;
+static const size_t RECEIVE_POOL_GROW = 4;
+// 每次接收的起点按缓存行对齐，相邻两次接收的数据不共享缓存行
+static const size_t RECEIVE_ALIGN = 64;
 
 // ====================== 构造函数 ======================
-UDP::UDP(int port) : sockfd(-1), running(false), server_port(port) {
+UDP::UDP(int port) : sockfd(-1), running(false), server_port(port),
+                       packet_pool(RECEIVE_POOL_BLOCKS, RECEIVE_BLOCK_SIZE, RECEIVE_POOL_GROW),
+                       message_queue(MESSAGE_QUEUE_CAPACITY),
+                       queue_full_count(0), kernel_drops(0), flood_guard(nullptr),
+                       near_overflow_count(0), peak_buffer_usage(0), gro_batches(0), gro_segments(0),
+                       received_count(0), received_bytes(0) {
     // 初始化服务器地址结构
     memset(&server_addr, 0, sizeof(server_addr));
     
     // 创建UDP socket
     sockfd = socket(AF_INET, SOCK_DGRAM, 0);
     if (sockfd < 0) {
-        std::cerr << "创建socket失败" << std::endl;
+        LOG_ERROR("创建socket失败");
         return;
     }
     
@@ -23,13 +50,28 @@ UDP::UDP(int port) : sockfd(-1), running(false), server_port(port) {
     
     // 绑定socket到端口
     if (bind(sockfd, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
-        std::cerr << "绑定端口失败: " << port << std::endl;
+        LOG_ERROR("绑定端口失败: {}", port);
         close(sockfd);
         sockfd = -1;
         return;
     }
+
+    // 开启内核接收时间戳和丢包计数，失败时只是少了统计数据，不影响收发
+    int enable = 1;
+    if (setsockopt(sockfd, SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable)) < 0) {
+        LOG_WARN("开启SO_TIMESTAMPNS失败");
+    }
+    if (setsockopt(sockfd, SOL_SOCKET, SO_RXQ_OVFL, &enable, sizeof(enable)) < 0) {
+        LOG_WARN("开启SO_RXQ_OVFL失败");
+    }
+
+    // 接收超时，保证停止监听时接收线程能及时退出
+    struct timeval timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_usec = RECEIVE_TIMEOUT_MS * 1000;
+    setsockopt(sockfd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
     
-    std::cout << "UDP服务器初始化成功，端口: " << port << std::endl;
+    LOG_INFO("UDP服务器初始化成功，端口: {}", port);
 }
 
 // ====================== 析构函数 ======================
@@ -40,32 +82,44 @@ UDP::~UDP() {
 // ====================== 开始监听 ======================
 void UDP::startListening() {
     if (sockfd < 0) {
-        std::cerr << "UDP服务器未初始化" << std::endl;
+        LOG_ERROR("UDP服务器未初始化");
+        return;
+    }
+    
+    if (running) {
         return;
     }
     
     running = true;
-    std::cout << "UDP服务器开始监听，端口: " << server_port << std::endl;
+    LOG_INFO("UDP服务器开始监听，端口: {}", server_port);
     
     // 在新线程中运行接收循环
-    std::thread receive_thread(&UDP::receiveLoop, this);
-    receive_thread.detach();
+    receive_thread = std::thread(&UDP::receiveLoop, this);
+}
+
+// ====================== 暂停监听 ======================
+void UDP::stopListening() {
+    running = false;
+    if (receive_thread.joinable()) {
+        receive_thread.join();
+    }
 }
 
 // ====================== 停止服务 ======================
 void UDP::stop() {
-    running = false;
+    // 先等接收线程退出再关socket，避免线程读到被复用的文件描述符
+    stopListening();
     if (sockfd >= 0) {
         close(sockfd);
         sockfd = -1;
-        std::cout << "UDP服务器已停止" << std::endl;
+        LOG_INFO("UDP服务器已停止");
     }
 }
 
 // ====================== 发送数据 ======================
 bool UDP::sendTo(const std::vector<uint8_t>& data, const std::string& ip, int port) {
     if (sockfd < 0) {
-        std::cerr << "UDP未初始化" << std::endl;
+        LOG_ERROR_EVERY(1000, "UDP未初始化");
         return false;
     }
     
@@ -77,7 +131,7 @@ bool UDP::sendTo(const std::vector<uint8_t>& data, const std::string& ip, int po
     
     // 转换IP地址
     if (inet_pton(AF_INET, ip.c_str(), &client_addr.sin_addr) <= 0) {
-        std::cerr << "无效IP地址: " << ip << std::endl;
+        LOG_WARN_EVERY(1000, "无效IP地址: {}", ip);
         return false;
     }
     
@@ -86,55 +140,272 @@ bool UDP::sendTo(const std::vector<uint8_t>& data, const std::string& ip, int po
                                 (struct sockaddr*)&client_addr, sizeof(client_addr));
     
     if (sent_bytes < 0) {
-        std::cerr << "发送失败到 " << ip << ":" << port << std::endl;
+        LOG_WARN_EVERY(1000, "发送失败到 {}:{}", ip, port);
         return false;
     }
     
-    std::cout << "发送成功到 " << ip << ":" << port << " (" << data.size() << " 字节)" << std::endl;
+    LOG_DEBUG("发送成功到 {}:{} ({} 字节)", ip, port, data.size());
     return true;
 }
 
+// ====================== 取出数据包 ======================
+bool UDP::popMessage(UdpPacket& packet) {
+    return message_queue.pop(packet);
+}
+
 // ====================== 获取消息队列 ======================
-std::queue<std::vector<uint8_t>> UDP::getMessageQueue() {
-    std::lock_guard<std::mutex> lock(queue_mutex);
-    std::queue<std::vector<uint8_t>> result;
-    // 使用swap避免拷贝，同时清空原队列
-    result.swap(message_queue);
+std::queue<UdpPacket> UDP::getMessageQueue() {
+    std::queue<UdpPacket> result;
+    UdpPacket packet;
+    while (message_queue.pop(packet)) {
+        result.push(std::move(packet));
+    }
     return result;
 }
 
 // ====================== 获取消息数量 ======================
 size_t UDP::getMessageCount() {
-    std::lock_guard<std::mutex> lock(queue_mutex);
     return message_queue.size();
 }
 
+uint64_t UDP::getQueueFullCount() const {
+    return queue_full_count.load(std::memory_order_relaxed);
+}
+
+// ====================== 数据包入队 ======================
+bool UDP::enqueue(UdpPacket&& packet) {
+    if (packet_sink != nullptr) {
+        return packet_sink->push(std::move(packet));
+    }
+    if (message_queue.push(std::move(packet))) {
+        return true;
+    }
+    // 队列满：暂停读socket，让数据报留在内核缓冲区，等处理线程跟上
+    queue_full_count.fetch_add(1, std::memory_order_relaxed);
+    while (running) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        if (message_queue.push(std::move(packet))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ====================== 获取内核丢包计数 ======================
+uint32_t UDP::getKernelDropCount() const {
+    return kernel_drops.load(std::memory_order_relaxed);
+}
+
+// ====================== 设置防洪器 ======================
+void UDP::setFloodGuard(FloodGuard* guard) {
+    flood_guard = guard;
+}
+
+// ====================== 设置数据包去向 ======================
+void UDP::setPacketSink(PacketSink* sink) {
+    packet_sink = sink;
+}
+
+// ====================== 设置抓包文件 ======================
+void UDP::setCapture(CaptureWriter* writer) {
+    capture = writer;
+}
+
+// ====================== 设置接收缓冲区大小 ======================
+int UDP::setReceiveBufferSize(int bytes) {
+    if (sockfd < 0) {
+        return -1;
+    }
+    // SO_RCVBUFFORCE需要CAP_NET_ADMIN，失败时退回受rmem_max限制的SO_RCVBUF
+    if (setsockopt(sockfd, SOL_SOCKET, SO_RCVBUFFORCE, &bytes, sizeof(bytes)) < 0 &&
+        setsockopt(sockfd, SOL_SOCKET, SO_RCVBUF, &bytes, sizeof(bytes)) < 0) {
+        LOG_WARN("设置接收缓冲区失败: {} 字节", bytes);
+        return -1;
+    }
+    int actual = getReceiveBufferSize();
+    // 内核把设置值翻倍用于记账，getsockopt 读到的是翻倍后的值，
+    // 折半后低于期望说明被rmem_max截断了
+    if (actual >= 0 && actual / 2 < bytes) {
+        LOG_WARN("接收缓冲区被截断为 {} 字节（期望 {}），可调大 net.core.rmem_max 或授予 CAP_NET_ADMIN",
+                 actual / 2, bytes);
+    }
+    return actual;
+}
+
+// ====================== 获取接收缓冲区大小 ======================
+int UDP::getReceiveBufferSize() const {
+    int size = 0;
+    socklen_t len = sizeof(size);
+    if (sockfd < 0 || getsockopt(sockfd, SOL_SOCKET, SO_RCVBUF, &size, &len) < 0) {
+        return -1;
+    }
+    return size;
+}
+
+// ====================== 开启/关闭GRO ======================
+bool UDP::setGro(bool enable) {
+    int value = enable ? 1 : 0;
+    if (sockfd < 0 || setsockopt(sockfd, SOL_UDP, UDP_GRO, &value, sizeof(value)) < 0) {
+        LOG_WARN("设置UDP_GRO失败（需要Linux 5.0以上）");
+        return false;
+    }
+    return true;
+}
+
+// ====================== 设置接收线程调度策略 ======================
+void UDP::setThreadPolicy(const ThreadPolicy& policy) {
+    receive_policy = policy;
+    if (sockfd >= 0 && policy.busy_poll_us > 0) {
+        int busy_poll = policy.busy_poll_us;
+        if (setsockopt(sockfd, SOL_SOCKET, SO_BUSY_POLL, &busy_poll, sizeof(busy_poll)) < 0) {
+            LOG_WARN("设置SO_BUSY_POLL {}us失败（超过net.core.busy_read时需要CAP_NET_ADMIN）", busy_poll);
+        }
+    }
+}
+
+// ====================== 缓冲区统计 ======================
+uint64_t UDP::getNearOverflowCount() const {
+    return near_overflow_count.load(std::memory_order_relaxed);
+}
+
+int UDP::takePeakBufferUsage() {
+    return peak_buffer_usage.exchange(0, std::memory_order_relaxed);
+}
+
+uint64_t UDP::getGroBatchCount() const {
+    return gro_batches.load(std::memory_order_relaxed);
+}
+
+uint64_t UDP::getGroSegmentCount() const {
+    return gro_segments.load(std::memory_order_relaxed);
+}
+
+// ====================== 采样缓冲区占用 ======================
+void UDP::sampleBufferUsage() {
+#ifdef SO_MEMINFO
+    uint32_t meminfo[SK_MEMINFO_VARS];
+    socklen_t len = sizeof(meminfo);
+    if (getsockopt(sockfd, SOL_SOCKET, SO_MEMINFO, meminfo, &len) < 0 || meminfo[SK_MEMINFO_RCVBUF] == 0) {
+        return;
+    }
+    int usage = static_cast<int>(100ULL * meminfo[SK_MEMINFO_RMEM_ALLOC] / meminfo[SK_MEMINFO_RCVBUF]);
+    if (usage >= NEAR_OVERFLOW_PERCENT) {
+        near_overflow_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    int peak = peak_buffer_usage.load(std::memory_order_relaxed);
+    while (usage > peak && !peak_buffer_usage.compare_exchange_weak(peak, usage, std::memory_order_relaxed)) {
+    }
+#endif
+}
+
 // ====================== 接收循环（在独立线程中运行）======================
 void UDP::receiveLoop() {
-    char buffer[1024];
+    // 当前接收块：内核直接写入池中的缓冲区，数据报以（偏移，长度）引用该块，全程不拷贝
+    PacketRef block;
+    size_t block_used = 0;
     struct sockaddr_in client_addr;
-    socklen_t client_len = sizeof(client_addr);
+    // 辅助数据缓冲区：内核时间戳 + 丢包计数 + GRO段长
+    char control[CMSG_SPACE(sizeof(struct timespec)) + CMSG_SPACE(sizeof(uint32_t)) + CMSG_SPACE(sizeof(int))];
+    
+    struct iovec iov;
+    struct msghdr msg;
+    unsigned receive_count = 0;
+    
+    applyThreadPolicy(receive_policy, "udp_receive");
     
     while (running) {
-        memset(buffer, 0, sizeof(buffer));
+        // 剩余空间放不下一次最大接收时换一块；旧块由还在处理的数据包持有，最后一个释放时归还
+        if (!block || block.capacity() - block_used < RECEIVE_BUFFER_SIZE) {
+            block = packet_pool.acquire(RECEIVE_BLOCK_SIZE);
+            block_used = 0;
+        }
+        iov.iov_base = block.data() + block_used;
+        iov.iov_len = RECEIVE_BUFFER_SIZE;
+        
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_name = &client_addr;
+        msg.msg_namelen = sizeof(client_addr);
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
         
         // 阻塞接收数据
-        ssize_t recv_len = recvfrom(sockfd, buffer, sizeof(buffer), 0,
-                                   (struct sockaddr*)&client_addr, &client_len);
+        ssize_t recv_len = recvmsg(sockfd, &msg, 0);
         
         if (recv_len > 0) {
-            // 获取客户端信息
-            std::string client_ip = inet_ntoa(client_addr.sin_addr);
-            int client_port = ntohs(client_addr.sin_port);
+            uint64_t wakeup_ns = nowRealtimeNs();
+            uint64_t kernel_ns = 0;
+            // GRO段长，0表示这次只交付了一个数据报
+            int segment_size = 0;
+            
+            // 解析辅助数据：内核时间戳、丢包计数和GRO段长
+            for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+                if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_TIMESTAMPNS) {
+                    struct timespec ts;
+                    memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+                    kernel_ns = static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+                } else if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_RXQ_OVFL) {
+                    uint32_t drops;
+                    memcpy(&drops, CMSG_DATA(cmsg), sizeof(drops));
+                    kernel_drops.store(drops, std::memory_order_relaxed);
+                } else if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+                    memcpy(&segment_size, CMSG_DATA(cmsg), sizeof(segment_size));
+                }
+            }
+            
+            if (kernel_ns != 0) {
+                wakeup_latency.record(static_cast<int64_t>(wakeup_ns - kernel_ns));
+            }
+            
+            // 定期采样缓冲区占用，突发时（GRO合并）每次都采样
+            if (segment_size > 0 || ++receive_count % BUFFER_SAMPLE_INTERVAL == 0) {
+                sampleBufferUsage();
+            }
             
-            std::cout << "收到来自 " << client_ip << ":" << client_port 
-                     << " (" << recv_len << " 字节)" << std::endl;
+            uint64_t datagrams = 1;
+            if (segment_size <= 0 || segment_size >= recv_len) {
+                segment_size = static_cast<int>(recv_len);
+            } else {
+                datagrams = (recv_len + segment_size - 1) / segment_size;
+                gro_batches.fetch_add(1, std::memory_order_relaxed);
+                gro_segments.fetch_add(datagrams, std::memory_order_relaxed);
+            }
+            received_count.store(received_count.load(std::memory_order_relaxed) + datagrams, std::memory_order_relaxed);
+            received_bytes.store(received_bytes.load(std::memory_order_relaxed) + static_cast<uint64_t>(recv_len), std::memory_order_relaxed);
             
-            // 将接收到的数据转换为vector并存入队列
-            std::vector<uint8_t> data(buffer, buffer + recv_len);
+            // 客户端信息只在DEBUG级别才格式化
+            LOG_DEBUG("收到来自 {}:{} ({} 字节，段长 {})",
+                      inet_ntoa(client_addr.sin_addr), ntohs(client_addr.sin_port), recv_len, segment_size);
             
-            std::lock_guard<std::mutex> lock(queue_mutex);
-            message_queue.push(data);
+            // GRO拆出的数据报直接引用接收块中的对应段，共享同一块的引用计数
+            const uint8_t* received = block.data() + block_used;
+            for (ssize_t offset = 0; offset < recv_len; offset += segment_size) {
+                UdpPacket packet;
+                packet.kernel_ns = kernel_ns;
+                size_t length = static_cast<size_t>(recv_len - offset < segment_size ? recv_len - offset : segment_size);
+                
+                // 抓包在限流之前，记录收到的每个数据报
+                if (capture != nullptr) {
+                    capture->append(kernel_ns != 0 ? kernel_ns : wakeup_ns, client_addr, received + offset, length);
+                }
+                
+                // 按来源限流，被丢弃的数据报不入队（GRO合并的每一段都单独计数）
+                if (flood_guard != nullptr) {
+                    uint64_t now_ns = kernel_ns != 0 ? kernel_ns : wakeup_ns;
+                    if (!flood_guard->admit(client_addr, now_ns, packet.slot)) {
+                        continue;
+                    }
+                }
+                
+                packet.buffer = block;
+                packet.offset = static_cast<uint32_t>(block_used + offset);
+                packet.length = static_cast<uint32_t>(length);
+                if (!enqueue(std::move(packet))) {
+                    break;
+                }
+            }
+            block_used += (static_cast<size_t>(recv_len) + RECEIVE_ALIGN - 1) / RECEIVE_ALIGN * RECEIVE_ALIGN;
         }
     }
 }
@@ -177,7 +448,7 @@ std::queue<ClientAddress> UDP::getClientAddressQueue() {
 // ====================== 线程管理封装 ======================
 void UDP::manageThread() {
     if (running) {
-        stop();
+        stopListening();
     } else {
         startListening();
     }
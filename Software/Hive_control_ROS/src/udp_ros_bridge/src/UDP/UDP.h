@@ -8,6 +8,12 @@
 #include <queue>
 #include <mutex>
 #include <vector>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include "../ThreadTuning/ThreadTuning.h"
+#include "../PacketPool/PacketPool.h"
 
 // 存放IP和端口的结构体
 struct ClientAddress {
@@ -15,6 +21,43 @@ struct ClientAddress {
     int port;
 };
 
+// 接收到的数据包
+// 数据在 PacketPool 的接收块中（内核直接写入），各处理阶段拷贝 UdpPacket 只增加引用计数，不拷贝数据；
+// 一块接收块依次容纳多次接收（含GRO合并后拆出的多个数据报），每个数据包只记录偏移和长度
+struct UdpPacket {
+    // 数据所在的缓冲区
+    PacketRef buffer;
+    // 本数据报在缓冲区中的偏移和长度
+    uint32_t offset = 0;
+    uint32_t length = 0;
+    // 内核接收时间戳（SO_TIMESTAMPNS，CLOCK_REALTIME纳秒），0表示内核未提供
+    uint64_t kernel_ns = 0;
+    // 来源无人机槽位（注册表下标），未知来源为-1
+    int slot = -1;
+
+    // 原始字节数据
+    const uint8_t* data() const { return buffer ? buffer.data() + offset : nullptr; }
+    size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+};
+
+class FloodGuard;
+class CaptureWriter;
+
+/**
+ * @brief 数据包去向
+ * @note 设置后接收线程把数据包直接交给它（如 DecodePool），不再放入 UDP 自身的消息队列
+ */
+class PacketSink {
+public:
+    virtual ~PacketSink() = default;
+    /**
+     * @brief 在接收线程中调用，接收线程是唯一的调用者
+     * @return 放弃该数据包（如已停止）时返回false
+     */
+    virtual bool push(UdpPacket&& packet) = 0;
+};
+
 /**
  * @brief UDP通信类
  * @note 简化版本，只处理原始字节数据，线程安全
@@ -38,6 +81,12 @@ public:
      */
     void startListening();
     
+    /**
+     * @brief 暂停监听
+     * @note 停止并等待接收线程退出，socket保持打开（注册阶段仍可用getClientFromBuffer读取）
+     */
+    void stopListening();
+    
     /**
      * @brief 停止UDP服务
      * @note 关闭socket并停止接收线程
@@ -51,14 +100,22 @@ public:
      * @param port 目标端口号
      * @return 发送成功返回true，失败返回false
      */
-    bool sendTo(const std::vector<uint8_t>& data);
+    bool sendTo(const std::vector<uint8_t>& data, const std::string& ip, int port);
     
+    /**
+     * @brief 取出一个接收到的数据包
+     * @param packet 输出，原来持有的缓冲区引用被释放
+     * @return 没有待处理的数据包时返回false
+     * @note 接收线程和调用者之间是无锁环形队列，只允许一个线程取数据；不分配内存
+     */
+    bool popMessage(UdpPacket& packet);
+
     /**
      * @brief 获取接收到的消息队列
      * @return 包含所有未处理消息的队列，获取后队列会被清空
-     * @note 线程安全，使用swap操作避免拷贝
+     * @note 与 popMessage 相同只允许一个线程调用；会为队列分配内存，热路径请用 popMessage
      */
-    std::queue<std::vector<uint8_t>> getMessageQueue();
+    std::queue<UdpPacket> getMessageQueue();
     
     /**
      * @brief 获取缓存中消息数量
@@ -67,6 +124,109 @@ public:
      */
     size_t getMessageCount();
 
+    /**
+     * @brief 接收队列满、接收线程等待取走的次数
+     * @note 等待期间数据报留在内核缓冲区中，缓冲区再满时由内核丢弃并计入内核丢包
+     */
+    uint64_t getQueueFullCount() const;
+
+    /**
+     * @brief 接收块池（块数、扩容次数等统计）
+     */
+    const PacketPool& getPacketPool() const { return packet_pool; }
+
+    /**
+     * @brief 接收线程收到的数据报数和字节数（GRO合并的按拆出的数据报计，含被限流丢弃的）
+     * @note 只有接收线程写，读取线程安全
+     */
+    uint64_t getReceivedCount() const { return received_count.load(std::memory_order_relaxed); }
+    uint64_t getReceivedByteCount() const { return received_bytes.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 获取内核丢包计数
+     * @return 因接收缓冲区满被内核丢弃的数据报总数（SO_RXQ_OVFL）
+     * @note 线程安全，计数从socket创建开始累计
+     */
+    uint32_t getKernelDropCount() const;
+
+    /**
+     * @brief 设置按来源限流的防洪器
+     * @param guard 防洪器，传nullptr关闭限流
+     * @note 必须在接收线程停止时设置
+     */
+    void setFloodGuard(FloodGuard* guard);
+
+    /**
+     * @brief 设置数据包去向
+     * @param sink 去向，传nullptr时放入自身消息队列（popMessage/getMessageQueue 取出）
+     * @note 必须在接收线程停止时设置
+     */
+    void setPacketSink(PacketSink* sink);
+
+    /**
+     * @brief 设置原始数据报抓包文件
+     * @param writer 抓包文件，传nullptr关闭抓包
+     * @note 必须在接收线程停止时设置；限流之前记录，被限流丢弃的数据报也会写入
+     */
+    void setCapture(CaptureWriter* writer);
+
+    /**
+     * @brief 设置内核接收缓冲区大小
+     * @param bytes 期望大小（字节）
+     * @return 内核实际分配的大小（字节，getsockopt 读数，含记账开销，为生效设置值的两倍），失败返回-1
+     * @note 优先使用SO_RCVBUFFORCE（需要CAP_NET_ADMIN，可突破rmem_max），
+     *       没有权限时退回SO_RCVBUF，此时受 /proc/sys/net/core/rmem_max 限制
+     */
+    int setReceiveBufferSize(int bytes);
+
+    /**
+     * @brief 获取内核接收缓冲区大小（字节）
+     */
+    int getReceiveBufferSize() const;
+
+    /**
+     * @brief 开启/关闭UDP_GRO
+     * @param enable 是否开启
+     * @return 成功返回true（内核低于5.0时不支持，返回false）
+     * @note 开启后内核会把同一来源的连续数据报合并成一次交付，
+     *       接收线程再按段长拆回独立数据包（不拷贝数据）
+     */
+    bool setGro(bool enable);
+
+    /**
+     * @brief 接收缓冲区接近溢出（占用超过 NEAR_OVERFLOW_PERCENT）的采样次数
+     */
+    uint64_t getNearOverflowCount() const;
+
+    /**
+     * @brief 接收缓冲区占用峰值（百分比），读取后清零
+     */
+    int takePeakBufferUsage();
+
+    /**
+     * @brief GRO合并交付的次数和其中包含的数据报总数
+     */
+    uint64_t getGroBatchCount() const;
+    uint64_t getGroSegmentCount() const;
+
+    /**
+     * @brief 设置接收线程的调度策略
+     * @param policy 绑核、SCHED_FIFO优先级和SO_BUSY_POLL忙轮询时间
+     * @note 忙轮询立即设置到socket上；绑核和优先级在接收线程启动时生效
+     */
+    void setThreadPolicy(const ThreadPolicy& policy);
+
+    /**
+     * @brief 接收线程唤醒延迟（内核收到数据报到recvmsg返回）
+     * @note 反映接收线程的调度延迟，用于检查绑核/优先级设置的效果
+     */
+    LatencyHistogram& getWakeupLatency() { return wakeup_latency; }
+
+    // 接收缓冲区占用超过该百分比记为一次"接近溢出"
+    static const int NEAR_OVERFLOW_PERCENT = 75;
+    // 每接收多少次采样一次缓冲区占用
+    static const int BUFFER_SAMPLE_INTERVAL = 16;
+
     /**
      * @brief 从缓冲区取数据，解析IP和端口，放到队列里
      * @return 成功返回true，失败返回false
@@ -81,29 +241,74 @@ public:
 
     /**
      * @brief 线程管理封装
+     * @note 正在监听则暂停，否则开始监听
      */
     void manageThread();
 
+    // 接收超时（毫秒），空闲时接收线程按此间隔检查是否需要退出
+    static const int RECEIVE_TIMEOUT_MS = 100;
+    // 接收队列容量（数据包个数）：主循环两次取数据之间的突发都要放得下，
+    // 否则接收线程停止读socket，由内核缓冲区继续承接
+    static const size_t MESSAGE_QUEUE_CAPACITY = 32768;
+
 private:
     // 套接字文件描述符
     int sockfd;
     // 服务器地址结构
     struct sockaddr_in server_addr;
     // 运行状态标志
-    bool running;
+    std::atomic<bool> running;
+    // 接收线程
+    std::thread receive_thread;
     // 服务器端口号
     int server_port;
     
-    // 消息缓存队列
-    std::queue<std::vector<uint8_t>> message_queue;
+    // 接收块池（内核直接写入），须在消息队列之前声明（队列中的数据包先析构）
+    PacketPool packet_pool;
+    // 消息缓存队列（接收线程写入，处理线程取出）
+    SpscRing<UdpPacket> message_queue;
+    // 接收队列满的等待次数
+    std::atomic<uint64_t> queue_full_count;
     // 初始化 地址队列
     std::queue<ClientAddress> client_address_queue;
-    // 队列访问互斥锁
+    // 地址队列访问互斥锁
     std::mutex queue_mutex;
+    // 内核丢包计数（SO_RXQ_OVFL，由接收线程更新）
+    std::atomic<uint32_t> kernel_drops;
+    // 按来源限流，nullptr表示不限流
+    FloodGuard* flood_guard;
+    // 数据包去向，nullptr表示放入消息队列
+    PacketSink* packet_sink = nullptr;
+    // 抓包文件，nullptr表示不抓包
+    CaptureWriter* capture = nullptr;
+    // 接收缓冲区占用统计
+    std::atomic<uint64_t> near_overflow_count;
+    std::atomic<int> peak_buffer_usage;
+    // GRO统计
+    std::atomic<uint64_t> gro_batches;
+    std::atomic<uint64_t> gro_segments;
+    // 接收统计（单写者，不用读改写原子操作）
+    std::atomic<uint64_t> received_count;
+    std::atomic<uint64_t> received_bytes;
+    // 接收线程调度策略
+    ThreadPolicy receive_policy;
+    // 接收线程唤醒延迟
+    LatencyHistogram wakeup_latency;
+
+    /**
+     * @brief 采样内核接收缓冲区占用（SO_MEMINFO）
+     */
+    void sampleBufferUsage();
+
+    /**
+     * @brief 把一个数据包交给去向或放入消息队列，队列满时等待处理线程取走
+     * @return 停止监听时放弃并返回false
+     */
+    bool enqueue(UdpPacket&& packet);
     
     /**
      * @brief 接收循环（在独立线程中运行）
-     * @note 持续接收UDP数据并存入队列
+     * @note 持续接收UDP数据并存入队列，同时读取内核时间戳和丢包计数
      */
     void receiveLoop();
 };
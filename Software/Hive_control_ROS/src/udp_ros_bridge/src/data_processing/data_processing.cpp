@@ -11,108 +11,31 @@
 /**
  * @brief 解析字符串格式的无人机数据
  * @param data 输入的字符串数据，格式为 "key1=value1,key2=value2,..."
+ * @return 解析结果：成功字段数、忽略的未知键数和第一个错误的位置
  * @details 支持的数据字段：
  *          - id: 无人机编号
  *          - roll, pitch, yaw: MPU6050姿态数据
- *          - x, y, z: GPS位置数据
+ *          - x, y, z: GPS位置数据（浮点数）
  *          - batt: 电池电压数据
  *          - pid0_kp~pid3_kd: 四个电机的PID参数
- * @note 输入字符串应遵循 key=value 的格式，多个键值对用逗号分隔
- * @example "id=1,x=100,y=200,z=50,batt=12,pid0_kp=10"
+ * @note 输入字符串应遵循 key=value 的格式，多个键值对用逗号分隔；
+ *       值非法或越界的字段被跳过并记入返回值，不抛异常，其余字段照常更新
+ * @example "id=1,x=100.5,y=200,z=50,batt=12,pid0_kp=10"
  */
-void DataProcessing::ParseData(const std::string& data)
+ParseResult DataProcessing::ParseData(std::string_view data)
 {
-    // 使用字符串流进行解析，按逗号分割每个键值对
-    std::stringstream ss(data);
-    std::string item;
-    
-    // 逐个解析每个键值对
-    while (std::getline(ss, item, ','))
-    {
-        // 查找等号位置，分离键和值
-        size_t pos = item.find('=');
-        if (pos != std::string::npos)
-        {
-            std::string key = item.substr(0, pos);      // 提取键名
-            std::string value = item.substr(pos + 1);   // 提取键值
-            
-            try {
-                // 根据键名设置对应的数据成员
-                if (key == "id") {
-                    id = static_cast<uint8_t>(std::stoi(value));    // 无人机编号
-                }
-                // MPU6050姿态数据解析
-                else if (key == "roll") {
-                    roll = static_cast<int16_t>(std::stoi(value));  // 横滚角
-                }
-                else if (key == "pitch") {
-                    pitch = static_cast<int16_t>(std::stoi(value)); // 俯仰角
-                }
-                else if (key == "yaw") {
-                    yaw = static_cast<int16_t>(std::stoi(value));   // 偏航角
-                }
-                // GPS位置数据解析
-                else if (key == "x") {
-                    x = static_cast<float>(std::stoi(value));     // 经度
-                }
-                else if (key == "y") {
-                    y = static_cast<float>(std::stoi(value));     // 纬度
-                }
-                else if (key == "z") {
-                    z = static_cast<float>(std::stoi(value));     // 海拔高度
-                }
-                // 电池电压数据解析
-                else if (key == "batt") {
-                    batt = static_cast<uint8_t>(std::stoi(value));  // 电池电压
-                }
-                // 一号电机PID参数解析
-                else if (key == "pid0_kp") {
-                    pid[0].kp = static_cast<uint8_t>(std::stoi(value)); // 比例系数
-                }
-                else if (key == "pid0_ki") {
-                    pid[0].ki = static_cast<uint8_t>(std::stoi(value)); // 积分系数
-                }
-                else if (key == "pid0_kd") {
-                    pid[0].kd = static_cast<uint8_t>(std::stoi(value)); // 微分系数
-                }
-                // 二号电机PID参数解析
-                else if (key == "pid1_kp") {
-                    pid[1].kp = static_cast<uint8_t>(std::stoi(value));
-                }
-                else if (key == "pid1_ki") {
-                    pid[1].ki = static_cast<uint8_t>(std::stoi(value));
-                }
-                else if (key == "pid1_kd") {
-                    pid[1].kd = static_cast<uint8_t>(std::stoi(value));
-                }
-                // 三号电机PID参数解析
-                else if (key == "pid2_kp") {
-                    pid[2].kp = static_cast<uint8_t>(std::stoi(value));
-                }
-                else if (key == "pid2_ki") {
-                    pid[2].ki = static_cast<uint8_t>(std::stoi(value));
-                }
-                else if (key == "pid2_kd") {
-                    pid[2].kd = static_cast<uint8_t>(std::stoi(value));
-                }
-                // 四号电机PID参数解析
-                else if (key == "pid3_kp") {
-                    pid[3].kp = static_cast<uint8_t>(std::stoi(value));
-                }
-                else if (key == "pid3_ki") {
-                    pid[3].ki = static_cast<uint8_t>(std::stoi(value));
-                }
-                else if (key == "pid3_kd") {
-                    pid[3].kd = static_cast<uint8_t>(std::stoi(value));
-                }
-                // 未知键名则忽略
-            }
-            catch (const std::exception& e) {
-                // 数值转换失败，抛出异常给上层处理
-                throw std::runtime_error("字符串解析失败，键[" + key + "]的值[" + value + "]无效: " + e.what());
-            }
-        }
-    }
+    ParseResult result = parseKeyValue(data, *this);
+    CountWritten(result);
+    return result;
+}
+
+/**
+ * @brief 解析字符串格式的无人机数据
+ * @details std::string 可同时隐式转换为 string_view 和 Json::Value，单独提供重载避免歧义
+ */
+ParseResult DataProcessing::ParseData(const std::string& data)
+{
+    return ParseData(std::string_view(data));
 }
 /**
  * @brief 解析JSON格式的无人机数据
@@ -201,6 +124,20 @@ void DataProcessing::ParseData(const Json::Value& data)
     }
 }
 
+/**
+ * @brief 直接从数据报文本解码JSON格式的无人机数据
+ * @param data 数据报中的JSON文本
+ * @return 解析结果，格式错误时本对象保持不变
+ * @details 字段和两种PID格式与 ParseData(const Json::Value&) 相同，但不构建 Json::Value，
+ *          边扫描边写入，适合接收线程逐包解码
+ */
+ParseResult DataProcessing::ParseJson(std::string_view data)
+{
+    ParseResult result = parseTelemetryJson(data, *this);
+    CountWritten(result);
+    return result;
+}
+
 /**
  * @brief 解析二进制格式的无人机数据包
  * @param data 输入的二进制数据指针
@@ -208,15 +145,18 @@ void DataProcessing::ParseData(const Json::Value& data)
  *   [包头0][包头1][状态位][数据长度][参数位1][参数位2]...[参数位n][校验位][包尾]
  *    0xEE   0xEE   status   length    param1    param2      paramn   checksum 0xFF
  * 
- * @note 状态位定义：
+ * @note 状态位高两位为校验方式，第5位表示带序号（见 FrameScanner.h），低5位定义：
  *   - 0x00: 姿态数据 (roll, pitch, yaw) - 6字节
  *   - 0x01: GPS数据 (x, y, z) - 6字节  
  *   - 0x02: ADC数据 (电池电压) - 1字节
  *   - 0x03: 无人机编号 - 1字节
  *   - 0x04~0x07: 电机PID数据 (kp, ki, kd) - 3字节
+ *   - 0x08: 紧凑遥测关键帧 - 20字节
+ *   - 0x09: 紧凑遥测增量帧 - 2~28字节（见 DeltaCodec.h）
  * 
  * @note 校验算法：
  *   校验位 = (状态位 + 数据长度 + 参数位1 + 参数位2 + ... + 参数位n) & 0xFF
+ *   或 CRC-16/CCITT（2字节）、CRC-32C（4字节），高位在前
  * 
  * @example GPS数据包 (16位格式):
  *   [0xEE][0xEE][0x01][0x06][0x00][100][0x00][200][0x00][50][checksum][0xFF]
@@ -228,85 +168,208 @@ void DataProcessing::ParseData(const Json::Value& data)
  */
 void DataProcessing::ParseData(const uint8_t* data)
 {
-    uint8_t check = 0;  // 校验和计算变量
-    
     // 验证包头是否正确 (0xEE 0xEE) 或者数据为空
-    if (data == nullptr || data[0] != 0xEE || data[1] != 0xEE)
+    if (data == nullptr || data[0] != FRAME_HEAD || data[1] != FRAME_HEAD)
     {
         return; // 包头错误，丢弃数据包
     }
-    
-    // 提取状态位和数据长度
-    uint8_t status = data[2];       // 数据类型标识
-    uint8_t length = data[3];       // 参数数据长度
 
-    check += status +length;
+    // 按状态位中的校验方式确定整帧长度，交给扫描器校验和解析
+    size_t check_size = frameCheckSize(data[2]);
+    if (check_size == 0)
+    {
+        return; // 未定义的校验方式
+    }
+    ParseData(data, 5 + frameSeqSize(data[2]) + data[3] + check_size);
+}
+
+/**
+ * @brief 解析一段缓冲区中的全部二进制数据帧
+ * @param data 缓冲区（一个数据报或一段录制数据）
+ * @param size 缓冲区字节数
+ * @param window 来源无人机的序号窗口，为空时不检查序号
+ * @return 校验通过的帧数（含因重复或过期未写入的帧）
+ * @details 由 FrameScanner 找出所有包头并校验，按出现顺序逐帧解析；
+ *          与单帧版本不同，不会读取超出 size 的字节。
+ *          带序号的帧先经过序号窗口，重复帧和过期帧不写入；不带序号的旧格式帧直接写入
+ */
+size_t DataProcessing::ParseData(const uint8_t* data, size_t size, SequenceWindow* window)
+{
+    // 每个解析线程一个扫描器，帧列表复用，稳定后不再分配内存
+    static thread_local FrameScanner scanner;
+    static thread_local std::vector<FrameView> frames;
+
+    scanner.scan(data, size, frames);
+    for (const FrameView& frame : frames)
+    {
+        if (window != nullptr && frame.has_seq &&
+            !SequenceWindow::shouldApply(window->accept(frame.seq, frameFieldGroups(frame.status))))
+        {
+            continue;
+        }
+        ParseFrame(frame);
+    }
+    return frames.size();
+}
 
-    // 计算校验和：累加所有参数位
-    for (int i = 0; i < length; i++)
+uint32_t frameFieldGroups(uint8_t status)
+{
+    switch (status)
     {
-        check += data[4 + i];
+        case 0x00:
+            return FRAME_FIELDS_ATTITUDE;
+        case 0x01:
+            return FRAME_FIELDS_POSITION;
+        case 0x02:
+            return FRAME_FIELDS_BATTERY;
+        case 0x03:
+            return FRAME_FIELDS_ID;
+        case 0x04:
+        case 0x05:
+        case 0x06:
+        case 0x07:
+            return FRAME_FIELDS_PID << (status - 0x04);
+        case FRAME_TYPE_KEYFRAME:
+        case FRAME_TYPE_DELTA:
+            return FRAME_FIELDS_ATTITUDE | FRAME_FIELDS_POSITION | FRAME_FIELDS_BATTERY;
+        default:
+            return 0;
     }
-    
-    
-    // 验证校验位和包尾
-    if (data[4 + length] != (check & 0xFF) || data[5 + length] != 0xFF)
+}
+
+/**
+ * @brief 解析一帧已校验通过的数据
+ * @param frame 帧视图，参数长度不足时忽略该帧
+ * @note 写入了状态时更新次数加一；未知状态位、长度不足和缺少关键帧的增量帧不写入
+ */
+void DataProcessing::ParseFrame(const FrameView& frame)
+{
+    // 各状态位需要的最少参数字节数，不足时丢弃，避免读到帧外
+    static const uint8_t MIN_LENGTH[] = {6, 12, 1, 1, 3, 3, 3, 3, KEYFRAME_LENGTH, 2};
+    if (frame.status < sizeof(MIN_LENGTH) && frame.length < MIN_LENGTH[frame.status])
     {
-        return; // 校验失败或包尾错误，丢弃数据包
+        return;
     }
+    const uint8_t* params = frame.params;
+    TelemetrySample sample;
+    bool applied = true;
+    bool position = false;
+    bool attitude = false;
 
     // 根据状态位解析不同类型的数据
-    switch (status)
+    switch (frame.status)
     {
         case 0x00: // 姿态数据解析
             // 最高位是符号位
-            roll = data[4] << 8 | data[5]; // 横滚角 高八位+低八位
-            pitch = data[6] << 8 | data[7]; // 俯仰角 高八位+低八位
-            yaw = data[8] << 8 | data[9]; // 偏航角 高八位+低八位
+            roll = params[0] << 8 | params[1]; // 横滚角 高八位+低八位
+            pitch = params[2] << 8 | params[3]; // 俯仰角 高八位+低八位
+            yaw = params[4] << 8 | params[5]; // 偏航角 高八位+低八位
+            attitude = true;
             break;
             
         case 0x01: // GPS位置数据解析
             // 注意：GPS数据为浮点数，一共四个字节
-            x = data[4] << 24 | data[5] << 16 | data[6] << 8 | data[7];    
-            y = data[8] << 24 | data[9] << 16 | data[10] << 8 | data[11];    
-            z = data[12] << 24 | data[13] << 16 | data[14] << 8 | data[15];    
+            x = params[0] << 24 | params[1] << 16 | params[2] << 8 | params[3];    
+            y = params[4] << 24 | params[5] << 16 | params[6] << 8 | params[7];    
+            z = params[8] << 24 | params[9] << 16 | params[10] << 8 | params[11];    
+            position = true;
             break;
             
         case 0x02: // 电池电压数据解析
-            batt = data[4];
+            batt = params[0];
             break;
             
         case 0x03: // 无人机编号解析
-            id = data[4];
+            id = params[0];
             break;
             
         case 0x04: // 一号电机PID参数解析
-            pid[0].kp = data[4];    // 比例系数
-            pid[0].ki = data[5];    // 积分系数
-            pid[0].kd = data[6];    // 微分系数
+            pid[0].kp = params[0];    // 比例系数
+            pid[0].ki = params[1];    // 积分系数
+            pid[0].kd = params[2];    // 微分系数
             break;
             
         case 0x05: // 二号电机PID参数解析
-            pid[1].kp = data[4];
-            pid[1].ki = data[5];
-            pid[1].kd = data[6];
+            pid[1].kp = params[0];
+            pid[1].ki = params[1];
+            pid[1].kd = params[2];
             break;
             
         case 0x06: // 三号电机PID参数解析
-            pid[2].kp = data[4];
-            pid[2].ki = data[5];
-            pid[2].kd = data[6];
+            pid[2].kp = params[0];
+            pid[2].ki = params[1];
+            pid[2].kd = params[2];
             break;
             
         case 0x07: // 四号电机PID参数解析
-            pid[3].kp = data[4];
-            pid[3].ki = data[5];
-            pid[3].kd = data[6];
+            pid[3].kp = params[0];
+            pid[3].ki = params[1];
+            pid[3].kd = params[2];
+            break;
+
+        case FRAME_TYPE_KEYFRAME: // 紧凑遥测关键帧，登记待回复的确认
+            applied = decodeKeyframe(params, frame.length, keyframes, sample);
+            if (applied)
+            {
+                ApplySample(sample);
+            }
+            position = attitude = applied;
+            break;
+
+        case FRAME_TYPE_DELTA: // 相对关键帧的增量，关键帧不在时丢弃
+            applied = decodeDelta(params, frame.length, keyframes, sample);
+            if (applied)
+            {
+                ApplySample(sample);
+            }
+            position = attitude = applied;
             break;
             
         default: // 未知状态位，忽略数据包
+            applied = false;
             break;
     }
+    if (applied)
+    {
+        updates++;
+    }
+    position_updates += position;
+    attitude_updates += attitude;
+}
+
+/**
+ * @brief 按文本/JSON解析结果累计写入次数
+ * @param result 解析结果，written 给出实际写入的字段
+ */
+void DataProcessing::CountWritten(const ParseResult& result)
+{
+    if (result.fields > 0)
+    {
+        updates++;
+    }
+    if (result.written & TELEMETRY_POSITION_FIELDS)
+    {
+        position_updates++;
+    }
+    if (result.written & TELEMETRY_ATTITUDE_FIELDS)
+    {
+        attitude_updates++;
+    }
+}
+
+/**
+ * @brief 写入一次紧凑遥测采样
+ * @param sample 关键帧或增量帧还原出的采样，位置与GPS帧一样按整数换算
+ */
+void DataProcessing::ApplySample(const TelemetrySample& sample)
+{
+    roll = sample.roll;
+    pitch = sample.pitch;
+    yaw = sample.yaw;
+    x = static_cast<float>(sample.x);
+    y = static_cast<float>(sample.y);
+    z = static_cast<float>(sample.z);
+    batt = sample.batt;
 }
 
 /**
@@ -321,6 +384,19 @@ void DataProcessing::ParseData(const std::vector<uint8_t>& data)
     }
 }
 
+/**
+ * @brief 解析UDP数据包
+ * @param packet 接收线程放入队列的数据包
+ * @details 时间戳只用于延迟统计，这里只解析其中的字节数据；
+ *          一个数据报中可以有多帧
+ */
+void DataProcessing::ParseData(const UdpPacket& packet)
+{
+    if (!packet.empty()) {
+        ParseData(packet.data(), packet.size());
+    }
+}
+
 // 数据格式
 // IP和端口 的数组
 void DataProcessing::Init_ParseData(const std::vector<Json::Value>& data)
@@ -14,9 +14,29 @@
 #include <algorithm>    // std::min
 #include <stdexcept>    // std::runtime_error
 #include "./../UDP/UDP.h"
+#include "./../SwarmRegistry/SwarmRegistry.h"
+#include "./../FrameScanner/FrameScanner.h"
+#include "./../TelemetryFields/TelemetryFields.h"
+#include "./../TelemetryJson/TelemetryJson.h"
+#include "./../SequenceWindow/SequenceWindow.h"
+#include "./../DeltaCodec/DeltaCodec.h"
 //  ============================= 公共变量声明 ==================
 extern SwarmRegistry swarm_registry;
 
+// 二进制帧写入的字段组（位掩码），序号窗口按字段组判断迟到帧是否过期
+static const uint32_t FRAME_FIELDS_ATTITUDE = 1u << 0;
+static const uint32_t FRAME_FIELDS_POSITION = 1u << 1;
+static const uint32_t FRAME_FIELDS_BATTERY = 1u << 2;
+static const uint32_t FRAME_FIELDS_ID = 1u << 3;
+// 第i号电机的PID为 FRAME_FIELDS_PID << i
+static const uint32_t FRAME_FIELDS_PID = 1u << 4;
+
+/**
+ * @brief 某状态位的帧写入的字段组
+ * @note 关键帧、增量帧整体写入姿态、位置和电池；未知状态位不写入任何字段，返回0
+ */
+uint32_t frameFieldGroups(uint8_t status);
+
 // ============================= 类声明 ==========================
 // 无人机参数类
 class DataProcessing {
@@ -43,14 +63,29 @@ public:
     uint8_t batt = 0;//电池电压
     // PID数据
     struct PID pid[4] = {0};
-
+    // 紧凑遥测的关键帧和待回复的确认
+    DeltaKeyframes keyframes;
+    // 状态被写入的次数：一帧通过序号窗口并生效、或文本/JSON至少写入一个字段时加一；
+    // 重复帧、过期帧、校验失败和缺少关键帧的增量帧都不计
+    uint64_t updates = 0;
+    // 位置（x/y/z）、姿态（roll/pitch/yaw）分别被写入的次数，计数规则同 updates；
+    // 只含电池、编号或PID的数据不计，下游据此区分各字段的测量时间
+    uint64_t position_updates = 0;
+    uint64_t attitude_updates = 0;
 
 
     // 更新
-    void ParseData(const std::string& data);
+    ParseResult ParseData(std::string_view data);
+    ParseResult ParseData(const std::string& data);
     void ParseData(const Json::Value& data);
+    ParseResult ParseJson(std::string_view data);
     void ParseData(const uint8_t* data);
+    size_t ParseData(const uint8_t* data, size_t size, SequenceWindow* window = nullptr);
     void ParseData(const std::vector<uint8_t>& data); 
+    void ParseData(const UdpPacket& packet);
+    void ParseFrame(const FrameView& frame);
+    void ApplySample(const TelemetrySample& sample);
+    void CountWritten(const ParseResult& result);
 
     // 更新 初始化数据
     void Init_ParseData(const std::vector<Json::Value>& data);
@@ -64,7 +99,7 @@ class DroneData
 {
 private:
     DataProcessing* data = NULL;
-    int size = 0;
+    int drone_count = 0;
 
 public:
     //  =================== 构造函数 ===================
@@ -76,7 +111,7 @@ public:
             return;
         }
         this->data = new DataProcessing[cont];//创建无人机数据数组
-        this->size = cont;
+        this->drone_count = cont;
     }
     //  =================== 析构函数 ===================
     ~DroneData()
@@ -102,7 +137,7 @@ public:
         if (data == nullptr) {
             throw std::runtime_error("DroneData未正确初始化，data指针为空");
         }
-        return data + size;
+        return data + drone_count;
     }
 
     // =================== 运算符 ===================
@@ -111,7 +146,7 @@ public:
         if (data == nullptr) {
             throw std::runtime_error("DroneData未正确初始化，data指针为空");
         }
-        if (index < 0 || index >= size) {
+        if (index < 0 || index >= drone_count) {
             throw std::out_of_range("DroneData下标越界");
         }
         return data[index];
@@ -121,7 +156,7 @@ public:
         if (data == nullptr) {
             throw std::runtime_error("DroneData未正确初始化，data指针为空");
         }
-        if (index < 0 || index >= size) {
+        if (index < 0 || index >= drone_count) {
             throw std::out_of_range("DroneData下标越界");
         }
         return data[index];
@@ -130,12 +165,12 @@ public:
     // =================== 大小 ===================
     int size() const
     {
-        return size;
+        return drone_count;
     }
     // =================== 判断是否为空 ===================
     bool empty() const
     {
-        return size == 0 && data == nullptr;
+        return drone_count == 0 && data == nullptr;
     }
 
     //  =================== 遍历缓存 ===================
@@ -1,18 +1,63 @@
 // 功能包：UDP与ROS桥接
 #include "main.h"
 
-// UDP服务器（只使用二进制数据）
+// UDP服务器（二进制、JSON、key=value 三种格式共用一个端口）
 UDP udp_binary(9600);
 
-// 二进制数据处理器（10架无人机）
-DroneData<std::vector<uint8_t>> binary_processor(10);
+// 无人机数据处理器（10架无人机，按注册表槽位索引）
+DroneData<UdpPacket> binary_processor(10);
+
+// 多格式接收入口（每架无人机一个序号窗口）
+Ingress ingress(binary_processor.size());
+
+// 解码线程池：接收线程直接把数据包交给它，解码线程写 binary_processor，主循环只读快照
+DecodePool decode_pool(ingress, binary_processor);
 
 // 无人机注册表
 SwarmRegistry swarm_registry;
 
+// 关键帧确认上行：解码线程解出关键帧即由上行线程回复确认
+KeyframeUplink keyframe_uplink(decode_pool);
+
+// 流水线各阶段延迟统计
+PipelineLatency pipeline_latency;
+
+// 按来源限流
+FloodGuard flood_guard;
+
+// 各工作线程的调度策略
+BridgeThreadPolicies thread_policies;
+
+// 原始数据报抓包（~capture_path 为空时不抓包）
+CaptureWriter capture_writer;
+
+// 解码后状态的列式记录（~record_path 为空时不记录）
+TelemetryRecorder telemetry_recorder;
+
+// 集群状态共享内存发布（~shm_name 为空时不发布）
+SwarmShmPublisher shm_publisher(decode_pool);
+
+// 集群点云和批量TF（~viz_cloud_rate_hz、~viz_tf_rate_hz 都为0时不发布）
+SwarmVizPublisher viz_publisher(decode_pool);
+
+// 延迟补偿：外推到当前时刻的集群状态（~predict_rate_hz 为0时不发布）
+SwarmPredictor swarm_predictor(decode_pool);
+
+// 发布主循环唤醒延迟（主循环周期1秒）
+WakeupProbe publish_probe(1000000000ULL);
+
+// 运行指标，名称前缀 udp_ros_bridge_
+MetricsRegistry metrics("udp_ros_bridge");
+
+// 发布主循环每周期的耗时
+LatencyHistogram publish_cycle_latency;
+
 // 初始化时间
 #define INIT_TIME 5
 
+// 延迟统计打印间隔（秒）
+#define STATS_INTERVAL 10
+
 // 路径规划结果 
 // 返回给无人机
 // 参数一 ： 无人机id
@@ -20,10 +65,317 @@ SwarmRegistry swarm_registry;
 // 参数三 ： x单位最小距离
 void stringCallback(const std_msgs::String::ConstPtr& msg)
 {
-    std::cout << "收到字符串消息: " << msg->data << std::endl;
+    LOG_INFO("收到字符串消息: {}", msg->data);
+}
+
+// 输出一个阶段的延迟统计（微秒）
+static void logHistogram(const char* stage, const LatencyHistogram& histogram)
+{
+    LOG_INFO("[延迟] {}: n={} avg={}us p50={}us p99={}us max={}us", stage,
+             histogram.count(),
+             histogram.mean() / 1000.0,
+             histogram.percentile(0.50) / 1000.0,
+             histogram.percentile(0.99) / 1000.0,
+             histogram.max() / 1000.0);
+}
+
+// 输出一个线程的调度延迟，并写到参数服务器 ~sched_latency/<name>_{p50,p99,max}_us 供外部监控
+static void exportSchedLatency(ros::NodeHandle& private_nh, const std::string& name, LatencyHistogram& histogram)
+{
+    double p50_us = histogram.percentile(0.50) / 1000.0;
+    double p99_us = histogram.percentile(0.99) / 1000.0;
+    double max_us = histogram.max() / 1000.0;
+    LOG_INFO("[调度] {}: n={} p50={}us p99={}us max={}us", name, histogram.count(), p50_us, p99_us, max_us);
+    private_nh.setParam("sched_latency/" + name + "_p50_us", p50_us);
+    private_nh.setParam("sched_latency/" + name + "_p99_us", p99_us);
+    private_nh.setParam("sched_latency/" + name + "_max_us", max_us);
+    histogram.reset();
+}
+
+// 从参数服务器读取一个线程的调度策略：~threads/<name>/{cpus,priority,busy_poll_us}
+static ThreadPolicy loadThreadPolicy(ros::NodeHandle& private_nh, const std::string& name)
+{
+    ThreadPolicy policy;
+    const std::string prefix = "threads/" + name + "/";
+    private_nh.getParam(prefix + "cpus", policy.cpus);
+    private_nh.param(prefix + "priority", policy.priority, policy.priority);
+    private_nh.param(prefix + "busy_poll_us", policy.busy_poll_us, policy.busy_poll_us);
+    return policy;
+}
+
+// 打印延迟统计、内核丢包数、接收缓冲区占用、各格式解码统计、各无人机序号统计和链路占用、调度延迟和限流丢包数，并清空统计窗口
+void reportPipelineStats(ros::NodeHandle& private_nh)
+{
+    logHistogram("内核->出队", pipeline_latency.kernel_to_dequeue);
+    logHistogram("出队->解析", pipeline_latency.dequeue_to_parse);
+    logHistogram("解析->发布", pipeline_latency.parse_to_publish);
+    LOG_INFO("[延迟] 内核丢包累计: {}", udp_binary.getKernelDropCount());
+    LOG_INFO("[缓冲区] 接近溢出 {} 次，窗口内峰值占用 {}%，GRO合并 {} 次共 {} 个数据报",
+             udp_binary.getNearOverflowCount(), udp_binary.takePeakBufferUsage(),
+             udp_binary.getGroBatchCount(), udp_binary.getGroSegmentCount());
+    const PacketPool& pool = udp_binary.getPacketPool();
+    LOG_INFO("[缓冲区池] 共 {} 块，使用中 {}，扩容 {} 次，超长数据报 {} 个，接收队列满 {} 次",
+             pool.getSlabCount(), pool.getInUseCount(), pool.getGrowCount(), pool.getOversizeCount(),
+             udp_binary.getQueueFullCount());
+    if (capture_writer.isOpen()) {
+        LOG_INFO("[抓包] 已写入 {} 个数据报 {} MB，文件满丢弃 {} 个", capture_writer.getRecordCount(),
+                 capture_writer.getByteCount() / (1024 * 1024), capture_writer.getDroppedCount());
+    }
+    if (telemetry_recorder.isOpen()) {
+        LOG_INFO("[记录] 已记录 {} 行 {} 块 {} MB，文件满丢弃 {} 行", telemetry_recorder.getRowCount(),
+                 telemetry_recorder.getChunkCount(), telemetry_recorder.getByteCount() / (1024 * 1024),
+                 telemetry_recorder.getDroppedCount());
+    }
+    if (shm_publisher.isRunning()) {
+        LOG_INFO("[共享内存] 已发布 {} 个快照，无更新跳过 {} 个周期", shm_publisher.getPublishCount(),
+                 shm_publisher.getIdleCount());
+    }
+    if (viz_publisher.isRunning()) {
+        LOG_INFO("[可视化] 已发布 {} 个点云、{} 条TF，最近一周期耗时 {} us", viz_publisher.getCloudCount(),
+                 viz_publisher.getTfCount(), viz_publisher.getLastCycleNs() / 1000);
+    }
+    if (swarm_predictor.isRunning()) {
+        LOG_INFO("[预测] 已发布 {} 条，登记测量 {} 次，平均外推 {} ms，最近一周期耗时 {} us（{}）",
+                 swarm_predictor.getPublishCount(), swarm_predictor.getMeasurementCount(),
+                 swarm_predictor.getMeanHorizonNs() / 1000000, swarm_predictor.getLastCycleNs() / 1000,
+                 KalmanBank::isaName(swarm_predictor.getIsa()));
+    }
+    // 各解码线程的数据包数和占用率，分片不均时某个线程会先到100%
+    for (int i = 0; i < decode_pool.getWorkerCount(); i++) {
+        LOG_INFO("[解码] 线程 {}: 累计 {} 个数据包，解码耗时 {} ms", i,
+                 decode_pool.getWorkerPacketCount(i), decode_pool.getWorkerBusyNs(i) / 1000000);
+    }
+    if (decode_pool.getQueueFullCount() != 0) {
+        LOG_WARN("[解码] 解码队列满累计 {} 次", decode_pool.getQueueFullCount());
+    }
+    pipeline_latency.reset();
+    publish_cycle_latency.reset();
+
+    // 各格式的数据报数和解码耗时，没有流量的格式不打印
+    for (int f = 0; f < PAYLOAD_FORMAT_COUNT; f++) {
+        PayloadFormat format = static_cast<PayloadFormat>(f);
+        if (ingress.getPacketCount(format) == 0) {
+            continue;
+        }
+        LatencyHistogram& decode = ingress.getDecodeLatency(format);
+        LOG_INFO("[入口] {}: 数据报 {} 个 {} 字节，解码失败 {} 个，解码耗时 p50={}us p99={}us",
+                 payloadFormatName(format), ingress.getPacketCount(format), ingress.getByteCount(format),
+                 ingress.getErrorCount(format), decode.percentile(0.50) / 1000.0, decode.percentile(0.99) / 1000.0);
+        decode.reset();
+    }
+    if (ingress.getUnroutedCount() != 0) {
+        LOG_WARN("[入口] 来源槽位无效累计丢弃 {} 个数据报", ingress.getUnroutedCount());
+    }
+
+    // 各无人机的丢包、乱序和重复统计（累计值），写到参数服务器 ~sequence/<id>/ 供外部监控
+    for (int slot = 0; slot < ingress.getSlotCount() && slot < swarm_registry.getDroneCount(); slot++) {
+        const SequenceWindow& window = ingress.getSequenceWindow(slot);
+        if (window.getReceivedCount() == 0) {
+            continue;
+        }
+        int id = swarm_registry[slot].id;
+        LOG_INFO("[序号] 无人机 {}: 收到 {} 帧，丢失 {}，乱序 {}，重复 {}，过期 {}", id,
+                 window.getReceivedCount(), window.getLostCount(), window.getReorderedCount(),
+                 window.getDuplicateCount(), window.getStaleCount());
+        if (window.getResyncCount() != 0) {
+            LOG_WARN("[序号] 无人机 {}: 序号重新开始 {} 次（疑似重启）", id, window.getResyncCount());
+        }
+        const std::string prefix = "sequence/" + std::to_string(id) + "/";
+        private_nh.setParam(prefix + "received", static_cast<int>(window.getReceivedCount()));
+        private_nh.setParam(prefix + "lost", static_cast<int>(window.getLostCount()));
+        private_nh.setParam(prefix + "reordered", static_cast<int>(window.getReorderedCount()));
+        private_nh.setParam(prefix + "duplicates", static_cast<int>(window.getDuplicateCount()));
+        private_nh.setParam(prefix + "stale", static_cast<int>(window.getStaleCount()));
+    }
+
+    // 各无人机本统计周期的接收字节率，写到 ~link/<id>/bytes_per_sec；
+    // 紧凑遥测缺少关键帧而丢弃的增量帧数一并打印
+    static std::vector<uint64_t> last_bytes;
+    last_bytes.resize(ingress.getSlotCount(), 0);
+    DroneSnapshot snap;
+    for (int slot = 0; slot < ingress.getSlotCount() && slot < swarm_registry.getDroneCount(); slot++) {
+        uint64_t bytes = ingress.getSlotByteCount(slot);
+        double rate = static_cast<double>(bytes - last_bytes[slot]) / STATS_INTERVAL;
+        last_bytes[slot] = bytes;
+        if (rate == 0) {
+            continue;
+        }
+        int id = swarm_registry[slot].id;
+        decode_pool.snapshot(slot, snap);
+        LOG_INFO("[链路] 无人机 {}: {} 字节/秒，缺少关键帧丢弃增量 {} 帧", id, rate, snap.missing_base);
+        private_nh.setParam("link/" + std::to_string(id) + "/bytes_per_sec", rate);
+    }
+
+    // 接收线程：内核收到数据报到线程被唤醒；发布线程：周期唤醒比预定时刻晚多少
+    exportSchedLatency(private_nh, "receive", udp_binary.getWakeupLatency());
+    exportSchedLatency(private_nh, "publish", publish_probe.histogram());
+
+    // 限流丢包只打印有丢包的无人机
+    for (int slot = 0; slot < flood_guard.getSlotCount(); slot++) {
+        uint64_t dropped = flood_guard.getDropCount(slot);
+        if (dropped != 0) {
+            LOG_WARN("[限流] 无人机 {} 累计丢弃 {} 个数据报（放行 {} 个）",
+                     swarm_registry[slot].id, dropped, flood_guard.getAcceptCount(slot));
+        }
+    }
+    if (flood_guard.getUnknownDropCount() != 0) {
+        LOG_WARN("[限流] 未注册地址累计丢弃 {} 个数据报", flood_guard.getUnknownDropCount());
+    }
 }
 
 
+// 注册运行指标：各模块已有的计数注册读取函数，热路径上不再重复计数
+void registerBridgeMetrics()
+{
+    // 接收
+    metrics.counter("udp_datagrams_total", "UDP收到的数据报数（GRO拆分后）",
+                    []() { return static_cast<double>(udp_binary.getReceivedCount()); }).group("接收");
+    metrics.counter("udp_bytes_total", "UDP收到的字节数",
+                    []() { return static_cast<double>(udp_binary.getReceivedByteCount()); }).group("接收");
+    metrics.counter("udp_kernel_drops_total", "接收缓冲区满被内核丢弃的数据报数",
+                    []() { return static_cast<double>(udp_binary.getKernelDropCount()); }).group("接收").warnAbove(0);
+    metrics.counter("udp_near_overflow_total", "接收缓冲区占用接近上限的次数",
+                    []() { return static_cast<double>(udp_binary.getNearOverflowCount()); }).group("接收").warnAbove(0);
+    metrics.counter("flood_dropped_total", "未注册地址被限流丢弃的数据报数",
+                    []() { return static_cast<double>(flood_guard.getUnknownDropCount()); }).group("接收");
+    metrics.latency("receive_wakeup_seconds", "内核收到数据报到接收线程被唤醒", udp_binary.getWakeupLatency())
+        .group("接收");
+    metrics.latency("kernel_to_dequeue_seconds", "内核时间戳到解码线程取出", pipeline_latency.kernel_to_dequeue)
+        .group("接收").warnAbove(0.01);
+
+    // 解码：各格式的数据报数、失败数和耗时，文本格式按错误类型细分
+    for (int f = 0; f < PAYLOAD_FORMAT_COUNT; f++) {
+        PayloadFormat format = static_cast<PayloadFormat>(f);
+        const char* name = payloadFormatName(format);
+        metrics.counter("decode_packets_total", "各格式的数据报数",
+                        [format]() { return static_cast<double>(ingress.getPacketCount(format)); })
+            .label("format", name).group("解码");
+        metrics.counter("decode_errors_total", "各格式解码失败的数据报数",
+                        [format]() { return static_cast<double>(ingress.getErrorCount(format)); })
+            .label("format", name).group("解码").warnAbove(0);
+        if (format != PayloadFormat::UNKNOWN) {
+            metrics.latency("decode_seconds", "单个数据报的解码耗时", ingress.getDecodeLatency(format))
+                .label("format", name);
+        }
+    }
+    for (int s = 1; s < PARSE_STATUS_COUNT; s++) {
+        ParseStatus status = static_cast<ParseStatus>(s);
+        metrics.counter("parse_errors_total", "文本/JSON遥测按第一个错误类型统计的解析失败数",
+                        [status]() { return static_cast<double>(ingress.getParseErrorCount(status)); })
+            .label("status", parseStatusName(status));
+    }
+    metrics.counter("decode_unrouted_total", "来源槽位无效而丢弃的数据报数",
+                    []() { return static_cast<double>(ingress.getUnroutedCount()); }).group("解码").warnAbove(0);
+    metrics.gauge("decode_queue_depth", "各解码队列中待解码的数据包数",
+                  []() { return static_cast<double>(decode_pool.getQueueDepth()); }).group("解码");
+    metrics.counter("decode_queue_full_total", "解码队列满、接收线程等待的次数",
+                    []() { return static_cast<double>(decode_pool.getQueueFullCount()); }).group("解码").warnAbove(0);
+    metrics.latency("dequeue_to_parse_seconds", "解码线程取出到解析完成", pipeline_latency.dequeue_to_parse)
+        .group("解码");
+
+    // 注册表
+    metrics.gauge("registered_drones", "已注册的无人机数",
+                  []() { return static_cast<double>(swarm_registry.getDroneCount()); }).group("注册表");
+    metrics.counter("registry_rejected_total", "地址无效被拒绝的注册数",
+                    []() { return static_cast<double>(swarm_registry.getRejectedCount()); }).group("注册表");
+    metrics.counter("registry_duplicate_total", "重复注册数",
+                    []() { return static_cast<double>(swarm_registry.getDuplicateCount()); }).group("注册表");
+    metrics.counter("registry_lookup_miss_total", "按来源地址查不到槽位的数据报数",
+                    []() { return static_cast<double>(swarm_registry.getLookupMissCount()); })
+        .group("注册表").warnAbove(0);
+
+    // 发布
+    metrics.latency("parse_to_publish_seconds", "解析完成到发布到ROS（主循环1Hz）", pipeline_latency.parse_to_publish)
+        .group("发布").warnAbove(2.0);
+    metrics.latency("publish_cycle_seconds", "发布主循环每周期的耗时", publish_cycle_latency).group("发布");
+    metrics.latency("publish_wakeup_seconds", "发布主循环唤醒比预定时刻晚多少", publish_probe.histogram())
+        .group("发布").warnAbove(0.1);
+    metrics.counter("shm_snapshots_total", "共享内存发布的快照数",
+                    []() { return static_cast<double>(shm_publisher.getPublishCount()); }).group("发布");
+    metrics.counter("keyframe_acks_total", "发回无人机的关键帧确认数",
+                    []() { return static_cast<double>(keyframe_uplink.getSentCount()); }).group("发布");
+    metrics.counter("keyframe_ack_errors_total", "发送失败的关键帧确认数",
+                    []() { return static_cast<double>(keyframe_uplink.getSendErrorCount()); })
+        .group("发布").warnAbove(0);
+    metrics.counter("viz_clouds_total", "发布的集群点云数",
+                    []() { return static_cast<double>(viz_publisher.getCloudCount()); }).group("发布");
+    metrics.counter("predictions_total", "发布的集群预测消息数",
+                    []() { return static_cast<double>(swarm_predictor.getPublishCount()); }).group("发布");
+    metrics.gauge("prediction_horizon_seconds", "最近一周期各无人机外推时长的平均值",
+                  []() { return swarm_predictor.getMeanHorizonNs() / 1e9; }).group("发布");
+
+    // 各无人机：更新率、距上次更新的时间、电量、丢帧和链路字节数
+    for (int slot = 0; slot < binary_processor.size() && slot < swarm_registry.getDroneCount(); slot++) {
+        std::string id = std::to_string(swarm_registry[slot].id);
+        std::string group = "无人机 " + id;
+        metrics.counter("drone_updates_total", "各无人机解码后的状态更新数",
+                        [slot]() {
+                            DroneSnapshot snap;
+                            decode_pool.snapshot(slot, snap);
+                            return static_cast<double>(snap.updates);
+                        })
+            .label("drone", id).group(group);
+        metrics.gauge("drone_update_age_seconds", "各无人机距上次状态更新的时间，还没有数据时为+Inf",
+                      [slot]() {
+                          DroneSnapshot snap;
+                          decode_pool.snapshot(slot, snap);
+                          uint64_t now_ns = nowRealtimeNs();
+                          if (snap.updated_ns == 0) {
+                              return std::numeric_limits<double>::infinity();
+                          }
+                          return now_ns > snap.updated_ns ? (now_ns - snap.updated_ns) / 1e9 : 0.0;
+                      })
+            .label("drone", id).group(group).warnAbove(1.0);
+        metrics.gauge("drone_battery_percent", "各无人机电量",
+                      [slot]() {
+                          DroneSnapshot snap;
+                          decode_pool.snapshot(slot, snap);
+                          return static_cast<double>(snap.batt);
+                      })
+            .label("drone", id).group(group);
+        if (slot < ingress.getSlotCount()) {
+            metrics.counter("drone_lost_frames_total", "各无人机按序号判断丢失的帧数",
+                            [slot]() { return static_cast<double>(ingress.getSequenceWindow(slot).getLostCount()); })
+                .label("drone", id).group(group).warnAbove(0);
+            metrics.counter("drone_bytes_total", "各无人机累计收到的字节数",
+                            [slot]() { return static_cast<double>(ingress.getSlotByteCount(slot)); })
+                .label("drone", id).group(group);
+        }
+        if (slot < flood_guard.getSlotCount()) {
+            metrics.counter("drone_flood_dropped_total", "各无人机被限流丢弃的数据报数",
+                            [slot]() { return static_cast<double>(flood_guard.getDropCount(slot)); })
+                .label("drone", id).group(group).warnAbove(0);
+        }
+    }
+}
+
+// 采样指标并导出：每个诊断分组一条 DiagnosticStatus，有指标超过告警阈值时为 WARN
+void exportMetrics(ros::Publisher* diagnostics_pub, const std::string& metrics_path)
+{
+    metrics.sample(nowRealtimeNs());
+    if (diagnostics_pub != nullptr) {
+        diagnostic_msgs::DiagnosticArray array;
+        array.header.stamp = ros::Time::now();
+        for (const MetricGroup& group : metrics.groups()) {
+            diagnostic_msgs::DiagnosticStatus status;
+            status.level = group.warning ? diagnostic_msgs::DiagnosticStatus::WARN : diagnostic_msgs::DiagnosticStatus::OK;
+            status.name = "udp_ros_bridge: " + group.name;
+            status.hardware_id = "udp_ros_bridge";
+            status.message = group.warning ? "有指标超过告警阈值" : "正常";
+            for (const auto& value : group.values) {
+                diagnostic_msgs::KeyValue pair;
+                pair.key = value.first;
+                pair.value = value.second;
+                status.values.push_back(pair);
+            }
+            array.status.push_back(status);
+        }
+        diagnostics_pub->publish(array);
+    }
+    if (!metrics_path.empty() && !metrics.writePrometheus(metrics_path)) {
+        LOG_WARN_EVERY(60000, "写指标文件失败: {}", metrics_path);
+    }
+}
 
 int main(int argc, char  *argv[])
 {   
@@ -37,21 +389,109 @@ int main(int argc, char  *argv[])
     
     //3.实例化 ROS 句柄
     ros::NodeHandle nh;//该类封装了 ROS 中的一些常用功能
+    ros::NodeHandle private_nh("~");
+
+    // 日志级别：debug/info/warn/error/off，逐包日志只在debug级别输出
+    std::string log_level;
+    private_nh.param<std::string>("log_level", log_level, "info");
+    Logger::setLevel(Logger::parseLevel(log_level));
+
+    // 每架无人机每秒允许的数据报数和突发容量
+    double flood_rate = 500.0;
+    double flood_burst = 100.0;
+    private_nh.param("flood_rate", flood_rate, flood_rate);
+    private_nh.param("flood_burst", flood_burst, flood_burst);
+    flood_guard.setLimits(flood_rate, flood_burst);
 
     //4.实例化 发布者 对象
     //泛型: 发布的消息类型
     //参数1: 要发布到的话题
     //参数2: 队列中最大保存的消息数，超出此阀值时，先进的先销毁(时间早的先销毁)
-    ros::Publisher pub = nh.advertise<swarm_planner::swarm>("UDP",10);
+    ros::Publisher pub = nh.advertise<udp_ros_bridge::swarm>("UDP",10);
+
+    // 内核接收缓冲区：整个集群同时上报时默认大小（约200KB）会溢出
+    int rcvbuf_bytes = 4 * 1024 * 1024;
+    bool udp_gro = true;
+    private_nh.param("rcvbuf_bytes", rcvbuf_bytes, rcvbuf_bytes);
+    private_nh.param("udp_gro", udp_gro, udp_gro);
+    udp_binary.setReceiveBufferSize(rcvbuf_bytes);
+    udp_binary.setGro(udp_gro);
+    // 抓包：把收到的每个数据报（含内核时间戳和来源地址）追加到文件，供 capture_replay 重放
+    std::string capture_path;
+    int capture_max_mb = 1024;
+    private_nh.param<std::string>("capture_path", capture_path, "");
+    private_nh.param("capture_max_mb", capture_max_mb, capture_max_mb);
+    if (!capture_path.empty() && capture_writer.open(capture_path, static_cast<size_t>(capture_max_mb) * 1024 * 1024)) {
+        udp_binary.setCapture(&capture_writer);
+    }
+    // 遥测记录：解码线程把每次解码后的状态按列追加到文件，可按时间范围和无人机查询
+    // 压缩时位置、姿态按 Gorilla 方式逐列编码，文件约为原样的 40%；按无人机查询只解码相关的段，
+    // 查询延迟在 gorilla_codec_benchmark 的预算内（单点约为原样的7倍、仍在微秒级），因此默认压缩。
+    // 压缩块行数多，小集群要几分钟才攒满一块，未封块的行查询不到、崩溃时丢失，
+    // 因此主循环每秒检查一次，最早一行超过 record_max_chunk_age_s 就封块（0为只按行数封块）
+    std::string record_path;
+    int record_max_mb = 1024;
+    bool record_compress = true;
+    double record_max_chunk_age_s = 5.0;
+    private_nh.param<std::string>("record_path", record_path, "");
+    private_nh.param("record_max_mb", record_max_mb, record_max_mb);
+    private_nh.param("record_compress", record_compress, record_compress);
+    private_nh.param("record_max_chunk_age_s", record_max_chunk_age_s, record_max_chunk_age_s);
+    uint64_t record_max_chunk_age_ns =
+        record_max_chunk_age_s > 0 ? static_cast<uint64_t>(record_max_chunk_age_s * 1e9) : 0;
+    if (!record_path.empty() &&
+        telemetry_recorder.open(record_path, static_cast<size_t>(record_max_mb) * 1024 * 1024,
+                                record_compress ? TelemetryRecorder::COMPRESSED_CHUNK_ROWS
+                                                : TelemetryRecorder::DEFAULT_CHUNK_ROWS,
+                                record_compress ? TelemetryEncoding::GORILLA : TelemetryEncoding::RAW)) {
+        decode_pool.setRecorder(&telemetry_recorder);
+    }
+
+    // 绑核与实时优先级（config/threads.yaml），未配置时沿用系统调度
+    thread_policies.receive = loadThreadPolicy(private_nh, "receive");
+    thread_policies.parse = loadThreadPolicy(private_nh, "parse");
+    thread_policies.publish = loadThreadPolicy(private_nh, "publish");
+    thread_policies.uplink = loadThreadPolicy(private_nh, "uplink");
+    thread_policies.shm = loadThreadPolicy(private_nh, "shm");
+    thread_policies.viz = loadThreadPolicy(private_nh, "viz");
+    thread_policies.predict = loadThreadPolicy(private_nh, "predict");
+    udp_binary.setThreadPolicy(thread_policies.receive);
+    // 解码线程数：每个线程负责 槽位%线程数 的无人机，上千架时按核数调大
+    int decode_workers = 2;
+    private_nh.param("decode_workers", decode_workers, decode_workers);
+    // 集群状态共享内存：规划、GUI等本机进程直接读整个集群的最新状态，ROS话题只为兼容保留
+    std::string shm_name;
+    int shm_rate_hz = SwarmShmPublisher::DEFAULT_RATE_HZ;
+    private_nh.param<std::string>("shm_name", shm_name, SWARM_SHM_DEFAULT_NAME);
+    private_nh.param("shm_rate_hz", shm_rate_hz, shm_rate_hz);
+    // rviz 可视化：每周期整个集群只发一个点云和一条TF消息，频率与遥测频率无关
+    std::string viz_frame;
+    double viz_cloud_rate_hz = 0;
+    double viz_tf_rate_hz = 0;
+    private_nh.param<std::string>("viz_frame", viz_frame, "world");
+    private_nh.param("viz_cloud_rate_hz", viz_cloud_rate_hz, viz_cloud_rate_hz);
+    private_nh.param("viz_tf_rate_hz", viz_tf_rate_hz, viz_tf_rate_hz);
+    // 延迟补偿：规划用外推到当前时刻的状态，而不是最近收到的状态；链路单程延迟为估计值
+    double predict_rate_hz = 0;
+    double predict_link_latency_ms = 0;
+    double predict_max_horizon_s = 0.5;
+    private_nh.param("predict_rate_hz", predict_rate_hz, predict_rate_hz);
+    private_nh.param("predict_link_latency_ms", predict_link_latency_ms, predict_link_latency_ms);
+    private_nh.param("predict_max_horizon_s", predict_max_horizon_s, predict_max_horizon_s);
+    // 运行指标：每秒发布一次 /diagnostics，并写 Prometheus 文本文件（node_exporter textfile 收集）
+    bool diagnostics = true;
+    std::string metrics_path;
+    private_nh.param("diagnostics", diagnostics, diagnostics);
+    private_nh.param<std::string>("metrics_path", metrics_path, "");
 
     // 启动UDP服务器监听
-    std::cout << "启动UDP服务器..." << std::endl;
+    LOG_INFO("启动UDP服务器...");
     udp_binary.startListening();
 
     //逻辑(一秒10次)
     ros::Rate Sleep_time(1);
-    swarm_planner::swarm ros_msg;
-    // 关闭udp服务器
+    udp_ros_bridge::swarm ros_msg;
+    // 暂停接收线程，注册阶段由主循环直接读取客户端地址
     udp_binary.manageThread();
 
     // 初始化5秒
@@ -72,56 +512,140 @@ int main(int argc, char  *argv[])
     // 获取客户端地址队列
     auto client_address_queue = udp_binary.getClientAddressQueue();
     if (!client_address_queue.empty()) {
-        std::cout << "处理 " << client_address_queue.size() << " 条客户端地址" << std::endl;
-        for(auto &client_address : client_address_queue) {
-            std::cout << "客户端地址: " << client_address.ip << ":" << client_address.port << std::endl;
+        LOG_INFO("处理 {} 条客户端地址", client_address_queue.size());
+        while (!client_address_queue.empty()) {
+            ClientAddress &client_address = client_address_queue.front();
+            LOG_INFO("客户端地址: {}:{}", client_address.ip, client_address.port);
             // 注册无人机
             swarm_registry.registerDrone(client_address.ip, client_address.port);
+            client_address_queue.pop();
         }
     }
 
+    // 注册结束：按注册表建立令牌桶，之后未注册地址直接丢弃
+    flood_guard.attach(swarm_registry);
+    flood_guard.closeRegistration();
+    udp_binary.setFloodGuard(&flood_guard);
+
+    // 关键帧确认由上行线程发回各无人机的注册地址，须在解码线程启动前就绪
+    std::vector<ClientAddress> uplink_addresses;
+    for (int slot = 0; slot < std::min(binary_processor.size(), swarm_registry.getDroneCount()); slot++) {
+        uplink_addresses.push_back({swarm_registry[slot].ip, swarm_registry[slot].port});
+    }
+    keyframe_uplink.setThreadPolicy(thread_policies.uplink);
+    keyframe_uplink.start(udp_binary, uplink_addresses);
+    decode_pool.setAckSink(&keyframe_uplink);
+
+    // 解码交给线程池（接收线程暂停期间接入），解码线程使用解析线程的调度策略
+    decode_pool.setThreadPolicy(thread_policies.parse);
+    decode_pool.setPipelineLatency(&pipeline_latency);
+    decode_pool.start(decode_workers);
+    udp_binary.setPacketSink(&decode_pool);
+
+    // 共享内存按注册的无人机数建环，注册结束后才能启动
+    if (!shm_name.empty()) {
+        shm_publisher.setThreadPolicy(thread_policies.shm);
+        shm_publisher.start(shm_name, std::min(binary_processor.size(), swarm_registry.getDroneCount()), shm_rate_hz);
+    }
+    // 点云和TF同样按注册的无人机建好消息，以槽位号标识无人机
+    int viz_count = std::min(binary_processor.size(), swarm_registry.getDroneCount());
+    std::vector<uint8_t> viz_ids;
+    for (int slot = 0; slot < viz_count; slot++) {
+        viz_ids.push_back(swarm_registry[slot].id);
+    }
+    viz_publisher.setThreadPolicy(thread_policies.viz);
+    viz_publisher.start(nh, viz_count, viz_frame, viz_cloud_rate_hz, viz_tf_rate_hz);
+    swarm_predictor.setThreadPolicy(thread_policies.predict);
+    swarm_predictor.start(nh, viz_ids, viz_frame, predict_rate_hz, predict_link_latency_ms / 1000.0,
+                          predict_max_horizon_s);
+
+    // 指标按注册的无人机建好，主循环只采样导出
+    registerBridgeMetrics();
+    MetricCounter& published_messages =
+        metrics.counter("published_messages_total", "发布到 UDP 话题的消息数").group("发布").counter();
+    MetricCounter& publish_errors =
+        metrics.counter("publish_errors_total", "发布主循环处理出错的次数").group("发布").warnAbove(0).counter();
+    ros::Publisher diagnostics_pub;
+    if (diagnostics) {
+        diagnostics_pub = nh.advertise<diagnostic_msgs::DiagnosticArray>("/diagnostics", 1);
+    }
+
     // 开启udp服务器
     udp_binary.manageThread();
 
+    // 主线程只发布快照，使用发布线程的调度策略
+    applyThreadPolicy(thread_policies.publish, "bridge_publish");
+
     // 注册无人机后，开始接收数据
+    time_t last_report_time = time(NULL);
+    // 每个槽位上次发布的快照时间，快照更新了才计入解析->发布延迟
+    std::vector<uint64_t> published_ns(binary_processor.size(), 0);
+    DroneSnapshot snap;
     //节点不死
     while (ros::ok())
     {
+        uint64_t cycle_start_ns = nowRealtimeNs();
         try {
 
-            // 获取二进制数据
-            auto binary_queue = udp_binary.getMessageQueue();
-            if (!binary_queue.empty()) {
-                std::cout << "处理 " << binary_queue.size() << " 条二进制消息" << std::endl;
-                binary_processor.ParseData(binary_queue);
-            }
-
-            // 处理数据
-            for(auto &data : binary_processor.data)
+            // 解码线程已把每架无人机的最新状态写进快照，这里只读快照发布，不碰解码状态
+            for (int slot = 0; slot < binary_processor.size(); slot++)
             {
-                std::cout << "当前id: "<<data.id<<" " <<std::endl;
+                decode_pool.snapshot(slot, snap);
+                LOG_DEBUG("当前id: {}", snap.id);
                 // 取出数据
-                ros_msg.roll = data.roll;
-                ros_msg.pitch = data.pitch;
-                ros_msg.yaw = data.yaw;
-                ros_msg.x = data.x;
-                ros_msg.y = data.y;
-                ros_msg.z = data.z;
+                ros_msg.roll = snap.roll;
+                ros_msg.pitch = snap.pitch;
+                ros_msg.yaw = snap.yaw;
+                ros_msg.x = snap.x;
+                ros_msg.y = snap.y;
+                ros_msg.z = snap.z;
                 pub.publish(ros_msg);
+                published_messages.addSingleWriter();
+                // 快照有更新时，记录解析完成到发布完成的时间
+                if (snap.updated_ns > published_ns[slot]) {
+                    pipeline_latency.parse_to_publish.record(static_cast<int64_t>(nowRealtimeNs() - snap.updated_ns));
+                    published_ns[slot] = snap.updated_ns;
+                }
             }
 
         }
         catch (const std::exception& e) {
-            std::cerr << "数据处理错误: " << e.what() << std::endl;
+            publish_errors.addSingleWriter();
+            LOG_ERROR_EVERY(1000, "数据处理错误: {}", e.what());
+        }
+        publish_cycle_latency.record(static_cast<int64_t>(nowRealtimeNs() - cycle_start_ns));
+
+        // 遥测记录按时间封块，小集群的行也能及时查询和落盘
+        if (record_max_chunk_age_ns > 0) {
+            telemetry_recorder.flushOlderThan(nowRealtimeNs(), record_max_chunk_age_ns);
+        }
+
+        // 每周期（1秒）导出一次指标，在统计窗口清空之前
+        exportMetrics(diagnostics ? &diagnostics_pub : nullptr, metrics_path);
+
+        // 定期打印延迟统计
+        if (time(NULL) - last_report_time >= STATS_INTERVAL) {
+            reportPipelineStats(private_nh);
+            last_report_time = time(NULL);
         }
 
         //根据前面制定的发送贫频率自动休眠 休眠时间 = 1/频率；
         Sleep_time.sleep();
+        publish_probe.onWakeup();
         //处理回调函数
         ros::spinOnce();
     }
 
-    std::cout << "停止UDP服务器..." << std::endl;
+    LOG_INFO("停止UDP服务器...");
+    udp_binary.stop();
+    shm_publisher.stop();
+    viz_publisher.stop();
+    swarm_predictor.stop();
+    decode_pool.stop();
+    keyframe_uplink.stop();
+    capture_writer.close();
+    telemetry_recorder.close();
+    Logger::instance().flush();
 
     return 0;
 }
\ No newline at end of file
@@ -4,19 +4,63 @@
 #include "ros/ros.h"
 #include "std_msgs/String.h" //普通文本类型的消息
 #include <sstream>
+#include <limits>
 #include "./UDP/UDP.h"
 #include "./data_processing/data_processing.h"
-#include "swarm_planner/swarm.h"
+#include "udp_ros_bridge/swarm.h"
 #include "time.h"
 #include "./SwarmRegistry/SwarmRegistry.h"
+#include "./LatencyStats/LatencyStats.h"
+#include "udp_ros_bridge/Logger.h"
+#include "./FloodGuard/FloodGuard.h"
+#include "./ThreadTuning/ThreadTuning.h"
+#include "./Ingress/Ingress.h"
+#include "./DecodePool/DecodePool.h"
+#include "./KeyframeUplink/KeyframeUplink.h"
+#include "./CaptureFile/CaptureFile.h"
+#include "./TelemetryRecorder/TelemetryRecorder.h"
+#include "./SwarmShmPublisher/SwarmShmPublisher.h"
+#include "./SwarmViz/SwarmViz.h"
+#include "./SwarmPredictor/SwarmPredictor.h"
+#include "./Metrics/Metrics.h"
+#include "diagnostic_msgs/DiagnosticArray.h"
 
 // =============================== 类声明 ==================
 // 无人机注册表
 extern SwarmRegistry swarm_registry;
 // 无人机数据处理器
-extern DroneData<std::vector<uint8_t>> binary_processor;
+extern DroneData<UdpPacket> binary_processor;
 // UDP服务器
 extern UDP udp_binary;
+// 流水线各阶段延迟统计
+extern PipelineLatency pipeline_latency;
+// 按来源限流
+extern FloodGuard flood_guard;
+// 各工作线程的调度策略
+extern BridgeThreadPolicies thread_policies;
+// 发布主循环唤醒延迟
+extern WakeupProbe publish_probe;
+// 多格式接收入口
+extern Ingress ingress;
+// 按无人机分片的解码线程池
+extern DecodePool decode_pool;
+// 关键帧确认上行
+extern KeyframeUplink keyframe_uplink;
+// 原始数据报抓包
+extern CaptureWriter capture_writer;
+// 集群状态共享内存发布
+extern SwarmShmPublisher shm_publisher;
+// 集群点云和批量TF发布
+extern SwarmVizPublisher viz_publisher;
+// 运行指标（/diagnostics 和 Prometheus 文本文件）
+extern MetricsRegistry metrics;
 // =============================== 函数声明 ==================
+// 打印延迟统计、内核丢包数、接收缓冲区占用、各格式解码统计、各无人机序号统计、调度延迟和限流丢包数，并清空统计窗口
+// 调度延迟和序号统计同时写到参数服务器 ~sched_latency/、~sequence/
+void reportPipelineStats(ros::NodeHandle& private_nh);
+// 注册接收、解码、注册表、发布和各无人机的指标，须在无人机注册结束后调用
+void registerBridgeMetrics();
+// 采样指标，发布 DiagnosticArray 并写 Prometheus 文件（路径为空时不写）
+void exportMetrics(ros::Publisher* diagnostics_pub, const std::string& metrics_path);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,280 @@
+/**
+ * @file bridge_microbenchmark.cpp
+ * @brief 桥接热路径微基准（Google Benchmark）：队列、三种格式解析、注册表、本机回环收包到快照
+ * @note 不依赖ROS，不需要 roscore。用于回归跟踪时把JSON结果写到文件
+ *       （UDP类会往标准输出打印启停信息，不要直接解析标准输出）：
+ *         bridge_microbenchmark --benchmark_out=bench.json --benchmark_out_format=json
+ *       也可用 --benchmark_filter=Parse 只跑一部分。
+ *       回环测试用 DRONES 个本地socket模拟无人机，经注册表、防洪器、接收线程、DecodePool 解码到快照，
+ *       与 main.cpp 的接收路径相同（发布本身是 ROS 调用，不在测试范围内）。
+ */
+
+#include "../src/DecodePool/DecodePool.h"
+#include "../src/FloodGuard/FloodGuard.h"
+#include "../src/Ingress/Ingress.h"
+#include "../src/PacketPool/PacketPool.h"
+#include "../src/SwarmRegistry/SwarmRegistry.h"
+#include "../src/UDP/UDP.h"
+#include "../src/data_processing/data_processing.h"
+#include "udp_ros_bridge/Logger.h"
+#include <benchmark/benchmark.h>
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// data_processing.cpp 引用的全局注册表
+SwarmRegistry swarm_registry;
+
+// 组一帧（加和校验，不带序号）
+static void append_frame(std::vector<uint8_t>& out, uint8_t type, const uint8_t* params, uint8_t length)
+{
+    size_t start = out.size();
+    out.push_back(FRAME_HEAD);
+    out.push_back(FRAME_HEAD);
+    out.push_back(type);
+    out.push_back(length);
+    out.insert(out.end(), params, params + length);
+    uint8_t sum = 0;
+    for (size_t i = start + 2; i < out.size(); i++) {
+        sum += out[i];
+    }
+    out.push_back(sum);
+    out.push_back(FRAME_TAIL);
+}
+
+// 一个数据报：姿态 + GPS + 电池，与固件每次采样发送的内容相同
+static std::vector<uint8_t> telemetry_datagram()
+{
+    const uint8_t attitude[6] = {0x00, 0x64, 0xFF, 0x38, 0x01, 0x2C};
+    const uint8_t gps[12] = {0x42, 0xC8, 0x00, 0x00, 0x43, 0x48, 0x00, 0x00, 0x42, 0x48, 0x00, 0x00};
+    const uint8_t batt[1] = {87};
+    std::vector<uint8_t> out;
+    append_frame(out, 0x00, attitude, sizeof(attitude));
+    append_frame(out, 0x01, gps, sizeof(gps));
+    append_frame(out, 0x02, batt, sizeof(batt));
+    return out;
+}
+
+// ====================== 队列 ======================
+// 接收线程到解码线程的无锁队列：单线程交替写入读出，测单次操作开销
+static void BM_SpscRingPushPop(benchmark::State& state)
+{
+    PacketPool pool(16, 64);
+    SpscRing<UdpPacket> ring(1024);
+    UdpPacket packet;
+    packet.buffer = pool.acquire(16);
+    packet.length = 16;
+    UdpPacket out;
+    for (auto _ : state) {
+        ring.push(std::move(packet));
+        ring.pop(out);
+        packet = std::move(out);
+        benchmark::DoNotOptimize(packet.length);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SpscRingPushPop);
+
+// 缓冲区池取用和归还
+static void BM_PacketPoolAcquireRelease(benchmark::State& state)
+{
+    PacketPool pool(64);
+    for (auto _ : state) {
+        PacketRef ref = pool.acquire(64);
+        benchmark::DoNotOptimize(ref.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PacketPoolAcquireRelease);
+
+// ====================== 解析 ======================
+static void BM_ParseBinary(benchmark::State& state)
+{
+    std::vector<uint8_t> datagram = telemetry_datagram();
+    DataProcessing drone;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(drone.ParseData(datagram.data(), datagram.size()));
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * datagram.size());
+}
+BENCHMARK(BM_ParseBinary);
+
+static void BM_ParseKeyValue(benchmark::State& state)
+{
+    const std::string text = "id=3,roll=100,pitch=-200,yaw=300,x=100.5,y=200.25,z=50.125,batt=87,"
+                             "pid0_kp=10,pid0_ki=2,pid0_kd=5";
+    DataProcessing drone;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(drone.ParseData(std::string_view(text)).ok());
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_ParseKeyValue);
+
+static void BM_ParseJson(benchmark::State& state)
+{
+    const std::string text = "{\"id\": 3, \"roll\": 100, \"pitch\": -200, \"yaw\": 300, \"x\": 100.5, \"y\": 200.25, "
+                             "\"z\": 50.125, \"batt\": 87, \"pid\": [{\"kp\": 10, \"ki\": 2, \"kd\": 5}]}";
+    DataProcessing drone;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(drone.ParseJson(text).ok());
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_ParseJson);
+
+// ====================== 注册表 ======================
+static std::string drone_ip(int index)
+{
+    return "10.0." + std::to_string(index / 250) + "." + std::to_string(index % 250 + 1);
+}
+
+// 注册 N 架无人机（含扩容和地址索引重建）
+static void BM_SwarmRegistryRegister(benchmark::State& state)
+{
+    int drones = static_cast<int>(state.range(0));
+    std::vector<std::string> ips;
+    for (int i = 0; i < drones; i++) {
+        ips.push_back(drone_ip(i));
+    }
+    for (auto _ : state) {
+        SwarmRegistry registry;
+        for (int i = 0; i < drones; i++) {
+            registry.registerDrone(ips[i], 9000);
+        }
+        benchmark::DoNotOptimize(registry.getDroneCount());
+    }
+    state.SetItemsProcessed(state.iterations() * drones);
+}
+BENCHMARK(BM_SwarmRegistryRegister)->Arg(10)->Arg(250)->Arg(1000);
+
+// 按来源地址查槽位（接收线程每个数据报一次）
+static void BM_SwarmRegistryLookup(benchmark::State& state)
+{
+    int drones = static_cast<int>(state.range(0));
+    SwarmRegistry registry;
+    std::vector<uint32_t> addresses;
+    for (int i = 0; i < drones; i++) {
+        registry.registerDrone(drone_ip(i), 9000);
+        in_addr addr;
+        inet_pton(AF_INET, drone_ip(i).c_str(), &addr);
+        addresses.push_back(addr.s_addr);
+    }
+    size_t next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(registry.findSlotByAddress(addresses[next], 9000));
+        next = next + 1 == addresses.size() ? 0 : next + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SwarmRegistryLookup)->Arg(10)->Arg(250)->Arg(1000);
+
+// ====================== 本机回环：接收到快照 ======================
+static const int LOOPBACK_PORT = 19670;
+static const int DRONES = 16;
+static const int DRONE_PORT_BASE = 19700;
+
+/**
+ * @brief 每次迭代每架无人机各发 range(0) 个数据报，等解码线程全部处理完
+ * @note 计时包含 sendto 系统调用、内核回环、接收线程、防洪器、解码队列和解码
+ */
+static void BM_LoopbackReceiveToSnapshot(benchmark::State& state)
+{
+    int per_drone = static_cast<int>(state.range(0));
+    SwarmRegistry registry;
+    std::vector<int> senders;
+    sockaddr_in target;
+    memset(&target, 0, sizeof(target));
+    target.sin_family = AF_INET;
+    target.sin_port = htons(LOOPBACK_PORT);
+    inet_pton(AF_INET, "127.0.0.1", &target.sin_addr);
+    for (int i = 0; i < DRONES; i++) {
+        int fd = socket(AF_INET, SOCK_DGRAM, 0);
+        sockaddr_in local;
+        memset(&local, 0, sizeof(local));
+        local.sin_family = AF_INET;
+        local.sin_port = htons(DRONE_PORT_BASE + i);
+        inet_pton(AF_INET, "127.0.0.1", &local.sin_addr);
+        if (bind(fd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) {
+            state.SkipWithError("无法绑定模拟无人机端口");
+            close(fd);
+            for (int s : senders) {
+                close(s);
+            }
+            return;
+        }
+        senders.push_back(fd);
+        registry.registerDrone("127.0.0.1", DRONE_PORT_BASE + i);
+    }
+
+    // 限流放到足够大，测的是处理能力
+    FloodGuard guard(1e9, 1e9);
+    guard.attach(registry);
+    guard.closeRegistration();
+    Ingress ingress(DRONES);
+    DroneData<UdpPacket> drones(DRONES);
+    DecodePool decode_pool(ingress, drones);
+    UDP receiver(LOOPBACK_PORT);
+    receiver.setReceiveBufferSize(4 * 1024 * 1024);
+    receiver.setFloodGuard(&guard);
+    receiver.setPacketSink(&decode_pool);
+    decode_pool.start(1);
+    receiver.startListening();
+
+    std::vector<uint8_t> datagram = telemetry_datagram();
+    uint64_t expected = 0;
+    bool timeout = false;
+    for (auto _ : state) {
+        for (int k = 0; k < per_drone; k++) {
+            for (int fd : senders) {
+                sendto(fd, datagram.data(), datagram.size(), 0, reinterpret_cast<const sockaddr*>(&target),
+                       sizeof(target));
+            }
+        }
+        expected += static_cast<uint64_t>(per_drone) * DRONES;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while (decode_pool.getDecodedCount() < expected) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                timeout = true;
+                break;
+            }
+            std::this_thread::yield();
+        }
+        if (timeout) {
+            break;
+        }
+    }
+    receiver.stop();
+    decode_pool.stop();
+    for (int fd : senders) {
+        close(fd);
+    }
+    if (timeout) {
+        state.SkipWithError("回环数据报丢失或解码超时");
+        return;
+    }
+    DroneSnapshot snap;
+    decode_pool.snapshot(DRONES - 1, snap);
+    state.counters["batt"] = snap.batt;
+    state.SetItemsProcessed(state.iterations() * per_drone * DRONES);
+}
+BENCHMARK(BM_LoopbackReceiveToSnapshot)->Arg(1)->Arg(16)->UseRealTime();
+
+int main(int argc, char** argv)
+{
+    Logger::setLevel(LogLevel::ERROR);
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,234 @@
+/**
+ * @file capture_file_test.cpp
+ * @brief 抓包文件测试：写入读回、跨越扩展边界、写满丢弃、未关闭时读取、磁盘满时停止抓包，以及接收线程抓包
+ * @note 接收线程部分经本机回环从两个来源各发一批数据报，检查抓包记录的数量、来源端口和内容，
+ *       并检查被防洪器拒绝的数据报同样被记录。最后输出单条记录的写入耗时。
+ */
+
+#include "../src/CaptureFile/CaptureFile.h"
+#include "../src/FloodGuard/FloodGuard.h"
+#include "../src/SwarmRegistry/SwarmRegistry.h"
+#include "../src/UDP/UDP.h"
+#include "udp_ros_bridge/Logger.h"
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdio>
+#include <csignal>
+#include <cstring>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static const char* PATH = "/tmp/capture_file_test.cap";
+
+static sockaddr_in make_address(const char* ip, uint16_t port)
+{
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_pton(AF_INET, ip, &addr.sin_addr);
+    return addr;
+}
+
+// ====================== 写入读回 ======================
+static bool check_round_trip()
+{
+    // 记录总长超过一次扩展（GROW_BYTES），检查扩展边界
+    const int COUNT = 300000;
+    std::vector<uint8_t> payload(120);
+    sockaddr_in source = make_address("192.168.4.7", 9000);
+    bool ok = true;
+    {
+        CaptureWriter writer;
+        ok = writer.open(PATH, 64 * 1024 * 1024);
+        for (int i = 0; i < COUNT && ok; i++) {
+            size_t size = 1 + i % payload.size();
+            payload[0] = static_cast<uint8_t>(i);
+            source.sin_port = htons(static_cast<uint16_t>(9000 + i % 5));
+            ok = writer.append(1000 + i, source, payload.data(), size);
+        }
+        ok = ok && writer.getRecordCount() == static_cast<uint64_t>(COUNT) &&
+             writer.getByteCount() > CaptureWriter::GROW_BYTES;
+    }
+
+    CaptureReader reader;
+    ok = ok && reader.open(PATH);
+    CaptureRecord record;
+    int read = 0;
+    while (ok && reader.next(record)) {
+        ok = record.kernel_ns == static_cast<uint64_t>(1000 + read) && record.length == 1 + read % payload.size() &&
+             record.port == 9000 + read % 5 && record.ip_be == source.sin_addr.s_addr &&
+             record.data[0] == static_cast<uint8_t>(read);
+        read++;
+    }
+    ok = ok && read == COUNT;
+    fprintf(stderr, "写入读回 %d 条：%s\n", read, ok ? "正确" : "错误");
+    return ok;
+}
+
+// ====================== 写满与未关闭 ======================
+static bool check_full_and_unclosed()
+{
+    sockaddr_in source = make_address("10.0.0.1", 1234);
+    uint8_t data[100] = {};
+    CaptureWriter writer;
+    // 文件头 + 3 条 116 字节的记录放得下，第4条放不下
+    bool ok = writer.open(PATH, CAPTURE_HEADER_SIZE + 3 * (CAPTURE_RECORD_HEADER_SIZE + sizeof(data)) + 50);
+    for (int i = 0; i < 5; i++) {
+        writer.append(i, source, data, sizeof(data));
+    }
+    ok = ok && writer.getRecordCount() == 3 && writer.getDroppedCount() == 2;
+
+    // 写入端未关闭（模拟进程崩溃）：按文件头中的结束偏移读出完整记录，不读到预留的空白
+    CaptureReader reader;
+    ok = ok && reader.open(PATH);
+    CaptureRecord record;
+    int read = 0;
+    while (reader.next(record)) {
+        read++;
+    }
+    ok = ok && read == 3;
+    fprintf(stderr, "写满丢弃与未关闭读取：%s（读出 %d 条）\n", ok ? "正确" : "错误", read);
+    return ok;
+}
+
+// ====================== 磁盘满 ======================
+/**
+ * @brief 扩展的空间先在磁盘上分配（文件不是稀疏的）；分配失败时停止抓包并计数，不触发 SIGBUS
+ * @note 用 RLIMIT_FSIZE 模拟磁盘满：超过上限的分配返回 EFBIG（忽略 SIGXFSZ）
+ */
+static bool check_disk_full()
+{
+    sockaddr_in source = make_address("10.0.0.2", 1234);
+    std::vector<uint8_t> data(1000);
+    rlimit saved;
+    getrlimit(RLIMIT_FSIZE, &saved);
+    void (*saved_handler)(int) = signal(SIGXFSZ, SIG_IGN);
+    rlimit limited = saved;
+    limited.rlim_cur = CaptureWriter::GROW_BYTES + CaptureWriter::GROW_BYTES / 2;
+    setrlimit(RLIMIT_FSIZE, &limited);
+
+    CaptureWriter writer;
+    bool ok = writer.open(PATH, 4 * CaptureWriter::GROW_BYTES);
+    struct stat st;
+    ok = ok && stat(PATH, &st) == 0 && static_cast<size_t>(st.st_blocks) * 512 >= CaptureWriter::GROW_BYTES;
+    int appended = 0;
+    for (int i = 0; i < 40000; i++) {
+        appended += writer.append(i, source, data.data(), data.size());
+    }
+    setrlimit(RLIMIT_FSIZE, &saved);
+    signal(SIGXFSZ, saved_handler);
+    // 第一段写满后停止，后面的记录全部计为丢弃，已写的记录完整可读
+    int per_grow = static_cast<int>((CaptureWriter::GROW_BYTES - CAPTURE_HEADER_SIZE) /
+                                    (CAPTURE_RECORD_HEADER_SIZE + data.size()));
+    ok = ok && appended == per_grow && writer.getDroppedCount() == static_cast<uint64_t>(40000 - per_grow);
+    writer.close();
+    CaptureReader reader;
+    ok = ok && reader.open(PATH);
+    CaptureRecord record;
+    int read = 0;
+    while (ok && reader.next(record)) {
+        read++;
+    }
+    ok = ok && read == appended;
+    fprintf(stderr, "磁盘满停止抓包：%s（写入 %d 条，丢弃 %lu 条）\n", ok ? "正确" : "错误", appended,
+            static_cast<unsigned long>(writer.getDroppedCount()));
+    return ok;
+}
+
+// ====================== 接收线程抓包 ======================
+static const int PORT = 19680;
+
+static bool check_receive_capture()
+{
+    // 注册一个来源，另一个来源未注册，被防洪器拒绝
+    SwarmRegistry registry;
+    int registered = socket(AF_INET, SOCK_DGRAM, 0);
+    int unknown = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in local = make_address("127.0.0.1", 19681);
+    bind(registered, reinterpret_cast<sockaddr*>(&local), sizeof(local));
+    registry.registerDrone("127.0.0.1", 19681);
+    FloodGuard guard(1e6, 1e6);
+    guard.attach(registry);
+    guard.closeRegistration();
+
+    CaptureWriter writer;
+    bool ok = writer.open(PATH, 16 * 1024 * 1024);
+    UDP receiver(PORT);
+    receiver.setFloodGuard(&guard);
+    receiver.setCapture(&writer);
+    receiver.startListening();
+
+    sockaddr_in target = make_address("127.0.0.1", PORT);
+    const int BATCH = 100;
+    uint8_t frame[12] = {0xEE, 0xEE, 0x00, 6, 0, 0, 0, 0, 0, 0, 0, 0xFF};
+    for (int i = 0; i < BATCH; i++) {
+        frame[4] = static_cast<uint8_t>(i);
+        sendto(registered, frame, sizeof(frame), 0, reinterpret_cast<sockaddr*>(&target), sizeof(target));
+        sendto(unknown, frame, sizeof(frame), 0, reinterpret_cast<sockaddr*>(&target), sizeof(target));
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (writer.getRecordCount() < 2 * BATCH && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    receiver.stop();
+    uint64_t queued = receiver.getMessageCount();
+    writer.close();
+    close(registered);
+    close(unknown);
+
+    CaptureReader reader;
+    ok = ok && reader.open(PATH);
+    CaptureRecord record;
+    int from_registered = 0;
+    int total = 0;
+    uint64_t last_ns = 0;
+    while (ok && reader.next(record)) {
+        total++;
+        if (record.port == 19681) {
+            ok = record.length == sizeof(frame) && record.data[4] == static_cast<uint8_t>(from_registered);
+            from_registered++;
+        }
+        ok = ok && record.kernel_ns >= last_ns && record.kernel_ns != 0;
+        last_ns = record.kernel_ns;
+    }
+    // 未注册来源的数据报被限流丢弃，但仍在抓包文件中
+    ok = ok && total == 2 * BATCH && from_registered == BATCH && queued == static_cast<uint64_t>(BATCH);
+    fprintf(stderr, "接收线程抓包：%s（记录 %d 条，其中已注册来源 %d 条，入队 %lu 条）\n", ok ? "正确" : "错误", total,
+            from_registered, static_cast<unsigned long>(queued));
+    return ok;
+}
+
+// ====================== 写入耗时 ======================
+static void report_append_cost()
+{
+    const int COUNT = 500000;
+    uint8_t data[48] = {};
+    sockaddr_in source = make_address("192.168.4.7", 9000);
+    CaptureWriter writer;
+    if (!writer.open(PATH, 256 * 1024 * 1024)) {
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < COUNT; i++) {
+        writer.append(i, source, data, sizeof(data));
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / COUNT;
+    fprintf(stderr, "写入 %d 条 48 字节记录：%.1f ns/条（含首次写入的缺页）\n", COUNT, ns);
+}
+
+int main()
+{
+    Logger::setLevel(LogLevel::ERROR);
+    bool passed = check_round_trip();
+    passed = check_full_and_unclosed() && passed;
+    passed = check_disk_full() && passed;
+    passed = check_receive_capture() && passed;
+    report_append_cost();
+    unlink(PATH);
+    fprintf(stderr, "%s\n", passed ? "PASS" : "FAIL");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,192 @@
+/**
+ * @file capture_replay.cpp
+ * @brief 抓包重放：把桥接抓到的原始数据报按原时间间隔（或加速、全速）重新发给桥接
+ * @note 抓包文件中每个来源地址对应重放端的一个socket（源端口不同），桥接仍按来源区分无人机，
+ *       序号、乱序和丢包都与现场一致。启动后先按出现顺序让每个来源发一个数据报供桥接注册，
+ *       等待 --register-wait 秒后开始重放。重放结束打印实际速率和落后于原时间轴的最大值。
+ *
+ * 用法：capture_replay --file=PATH [选项]
+ *   --target=IP          桥接地址（默认 127.0.0.1）
+ *   --port=N             桥接端口（默认 9600）
+ *   --speed=X            倍速（默认 1，0 表示不等待、全速发送）
+ *   --loop=N             重放次数（默认 1）
+ *   --register-wait=S    注册后等待的秒数（默认 6，桥接已在运行时可设为0）
+ */
+
+#include "../src/CaptureFile/CaptureFile.h"
+#include <arpa/inet.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <string>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+// 离发送时刻不足该值时忙等，避免 clock_nanosleep 的唤醒延迟
+static const uint64_t SPIN_NS = 50000;
+
+struct Options {
+    std::string file;
+    std::string target = "127.0.0.1";
+    int port = 9600;
+    double speed = 1;
+    int loop = 1;
+    double register_wait = 6;
+};
+
+static uint64_t monotonic_ns()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+static void wait_until(uint64_t deadline_ns)
+{
+    uint64_t now = monotonic_ns();
+    if (deadline_ns > now + SPIN_NS) {
+        uint64_t wake = deadline_ns - SPIN_NS;
+        timespec ts;
+        ts.tv_sec = static_cast<time_t>(wake / 1000000000ULL);
+        ts.tv_nsec = static_cast<long>(wake % 1000000000ULL);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr);
+    }
+    while (monotonic_ns() < deadline_ns) {
+    }
+}
+
+static bool parse_options(int argc, char** argv, Options& options)
+{
+    static const option long_options[] = {
+        {"file", required_argument, nullptr, 'f'},
+        {"target", required_argument, nullptr, 't'},
+        {"port", required_argument, nullptr, 'p'},
+        {"speed", required_argument, nullptr, 's'},
+        {"loop", required_argument, nullptr, 'l'},
+        {"register-wait", required_argument, nullptr, 'w'},
+        {nullptr, 0, nullptr, 0},
+    };
+    int c;
+    while ((c = getopt_long(argc, argv, "", long_options, nullptr)) != -1) {
+        switch (c) {
+            case 'f': options.file = optarg; break;
+            case 't': options.target = optarg; break;
+            case 'p': options.port = atoi(optarg); break;
+            case 's': options.speed = atof(optarg); break;
+            case 'l': options.loop = atoi(optarg); break;
+            case 'w': options.register_wait = atof(optarg); break;
+            default: return false;
+        }
+    }
+    if (options.file.empty() || options.speed < 0 || options.loop < 1) {
+        fprintf(stderr, "用法：capture_replay --file=PATH [--target=IP] [--port=N] [--speed=X] [--loop=N] "
+                        "[--register-wait=S]\n");
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        return 2;
+    }
+    CaptureReader reader;
+    if (!reader.open(options.file)) {
+        fprintf(stderr, "无法打开抓包文件或格式不符: %s\n", options.file.c_str());
+        return 1;
+    }
+
+    sockaddr_in target;
+    memset(&target, 0, sizeof(target));
+    target.sin_family = AF_INET;
+    target.sin_port = htons(static_cast<uint16_t>(options.port));
+    if (inet_pton(AF_INET, options.target.c_str(), &target.sin_addr) != 1) {
+        fprintf(stderr, "无效地址: %s\n", options.target.c_str());
+        return 2;
+    }
+
+    // 第一遍：统计记录数，给每个来源建一个socket，并发注册数据报
+    std::unordered_map<uint64_t, int> sources;
+    CaptureRecord record;
+    uint64_t record_count = 0;
+    uint64_t first_ns = 0;
+    uint64_t last_ns = 0;
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+    while (reader.next(record)) {
+        if (record_count == 0) {
+            first_ns = record.kernel_ns;
+        }
+        last_ns = record.kernel_ns;
+        record_count++;
+        uint64_t key = (static_cast<uint64_t>(record.ip_be) << 16) | record.port;
+        if (sources.count(key) != 0) {
+            continue;
+        }
+        int fd = socket(AF_INET, SOCK_DGRAM, 0);
+        if (fd < 0) {
+            perror("socket");
+            return 1;
+        }
+        sources[key] = fd;
+        sendto(fd, record.data, record.length, 0, reinterpret_cast<const sockaddr*>(&target), sizeof(target));
+    }
+    if (record_count == 0) {
+        fprintf(stderr, "抓包文件中没有记录\n");
+        return 1;
+    }
+    fprintf(stderr, "%lu 个数据报，%zu 个来源，原时长 %.3f 秒；已发注册数据报，等待 %.1f 秒\n",
+            static_cast<unsigned long>(record_count), sources.size(), (last_ns - first_ns) / 1e9, options.register_wait);
+    wait_until(monotonic_ns() + static_cast<uint64_t>(options.register_wait * 1e9));
+
+    uint64_t sent = 0;
+    uint64_t failed = 0;
+    uint64_t bytes = 0;
+    uint64_t max_lag_ns = 0;
+    uint64_t start_ns = monotonic_ns();
+    for (int round = 0; round < options.loop; round++) {
+        reader.rewind();
+        uint64_t round_start = monotonic_ns();
+        while (reader.next(record)) {
+            if (options.speed > 0) {
+                // 原时间轴按倍速压缩；时间戳回退（如系统时间被校正）时立即发送
+                uint64_t elapsed = record.kernel_ns > first_ns ? record.kernel_ns - first_ns : 0;
+                uint64_t due = round_start + static_cast<uint64_t>(elapsed / options.speed);
+                wait_until(due);
+                uint64_t lag = monotonic_ns() - due;
+                max_lag_ns = lag > max_lag_ns ? lag : max_lag_ns;
+            }
+            int fd = sources[(static_cast<uint64_t>(record.ip_be) << 16) | record.port];
+            if (sendto(fd, record.data, record.length, 0, reinterpret_cast<const sockaddr*>(&target),
+                       sizeof(target)) < 0) {
+                failed++;
+                continue;
+            }
+            sent++;
+            bytes += record.length;
+        }
+    }
+    double seconds = (monotonic_ns() - start_ns) / 1e9;
+    fprintf(stderr, "重放 %d 次：发出 %lu 个数据报（%.0f 个/秒，%.2f Mbit/s），发送失败 %lu，用时 %.3f 秒",
+            options.loop, static_cast<unsigned long>(sent), sent / seconds, bytes * 8 / seconds / 1e6,
+            static_cast<unsigned long>(failed), seconds);
+    if (options.speed > 0) {
+        fprintf(stderr, "，最大落后原时间轴 %.1f us\n", max_lag_ns / 1000.0);
+    } else {
+        fprintf(stderr, "\n");
+    }
+    for (auto& source : sources) {
+        close(source.second);
+    }
+    return 0;
+}
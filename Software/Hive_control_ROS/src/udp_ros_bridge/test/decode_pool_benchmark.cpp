@@ -0,0 +1,250 @@
+/**
+ * @file decode_pool_benchmark.cpp
+ * @brief 并行解码扩展性测试：1024架无人机交错上报，解码线程数从1增加到N时的吞吐
+ * @note 每架无人机发64个带序号的姿态帧，按"每轮每架一帧"交错推入 DecodePool（与接收线程的调用方式相同），
+ *       等全部解码完成后计时。每种线程数都检查顺序：每架无人机的快照必须是它最后一帧的姿态，
+ *       序号窗口中不能有过期、重复或乱序帧——同一架无人机的帧只在一个线程中按推入顺序解码。
+ *       加速比受机器核数限制，单核机器上各线程轮流运行，加速比约为1，结果中同时打印核数。
+ *       另有一项字段时间检查：电池帧与位置帧交错到达时，快照的 position_ns 只随位置帧前进；
+ *       以及关键帧确认检查：解出关键帧时解码线程立即通知确认去向，不等调用方轮询。
+ */
+
+#include "../src/DecodePool/DecodePool.h"
+#include "../src/Ingress/Ingress.h"
+#include "../src/PacketPool/PacketPool.h"
+#include "../src/DeltaCodec/DeltaCodec.h"
+#include "udp_ros_bridge/Logger.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// data_processing.cpp 引用的全局注册表
+SwarmRegistry swarm_registry;
+
+static const int DRONES = 1024;
+static const int FRAMES_PER_DRONE = 64;
+static const int TOTAL = DRONES * FRAMES_PER_DRONE;
+// 姿态帧带序号共14字节
+static const size_t FRAME_SIZE = 14;
+
+// 每架无人机第 frame 帧的偏航角，各不相同便于核对
+static int16_t expected_yaw(int drone, int frame)
+{
+    return static_cast<int16_t>(drone * 16 + frame);
+}
+
+// 带序号的姿态帧（加和校验）
+static UdpPacket make_attitude(PacketPool& pool, int drone, int frame)
+{
+    int16_t yaw = expected_yaw(drone, frame);
+    uint16_t seq = static_cast<uint16_t>(frame);
+    UdpPacket packet;
+    packet.buffer = pool.acquire(FRAME_SIZE);
+    uint8_t* out = packet.buffer.data();
+    const uint8_t bytes[] = {FRAME_HEAD, FRAME_HEAD, static_cast<uint8_t>(0x00 | FRAME_SEQ_FLAG), 6,
+                             static_cast<uint8_t>(seq >> 8), static_cast<uint8_t>(seq),
+                             static_cast<uint8_t>(drone >> 8), static_cast<uint8_t>(drone), 0, 0,
+                             static_cast<uint8_t>(yaw >> 8), static_cast<uint8_t>(yaw)};
+    uint8_t sum = 0;
+    for (size_t i = 0; i < sizeof(bytes); i++) {
+        out[i] = bytes[i];
+        if (i >= 2) {
+            sum += bytes[i];
+        }
+    }
+    out[12] = sum;
+    out[13] = FRAME_TAIL;
+    packet.length = FRAME_SIZE;
+    packet.slot = drone;
+    return packet;
+}
+
+// 不带序号的单帧（加和校验），带内核时间戳
+static UdpPacket make_frame(PacketPool& pool, int slot, uint8_t status, const std::vector<uint8_t>& params,
+                            uint64_t kernel_ns)
+{
+    std::vector<uint8_t> bytes = {FRAME_HEAD, FRAME_HEAD, status, static_cast<uint8_t>(params.size())};
+    bytes.insert(bytes.end(), params.begin(), params.end());
+    uint8_t sum = 0;
+    for (size_t i = 2; i < bytes.size(); i++) {
+        sum += bytes[i];
+    }
+    bytes.push_back(sum);
+    bytes.push_back(FRAME_TAIL);
+    UdpPacket packet;
+    packet.buffer = pool.acquire(bytes.size());
+    std::copy(bytes.begin(), bytes.end(), packet.buffer.data());
+    packet.length = static_cast<uint32_t>(bytes.size());
+    packet.slot = slot;
+    packet.kernel_ns = kernel_ns;
+    return packet;
+}
+
+/**
+ * @brief 位置帧、电池帧交错到达：position_ns 是最后一个位置帧的接收时间，电池帧只推进 received_ns
+ */
+static bool check_field_times()
+{
+    PacketPool pool(8, 64);
+    Ingress ingress(1);
+    DroneData<UdpPacket> drones(1);
+    DecodePool decode_pool(ingress, drones);
+    decode_pool.start(1);
+    const std::vector<uint8_t> position = {0, 0, 0, 100, 0, 0, 0, 200, 0, 0, 0, 50};
+    const std::vector<uint8_t> battery = {80};
+    const std::vector<uint8_t> attitude = {0, 10, 0, 20, 0, 30};
+    decode_pool.push(make_frame(pool, 0, 0x01, position, 1000));
+    decode_pool.push(make_frame(pool, 0, 0x02, battery, 2000));
+    decode_pool.push(make_frame(pool, 0, 0x01, position, 3000));
+    decode_pool.push(make_frame(pool, 0, 0x02, battery, 4000));
+    decode_pool.push(make_frame(pool, 0, 0x00, attitude, 5000));
+    decode_pool.push(make_frame(pool, 0, 0x02, battery, 6000));
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (decode_pool.getDecodedCount() < 6 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+    decode_pool.stop();
+
+    DroneSnapshot snap;
+    bool ok = decode_pool.snapshot(0, snap) && snap.received_ns == 6000 && snap.position_ns == 3000 &&
+              snap.attitude_ns == 5000 && snap.position_updates == 2 && snap.attitude_updates == 1 &&
+              snap.updates == 6 && snap.x == 100 && snap.yaw == 30 && snap.batt == 80;
+    fprintf(stderr, "字段时间：received %lu，position %lu，attitude %lu，位置写入 %lu 次，姿态写入 %lu 次：%s\n",
+            static_cast<unsigned long>(snap.received_ns), static_cast<unsigned long>(snap.position_ns),
+            static_cast<unsigned long>(snap.attitude_ns), static_cast<unsigned long>(snap.position_updates),
+            static_cast<unsigned long>(snap.attitude_updates), ok ? "正确" : "错误");
+    return ok;
+}
+
+// 记录通知的确认去向：通知时立即取出确认，与上行线程的做法相同
+class RecordingAckSink : public KeyframeAckSink {
+public:
+    explicit RecordingAckSink(DecodePool& pool) : pool(pool) {}
+    void notifyKeyframeAck(int slot) override
+    {
+        uint8_t key_id = 0;
+        if (pool.takeKeyframeAck(slot, key_id)) {
+            last_key.store(key_id);
+            acks.fetch_add(1);
+        }
+    }
+    DecodePool& pool;
+    std::atomic<int> acks{0};
+    std::atomic<int> last_key{-1};
+};
+
+/**
+ * @brief 关键帧解码后立即通知确认去向，增量帧不通知；确认只取出一次
+ */
+static bool check_keyframe_ack()
+{
+    PacketPool pool(8, 64);
+    Ingress ingress(1);
+    DroneData<UdpPacket> drones(1);
+    DecodePool decode_pool(ingress, drones);
+    RecordingAckSink sink(decode_pool);
+    decode_pool.setAckSink(&sink);
+    decode_pool.start(1);
+    // 关键帧7：roll=1 pitch=2 yaw=3 x=100 y=200 z=50 batt=80
+    const std::vector<uint8_t> keyframe = {7, 0, 1, 0, 2, 0, 3, 0, 0, 0, 100, 0, 0, 0, 200, 0, 0, 0, 50, 80};
+    // 增量帧：以关键帧7为基准，只有 yaw 变化 +2（zig-zag 4）
+    const std::vector<uint8_t> delta = {7, 0x04, 4};
+    decode_pool.push(make_frame(pool, 0, FRAME_TYPE_KEYFRAME, keyframe, 1000));
+    decode_pool.push(make_frame(pool, 0, FRAME_TYPE_DELTA, delta, 2000));
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (decode_pool.getDecodedCount() < 2 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+    decode_pool.stop();
+
+    DroneSnapshot snap;
+    uint8_t key_id = 0;
+    bool ok = sink.acks.load() == 1 && sink.last_key.load() == 7 && !decode_pool.takeKeyframeAck(0, key_id) &&
+              decode_pool.snapshot(0, snap) && snap.yaw == 5 && snap.x == 100;
+    fprintf(stderr, "关键帧确认：通知 %d 次，关键帧号 %d：%s\n", sink.acks.load(), sink.last_key.load(),
+            ok ? "正确" : "错误");
+    return ok;
+}
+
+struct RunResult {
+    double packets_per_sec = 0;
+    bool ordered = false;
+    uint64_t min_worker = 0;
+    uint64_t max_worker = 0;
+};
+
+static RunResult run(int workers)
+{
+    // 每次重新建状态和序号窗口；数据包预先组好，计时只含分发和解码
+    PacketPool pool(TOTAL, 64);
+    Ingress ingress(DRONES);
+    DroneData<UdpPacket> drones(DRONES);
+    std::vector<UdpPacket> traffic;
+    traffic.reserve(TOTAL);
+    for (int frame = 0; frame < FRAMES_PER_DRONE; frame++) {
+        for (int drone = 0; drone < DRONES; drone++) {
+            traffic.push_back(make_attitude(pool, drone, frame));
+        }
+    }
+
+    RunResult result;
+    DecodePool decode_pool(ingress, drones);
+    decode_pool.start(workers);
+    auto start = std::chrono::steady_clock::now();
+    for (UdpPacket& packet : traffic) {
+        decode_pool.push(std::move(packet));
+    }
+    auto deadline = start + std::chrono::seconds(30);
+    while (decode_pool.getDecodedCount() < static_cast<uint64_t>(TOTAL) && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.packets_per_sec = decode_pool.getDecodedCount() / seconds;
+
+    result.min_worker = decode_pool.getWorkerPacketCount(0);
+    for (int i = 0; i < decode_pool.getWorkerCount(); i++) {
+        uint64_t count = decode_pool.getWorkerPacketCount(i);
+        result.min_worker = count < result.min_worker ? count : result.min_worker;
+        result.max_worker = count > result.max_worker ? count : result.max_worker;
+    }
+    decode_pool.stop();
+
+    // 顺序检查：快照是最后一帧，窗口中没有被拒的帧
+    result.ordered = decode_pool.getDecodedCount() == static_cast<uint64_t>(TOTAL);
+    DroneSnapshot snap;
+    for (int drone = 0; drone < DRONES && result.ordered; drone++) {
+        const SequenceWindow& window = ingress.getSequenceWindow(drone);
+        result.ordered = decode_pool.snapshot(drone, snap) && snap.yaw == expected_yaw(drone, FRAMES_PER_DRONE - 1) &&
+                         drones[drone].yaw == snap.yaw && window.getReceivedCount() == FRAMES_PER_DRONE &&
+                         window.getStaleCount() == 0 && window.getDuplicateCount() == 0 &&
+                         window.getReorderedCount() == 0 && window.getLostCount() == 0;
+    }
+    return result;
+}
+
+int main()
+{
+    Logger::setLevel(LogLevel::ERROR);
+    int cores = static_cast<int>(std::thread::hardware_concurrency());
+    int max_workers = cores > 4 ? cores : 4;
+    fprintf(stderr, "%d 架无人机 x %d 帧，CPU核数 %d\n", DRONES, FRAMES_PER_DRONE, cores);
+
+    bool passed = check_field_times();
+    passed = check_keyframe_ack() && passed;
+    double baseline = 0;
+    for (int workers = 1; workers <= max_workers; workers *= 2) {
+        RunResult result = run(workers);
+        if (workers == 1) {
+            baseline = result.packets_per_sec;
+        }
+        fprintf(stderr, "解码线程 %2d: %10.0f 包/秒，加速比 %.2f，各线程 %lu..%lu 包，顺序%s\n", workers,
+                result.packets_per_sec, result.packets_per_sec / baseline, static_cast<unsigned long>(result.min_worker),
+                static_cast<unsigned long>(result.max_worker), result.ordered ? "正确" : "错误");
+        passed = passed && result.ordered;
+    }
+    fprintf(stderr, "%s\n", passed ? "PASS" : "FAIL");
+    return passed ? 0 : 1;
+}
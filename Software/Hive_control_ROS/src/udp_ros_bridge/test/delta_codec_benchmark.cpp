@@ -0,0 +1,187 @@
+/**
+ * @file delta_codec_benchmark.cpp
+ * @brief 紧凑遥测编码测试：varint 边界值、丢包丢确认下的还原正确性、每架无人机的字节率和解码耗时
+ * @note 模拟一次50Hz的飞行：姿态小幅抖动，位置按厘米缓慢移动。
+ *       旧格式每次采样发姿态、GPS、电池三帧（三个数据报），紧凑格式发一帧关键帧或增量帧。
+ *       字节率分别按UDP负载和加上IP/UDP头（28字节）统计，后者接近Wi-Fi上实际占用。
+ */
+
+#include "../src/DeltaCodec/DeltaCodec.h"
+#include "../src/data_processing/data_processing.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// data_processing.cpp 引用的全局注册表
+SwarmRegistry swarm_registry;
+
+// 采样频率
+static const int SAMPLE_HZ = 50;
+// IPv4 + UDP 头
+static const int DATAGRAM_OVERHEAD = 28;
+
+// 组一帧（加和校验，带序号，与固件默认一致）
+static void append_frame(std::vector<uint8_t>& out, uint8_t type, const uint8_t* params, uint8_t length,
+                         uint16_t seq)
+{
+    size_t start = out.size();
+    out.push_back(FRAME_HEAD);
+    out.push_back(FRAME_HEAD);
+    out.push_back(static_cast<uint8_t>(type | FRAME_SEQ_FLAG));
+    out.push_back(length);
+    out.push_back(static_cast<uint8_t>(seq >> 8));
+    out.push_back(static_cast<uint8_t>(seq));
+    out.insert(out.end(), params, params + length);
+    uint8_t sum = 0;
+    for (size_t i = start + 2; i < out.size(); i++) {
+        sum += out[i];
+    }
+    out.push_back(sum);
+    out.push_back(FRAME_TAIL);
+}
+
+static bool check_varint()
+{
+    const int32_t values[] = {0, 1, -1, 63, -64, 64, -65, 8191, -8192, 1000000, INT32_MAX, INT32_MIN};
+    bool ok = true;
+    for (int32_t value : values) {
+        uint8_t buffer[5];
+        size_t n = writeVarint(zigzagEncode(value), buffer);
+        uint32_t decoded = 0;
+        ok = ok && readVarint(buffer, n, decoded) == n && zigzagDecode(decoded) == value;
+        // 截断的varint必须报错
+        ok = ok && (n == 1 || readVarint(buffer, n - 1, decoded) == 0);
+    }
+    uint8_t small[5];
+    ok = ok && writeVarint(zigzagEncode(-64), small) == 1 && writeVarint(zigzagEncode(64), small) == 2;
+    fprintf(stderr, "varint 边界值：%s\n", ok ? "正确" : "错误");
+    return ok;
+}
+
+// 生成第i次采样：姿态抖动、位置匀速移动加噪声、电池缓慢下降
+static TelemetrySample make_sample(int i, std::mt19937& rng)
+{
+    std::normal_distribution<double> noise(0.0, 3.0);
+    double t = static_cast<double>(i) / SAMPLE_HZ;
+    TelemetrySample sample;
+    sample.roll = static_cast<int16_t>(150 * std::sin(t * 0.7) + noise(rng));
+    sample.pitch = static_cast<int16_t>(-80 * std::cos(t * 0.5) + noise(rng));
+    sample.yaw = static_cast<int16_t>(static_cast<int>(t * 300) % 36000 / 10);
+    sample.x = static_cast<int32_t>(5000 + 120 * t + noise(rng));
+    sample.y = static_cast<int32_t>(-2000 + 60 * t + noise(rng));
+    sample.z = static_cast<int32_t>(1500 + 20 * std::sin(t) + noise(rng));
+    sample.batt = static_cast<uint8_t>(168 - i / 3000);
+    return sample;
+}
+
+int main()
+{
+    bool passed = check_varint();
+
+    // 模拟5分钟飞行：数据报丢失10%，确认丢失20%
+    const int COUNT = SAMPLE_HZ * 300;
+    std::mt19937 rng(37);
+    std::vector<TelemetrySample> samples;
+    samples.reserve(COUNT);
+    for (int i = 0; i < COUNT; i++) {
+        samples.push_back(make_sample(i, rng));
+    }
+
+    DeltaEncoder encoder;
+    DataProcessing drone;
+    std::vector<std::vector<uint8_t>> datagrams;
+    uint64_t compact_bytes = 0;
+    uint64_t legacy_bytes = 0;
+    int keyframes = 0;
+    int delivered = 0;
+    int restored = 0;
+    int mismatched = 0;
+    uint16_t seq = 0;
+    for (int i = 0; i < COUNT; i++) {
+        const TelemetrySample& sample = samples[i];
+
+        // 旧格式：姿态、GPS、电池三帧
+        legacy_bytes += (6 + 8) + (12 + 8) + (1 + 8) + 3 * DATAGRAM_OVERHEAD;
+
+        uint8_t params[KEYFRAME_LENGTH];
+        uint8_t length = 0;
+        uint8_t type = encoder.encode(sample, params, length);
+        keyframes += type == FRAME_TYPE_KEYFRAME;
+        std::vector<uint8_t> datagram;
+        append_frame(datagram, type, params, length, seq++);
+        compact_bytes += datagram.size() + DATAGRAM_OVERHEAD;
+        datagrams.push_back(datagram);
+
+        if (rng() % 10 == 0) {
+            continue;
+        }
+        delivered++;
+        uint32_t missing = drone.keyframes.missing_base;
+        drone.ParseData(datagram.data(), datagram.size());
+        if (drone.keyframes.missing_base != missing) {
+            continue;
+        }
+        restored++;
+        if (drone.roll != sample.roll || drone.pitch != sample.pitch || drone.yaw != sample.yaw ||
+            drone.x != static_cast<float>(sample.x) || drone.y != static_cast<float>(sample.y) ||
+            drone.z != static_cast<float>(sample.z) || drone.batt != sample.batt) {
+            mismatched++;
+        }
+        if (drone.keyframes.ack_pending) {
+            drone.keyframes.ack_pending = false;
+            std::vector<uint8_t> ack;
+            buildKeyframeAck(drone.keyframes.ack_id, ack);
+            if (rng() % 5 != 0) {
+                encoder.onAck(ack[4]);
+            }
+        }
+    }
+    // 丢包和丢确认都只会让增量帧等待新关键帧，不会还原出错误的值
+    bool ok = mismatched == 0 && restored > delivered * 9 / 10;
+    fprintf(stderr, "丢包10%%、丢确认20%%：送达 %d 帧，还原 %d 帧，缺少关键帧 %u 帧，错误 %d 帧：%s\n", delivered,
+            restored, drone.keyframes.missing_base, mismatched, ok ? "正确" : "错误");
+    passed = passed && ok;
+
+    double seconds = static_cast<double>(COUNT) / SAMPLE_HZ;
+    fprintf(stderr, "\n每架无人机 %dHz：旧格式 %.0f 字节/秒，紧凑格式 %.0f 字节/秒（含IP/UDP头，关键帧占 %.1f%%）\n",
+            SAMPLE_HZ, legacy_bytes / seconds, compact_bytes / seconds, 100.0 * keyframes / COUNT);
+    uint64_t compact_payload = compact_bytes - static_cast<uint64_t>(COUNT) * DATAGRAM_OVERHEAD;
+    fprintf(stderr, "仅UDP负载：旧格式 %.1f 字节/采样，紧凑格式 %.1f 字节/采样\n",
+            static_cast<double>((6 + 8) + (12 + 8) + (1 + 8)), static_cast<double>(compact_payload) / COUNT);
+
+    // 解码耗时：所有数据报都送达，确认立即生效（编码端已按上面的过程生成）
+    DataProcessing bench;
+    const int ROUNDS = 20;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (const std::vector<uint8_t>& datagram : datagrams) {
+            bench.ParseData(datagram.data(), datagram.size());
+        }
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "地面解码 %.1f ns/帧\n", ns / (static_cast<double>(ROUNDS) * datagrams.size()));
+
+    // 编码耗时（地面端同一实现，固件上的耗时见 UAV_ESP/test/delta_codec_test.cpp）
+    DeltaEncoder bench_encoder;
+    uint8_t params[KEYFRAME_LENGTH];
+    uint8_t length = 0;
+    uint64_t sink = 0;
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (const TelemetrySample& sample : samples) {
+            if (bench_encoder.encode(sample, params, length) == FRAME_TYPE_KEYFRAME) {
+                bench_encoder.onAck(params[0]);
+            }
+            sink += length;
+        }
+    }
+    ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "编码 %.1f ns/采样（%lu）\n", ns / (static_cast<double>(ROUNDS) * COUNT),
+            static_cast<unsigned long>(sink % 10));
+
+    passed = passed && compact_bytes * 2 < legacy_bytes;
+    fprintf(stderr, "%s\n", passed ? "PASS" : "FAIL");
+    return passed ? 0 : 1;
+}
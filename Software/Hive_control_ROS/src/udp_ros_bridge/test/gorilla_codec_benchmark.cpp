@@ -0,0 +1,456 @@
+/**
+ * @file gorilla_codec_benchmark.cpp
+ * @brief Gorilla 列压缩：边界值往返检查，遥测数据上的逐列压缩比和解码吞吐，以及原样/压缩记录的查询延迟
+ * @note 数据来源：--file 给出桥接 ~record_path 录下的真实飞行记录；不给时生成仿真集群
+ *       （1000架 50Hz 60秒，平滑航线，位置为厘米整数，姿态为0.1度整数，时间戳带解码抖动）。
+ *       行按记录器的方式切块（每块 COMPRESSED_CHUNK_ROWS 行、块内按槽位稳定排序）后逐列编码，
+ *       解码吞吐按解码出的原样列字节数计算。
+ *       查询延迟：同一批行分别用 RAW 和 GORILLA 写成记录文件，执行同一组单点、单机区间和全集群区间查询，
+ *       两边返回的行数须一致；压缩记录的平均延迟超出预算时判为失败（桥接默认 record_compress 以此为依据）。
+ *
+ * 用法：gorilla_codec_benchmark [--file=PATH] [--repeat=N]
+ */
+
+#include "../src/GorillaCodec/GorillaCodec.h"
+#include "../src/TelemetryRecorder/TelemetryRecorder.h"
+#include "udp_ros_bridge/Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+// ====================== 往返检查 ======================
+template <typename T>
+static bool round_trip_ints(const std::vector<T>& values)
+{
+    std::vector<uint8_t> encoded;
+    gorillaEncodeInts(values.data(), values.size(), encoded);
+    std::vector<T> decoded(values.size());
+    return gorillaDecodeInts(encoded.data(), encoded.size(), values.size(), decoded.data()) && decoded == values;
+}
+
+static bool round_trip_floats(const std::vector<float>& values)
+{
+    std::vector<uint8_t> encoded;
+    gorillaEncodeFloats(values.data(), values.size(), encoded);
+    std::vector<float> decoded(values.size());
+    // 按位比较（含NaN）
+    return gorillaDecodeFloats(encoded.data(), encoded.size(), values.size(), decoded.data()) &&
+           memcmp(decoded.data(), values.data(), values.size() * sizeof(float)) == 0;
+}
+
+static bool check_round_trips()
+{
+    std::mt19937_64 rng(7);
+    bool ok = true;
+    // 空列、单值、二阶差分各个桶的边界、64位回绕
+    ok = round_trip_ints(std::vector<uint64_t>{}) && ok;
+    ok = round_trip_ints(std::vector<uint64_t>{42}) && ok;
+    ok = round_trip_ints(std::vector<uint64_t>{0, UINT64_MAX, 0, UINT64_MAX, 1, 0}) && ok;
+    std::vector<uint64_t> buckets = {1000};
+    for (uint64_t step : {0ULL, 63ULL, 64ULL, 8191ULL, 8192ULL, 8388607ULL, 8388608ULL, 2147483647ULL, 2147483648ULL,
+                          1ULL << 40}) {
+        buckets.push_back(buckets.back() + step);
+        buckets.push_back(buckets.back() - step);
+    }
+    ok = round_trip_ints(buckets) && ok;
+    std::vector<int16_t> attitude;
+    std::vector<uint8_t> bytes;
+    std::vector<uint16_t> slots;
+    std::vector<uint64_t> random64;
+    std::vector<float> floats = {0.0f, -0.0f, 1.0f, std::numeric_limits<float>::quiet_NaN(),
+                                 std::numeric_limits<float>::infinity(), std::numeric_limits<float>::denorm_min(),
+                                 -std::numeric_limits<float>::max(), 1.0f, 1.0f};
+    for (int i = 0; i < 100000; i++) {
+        uint64_t r = rng();
+        attitude.push_back(static_cast<int16_t>(r));
+        bytes.push_back(static_cast<uint8_t>(r >> 16));
+        slots.push_back(static_cast<uint16_t>(i / 37));
+        random64.push_back(r);
+        uint32_t bits = static_cast<uint32_t>(r >> 32);
+        float value;
+        memcpy(&value, &bits, 4);
+        floats.push_back(i % 3 == 0 ? value : static_cast<float>(i % 1000) * 0.01f);
+    }
+    ok = round_trip_ints(attitude) && round_trip_ints(bytes) && round_trip_ints(slots) && ok;
+    ok = round_trip_ints(random64) && round_trip_floats(floats) && ok;
+
+    // 截断的编码数据应报告失败而不是越界
+    std::vector<uint8_t> encoded;
+    gorillaEncodeInts(random64.data(), random64.size(), encoded);
+    std::vector<uint64_t> decoded(random64.size());
+    ok = !gorillaDecodeInts(encoded.data(), encoded.size() / 2, random64.size(), decoded.data()) && ok;
+    fprintf(stderr, "往返检查（边界值、随机值、截断数据）：%s\n", ok ? "正确" : "错误");
+    return ok;
+}
+
+// ====================== 数据 ======================
+static void simulate_swarm(std::vector<TelemetryRow>& rows)
+{
+    const int DRONES = 1000;
+    const int RATE_HZ = 50;
+    const int SECONDS = 60;
+    const uint64_t PERIOD_NS = 1000000000ULL / RATE_HZ;
+    const uint64_t START_NS = 1700000000ULL * 1000000000ULL;
+    std::mt19937 rng(2024);
+    std::normal_distribution<double> jitter_us(0, 200);
+    std::normal_distribution<double> noise(0, 3);
+    std::uniform_real_distribution<double> uniform(0, 1);
+
+    struct Route {
+        double cx, cy, radius, omega, phase, altitude;
+        uint64_t offset_ns;
+    };
+    std::vector<Route> routes(DRONES);
+    for (Route& route : routes) {
+        route.cx = uniform(rng) * 20000 - 10000;
+        route.cy = uniform(rng) * 20000 - 10000;
+        route.radius = 500 + uniform(rng) * 4500;
+        route.omega = (0.5 + uniform(rng) * 2) / route.radius * 100;
+        route.phase = uniform(rng) * 6.283;
+        route.altitude = 1000 + uniform(rng) * 2000;
+        route.offset_ns = static_cast<uint64_t>(uniform(rng) * PERIOD_NS);
+    }
+    rows.clear();
+    rows.reserve(static_cast<size_t>(DRONES) * RATE_HZ * SECONDS);
+    for (int tick = 0; tick < RATE_HZ * SECONDS; tick++) {
+        double t = static_cast<double>(tick) / RATE_HZ;
+        for (int slot = 0; slot < DRONES; slot++) {
+            const Route& route = routes[slot];
+            double angle = route.phase + route.omega * t;
+            TelemetryRow row;
+            int64_t jitter = static_cast<int64_t>(jitter_us(rng) * 1000);
+            row.time_ns = START_NS + tick * PERIOD_NS + route.offset_ns + jitter;
+            row.slot = static_cast<uint16_t>(slot);
+            row.id = static_cast<uint8_t>(slot % 250 + 1);
+            // 位置：厘米整数转浮点（与二进制帧解码一致）
+            row.x = static_cast<float>(std::lround(route.cx + route.radius * std::cos(angle)));
+            row.y = static_cast<float>(std::lround(route.cy + route.radius * std::sin(angle)));
+            row.z = static_cast<float>(std::lround(route.altitude + 30 * std::sin(t * 0.7 + slot)));
+            // 姿态：0.1度，协调转弯时稳定倾斜加噪声，航向沿切线
+            row.roll = static_cast<int16_t>(std::lround(150 + noise(rng)));
+            row.pitch = static_cast<int16_t>(std::lround(-20 + noise(rng)));
+            double heading = std::fmod(angle * 57.2958 + 90, 360.0);
+            row.yaw = static_cast<int16_t>(std::lround(heading * 10));
+            row.batt = static_cast<uint8_t>(100 - static_cast<int>(t / 36) - slot % 7);
+            rows.push_back(row);
+        }
+    }
+}
+
+static bool load_recording(const std::string& path, std::vector<TelemetryRow>& rows)
+{
+    TelemetryRecordReader reader;
+    if (!reader.open(path)) {
+        return false;
+    }
+    rows.clear();
+    reader.query(0, UINT64_MAX, std::vector<uint16_t>(), rows);
+    fprintf(stderr, "读入记录 %s：%lu 块 %zu 行，时长 %.1f 秒\n", path.c_str(),
+            static_cast<unsigned long>(reader.getChunkCount()), rows.size(),
+            (reader.getEndNs() - reader.getBeginNs()) / 1e9);
+    return !rows.empty();
+}
+
+// ====================== 逐列压缩 ======================
+static const int COLUMNS = 10;
+static const char* COLUMN_NAMES[COLUMNS] = {"time", "slot", "roll", "pitch", "yaw", "x", "y", "z", "id", "batt"};
+static const size_t COLUMN_WIDTH[COLUMNS] = {8, 2, 2, 2, 2, 4, 4, 4, 1, 1};
+
+struct Chunk {
+    size_t rows = 0;
+    std::vector<uint64_t> time;
+    std::vector<uint16_t> slot;
+    std::vector<int16_t> roll, pitch, yaw;
+    std::vector<float> x, y, z;
+    std::vector<uint8_t> id, batt;
+    std::vector<uint8_t> encoded[COLUMNS];
+};
+
+static void build_chunks(std::vector<TelemetryRow>& rows, std::vector<Chunk>& chunks)
+{
+    const size_t CHUNK_ROWS = TelemetryRecorder::COMPRESSED_CHUNK_ROWS;
+    for (size_t first = 0; first < rows.size(); first += CHUNK_ROWS) {
+        size_t last = std::min(rows.size(), first + CHUNK_ROWS);
+        std::stable_sort(rows.begin() + first, rows.begin() + last,
+                         [](const TelemetryRow& a, const TelemetryRow& b) { return a.slot < b.slot; });
+        Chunk chunk;
+        chunk.rows = last - first;
+        for (size_t i = first; i < last; i++) {
+            const TelemetryRow& row = rows[i];
+            chunk.time.push_back(row.time_ns);
+            chunk.slot.push_back(row.slot);
+            chunk.roll.push_back(row.roll);
+            chunk.pitch.push_back(row.pitch);
+            chunk.yaw.push_back(row.yaw);
+            chunk.x.push_back(row.x);
+            chunk.y.push_back(row.y);
+            chunk.z.push_back(row.z);
+            chunk.id.push_back(row.id);
+            chunk.batt.push_back(row.batt);
+        }
+        gorillaEncodeInts(chunk.time.data(), chunk.rows, chunk.encoded[0]);
+        gorillaEncodeInts(chunk.slot.data(), chunk.rows, chunk.encoded[1]);
+        gorillaEncodeInts(chunk.roll.data(), chunk.rows, chunk.encoded[2]);
+        gorillaEncodeInts(chunk.pitch.data(), chunk.rows, chunk.encoded[3]);
+        gorillaEncodeInts(chunk.yaw.data(), chunk.rows, chunk.encoded[4]);
+        gorillaEncodeFloats(chunk.x.data(), chunk.rows, chunk.encoded[5]);
+        gorillaEncodeFloats(chunk.y.data(), chunk.rows, chunk.encoded[6]);
+        gorillaEncodeFloats(chunk.z.data(), chunk.rows, chunk.encoded[7]);
+        gorillaEncodeInts(chunk.id.data(), chunk.rows, chunk.encoded[8]);
+        gorillaEncodeInts(chunk.batt.data(), chunk.rows, chunk.encoded[9]);
+        chunks.push_back(std::move(chunk));
+    }
+}
+
+// 解码一列并与原值比较
+template <typename T>
+static bool decode_column(const std::vector<uint8_t>& encoded, const std::vector<T>& expected, std::vector<T>& out)
+{
+    out.resize(expected.size());
+    return gorillaDecodeInts(encoded.data(), encoded.size(), expected.size(), out.data());
+}
+
+static bool decode_column(const std::vector<uint8_t>& encoded, const std::vector<float>& expected,
+                          std::vector<float>& out)
+{
+    out.resize(expected.size());
+    return gorillaDecodeFloats(encoded.data(), encoded.size(), expected.size(), out.data());
+}
+
+struct ColumnTiming {
+    double seconds = 0;
+    bool ok = true;
+};
+
+template <typename T>
+static void time_column(const std::vector<Chunk>& chunks, int column, std::vector<T> Chunk::*values, int repeat,
+                        ColumnTiming& timing)
+{
+    std::vector<T> out;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeat; r++) {
+        for (const Chunk& chunk : chunks) {
+            timing.ok = decode_column(chunk.encoded[column], chunk.*values, out) && timing.ok;
+        }
+    }
+    timing.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for (const Chunk& chunk : chunks) {
+        decode_column(chunk.encoded[column], chunk.*values, out);
+        timing.ok = memcmp(out.data(), (chunk.*values).data(), out.size() * sizeof(T)) == 0 && timing.ok;
+    }
+}
+
+static bool report_columns(std::vector<TelemetryRow>& rows, int repeat)
+{
+    std::vector<Chunk> chunks;
+    auto start = std::chrono::steady_clock::now();
+    build_chunks(rows, chunks);
+    double build_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    ColumnTiming timings[COLUMNS];
+    time_column(chunks, 0, &Chunk::time, repeat, timings[0]);
+    time_column(chunks, 1, &Chunk::slot, repeat, timings[1]);
+    time_column(chunks, 2, &Chunk::roll, repeat, timings[2]);
+    time_column(chunks, 3, &Chunk::pitch, repeat, timings[3]);
+    time_column(chunks, 4, &Chunk::yaw, repeat, timings[4]);
+    time_column(chunks, 5, &Chunk::x, repeat, timings[5]);
+    time_column(chunks, 6, &Chunk::y, repeat, timings[6]);
+    time_column(chunks, 7, &Chunk::z, repeat, timings[7]);
+    time_column(chunks, 8, &Chunk::id, repeat, timings[8]);
+    time_column(chunks, 9, &Chunk::batt, repeat, timings[9]);
+
+    bool ok = true;
+    double raw_total = 0;
+    double encoded_total = 0;
+    double seconds_total = 0;
+    fprintf(stderr, "%zu 行，%zu 块（含排序和列拆分的编码用时 %.3f 秒）\n", rows.size(), chunks.size(),
+            build_seconds);
+    fprintf(stderr, "  列      原样MB  压缩MB  压缩比  位/值   解码GB/s\n");
+    for (int c = 0; c < COLUMNS; c++) {
+        double raw = static_cast<double>(rows.size()) * COLUMN_WIDTH[c];
+        double encoded = 0;
+        for (const Chunk& chunk : chunks) {
+            encoded += chunk.encoded[c].size();
+        }
+        raw_total += raw;
+        encoded_total += encoded;
+        seconds_total += timings[c].seconds;
+        ok = ok && timings[c].ok;
+        fprintf(stderr, "  %-6s %7.1f %7.2f %7.1f %7.2f %9.2f%s\n", COLUMN_NAMES[c], raw / 1048576, encoded / 1048576,
+                raw / encoded, encoded * 8 / rows.size(), raw * repeat / timings[c].seconds / 1e9,
+                timings[c].ok ? "" : "  解码错误");
+    }
+    fprintf(stderr, "  合计   %7.1f %7.2f %7.1f %7.2f %9.2f\n", raw_total / 1048576, encoded_total / 1048576,
+            raw_total / encoded_total, encoded_total * 8 / rows.size(), raw_total * repeat / seconds_total / 1e9);
+    return ok;
+}
+
+// ====================== 查询延迟 ======================
+// 压缩记录的查询延迟预算（平均值）。飞行记录由 telemetry_query 离线检索，
+// 单点和单机区间查询在交互使用时需要远低于1毫秒，全集群1秒窗口的导出不超过数十毫秒
+static const double POINT_QUERY_BUDGET_US = 20;
+static const double DRONE_RANGE_BUDGET_US = 200;
+static const double FLEET_RANGE_BUDGET_US = 20000;
+static const int QUERY_COUNT = 2000;
+static const int FLEET_QUERY_COUNT = 50;
+
+struct QuerySpec {
+    uint64_t begin_ns;
+    uint64_t end_ns;
+    std::vector<uint16_t> slots;
+};
+
+struct QueryTiming {
+    double mean_us = 0;
+    double p99_us = 0;
+    size_t rows = 0;
+};
+
+static QueryTiming time_queries(TelemetryRecordReader& reader, const std::vector<QuerySpec>& specs)
+{
+    std::vector<double> latencies;
+    std::vector<TelemetryRow> out;
+    QueryTiming timing;
+    for (const QuerySpec& spec : specs) {
+        out.clear();
+        auto start = std::chrono::steady_clock::now();
+        reader.query(spec.begin_ns, spec.end_ns, spec.slots, out);
+        latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        timing.rows += out.size();
+    }
+    double total = 0;
+    for (double latency : latencies) {
+        total += latency;
+    }
+    timing.mean_us = total / latencies.size();
+    std::sort(latencies.begin(), latencies.end());
+    timing.p99_us = latencies[latencies.size() * 99 / 100];
+    return timing;
+}
+
+static bool write_recording(const std::string& path, const std::vector<TelemetryRow>& rows, TelemetryEncoding encoding)
+{
+    TelemetryRecorder recorder;
+    size_t chunk_rows = encoding == TelemetryEncoding::GORILLA ? TelemetryRecorder::COMPRESSED_CHUNK_ROWS
+                                                               : TelemetryRecorder::DEFAULT_CHUNK_ROWS;
+    if (!recorder.open(path, rows.size() * sizeof(TelemetryRow) * 2 + (64 << 20), chunk_rows, encoding)) {
+        return false;
+    }
+    for (const TelemetryRow& row : rows) {
+        recorder.append(row);
+    }
+    bool ok = recorder.getDroppedCount() == 0;
+    fprintf(stderr, "  %-8s %8.1f MB\n", encoding == TelemetryEncoding::GORILLA ? "GORILLA" : "RAW",
+            recorder.getByteCount() / 1048576.0);
+    recorder.close();
+    return ok;
+}
+
+static bool report_queries(const std::vector<TelemetryRow>& rows)
+{
+    const std::string raw_path = "/tmp/gorilla_codec_benchmark_raw.tlm";
+    const std::string gorilla_path = "/tmp/gorilla_codec_benchmark_gorilla.tlm";
+    fprintf(stderr, "查询延迟（记录文件长度）：\n");
+    bool ok = write_recording(raw_path, rows, TelemetryEncoding::RAW) &&
+              write_recording(gorilla_path, rows, TelemetryEncoding::GORILLA);
+    TelemetryRecordReader raw;
+    TelemetryRecordReader gorilla;
+    ok = ok && raw.open(raw_path) && gorilla.open(gorilla_path);
+    if (!ok) {
+        fprintf(stderr, "  无法写入或打开记录文件\n");
+        return false;
+    }
+
+    // 单点：随机取一行，按其槽位和时间查询；单机区间：10秒；全集群：1秒窗口
+    std::mt19937_64 rng(11);
+    std::vector<QuerySpec> point, drone, fleet;
+    uint64_t begin_ns = raw.getBeginNs();
+    uint64_t span_ns = raw.getEndNs() - begin_ns;
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        const TelemetryRow& row = rows[rng() % rows.size()];
+        point.push_back({row.time_ns, row.time_ns, {row.slot}});
+        uint64_t start = begin_ns + rng() % span_ns;
+        drone.push_back({start, start + 10000000000ULL, {row.slot}});
+    }
+    for (int i = 0; i < FLEET_QUERY_COUNT; i++) {
+        uint64_t start = begin_ns + rng() % span_ns;
+        fleet.push_back({start, start + 1000000000ULL, {}});
+    }
+
+    struct Case {
+        const char* name;
+        const std::vector<QuerySpec>* specs;
+        double budget_us;
+    };
+    const Case cases[] = {
+        {"单点", &point, POINT_QUERY_BUDGET_US},
+        {"单机10秒", &drone, DRONE_RANGE_BUDGET_US},
+        {"全集群1秒", &fleet, FLEET_RANGE_BUDGET_US},
+    };
+    fprintf(stderr, "  查询        RAW平均us  RAW p99  压缩平均us  压缩p99   倍数   预算us\n");
+    for (const Case& item : cases) {
+        // 先各跑一遍预热页缓存
+        time_queries(raw, *item.specs);
+        time_queries(gorilla, *item.specs);
+        QueryTiming r = time_queries(raw, *item.specs);
+        QueryTiming g = time_queries(gorilla, *item.specs);
+        bool rows_ok = r.rows == g.rows && r.rows > 0;
+        bool budget_ok = g.mean_us <= item.budget_us;
+        ok = ok && rows_ok && budget_ok;
+        fprintf(stderr, "  %-10s %10.2f %8.2f %11.2f %8.2f %6.1f %8.0f%s%s\n", item.name, r.mean_us, r.p99_us,
+                g.mean_us, g.p99_us, g.mean_us / r.mean_us, item.budget_us, rows_ok ? "" : "  行数不一致",
+                budget_ok ? "" : "  超出预算");
+    }
+    raw.close();
+    gorilla.close();
+    remove(raw_path.c_str());
+    remove(gorilla_path.c_str());
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    static const option long_options[] = {
+        {"file", required_argument, nullptr, 'f'},
+        {"repeat", required_argument, nullptr, 'r'},
+        {nullptr, 0, nullptr, 0},
+    };
+    std::string file;
+    int repeat = 5;
+    int c;
+    while ((c = getopt_long(argc, argv, "", long_options, nullptr)) != -1) {
+        switch (c) {
+            case 'f': file = optarg; break;
+            case 'r': repeat = atoi(optarg) > 0 ? atoi(optarg) : 1; break;
+            default:
+                fprintf(stderr, "用法：gorilla_codec_benchmark [--file=PATH] [--repeat=N]\n");
+                return 2;
+        }
+    }
+    Logger::setLevel(LogLevel::ERROR);
+    bool passed = check_round_trips();
+
+    std::vector<TelemetryRow> rows;
+    if (!file.empty()) {
+        if (!load_recording(file, rows)) {
+            fprintf(stderr, "无法读取记录文件: %s\n", file.c_str());
+            return 1;
+        }
+    } else {
+        simulate_swarm(rows);
+        fprintf(stderr, "仿真集群：1000 架 50 Hz 60 秒\n");
+    }
+    // report_columns 会按块重排 rows，查询先用原始顺序写记录
+    passed = report_queries(rows) && passed;
+    passed = report_columns(rows, repeat) && passed;
+    fprintf(stderr, "%s\n", passed ? "PASS" : "FAIL");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,190 @@
+/**
+ * @file ingress_test.cpp
+ * @brief 多格式接收入口测试：格式识别、按槽位路由和各格式统计
+ * @note 模拟混合固件的集群：三架无人机分别发二进制帧、JSON 和 key=value，
+ *       另有无法识别的数据报和无效槽位。检查每架无人机只被自己的数据更新，
+ *       并输出各格式的单包解码耗时（含格式识别）。
+ */
+
+#include "../src/Ingress/Ingress.h"
+#include "../src/Crc/Crc.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+// data_processing.cpp 引用的全局注册表
+SwarmRegistry swarm_registry;
+
+static const int ROUNDS = 200000;
+
+static PacketPool pool(64);
+
+static UdpPacket make_packet(const std::vector<uint8_t>& bytes, int slot)
+{
+    UdpPacket packet;
+    packet.buffer = pool.acquire(bytes.size());
+    std::copy(bytes.begin(), bytes.end(), packet.buffer.data());
+    packet.length = static_cast<uint32_t>(bytes.size());
+    packet.slot = slot;
+    return packet;
+}
+
+static UdpPacket make_packet(const std::string& text, int slot)
+{
+    return make_packet(std::vector<uint8_t>(text.begin(), text.end()), slot);
+}
+
+// 姿态帧（加和校验）
+static std::vector<uint8_t> attitude_frame(int16_t roll, int16_t pitch, int16_t yaw)
+{
+    std::vector<uint8_t> frame = {FRAME_HEAD, FRAME_HEAD, 0x00, 6,
+                                  static_cast<uint8_t>(roll >> 8), static_cast<uint8_t>(roll),
+                                  static_cast<uint8_t>(pitch >> 8), static_cast<uint8_t>(pitch),
+                                  static_cast<uint8_t>(yaw >> 8), static_cast<uint8_t>(yaw)};
+    uint8_t sum = 0;
+    for (size_t i = 2; i < frame.size(); i++) {
+        sum += frame[i];
+    }
+    frame.push_back(sum);
+    frame.push_back(FRAME_TAIL);
+    return frame;
+}
+
+// 带序号的姿态帧（加和校验）
+static std::vector<uint8_t> sequenced_attitude_frame(uint16_t seq, int16_t yaw)
+{
+    std::vector<uint8_t> frame = {FRAME_HEAD, FRAME_HEAD, static_cast<uint8_t>(0x00 | FRAME_SEQ_FLAG), 6,
+                                  static_cast<uint8_t>(seq >> 8), static_cast<uint8_t>(seq),
+                                  0, 0, 0, 0, static_cast<uint8_t>(yaw >> 8), static_cast<uint8_t>(yaw)};
+    uint8_t sum = 0;
+    for (size_t i = 2; i < frame.size(); i++) {
+        sum += frame[i];
+    }
+    frame.push_back(sum);
+    frame.push_back(FRAME_TAIL);
+    return frame;
+}
+
+/**
+ * @brief route 只在数据报写入了状态时返回true：重复帧、过期帧、解码失败都返回false
+ */
+static bool check_applied()
+{
+    DroneData<UdpPacket> drones(1);
+    Ingress ingress(1);
+    struct Case {
+        const char* name;
+        UdpPacket packet;
+        bool applied;
+    };
+    std::vector<uint8_t> corrupt = sequenced_attitude_frame(9, 1);
+    corrupt[corrupt.size() - 2]++;
+    const Case cases[] = {
+        {"序号5", make_packet(sequenced_attitude_frame(5, 50), 0), true},
+        {"序号5重复", make_packet(sequenced_attitude_frame(5, 51), 0), false},
+        {"序号6", make_packet(sequenced_attitude_frame(6, 60), 0), true},
+        {"序号4迟到", make_packet(sequenced_attitude_frame(4, 40), 0), false},
+        {"校验错误", make_packet(corrupt, 0), false},
+        {"无法识别", make_packet("garbage", 0), false},
+        {"未知键名", make_packet("unknown=1", 0), false},
+        {"key_value", make_packet("batt=80", 0), true},
+        {"无效槽位", make_packet("batt=80", 1), false},
+    };
+    bool ok = true;
+    for (const Case& c : cases) {
+        bool applied = ingress.route(c.packet, drones);
+        if (applied != c.applied) {
+            fprintf(stderr, "  %s：返回 %d，应为 %d\n", c.name, applied, c.applied);
+            ok = false;
+        }
+    }
+    // 被拒绝的重复帧和迟到的旧姿态都没有写入
+    ok = ok && drones[0].yaw == 60 && drones[0].batt == 80 && drones[0].updates == 3;
+    fprintf(stderr, "写入判定：重复、过期、解码失败和无效槽位返回false：%s\n", ok ? "正确" : "错误");
+    return ok;
+}
+
+static bool check_classify()
+{
+    struct Case {
+        std::string text;
+        PayloadFormat format;
+    };
+    const Case cases[] = {
+        {"\xEE\xEE\x00\x06", PayloadFormat::BINARY},
+        {"{\"id\": 1}", PayloadFormat::JSON},
+        {" \t{\"id\": 1}", PayloadFormat::JSON},
+        {"id=1,yaw=5", PayloadFormat::KEY_VALUE},
+        {"pid0_kp = 3", PayloadFormat::KEY_VALUE},
+        {"hello world", PayloadFormat::UNKNOWN},
+        {"=5", PayloadFormat::UNKNOWN},
+        {"\xEE\x01", PayloadFormat::UNKNOWN},
+        {"", PayloadFormat::UNKNOWN},
+    };
+    bool ok = true;
+    for (const Case& c : cases) {
+        PayloadFormat format = classifyPayload(reinterpret_cast<const uint8_t*>(c.text.data()), c.text.size());
+        bool pass = format == c.format;
+        fprintf(stderr, "  %-22s -> %-10s %s\n", c.text[0] == '\xEE' ? "EE EE ..." : c.text.c_str(),
+                payloadFormatName(format), pass ? "" : "(不符合预期)");
+        ok = ok && pass;
+    }
+    return ok;
+}
+
+int main()
+{
+    fprintf(stderr, "格式识别：\n");
+    bool passed = check_classify();
+    passed = check_applied() && passed;
+
+    DroneData<UdpPacket> drones(3);
+    Ingress ingress;
+    std::vector<UdpPacket> traffic = {
+        make_packet(attitude_frame(10, -6, 336), 0),
+        make_packet("{\"id\": 2, \"yaw\": 90, \"x\": 12.5, \"pid\": [{\"kp\": 4}]}", 1),
+        make_packet("id=3,yaw=45,z=7.25,pid1_kd=9", 2),
+        make_packet("garbage", 0),
+        make_packet("id=9", -1),
+        make_packet("id=9", 3),
+    };
+    for (const UdpPacket& packet : traffic) {
+        ingress.route(packet, drones);
+    }
+
+    passed = passed && drones[0].roll == 10 && drones[0].pitch == -6 && drones[0].yaw == 336 && drones[0].id == 0;
+    passed = passed && drones[1].id == 2 && drones[1].yaw == 90 && drones[1].x == 12.5f && drones[1].pid[0].kp == 4;
+    passed = passed && drones[2].id == 3 && drones[2].yaw == 45 && drones[2].z == 7.25f && drones[2].pid[1].kd == 9;
+    passed = passed && ingress.getPacketCount(PayloadFormat::BINARY) == 1 &&
+             ingress.getPacketCount(PayloadFormat::JSON) == 1 &&
+             ingress.getPacketCount(PayloadFormat::KEY_VALUE) == 1 &&
+             ingress.getPacketCount(PayloadFormat::UNKNOWN) == 1 &&
+             ingress.getErrorCount(PayloadFormat::UNKNOWN) == 1 &&
+             ingress.getErrorCount(PayloadFormat::BINARY) == 0 &&
+             ingress.getUnroutedCount() == 2;
+    fprintf(stderr, "\n路由：binary/json/key_value 各写入自己的槽位，无效槽位丢弃 %lu 个：%s\n",
+            static_cast<unsigned long>(ingress.getUnroutedCount()), passed ? "正确" : "错误");
+
+    // 各格式单包解码耗时
+    fprintf(stderr, "\n%-10s %8s %10s %10s\n", "格式", "数据报", "p50", "p99");
+    for (int r = 0; r < ROUNDS; r++) {
+        for (int i = 0; i < 3; i++) {
+            ingress.route(traffic[i], drones);
+        }
+    }
+    for (int f = 0; f < PAYLOAD_FORMAT_COUNT - 1; f++) {
+        PayloadFormat format = static_cast<PayloadFormat>(f);
+        LatencyHistogram& decode = ingress.getDecodeLatency(format);
+        fprintf(stderr, "%-10s %8lu %8luns %8luns\n", payloadFormatName(format),
+                static_cast<unsigned long>(ingress.getPacketCount(format)),
+                static_cast<unsigned long>(decode.percentile(0.50)),
+                static_cast<unsigned long>(decode.percentile(0.99)));
+        passed = passed && ingress.getErrorCount(format) == 0;
+    }
+
+    fprintf(stderr, "%s\n", passed ? "PASS" : "FAIL");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+/**
+ * @file json_telemetry_benchmark.cpp
+ * @brief JSON遥测解码：jsoncpp（解析成 Json::Value 再逐字段读取）与流式解码（parseTelemetryJson）的吞吐对比
+ * @note jsoncpp 路径的逐字段读取原样复制自 DataProcessing::ParseData(const Json::Value&)（jsoncpp_decode），
+ *       两者对同一组消息（数组/键值对两种PID格式各半）的解码结果必须一致。
+ *       另外检查几种错误输入：类型不符的字段被跳过，格式错误时目标数据不变。
+ */
+
+#include "../src/TelemetryJson/TelemetryJson.h"
+#include "../src/data_processing/data_processing.h"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+static const int ROUNDS = 10;
+
+/**
+ * @brief 原 DataProcessing::ParseData(const Json::Value&) 实现
+ */
+static void jsoncpp_decode(DataProcessing& d, const Json::Value& data)
+{
+    if (data.isMember("id") && data["id"].isInt()) d.id = static_cast<uint8_t>(data["id"].asInt());
+    if (data.isMember("roll") && data["roll"].isInt()) d.roll = static_cast<int16_t>(data["roll"].asInt());
+    if (data.isMember("pitch") && data["pitch"].isInt()) d.pitch = static_cast<int16_t>(data["pitch"].asInt());
+    if (data.isMember("yaw") && data["yaw"].isInt()) d.yaw = static_cast<int16_t>(data["yaw"].asInt());
+    if (data.isMember("x") && (data["x"].isNumeric() || data["x"].isInt())) d.x = static_cast<float>(data["x"].asDouble());
+    if (data.isMember("y") && (data["y"].isNumeric() || data["y"].isInt())) d.y = static_cast<float>(data["y"].asDouble());
+    if (data.isMember("z") && (data["z"].isNumeric() || data["z"].isInt())) d.z = static_cast<float>(data["z"].asDouble());
+    if (data.isMember("batt") && data["batt"].isInt()) d.batt = static_cast<uint8_t>(data["batt"].asInt());
+    if (data.isMember("pid") && data["pid"].isArray()) {
+        const Json::Value& pid_array = data["pid"];
+        for (Json::ArrayIndex i = 0; i < std::min(static_cast<Json::ArrayIndex>(4), pid_array.size()); i++) {
+            if (pid_array[i].isObject()) {
+                if (pid_array[i].isMember("kp") && pid_array[i]["kp"].isInt()) d.pid[i].kp = static_cast<uint8_t>(pid_array[i]["kp"].asInt());
+                if (pid_array[i].isMember("ki") && pid_array[i]["ki"].isInt()) d.pid[i].ki = static_cast<uint8_t>(pid_array[i]["ki"].asInt());
+                if (pid_array[i].isMember("kd") && pid_array[i]["kd"].isInt()) d.pid[i].kd = static_cast<uint8_t>(pid_array[i]["kd"].asInt());
+            }
+        }
+    }
+    else {
+        for (int i = 0; i < 4; i++) {
+            std::string prefix = "pid" + std::to_string(i) + "_";
+            if (data.isMember(prefix + "kp") && data[prefix + "kp"].isInt()) d.pid[i].kp = static_cast<uint8_t>(data[prefix + "kp"].asInt());
+            if (data.isMember(prefix + "ki") && data[prefix + "ki"].isInt()) d.pid[i].ki = static_cast<uint8_t>(data[prefix + "ki"].asInt());
+            if (data.isMember(prefix + "kd") && data[prefix + "kd"].isInt()) d.pid[i].kd = static_cast<uint8_t>(data[prefix + "kd"].asInt());
+        }
+    }
+}
+
+static bool same(const DataProcessing& a, const DataProcessing& b)
+{
+    bool ok = a.id == b.id && a.roll == b.roll && a.pitch == b.pitch && a.yaw == b.yaw &&
+              a.x == b.x && a.y == b.y && a.z == b.z && a.batt == b.batt;
+    for (int i = 0; i < 4; i++) {
+        ok = ok && a.pid[i].kp == b.pid[i].kp && a.pid[i].ki == b.pid[i].ki && a.pid[i].kd == b.pid[i].kd;
+    }
+    return ok;
+}
+
+/**
+ * @brief 生成遥测消息：偶数条用数组格式PID，奇数条用键值对格式PID，位置为两位小数
+ */
+static std::vector<std::string> make_messages(int count)
+{
+    std::mt19937 rng(5);
+    auto decimal = [&](unsigned range) {
+        unsigned v = rng() % (range * 100);
+        char text[32];
+        snprintf(text, sizeof(text), "%u.%02u", v / 100, v % 100);
+        return std::string(text);
+    };
+    std::vector<std::string> messages;
+    for (int i = 0; i < count; i++) {
+        std::string m = "{\"id\": " + std::to_string(rng() % 100) +
+                        ", \"roll\": " + std::to_string(static_cast<int>(rng() % 3600) - 1800) +
+                        ", \"pitch\": " + std::to_string(static_cast<int>(rng() % 3600) - 1800) +
+                        ", \"yaw\": " + std::to_string(rng() % 3600) +
+                        ", \"x\": " + decimal(1000) + ", \"y\": " + decimal(1000) + ", \"z\": " + decimal(100) +
+                        ", \"batt\": " + std::to_string(rng() % 256);
+        if (i % 2 == 0) {
+            m += ", \"pid\": [";
+            for (int p = 0; p < 4; p++) {
+                m += std::string(p ? ", " : "") + "{\"kp\": " + std::to_string(rng() % 256) +
+                     ", \"ki\": " + std::to_string(rng() % 256) + ", \"kd\": " + std::to_string(rng() % 256) + "}";
+            }
+            m += "]";
+        }
+        else {
+            for (int p = 0; p < 4; p++) {
+                std::string prefix = ", \"pid" + std::to_string(p) + "_";
+                m += prefix + "kp\": " + std::to_string(rng() % 256) + prefix + "ki\": " +
+                     std::to_string(rng() % 256) + prefix + "kd\": " + std::to_string(rng() % 256);
+            }
+        }
+        m += "}";
+        messages.push_back(m);
+    }
+    return messages;
+}
+
+template <typename Body>
+static double ns_per_message(const std::vector<std::string>& messages, Body body)
+{
+    double best = 0;
+    for (int r = 0; r < ROUNDS; r++) {
+        auto start = std::chrono::steady_clock::now();
+        for (const std::string& m : messages) {
+            body(m);
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        if (r == 0 || ns < best) {
+            best = ns;
+        }
+    }
+    return best / messages.size();
+}
+
+static bool check_errors()
+{
+    struct Case {
+        const char* text;
+        ParseStatus status;
+        uint32_t offset;
+        uint16_t fields;
+    };
+    const Case cases[] = {
+        {"{\"id\": \"7\", \"yaw\": 5}", ParseStatus::INVALID_NUMBER, 7, 1},
+        {"{\"batt\": 300, \"id\": 2}", ParseStatus::OUT_OF_RANGE, 9, 1},
+        {"{\"roll\": 1.5, \"x\": -2.5e1}", ParseStatus::INVALID_NUMBER, 9, 1},
+        {"{\"id\": 3, \"yaw\": 12", ParseStatus::SYNTAX_ERROR, 19, 0},
+        {"{\"id\": 3, \"yaw\": 0x12}", ParseStatus::SYNTAX_ERROR, 18, 0},
+        {"{\"meta\": {\"fw\": [1, {\"a\": null}], \"ok\": true}, \"id\": 4}\n", ParseStatus::OK, 0, 1},
+        {"{\"pid\": [{\"kp\": 1}, 5, {\"kd\": 2}], \"pid0_kp\": 9}", ParseStatus::OK, 0, 2},
+        {"{\"pid0_ki\": 4, \"pid3_kd\": 8}", ParseStatus::OK, 0, 2},
+    };
+    bool ok = true;
+    for (const Case& c : cases) {
+        DataProcessing d;
+        d.yaw = 77;
+        ParseResult r = parseTelemetryJson(c.text, d);
+        bool pass = r.status == c.status && r.error_offset == c.offset && r.fields == c.fields;
+        // 格式错误时不写入任何字段
+        if (c.status == ParseStatus::SYNTAX_ERROR) {
+            pass = pass && d.id == 0 && d.yaw == 77;
+        }
+        fprintf(stderr, "  %-56s -> %-15s offset=%u fields=%u %s\n", c.text, parseStatusName(r.status),
+                r.error_offset, r.fields, pass ? "" : "(不符合预期)");
+        ok = ok && pass;
+    }
+    // 数组格式优先于键值对格式
+    DataProcessing d;
+    parseTelemetryJson("{\"pid\": [{\"kp\": 1}, 5, {\"kd\": 2}], \"pid0_kp\": 9}", d);
+    ok = ok && d.pid[0].kp == 1 && d.pid[2].kd == 2;
+    return ok;
+}
+
+int main()
+{
+    fprintf(stderr, "错误输入检查：\n");
+    bool passed = check_errors();
+
+    std::vector<std::string> messages = make_messages(10000);
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    Json::Value root;
+    std::string errors;
+
+    for (const std::string& m : messages) {
+        DataProcessing a;
+        DataProcessing b;
+        reader->parse(m.data(), m.data() + m.size(), &root, &errors);
+        jsoncpp_decode(a, root);
+        ParseResult r = parseTelemetryJson(m, b);
+        passed = passed && r.ok() && r.fields == 20 && same(a, b);
+    }
+
+    DataProcessing target;
+    double jsoncpp_ns = ns_per_message(messages, [&](const std::string& m) {
+        reader->parse(m.data(), m.data() + m.size(), &root, &errors);
+        jsoncpp_decode(target, root);
+    });
+    double stream_ns = ns_per_message(messages, [&](const std::string& m) { parseTelemetryJson(m, target); });
+
+    size_t total = 0;
+    for (const std::string& m : messages) {
+        total += m.size();
+    }
+    fprintf(stderr, "\n%zu 条消息（平均 %zu 字节）：\n", messages.size(), total / messages.size());
+    fprintf(stderr, "jsoncpp(Json::Value+isMember)  %8.1f ns/条\n", jsoncpp_ns);
+    fprintf(stderr, "流式解码(parseTelemetryJson)   %8.1f ns/条  (%.1fx)\n", stream_ns, jsoncpp_ns / stream_ns);
+    fprintf(stderr, "%s\n", passed ? "PASS" : "FAIL");
+    return passed ? 0 : 1;
+}
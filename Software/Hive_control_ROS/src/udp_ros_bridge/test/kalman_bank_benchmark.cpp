@@ -0,0 +1,418 @@
+/**
+ * @file kalman_bank_benchmark.cpp
+ * @brief 集群卡尔曼滤波器组：与逐架标量实现（结构体数组AoS、有分支）的结果对比，
+ *        模拟轨迹上的滤波误差（不规则采样、偏航角回绕、乱序测量、位置姿态分开到达）和延迟补偿（外推到当前时刻）的误差，
+ *        以及 10 ~ 10000 架时每架每次更新、每次外推的耗时（通用 / AVX2 / 逐架标量）；
+ *        批量更新不比逐架标量实现快时判为失败（例如没有按 -O3 编译、内核没有向量化）
+ */
+
+#include "../src/KalmanBank/KalmanBank.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+static const int AXES = KalmanBank::AXIS_COUNT;
+
+// 姿态回绕到原始遥测的范围：横滚、俯仰 [-1800, 1800]，偏航 [0, 3600)
+static float wrap_attitude(int axis, float value)
+{
+    if (axis != KalmanBank::AXIS_YAW) {
+        return std::remainder(value, 3600.0f);
+    }
+    float wrapped = value - 3600.0f * std::floor(value / 3600.0f);
+    return wrapped >= 3600.0f ? 0.0f : wrapped;
+}
+
+// ====================== 逐架标量参考实现 ======================
+/**
+ * @brief 与 KalmanBank 相同模型的逐架实现：每架一个结构体，按轴循环，首次测量和回绕用分支
+ */
+struct ReferenceFilter {
+    struct Axis {
+        float p, v, p00, p01, p11;
+    };
+    Axis axis[AXES];
+    double time = 0;
+    bool initialized = false;
+
+    void update(const float* z, double measure_time, const KalmanBank::AxisNoise* noise)
+    {
+        float forward = std::max(static_cast<float>(measure_time - time), 0.0f);
+        time = std::max(measure_time, time);
+        if (!initialized) {
+            for (int a = 0; a < AXES; a++) {
+                axis[a] = Axis{z[a], 0.0f, noise[a].measure_std * noise[a].measure_std, 0.0f,
+                               noise[a].initial_velocity_std * noise[a].initial_velocity_std};
+            }
+            initialized = true;
+            return;
+        }
+        for (int a = 0; a < AXES; a++) {
+            Axis& s = axis[a];
+            float q = noise[a].accel_std * noise[a].accel_std;
+            float r = noise[a].measure_std * noise[a].measure_std;
+            float d = forward;
+            s.p += s.v * d;
+            s.p00 += d * (2.0f * s.p01 + d * s.p11) + q * d * d * d / 3.0f;
+            s.p01 += d * s.p11 + q * d * d / 2.0f;
+            s.p11 += q * d;
+            float y = z[a] - s.p;
+            if (a >= KalmanBank::AXIS_ROLL) {
+                y = std::remainder(y, 3600.0f);
+            }
+            float k0 = s.p00 / (s.p00 + r);
+            float k1 = s.p01 / (s.p00 + r);
+            s.p += k0 * y;
+            s.v += k1 * y;
+            s.p11 -= k1 * s.p01;
+            s.p01 -= k0 * s.p01;
+            s.p00 -= k0 * s.p00;
+            if (a >= KalmanBank::AXIS_ROLL) {
+                s.p = wrap_attitude(a, s.p);
+            }
+        }
+    }
+};
+
+// ====================== 模拟轨迹 ======================
+/**
+ * @brief 一架无人机的真实轨迹：位置和横滚俯仰为正弦，偏航匀速旋转（跨越0°）
+ */
+struct Trajectory {
+    float amplitude[AXES];
+    float omega[AXES];
+    float phase[AXES];
+    float yaw_rate;
+
+    void at(double t, float* out) const
+    {
+        for (int a = 0; a < KalmanBank::AXIS_YAW; a++) {
+            out[a] = amplitude[a] * static_cast<float>(std::sin(omega[a] * t + phase[a]));
+        }
+        out[KalmanBank::AXIS_YAW] = wrap_attitude(KalmanBank::AXIS_YAW,
+                                                  static_cast<float>(phase[KalmanBank::AXIS_YAW] + yaw_rate * t));
+    }
+};
+
+static std::vector<Trajectory> make_trajectories(int n, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<Trajectory> result(n);
+    for (Trajectory& trajectory : result) {
+        for (int a = 0; a < AXES; a++) {
+            bool position = a <= KalmanBank::AXIS_Z;
+            // 位置幅度1~3m、角频率0.2~0.5rad/s（加速度 <1m/s²）；横滚俯仰幅度 <10°
+            trajectory.amplitude[a] = position ? 100.0f + 200.0f * unit(rng) : 100.0f * unit(rng);
+            trajectory.omega[a] = 0.2f + 0.3f * unit(rng);
+            trajectory.phase[a] = 6.283f * unit(rng);
+        }
+        trajectory.phase[KalmanBank::AXIS_YAW] = 3600.0f * unit(rng);
+        // 偏航角速度 ±30°/s
+        trajectory.yaw_rate = 600.0f * unit(rng) - 300.0f;
+    }
+    return result;
+}
+
+static float axis_error(int axis, float estimate, float truth)
+{
+    float error = estimate - truth;
+    return axis >= KalmanBank::AXIS_ROLL ? std::remainder(error, 3600.0f) : error;
+}
+
+// ====================== 正确性 ======================
+/**
+ * @brief 模拟20秒：每架无人机每20~120ms一次测量，经 LINK_LATENCY 后到达，约2%的测量晚到（时间早于上一条），
+ *        滤波器组每10ms步进并外推到当前时刻一次。比较与参考实现的差异、滤波误差与测量噪声，
+ *        以及外推结果与“沿用最近一次测量”相对当前真实状态的误差
+ */
+static bool check_accuracy(KalmanBank::Isa isa)
+{
+    const int N = 500;
+    const double CYCLE = 0.01;
+    const double DURATION = 20.0;
+    const double LINK_LATENCY = 0.05;
+    const float MAX_HORIZON = 0.5f;
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> interval(0.02, 0.12);
+    std::vector<Trajectory> trajectories = make_trajectories(N, rng);
+
+    KalmanBank bank(N, isa);
+    KalmanBank::AxisNoise noise[AXES];
+    std::vector<std::normal_distribution<float>> measure_noise;
+    for (int a = 0; a < AXES; a++) {
+        noise[a] = KalmanBank::defaultNoise(static_cast<KalmanBank::Axis>(a));
+        measure_noise.emplace_back(0.0f, noise[a].measure_std);
+    }
+    std::vector<ReferenceFilter> reference(N);
+    std::vector<double> next_measure(N);
+    for (int i = 0; i < N; i++) {
+        next_measure[i] = interval(rng);
+    }
+
+    double raw_sq[2] = {0, 0};
+    double filtered_sq[2] = {0, 0};
+    long samples[2] = {0, 0};
+    float max_diff[2] = {0, 0};
+    double hold_sq[2] = {0, 0};
+    double predicted_sq[2] = {0, 0};
+    long predicted_samples = 0;
+    std::vector<float> last(static_cast<size_t>(N) * AXES);
+    float z[AXES];
+    float truth[AXES];
+    for (double now = CYCLE; now < DURATION; now += CYCLE) {
+        std::vector<char> has(N, 0);
+        std::vector<double> stamp(N, 0);
+        std::vector<float> measured(static_cast<size_t>(N) * AXES);
+        for (int i = 0; i < N; i++) {
+            if (next_measure[i] + LINK_LATENCY > now) {
+                continue;
+            }
+            // 晚到的测量时间戳早于上一条已处理的测量
+            double t = rng() % 50 == 0 ? next_measure[i] - 0.15 : next_measure[i];
+            next_measure[i] += interval(rng);
+            trajectories[i].at(t, truth);
+            for (int a = 0; a < AXES; a++) {
+                z[a] = truth[a] + measure_noise[a](rng);
+                if (a >= KalmanBank::AXIS_ROLL) {
+                    z[a] = wrap_attitude(a, z[a]);
+                }
+                measured[static_cast<size_t>(i) * AXES + a] = z[a];
+                last[static_cast<size_t>(i) * AXES + a] = z[a];
+                // 1秒收敛后统计测量噪声（按测量时刻）
+                if (now > 1.0) {
+                    int kind = a >= KalmanBank::AXIS_ROLL;
+                    raw_sq[kind] += axis_error(a, z[a], truth[a]) * axis_error(a, z[a], truth[a]);
+                }
+            }
+            has[i] = 1;
+            stamp[i] = t;
+            bank.setMeasurement(i, z, t);
+        }
+        bank.step();
+        bank.extrapolate(now, MAX_HORIZON);
+        for (int i = 0; i < N; i++) {
+            if (has[i]) {
+                reference[i].update(&measured[static_cast<size_t>(i) * AXES], stamp[i], noise);
+            }
+            if (!bank.isInitialized(i)) {
+                continue;
+            }
+            if (now > 1.0) {
+                trajectories[i].at(now, truth);
+                for (int a = 0; a < AXES; a++) {
+                    int kind = a >= KalmanBank::AXIS_ROLL;
+                    float hold = axis_error(a, last[static_cast<size_t>(i) * AXES + a], truth[a]);
+                    float predicted = axis_error(a, bank.getPredicted(static_cast<KalmanBank::Axis>(a), i), truth[a]);
+                    hold_sq[kind] += hold * hold;
+                    predicted_sq[kind] += predicted * predicted;
+                }
+                predicted_samples++;
+            }
+            trajectories[i].at(bank.getTime(i), truth);
+            for (int a = 0; a < AXES; a++) {
+                int kind = a >= KalmanBank::AXIS_ROLL;
+                float estimate = bank.getPosition(static_cast<KalmanBank::Axis>(a), i);
+                max_diff[kind] = std::max(max_diff[kind], std::fabs(axis_error(a, estimate, reference[i].axis[a].p)));
+                if (now > 1.0 && has[i]) {
+                    float error = axis_error(a, estimate, truth[a]);
+                    filtered_sq[kind] += error * error;
+                    samples[kind]++;
+                }
+            }
+        }
+    }
+
+    bool ok = true;
+    const char* names[2] = {"位置(cm)", "姿态(0.1°)"};
+    for (int kind = 0; kind < 2; kind++) {
+        double raw = std::sqrt(raw_sq[kind] / samples[kind]);
+        double filtered = std::sqrt(filtered_sq[kind] / samples[kind]);
+        // 与参考实现只有浮点运算顺序的差异
+        bool agree = max_diff[kind] < (kind == 0 ? 0.05f : 0.1f);
+        bool better = filtered < raw * 0.8;
+        // 当前时刻：沿用最近一次测量 vs 外推
+        double hold = std::sqrt(hold_sq[kind] / (predicted_samples * 3));
+        double predicted = std::sqrt(predicted_sq[kind] / (predicted_samples * 3));
+        bool compensated = predicted < hold * 0.85;
+        ok = ok && agree && better && compensated;
+        fprintf(stderr, "%-7s %-11s 测量RMS %6.2f  滤波RMS %6.2f  与逐架实现最大差 %.4f  "
+                "当前时刻：沿用测量RMS %6.2f  外推RMS %6.2f %s\n", KalmanBank::isaName(isa), names[kind], raw, filtered,
+                max_diff[kind], hold, predicted, agree && better && compensated ? "" : "错误");
+    }
+    return ok;
+}
+
+/**
+ * @brief 边界：未测量的槽位保持未初始化且状态为0；重置后重新初始化；偏航跨越0°不跳变且保持在 [0, 3600)；
+ *        外推时长截断
+ */
+static bool check_edges(KalmanBank::Isa isa)
+{
+    KalmanBank bank(3, isa);
+    float z[AXES] = {100, 200, 300, 0, 0, 3595};
+    bank.step();
+    bool ok = !bank.isInitialized(0) && bank.getVariance(KalmanBank::AXIS_X, 0) == 0;
+    bank.setMeasurement(0, z, 1.0);
+    bank.setMeasurement(5, z, 1.0);
+    bank.step();
+    ok = ok && bank.isInitialized(0) && !bank.isInitialized(1) && bank.getPosition(KalmanBank::AXIS_Z, 0) == 300;
+    // 偏航以 +10°/s 穿过0°（原始遥测 3599 之后是 0）
+    for (int k = 1; k <= 20; k++) {
+        z[KalmanBank::AXIS_YAW] = wrap_attitude(KalmanBank::AXIS_YAW, 3595.0f + 10.0f * k);
+        bank.setMeasurement(0, z, 1.0 + 0.1 * k);
+        bank.step();
+    }
+    float yaw = bank.getPosition(KalmanBank::AXIS_YAW, 0);
+    float rate = bank.getVelocity(KalmanBank::AXIS_YAW, 0);
+    ok = ok && std::fabs(axis_error(KalmanBank::AXIS_YAW, yaw, 195.0f)) < 5 && yaw >= 0 && yaw < 3600 &&
+         std::fabs(rate - 100.0f) < 10;
+    // 外推0.2秒按速度前进并回绕；超过最长时长按最长时长；未初始化的槽位为0
+    bank.extrapolate(3.2, 1.0f);
+    ok = ok && std::fabs(bank.getHorizon(0) - 0.2f) < 1e-4f && bank.getHorizon(1) == 0 &&
+         std::fabs(axis_error(KalmanBank::AXIS_YAW, bank.getPredicted(KalmanBank::AXIS_YAW, 0), yaw + rate * 0.2f)) < 0.01f &&
+         bank.getPredicted(KalmanBank::AXIS_YAW, 0) >= 0 && bank.getPredicted(KalmanBank::AXIS_YAW, 0) < 3600 &&
+         bank.getPredicted(KalmanBank::AXIS_X, 1) == 0;
+    bank.extrapolate(100.0, 1.0f);
+    ok = ok && bank.getHorizon(0) == 1.0f && bank.getPosition(KalmanBank::AXIS_YAW, 0) == yaw;
+    bank.reset(0);
+    ok = ok && !bank.isInitialized(0);
+    z[KalmanBank::AXIS_X] = -50;
+    bank.setMeasurement(0, z, 5.0);
+    bank.step();
+    ok = ok && bank.getPosition(KalmanBank::AXIS_X, 0) == -50 && bank.getVelocity(KalmanBank::AXIS_X, 0) == 0;
+    fprintf(stderr, "%-7s 边界情况（未初始化、越界槽位、回绕、外推截断、重置） %s\n", KalmanBank::isaName(isa), ok ? "正确" : "错误");
+    return ok;
+}
+
+/**
+ * @brief 轴掩码：位置、姿态由不同的数据包在不同时刻送达，每次只登记写入的那组轴；
+ *        另一组轴数组里的旧值不能当作新时刻的测量，否则速度被拉向0
+ */
+static bool check_axis_masks(KalmanBank::Isa isa)
+{
+    KalmanBank bank(2, isa);
+    float z[AXES] = {0, 0, 0, 0, 0, 0};
+    bank.setMeasurement(0, z, 0.0);
+    bank.step();
+    // x 以 100cm/s、偏航以 10°/s 运动；位置在整 0.1 秒到达，姿态错开 0.05 秒到达，
+    // 每次登记时另一组轴仍是上次的值
+    for (int k = 1; k <= 40; k++) {
+        double t = 0.1 * k;
+        z[KalmanBank::AXIS_X] = static_cast<float>(100.0 * t);
+        bank.setMeasurement(0, z, t, KalmanBank::POSITION_AXES);
+        bank.step();
+        z[KalmanBank::AXIS_YAW] = static_cast<float>(10.0 * (t + 0.05));
+        bank.setMeasurement(0, z, t + 0.05, KalmanBank::ATTITUDE_AXES);
+        bank.step();
+    }
+    // 最后一次是姿态测量（t=4.05），x 由速度预测到同一时刻
+    bool ok = std::fabs(bank.getVelocity(KalmanBank::AXIS_X, 0) - 100.0f) < 5 &&
+              std::fabs(bank.getPosition(KalmanBank::AXIS_X, 0) - 405.0f) < 5 &&
+              std::fabs(bank.getVelocity(KalmanBank::AXIS_YAW, 0) - 10.0f) < 1 &&
+              std::fabs(bank.getPosition(KalmanBank::AXIS_YAW, 0) - 40.5f) < 1 && !bank.isInitialized(1);
+    fprintf(stderr, "%-7s 轴掩码（位置、姿态交错登记） x速度 %.1f，偏航速度 %.1f %s\n", KalmanBank::isaName(isa),
+            bank.getVelocity(KalmanBank::AXIS_X, 0), bank.getVelocity(KalmanBank::AXIS_YAW, 0), ok ? "正确" : "错误");
+    return ok;
+}
+
+// ====================== 性能 ======================
+struct BankCost {
+    double update_ns;
+    double extrapolate_ns;
+};
+
+/**
+ * @brief 每周期所有无人机都有新测量，统计每架每次更新（登记测量+预测+更新）和每次外推的耗时
+ */
+static BankCost bank_ns(KalmanBank::Isa isa, int n, const std::vector<float>& measured, int cycles)
+{
+    KalmanBank bank(n, isa);
+    BankCost best = {0, 0};
+    for (int round = 0; round < 3; round++) {
+        auto start = std::chrono::steady_clock::now();
+        for (int c = 0; c < cycles; c++) {
+            double now = round * cycles * 0.01 + c * 0.01;
+            for (int i = 0; i < n; i++) {
+                bank.setMeasurement(i, &measured[static_cast<size_t>(i) * AXES], now);
+            }
+            bank.step();
+        }
+        auto middle = std::chrono::steady_clock::now();
+        double last = bank.getTime(0);
+        for (int c = 0; c < cycles; c++) {
+            bank.extrapolate(last + c * 0.001, 0.5f);
+        }
+        auto end = std::chrono::steady_clock::now();
+        double update = std::chrono::duration<double, std::nano>(middle - start).count() / cycles / n;
+        double extrapolate = std::chrono::duration<double, std::nano>(end - middle).count() / cycles / n;
+        best.update_ns = round == 0 ? update : std::min(best.update_ns, update);
+        best.extrapolate_ns = round == 0 ? extrapolate : std::min(best.extrapolate_ns, extrapolate);
+    }
+    return best;
+}
+
+static double reference_ns(int n, const std::vector<float>& measured, int cycles)
+{
+    std::vector<ReferenceFilter> filters(n);
+    KalmanBank::AxisNoise noise[AXES];
+    for (int a = 0; a < AXES; a++) {
+        noise[a] = KalmanBank::defaultNoise(static_cast<KalmanBank::Axis>(a));
+    }
+    double best = 0;
+    for (int round = 0; round < 3; round++) {
+        auto start = std::chrono::steady_clock::now();
+        for (int c = 0; c < cycles; c++) {
+            double now = round * cycles * 0.01 + c * 0.01;
+            for (int i = 0; i < n; i++) {
+                filters[i].update(&measured[static_cast<size_t>(i) * AXES], now, noise);
+            }
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        best = round == 0 ? ns : std::min(best, ns);
+    }
+    return best / cycles / n;
+}
+
+int main()
+{
+    fprintf(stderr, "CPU最快实现: %s\n", KalmanBank::isaName(KalmanBank::detectIsa()));
+    const KalmanBank::Isa isas[] = {KalmanBank::Isa::GENERIC, KalmanBank::Isa::AVX2};
+    bool passed = true;
+    for (KalmanBank::Isa isa : isas) {
+        if (static_cast<int>(isa) > static_cast<int>(KalmanBank::detectIsa())) {
+            continue;
+        }
+        passed = check_edges(isa) && passed;
+        passed = check_axis_masks(isa) && passed;
+        passed = check_accuracy(isa) && passed;
+    }
+
+    std::mt19937 rng(7);
+    std::normal_distribution<float> value(0.0f, 100.0f);
+    bool avx2 = KalmanBank::detectIsa() == KalmanBank::Isa::AVX2;
+    fprintf(stderr, "%8s %10s %14s %14s %10s %10s  (ns/架/次)\n", "无人机数", "更新:逐架标量", "generic", "avx2",
+            "外推:generic", "avx2");
+    for (int n : {10, 100, 1000, 10000}) {
+        std::vector<float> measured(static_cast<size_t>(n) * AXES);
+        for (float& v : measured) {
+            v = value(rng);
+        }
+        // 每个规模约200万次单架更新
+        int cycles = std::max(50, 2000000 / n);
+        double reference = reference_ns(n, measured, cycles);
+        BankCost generic = bank_ns(KalmanBank::Isa::GENERIC, n, measured, cycles);
+        BankCost fastest = avx2 ? bank_ns(KalmanBank::Isa::AVX2, n, measured, cycles) : BankCost{0, 0};
+        fprintf(stderr, "%8d %10.2f %8.2f(%.1fx) %8.2f(%.1fx) %10.2f %10.2f\n", n, reference, generic.update_ns,
+                reference / generic.update_ns, fastest.update_ns, avx2 ? reference / fastest.update_ns : 0.0,
+                generic.extrapolate_ns, fastest.extrapolate_ns);
+        if (generic.update_ns >= reference || (avx2 && fastest.update_ns >= reference)) {
+            fprintf(stderr, "%8d 架时批量更新不比逐架标量实现快\n", n);
+            passed = false;
+        }
+    }
+    fprintf(stderr, "%s\n", passed ? "PASS" : "FAIL");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,164 @@
+/**
+ * @file key_value_benchmark.cpp
+ * @brief key=value 遥测文本解析：原 stringstream/stoi 实现与单次遍历解析器（parseKeyValue）的吞吐对比
+ * @note 原实现原样保留在本文件中作为对照（legacy_parse），两者对同一组消息的解析结果必须一致
+ *       （原实现把x/y/z当整数解析，对照消息中的x/y/z使用整数）。
+ *       另外检查几种错误输入只返回错误码、不抛异常。
+ */
+
+#include "../src/TelemetryFields/TelemetryFields.h"
+#include "../src/data_processing/data_processing.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+static const int ROUNDS = 20;
+
+/**
+ * @brief 原 DataProcessing::ParseData(const std::string&) 实现
+ */
+static void legacy_parse(DataProcessing& d, const std::string& data)
+{
+    std::stringstream ss(data);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        size_t pos = item.find('=');
+        if (pos != std::string::npos) {
+            std::string key = item.substr(0, pos);
+            std::string value = item.substr(pos + 1);
+            if (key == "id") d.id = static_cast<uint8_t>(std::stoi(value));
+            else if (key == "roll") d.roll = static_cast<int16_t>(std::stoi(value));
+            else if (key == "pitch") d.pitch = static_cast<int16_t>(std::stoi(value));
+            else if (key == "yaw") d.yaw = static_cast<int16_t>(std::stoi(value));
+            else if (key == "x") d.x = static_cast<float>(std::stoi(value));
+            else if (key == "y") d.y = static_cast<float>(std::stoi(value));
+            else if (key == "z") d.z = static_cast<float>(std::stoi(value));
+            else if (key == "batt") d.batt = static_cast<uint8_t>(std::stoi(value));
+            else if (key == "pid0_kp") d.pid[0].kp = static_cast<uint8_t>(std::stoi(value));
+            else if (key == "pid0_ki") d.pid[0].ki = static_cast<uint8_t>(std::stoi(value));
+            else if (key == "pid0_kd") d.pid[0].kd = static_cast<uint8_t>(std::stoi(value));
+            else if (key == "pid1_kp") d.pid[1].kp = static_cast<uint8_t>(std::stoi(value));
+            else if (key == "pid1_ki") d.pid[1].ki = static_cast<uint8_t>(std::stoi(value));
+            else if (key == "pid1_kd") d.pid[1].kd = static_cast<uint8_t>(std::stoi(value));
+            else if (key == "pid2_kp") d.pid[2].kp = static_cast<uint8_t>(std::stoi(value));
+            else if (key == "pid2_ki") d.pid[2].ki = static_cast<uint8_t>(std::stoi(value));
+            else if (key == "pid2_kd") d.pid[2].kd = static_cast<uint8_t>(std::stoi(value));
+            else if (key == "pid3_kp") d.pid[3].kp = static_cast<uint8_t>(std::stoi(value));
+            else if (key == "pid3_ki") d.pid[3].ki = static_cast<uint8_t>(std::stoi(value));
+            else if (key == "pid3_kd") d.pid[3].kd = static_cast<uint8_t>(std::stoi(value));
+        }
+    }
+}
+
+static bool same(const DataProcessing& a, const DataProcessing& b)
+{
+    bool ok = a.id == b.id && a.roll == b.roll && a.pitch == b.pitch && a.yaw == b.yaw &&
+              a.x == b.x && a.y == b.y && a.z == b.z && a.batt == b.batt;
+    for (int i = 0; i < 4; i++) {
+        ok = ok && a.pid[i].kp == b.pid[i].kp && a.pid[i].ki == b.pid[i].ki && a.pid[i].kd == b.pid[i].kd;
+    }
+    return ok;
+}
+
+/**
+ * @brief 生成遥测消息：姿态+位置+电池，约1/4的消息带全部PID参数
+ */
+static std::vector<std::string> make_messages(int count)
+{
+    std::mt19937 rng(3);
+    std::vector<std::string> messages;
+    for (int i = 0; i < count; i++) {
+        std::string m = "id=" + std::to_string(rng() % 100) +
+                        ",roll=" + std::to_string(static_cast<int>(rng() % 3600) - 1800) +
+                        ",pitch=" + std::to_string(static_cast<int>(rng() % 3600) - 1800) +
+                        ",yaw=" + std::to_string(rng() % 3600) +
+                        ",x=" + std::to_string(rng() % 100000) +
+                        ",y=" + std::to_string(rng() % 100000) +
+                        ",z=" + std::to_string(rng() % 500) +
+                        ",batt=" + std::to_string(rng() % 256);
+        if (i % 4 == 0) {
+            for (int p = 0; p < 4; p++) {
+                m += ",pid" + std::to_string(p) + "_kp=" + std::to_string(rng() % 256) +
+                     ",pid" + std::to_string(p) + "_ki=" + std::to_string(rng() % 256) +
+                     ",pid" + std::to_string(p) + "_kd=" + std::to_string(rng() % 256);
+            }
+        }
+        messages.push_back(m);
+    }
+    return messages;
+}
+
+template <typename Body>
+static double ns_per_message(const std::vector<std::string>& messages, Body body)
+{
+    double best = 0;
+    for (int r = 0; r < ROUNDS; r++) {
+        auto start = std::chrono::steady_clock::now();
+        for (const std::string& m : messages) {
+            body(m);
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        if (r == 0 || ns < best) {
+            best = ns;
+        }
+    }
+    return best / messages.size();
+}
+
+static bool check_errors()
+{
+    struct Case {
+        const char* text;
+        ParseStatus status;
+        uint32_t offset;
+        uint16_t fields;
+    };
+    const Case cases[] = {
+        {"roll=abc,yaw=5", ParseStatus::INVALID_NUMBER, 5, 1},
+        {"batt=300,id=2", ParseStatus::OUT_OF_RANGE, 5, 1},
+        {"id=1,pitch", ParseStatus::MISSING_VALUE, 5, 1},
+        {"=4,x=1.5", ParseStatus::EMPTY_KEY, 0, 1},
+        {"x=12.5e1,y=-0.25,z=+3", ParseStatus::OK, 0, 3},
+        {"id=7,foo=1,yaw=12\r\n", ParseStatus::OK, 0, 2},
+    };
+    bool ok = true;
+    for (const Case& c : cases) {
+        DataProcessing d;
+        ParseResult r = parseKeyValue(c.text, d);
+        bool pass = r.status == c.status && r.error_offset == c.offset && r.fields == c.fields;
+        fprintf(stderr, "  %-28s -> %-15s offset=%u fields=%u %s\n", c.text, parseStatusName(r.status),
+                r.error_offset, r.fields, pass ? "" : "(不符合预期)");
+        ok = ok && pass;
+    }
+    DataProcessing d;
+    parseKeyValue("x=12.5e1,y=-0.25", d);
+    return ok && d.x == 125.0f && d.y == -0.25f;
+}
+
+int main()
+{
+    fprintf(stderr, "错误输入检查：\n");
+    bool passed = check_errors();
+
+    std::vector<std::string> messages = make_messages(10000);
+    for (const std::string& m : messages) {
+        DataProcessing a;
+        DataProcessing b;
+        legacy_parse(a, m);
+        ParseResult r = parseKeyValue(m, b);
+        passed = passed && r.ok() && same(a, b);
+    }
+
+    DataProcessing target;
+    double legacy_ns = ns_per_message(messages, [&](const std::string& m) { legacy_parse(target, m); });
+    double fast_ns = ns_per_message(messages, [&](const std::string& m) { parseKeyValue(m, target); });
+
+    fprintf(stderr, "\n%zu 条消息（平均 %zu 字节）：\n", messages.size(),
+            [&]() { size_t t = 0; for (auto& m : messages) t += m.size(); return t / messages.size(); }());
+    fprintf(stderr, "原实现(stringstream+stoi)   %8.1f ns/条\n", legacy_ns);
+    fprintf(stderr, "单次遍历(from_chars+哈希)  %8.1f ns/条  (%.1fx)\n", fast_ns, legacy_ns / fast_ns);
+    fprintf(stderr, "%s\n", passed ? "PASS" : "FAIL");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file logger_benchmark.cpp
+ * @brief 异步日志与 std::cout 的单次调用耗时对比
+ * @note 结果输出到 stderr，日志本身输出到 stdout，建议运行：
+ *       ./logger_benchmark > /dev/null      （只看调用开销）
+ *       ./logger_benchmark                 （终端输出，接近现场情况）
+ */
+
+#include "udp_ros_bridge/Logger.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const int ITERATIONS = 200000;
+static const int THREADS = 4;
+// 每批调用数，不超过每线程环形缓冲区的一半，批间排空，保证记录真正写出而不是走丢弃路径
+static const int BATCH = Logger::RING_SIZE / 2;
+
+// 与接收线程中的日志内容一致
+static const std::string client_ip = "192.168.0.107";
+static const int client_port = 8888;
+
+/**
+ * @brief 在多个线程中同时执行 body，返回平均每次调用的纳秒数
+ * @note 每个线程按批计时，批与批之间同步排空日志（不计时），
+ *       测的是记录写入缓冲区的开销；丢弃数由调用方另行统计
+ */
+template <typename Body>
+static double measure(int threads, Body body)
+{
+    std::atomic<uint64_t> total_ns{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&body, &total_ns]() {
+            uint64_t timed_ns = 0;
+            for (int i = 0; i < ITERATIONS; i += BATCH) {
+                int end = std::min(i + BATCH, ITERATIONS);
+                auto start = std::chrono::steady_clock::now();
+                for (int j = i; j < end; j++) {
+                    body(j);
+                }
+                auto elapsed = std::chrono::steady_clock::now() - start;
+                timed_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+                Logger::instance().flush();
+            }
+            total_ns.fetch_add(timed_ns);
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return static_cast<double>(total_ns.load()) / (static_cast<double>(ITERATIONS) * threads);
+}
+
+/**
+ * @brief 执行一项测试，返回平均每次调用的纳秒数，dropped 为本项测试期间缓冲区满丢弃的条数
+ */
+template <typename Test>
+static double run_test(Test test, int threads, uint64_t& dropped)
+{
+    uint64_t before = Logger::instance().droppedCount();
+    double ns = test(threads);
+    Logger::instance().flush();
+    dropped = Logger::instance().droppedCount() - before;
+    return ns;
+}
+
+/**
+ * @brief 原来的写法：每个包一次 std::cout + std::endl
+ */
+static double test_cout(int threads)
+{
+    return measure(threads, [](int i) {
+        std::cout << "收到来自 " << client_ip << ":" << client_port
+                  << " (" << i << " 字节)" << std::endl;
+    });
+}
+
+/**
+ * @brief 异步日志，级别开启
+ */
+static double test_logger_enabled(int threads)
+{
+    return measure(threads, [](int i) {
+        LOG_INFO("收到来自 {}:{} ({} 字节)", client_ip, client_port, i);
+    });
+}
+
+/**
+ * @brief 异步日志，级别关闭（热路径只有一次原子读）
+ */
+static double test_logger_disabled(int threads)
+{
+    return measure(threads, [](int i) {
+        LOG_DEBUG("收到来自 {}:{} ({} 字节)", client_ip, client_port, i);
+    });
+}
+
+/**
+ * @brief 异步日志，限频（每秒最多一条）
+ */
+static double test_logger_rate_limited(int threads)
+{
+    return measure(threads, [](int i) {
+        LOG_INFO_EVERY(1000, "收到来自 {}:{} ({} 字节)", client_ip, client_port, i);
+    });
+}
+
+int main()
+{
+    Logger::setLevel(LogLevel::INFO);
+
+    uint64_t total_dropped = 0;
+    for (int threads = 1; threads <= THREADS; threads *= 2) {
+        uint64_t cout_dropped, enabled_dropped, disabled_dropped, limited_dropped;
+        double cout_ns = run_test(test_cout, threads, cout_dropped);
+        double enabled_ns = run_test(test_logger_enabled, threads, enabled_dropped);
+        double disabled_ns = run_test(test_logger_disabled, threads, disabled_dropped);
+        double limited_ns = run_test(test_logger_rate_limited, threads, limited_dropped);
+        total_dropped += enabled_dropped + disabled_dropped + limited_dropped;
+
+        fprintf(stderr, "线程数 %d:\n", threads);
+        fprintf(stderr, "  std::cout          %8.1f ns/次\n", cout_ns);
+        fprintf(stderr, "  LOG_INFO           %8.1f ns/次  丢弃 %llu 条\n", enabled_ns,
+                static_cast<unsigned long long>(enabled_dropped));
+        fprintf(stderr, "  LOG_DEBUG(关闭)    %8.1f ns/次  丢弃 %llu 条\n", disabled_ns,
+                static_cast<unsigned long long>(disabled_dropped));
+        fprintf(stderr, "  LOG_INFO_EVERY     %8.1f ns/次  丢弃 %llu 条\n", limited_ns,
+                static_cast<unsigned long long>(limited_dropped));
+    }
+    // 批间已排空，正常情况下不应有丢弃；有丢弃说明测到的是丢弃路径，结果不可信
+    fprintf(stderr, "缓冲区满丢弃: %llu 条\n", static_cast<unsigned long long>(total_dropped));
+    if (total_dropped > 0) {
+        fprintf(stderr, "FAIL: 有记录被丢弃，LOG_INFO 的结果包含丢弃路径\n");
+        return 1;
+    }
+    fprintf(stderr, "PASS\n");
+    return 0;
+}
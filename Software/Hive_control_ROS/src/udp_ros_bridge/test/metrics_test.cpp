@@ -0,0 +1,201 @@
+/**
+ * @file metrics_test.cpp
+ * @brief 运行指标测试：HDR式直方图的分桶和百分位误差、注册表的速率计算、Prometheus 文本格式、
+ *        诊断分组告警，以及热路径计数/直方图记录的单次开销（单线程与多线程争用）
+ */
+
+#include "../src/Metrics/Metrics.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// ====================== 直方图 ======================
+static bool check_histogram()
+{
+    bool ok = true;
+    // 分桶连续：每个值落在 [上一个桶上界, 本桶上界) 内
+    for (uint64_t v = 0; v < (1ULL << 20); v++) {
+        int index = LatencyHistogram::bucketIndex(v);
+        uint64_t lower = index == 0 ? 0 : LatencyHistogram::bucketUpperBound(index - 1);
+        if (v < lower || v >= LatencyHistogram::bucketUpperBound(index)) {
+            fprintf(stderr, "值 %lu 落在桶 %d [%lu, %lu) 外\n", static_cast<unsigned long>(v), index,
+                    static_cast<unsigned long>(lower),
+                    static_cast<unsigned long>(LatencyHistogram::bucketUpperBound(index)));
+            ok = false;
+            break;
+        }
+    }
+    ok = ok && LatencyHistogram::bucketIndex(~0ULL) == LatencyHistogram::BUCKET_COUNT - 1;
+
+    // 对数均匀分布的延迟（100ns ~ 100ms），百分位与精确值比较
+    LatencyHistogram histogram;
+    std::vector<uint64_t> values;
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> exponent(2.0, 8.0);
+    for (int i = 0; i < 200000; i++) {
+        uint64_t v = static_cast<uint64_t>(std::pow(10.0, exponent(rng)));
+        values.push_back(v);
+        histogram.record(static_cast<int64_t>(v));
+    }
+    std::sort(values.begin(), values.end());
+    double worst = 0;
+    for (double p : {0.5, 0.9, 0.99, 0.999}) {
+        double exact = static_cast<double>(values[static_cast<size_t>(p * values.size())]);
+        double error = std::fabs(histogram.percentile(p) - exact) / exact;
+        worst = std::max(worst, error);
+    }
+    ok = ok && worst <= 1.0 / LatencyHistogram::SUB_BUCKETS && histogram.max() == values.back();
+    fprintf(stderr, "直方图：%d 个桶，百分位最大相对误差 %.2f%%（上限 %.1f%%） %s\n", LatencyHistogram::BUCKET_COUNT,
+            worst * 100, 100.0 / LatencyHistogram::SUB_BUCKETS, ok ? "正确" : "错误");
+    return ok;
+}
+
+// ====================== 注册表与导出 ======================
+static bool contains(const std::string& text, const std::string& line)
+{
+    return text.find(line + "\n") != std::string::npos;
+}
+
+static bool check_registry()
+{
+    MetricsRegistry registry("test");
+    double external = 100;
+    double depth = 3;
+    LatencyHistogram latency;
+    MetricCounter& packets = registry.counter("packets_total", "数据报数").label("format", "json").group("接收").counter();
+    registry.counter("packets_total", "数据报数", [&external]() { return external; })
+        .label("format", "bin\"ary").group("接收");
+    registry.counter("drops_total", "丢包", [&external]() { return external / 100; }).group("接收").warnAbove(0);
+    registry.gauge("queue_depth", "队列深度", [&depth]() { return depth; }).group("解码").warnAbove(10);
+    registry.gauge("age_seconds", "距上次更新", []() { return std::numeric_limits<double>::infinity(); });
+    registry.latency("publish_seconds", "发布延迟", latency).group("发布").warnAbove(0.001);
+
+    packets.add(5);
+    registry.sample(1000000000ULL);
+    packets.add(10);
+    packets.addSingleWriter(10);
+    external = 300;
+    for (int i = 0; i < 100; i++) {
+        latency.record(2000000);
+    }
+    registry.sample(3000000000ULL);
+
+    bool ok = registry.size() == 6;
+    std::string text = registry.renderPrometheus();
+    ok = ok && contains(text, "# TYPE test_packets_total counter");
+    // 同名指标只有一组 HELP/TYPE
+    ok = ok && text.find("# HELP test_packets_total") == text.rfind("# HELP test_packets_total");
+    ok = ok && contains(text, "test_packets_total{format=\"json\"} 25");
+    ok = ok && contains(text, "test_packets_total{format=\"bin\\\"ary\"} 300");
+    ok = ok && contains(text, "test_queue_depth 3");
+    ok = ok && contains(text, "test_age_seconds +Inf");
+    // 延迟导出为累计直方图：2ms 落在 2^21 ns（约2.1ms）桶内，不导出窗口分位数
+    ok = ok && contains(text, "# TYPE test_publish_seconds histogram");
+    ok = ok && contains(text, "test_publish_seconds_count 100");
+    ok = ok && contains(text, "test_publish_seconds_bucket{le=\"0.001048576\"} 0");
+    ok = ok && contains(text, "test_publish_seconds_bucket{le=\"0.002097152\"} 100");
+    ok = ok && contains(text, "test_publish_seconds_bucket{le=\"+Inf\"} 100");
+    ok = ok && contains(text, "test_publish_seconds_sum 0.20000000000000001");
+    ok = ok && text.find("quantile=") == std::string::npos;
+
+    // 速率：两次采样间隔2秒
+    std::vector<MetricGroup> groups = registry.groups();
+    ok = ok && groups.size() == 3 && groups[0].name == "接收" && groups[0].values.size() == 3;
+    ok = ok && groups.size() == 3 && groups[0].values[1].second == "300（100/s）";
+    // 丢包速率 > 0、p99 2ms > 1ms 告警；队列深度 3 未超过 10
+    ok = ok && groups.size() == 3 && groups[0].warning && !groups[1].warning && groups[2].warning;
+
+    // 清空统计窗口后：诊断只看新窗口，Prometheus 的 _count/_sum 继续累加
+    latency.reset();
+    for (int i = 0; i < 50; i++) {
+        latency.record(500000);
+    }
+    registry.sample(4000000000ULL);
+    std::string after = registry.renderPrometheus();
+    std::vector<MetricGroup> window = registry.groups();
+    ok = ok && contains(after, "test_publish_seconds_count 150");
+    ok = ok && contains(after, "test_publish_seconds_bucket{le=\"0.000524288\"} 50");
+    ok = ok && contains(after, "test_publish_seconds_sum 0.22500000000000001");
+    ok = ok && window.size() == 3 && window[2].values[0].second.compare(0, 5, "n=50 ") == 0 && !window[2].warning;
+    ok = ok && latency.count() == 50 && latency.cumulativeCount() == 150;
+    // 写文件的比较用最新一次采样的文本
+    registry.sample(5000000000ULL);
+    text = registry.renderPrometheus();
+
+    std::string path = "/tmp/metrics_test_" + std::to_string(getpid()) + ".prom";
+    ok = ok && registry.writePrometheus(path);
+    std::ifstream file(path);
+    std::stringstream written;
+    written << file.rdbuf();
+    ok = ok && written.str() == text && access((path + ".tmp").c_str(), F_OK) != 0;
+    unlink(path.c_str());
+    ok = ok && !registry.writePrometheus("/nonexistent/dir/metrics.prom");
+    fprintf(stderr, "注册表：Prometheus 文本 %zu 字节，诊断分组 %zu 个 %s\n", text.size(), groups.size(),
+            ok ? "正确" : "错误");
+    if (!ok) {
+        fprintf(stderr, "%s", text.c_str());
+    }
+    return ok;
+}
+
+// ====================== 热路径开销 ======================
+template <typename Body>
+static double ns_per_op(int threads, long ops, Body body)
+{
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&body, t, ops]() {
+            for (long i = 0; i < ops; i++) {
+                body(t, i);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ops;
+}
+
+static bool check_overhead()
+{
+    const long OPS = 20000000;
+    int threads = static_cast<int>(std::max(2u, std::thread::hardware_concurrency()));
+    std::vector<MetricCounter> counters(threads);
+    MetricCounter shared;
+    LatencyHistogram histogram;
+
+    double single = ns_per_op(1, OPS, [&counters](int t, long) { counters[t].addSingleWriter(); });
+    double atomic = ns_per_op(1, OPS, [&counters](int t, long) { counters[t].add(); });
+    double own = ns_per_op(threads, OPS / threads, [&counters](int t, long) { counters[t].add(); });
+    double contended = ns_per_op(threads, OPS / threads, [&shared](int, long) { shared.add(); });
+    double record = ns_per_op(1, OPS / 4, [&histogram](int, long i) { histogram.record(1000 + (i & 0xffff)); });
+
+    uint64_t total = shared.get();
+    for (const MetricCounter& counter : counters) {
+        total += counter.get();
+    }
+    bool ok = total == static_cast<uint64_t>(OPS) * 2 + static_cast<uint64_t>(OPS / threads) * threads * 2 &&
+              histogram.count() == static_cast<uint64_t>(OPS / 4);
+    fprintf(stderr, "单写者计数 %.2f ns，原子计数 %.2f ns，%d 线程各自计数 %.2f ns/线程，"
+            "共用一个计数 %.2f ns/线程，直方图记录 %.2f ns %s\n",
+            single, atomic, threads, own, contended, record, ok ? "" : "错误");
+    return ok;
+}
+
+int main()
+{
+    bool passed = check_histogram();
+    passed = check_registry() && passed;
+    passed = check_overhead() && passed;
+    fprintf(stderr, "%s\n", passed ? "PASS" : "FAIL");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,212 @@
+/**
+ * @file packet_pool_test.cpp
+ * @brief 数据包缓冲区池测试：引用计数、跨线程归还，以及稳定运行时接收到解析全程不分配内存
+ * @note 测试程序替换了 malloc/calloc/realloc/free（转发到 glibc 的 __libc_* 实现），
+ *       统计开关打开期间所有线程的分配次数。先经本机回环收发一段数据报让池、队列、
+ *       扫描器等预热到稳定容量，再打开统计收发大量数据报，分配次数必须为0。
+ *       数据包走与 main.cpp 相同的路径：接收线程 -> 无锁队列 -> popMessage -> Ingress -> DataProcessing
+ */
+
+#include "../src/PacketPool/PacketPool.h"
+#include "../src/UDP/UDP.h"
+#include "../src/Ingress/Ingress.h"
+#include "udp_ros_bridge/Logger.h"
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// data_processing.cpp 引用的全局注册表
+SwarmRegistry swarm_registry;
+
+// ====================== 分配计数 ======================
+static std::atomic<bool> counting(false);
+static std::atomic<uint64_t> allocations(0);
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(size_t size)
+{
+    if (counting.load(std::memory_order_relaxed)) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size)
+{
+    if (counting.load(std::memory_order_relaxed)) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size)
+{
+    if (counting.load(std::memory_order_relaxed)) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    return __libc_realloc(ptr, size);
+}
+
+void* memalign(size_t alignment, size_t size)
+{
+    if (counting.load(std::memory_order_relaxed)) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** ptr, size_t alignment, size_t size)
+{
+    *ptr = memalign(alignment, size);
+    return *ptr != nullptr ? 0 : 12;
+}
+
+void* aligned_alloc(size_t alignment, size_t size)
+{
+    return memalign(alignment, size);
+}
+
+void free(void* ptr)
+{
+    __libc_free(ptr);
+}
+}
+
+// ====================== 引用计数 ======================
+static bool check_refcount()
+{
+    PacketPool pool(4, 64);
+    bool ok = pool.getSlabCount() == 4 && pool.getInUseCount() == 0;
+    {
+        PacketRef a = pool.acquire(10);
+        PacketRef b = a;
+        PacketRef c = std::move(b);
+        ok = ok && a.useCount() == 2 && !b && c.data() == a.data() && pool.getInUseCount() == 1;
+        a.reset();
+        ok = ok && c.useCount() == 1 && pool.getInUseCount() == 1;
+    }
+    ok = ok && pool.getInUseCount() == 0;
+
+    // 取空后扩容；超长请求单独分配
+    std::vector<PacketRef> held;
+    for (int i = 0; i < 5; i++) {
+        held.push_back(pool.acquire(64));
+    }
+    PacketRef large = pool.acquire(1000);
+    ok = ok && pool.getGrowCount() == 1 && pool.getSlabCount() == 4 + PacketPool::GROW_SLABS &&
+         pool.getOversizeCount() == 1 && large.capacity() >= 1000;
+
+    // 其他线程释放，取用线程能重新取到同一批缓冲区
+    std::thread releaser([&held]() { held.clear(); });
+    releaser.join();
+    size_t slabs = pool.getSlabCount();
+    for (int i = 0; i < 5; i++) {
+        held.push_back(pool.acquire(64));
+    }
+    ok = ok && pool.getSlabCount() == slabs && pool.getInUseCount() == 5;
+
+    fprintf(stderr, "引用计数与跨线程归还：%s\n", ok ? "正确" : "错误");
+    return ok;
+}
+
+// ====================== 稳定运行不分配内存 ======================
+static const int PORT = 19660;
+static const int BATCH = 64;
+
+// 发送一批姿态帧，并把收到的数据报全部解析完
+static int exchange(UDP& receiver, int sender, const sockaddr_in& target, Ingress& ingress,
+                    DroneData<UdpPacket>& drones, int batch_index)
+{
+    uint8_t frame[12] = {0xEE, 0xEE, 0x00, 6};
+    for (int i = 0; i < BATCH; i++) {
+        int value = batch_index * BATCH + i;
+        frame[4] = static_cast<uint8_t>(value >> 8);
+        frame[5] = static_cast<uint8_t>(value);
+        uint8_t check = 0;
+        for (int k = 2; k < 10; k++) {
+            check += frame[k];
+        }
+        frame[10] = check;
+        frame[11] = 0xFF;
+        sendto(sender, frame, sizeof(frame), 0, reinterpret_cast<const sockaddr*>(&target), sizeof(target));
+    }
+
+    int received = 0;
+    UdpPacket packet;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+    while (received < BATCH && std::chrono::steady_clock::now() < deadline) {
+        if (!receiver.popMessage(packet)) {
+            std::this_thread::yield();
+            continue;
+        }
+        // 没有接防洪器时来源槽位为-1，这里按单架无人机处理
+        packet.slot = 0;
+        ingress.route(packet, drones);
+        received++;
+    }
+    return received;
+}
+
+static bool check_steady_state()
+{
+    UDP receiver(PORT);
+    receiver.setReceiveBufferSize(4 * 1024 * 1024);
+    receiver.startListening();
+    Ingress ingress(1);
+    DroneData<UdpPacket> drones(1);
+
+    int sender = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in target;
+    memset(&target, 0, sizeof(target));
+    target.sin_family = AF_INET;
+    target.sin_port = htons(PORT);
+    inet_pton(AF_INET, "127.0.0.1", &target.sin_addr);
+
+    // 预热：池和各线程的复用缓冲区达到稳定容量
+    int warmup = 0;
+    for (int i = 0; i < 200; i++) {
+        warmup += exchange(receiver, sender, target, ingress, drones, i);
+    }
+
+    const int BATCHES = 2000;
+    uint64_t grows = receiver.getPacketPool().getGrowCount();
+    counting.store(true);
+    auto start = std::chrono::steady_clock::now();
+    int received = 0;
+    for (int i = 0; i < BATCHES; i++) {
+        received += exchange(receiver, sender, target, ingress, drones, i);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    counting.store(false);
+
+    close(sender);
+    receiver.stop();
+
+    uint64_t count = allocations.load();
+    fprintf(stderr, "预热 %d 个数据报；统计期间收发 %d/%d 个数据报（%.0f 个/秒），内存分配 %lu 次，池扩容 %lu 次\n",
+            warmup, received, BATCHES * BATCH, received / seconds, static_cast<unsigned long>(count),
+            static_cast<unsigned long>(receiver.getPacketPool().getGrowCount() - grows));
+    bool ok = count == 0 && received > BATCHES * BATCH * 9 / 10 && drones[0].roll != 0;
+    fprintf(stderr, "稳定运行不分配内存：%s\n", ok ? "正确" : "错误");
+    return ok;
+}
+
+int main()
+{
+    Logger::setLevel(LogLevel::ERROR);
+    bool passed = check_refcount();
+    passed = check_steady_state() && passed;
+    fprintf(stderr, "%s\n", passed ? "PASS" : "FAIL");
+    return passed ? 0 : 1;
+}
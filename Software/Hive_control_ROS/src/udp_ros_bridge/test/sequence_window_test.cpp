@@ -0,0 +1,223 @@
+/**
+ * @file sequence_window_test.cpp
+ * @brief 帧序号窗口测试：丢包、重复、乱序、过期和无人机重启
+ * @note 第一部分直接对 SequenceWindow 构造各种到达顺序并核对计数；
+ *       第二部分组装带序号的二进制帧，经 DataProcessing 解析，检查迟到的旧姿态不会覆盖新姿态，
+ *       包括写同一组字段的不同帧类型：迟到的旧关键帧、旧姿态帧不会覆盖增量帧写入的新姿态。
+ *       最后模拟10%丢包、5%重复和窗口内乱序的长序列，输出单帧判定耗时。
+ */
+
+#include "../src/SequenceWindow/SequenceWindow.h"
+#include "../src/data_processing/data_processing.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// data_processing.cpp 引用的全局注册表
+SwarmRegistry swarm_registry;
+
+using Verdict = SequenceWindow::Verdict;
+
+static const char* verdict_name(Verdict verdict)
+{
+    switch (verdict) {
+        case Verdict::ACCEPT: return "accept";
+        case Verdict::REORDERED: return "reordered";
+        case Verdict::DUPLICATE: return "duplicate";
+        case Verdict::STALE: return "stale";
+    }
+    return "?";
+}
+
+static bool check_sequence()
+{
+    struct Step {
+        uint16_t seq;
+        uint32_t fields;
+        Verdict verdict;
+    };
+    const uint32_t ATTITUDE = FRAME_FIELDS_ATTITUDE;
+    const uint32_t PID = FRAME_FIELDS_PID;
+    const uint32_t SAMPLE = frameFieldGroups(FRAME_TYPE_KEYFRAME);
+    const Step steps[] = {
+        {100, ATTITUDE, Verdict::ACCEPT},
+        {101, ATTITUDE, Verdict::ACCEPT},
+        {101, ATTITUDE, Verdict::DUPLICATE},   // 重复
+        {104, ATTITUDE, Verdict::ACCEPT},      // 102、103 暂记丢失
+        {103, PID, Verdict::REORDERED},        // 迟到的PID：该字段组没有更新的数据，写入
+        {102, ATTITUDE, Verdict::STALE},       // 迟到的姿态：已有更新的104，不覆盖
+        {102, ATTITUDE, Verdict::DUPLICATE},   // 已登记过
+        {30, ATTITUDE, Verdict::STALE},        // 早于窗口
+        {65535, ATTITUDE, Verdict::STALE},
+        {105, ATTITUDE, Verdict::ACCEPT},
+        {108, SAMPLE, Verdict::ACCEPT},        // 增量帧写姿态、位置和电池
+        {107, SAMPLE, Verdict::STALE},         // 迟到的旧关键帧：同一组字段已有108
+        {106, ATTITUDE, Verdict::STALE},       // 迟到的旧姿态帧：姿态已由108写入
+    };
+    SequenceWindow window;
+    bool ok = true;
+    for (const Step& step : steps) {
+        Verdict verdict = window.accept(step.seq, step.fields);
+        if (verdict != step.verdict) {
+            fprintf(stderr, "  seq=%u fields=0x%x -> %s（期望 %s）\n", step.seq, step.fields, verdict_name(verdict),
+                    verdict_name(step.verdict));
+            ok = false;
+        }
+    }
+    ok = ok && window.getReceivedCount() == 13 && window.getLostCount() == 0 && window.getReorderedCount() == 4 &&
+         window.getDuplicateCount() == 2 && window.getStaleCount() == 5;
+
+    // 序号回绕
+    SequenceWindow wrap;
+    ok = ok && wrap.accept(65534, ATTITUDE) == Verdict::ACCEPT && wrap.accept(65535, ATTITUDE) == Verdict::ACCEPT &&
+         wrap.accept(1, ATTITUDE) == Verdict::ACCEPT && wrap.getLostCount() == 1 &&
+         wrap.accept(0, FRAME_FIELDS_POSITION) == Verdict::REORDERED && wrap.getLostCount() == 0;
+
+    // 重启：序号回到0后，连续被拒 RESYNC_THRESHOLD 帧时重建窗口
+    SequenceWindow restart;
+    for (uint16_t seq = 5000; seq < 5100; seq++) {
+        restart.accept(seq, ATTITUDE);
+    }
+    int rejected = 0;
+    for (uint16_t seq = 0; seq < 40; seq++) {
+        if (!SequenceWindow::shouldApply(restart.accept(seq, ATTITUDE))) {
+            rejected++;
+        }
+    }
+    ok = ok && restart.getResyncCount() == 1 && rejected == SequenceWindow::RESYNC_THRESHOLD - 1;
+
+    fprintf(stderr, "窗口判定：%s\n", ok ? "正确" : "错误");
+    return ok;
+}
+
+// 带序号的帧（加和校验）
+static void append_frame(std::vector<uint8_t>& out, uint8_t status, uint16_t seq, const std::vector<uint8_t>& params)
+{
+    size_t start = out.size();
+    const uint8_t head[] = {FRAME_HEAD, FRAME_HEAD, static_cast<uint8_t>(status | FRAME_SEQ_FLAG),
+                            static_cast<uint8_t>(params.size()), static_cast<uint8_t>(seq >> 8),
+                            static_cast<uint8_t>(seq)};
+    out.insert(out.end(), head, head + sizeof(head));
+    out.insert(out.end(), params.begin(), params.end());
+    uint8_t sum = 0;
+    for (size_t i = start + 2; i < out.size(); i++) {
+        sum += out[i];
+    }
+    out.push_back(sum);
+    out.push_back(FRAME_TAIL);
+}
+
+// 带序号的姿态帧
+static void append_attitude(std::vector<uint8_t>& out, uint16_t seq, int16_t yaw)
+{
+    append_frame(out, 0x00, seq, {0, 0, 0, 0, static_cast<uint8_t>(yaw >> 8), static_cast<uint8_t>(yaw)});
+}
+
+// 带序号的关键帧：只有 yaw 非零
+static void append_keyframe(std::vector<uint8_t>& out, uint16_t seq, uint8_t key_id, int16_t yaw)
+{
+    std::vector<uint8_t> params(KEYFRAME_LENGTH, 0);
+    params[0] = key_id;
+    params[5] = static_cast<uint8_t>(yaw >> 8);
+    params[6] = static_cast<uint8_t>(yaw);
+    append_frame(out, FRAME_TYPE_KEYFRAME, seq, params);
+}
+
+static bool check_frames()
+{
+    DataProcessing drone;
+    SequenceWindow window;
+    std::vector<uint8_t> datagram;
+
+    append_attitude(datagram, 10, 100);
+    drone.ParseData(datagram.data(), datagram.size(), &window);
+    datagram.clear();
+    append_attitude(datagram, 12, 120);
+    drone.ParseData(datagram.data(), datagram.size(), &window);
+    // 迟到的11号帧
+    datagram.clear();
+    append_attitude(datagram, 11, 110);
+    size_t frames = drone.ParseData(datagram.data(), datagram.size(), &window);
+
+    // 不带窗口时按旧行为直接写入
+    DataProcessing legacy;
+    legacy.ParseData(datagram.data(), datagram.size());
+
+    bool ok = frames == 1 && drone.yaw == 120 && legacy.yaw == 110 && window.getStaleCount() == 1;
+    fprintf(stderr, "带序号帧解析：%s（yaw=%d）\n", ok ? "正确" : "错误", drone.yaw);
+    return ok;
+}
+
+/**
+ * @brief 关键帧、增量帧和旧格式姿态帧写同一组字段：迟到的旧关键帧、旧姿态帧不覆盖增量帧写入的新姿态
+ */
+static bool check_late_keyframe()
+{
+    DataProcessing drone;
+    SequenceWindow window;
+    std::vector<uint8_t> datagram;
+
+    // 关键帧1（序号20，yaw=100），增量帧（序号23，以关键帧1为基准 yaw+20，zig-zag 40）
+    append_keyframe(datagram, 20, 1, 100);
+    append_frame(datagram, FRAME_TYPE_DELTA, 23, {1, 0x04, 40});
+    drone.ParseData(datagram.data(), datagram.size(), &window);
+    // 迟到：序号21的新关键帧（yaw=110）、序号22的姿态帧（yaw=115），都比增量帧旧
+    datagram.clear();
+    append_keyframe(datagram, 21, 2, 110);
+    append_attitude(datagram, 22, 115);
+    drone.ParseData(datagram.data(), datagram.size(), &window);
+
+    bool ok = drone.yaw == 120 && window.getStaleCount() == 2 && window.getReorderedCount() == 2 && drone.updates == 2;
+    fprintf(stderr, "迟到的旧关键帧：%s（yaw=%d，过期 %lu）\n", ok ? "正确" : "错误", drone.yaw,
+            static_cast<unsigned long>(window.getStaleCount()));
+    return ok;
+}
+
+int main()
+{
+    bool passed = check_sequence();
+    passed = check_frames() && passed;
+    passed = check_late_keyframe() && passed;
+
+    // 模拟链路：10%丢包，5%重复，20%的帧在8帧范围内乱序
+    const int COUNT = 1000000;
+    std::mt19937 rng(11);
+    std::vector<uint16_t> arrivals;
+    arrivals.reserve(COUNT * 2);
+    int dropped = 0;
+    for (int i = 0; i < COUNT; i++) {
+        if (rng() % 10 == 0) {
+            dropped++;
+            continue;
+        }
+        arrivals.push_back(static_cast<uint16_t>(i));
+        if (rng() % 20 == 0) {
+            arrivals.push_back(static_cast<uint16_t>(i));
+        }
+    }
+    for (size_t i = 0; i + 8 < arrivals.size(); i++) {
+        if (rng() % 5 == 0) {
+            std::swap(arrivals[i], arrivals[i + 1 + rng() % 7]);
+        }
+    }
+
+    SequenceWindow window;
+    auto start = std::chrono::steady_clock::now();
+    size_t applied = 0;
+    for (uint16_t seq : arrivals) {
+        applied += SequenceWindow::shouldApply(window.accept(seq, 1u << (seq & 7)));
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    fprintf(stderr, "\n模拟 %d 帧：实际丢弃 %d，统计丢失 %lu，乱序 %lu，重复 %lu，过期 %lu，写入 %zu\n", COUNT, dropped,
+            static_cast<unsigned long>(window.getLostCount()), static_cast<unsigned long>(window.getReorderedCount()),
+            static_cast<unsigned long>(window.getDuplicateCount()), static_cast<unsigned long>(window.getStaleCount()),
+            applied);
+    fprintf(stderr, "单帧判定 %.2f ns\n", ns / arrivals.size());
+    passed = passed && window.getLostCount() == static_cast<uint64_t>(dropped) && window.getResyncCount() == 0;
+
+    fprintf(stderr, "%s\n", passed ? "PASS" : "FAIL");
+    return passed ? 0 : 1;
+}
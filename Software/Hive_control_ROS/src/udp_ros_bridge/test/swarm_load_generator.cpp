@@ -0,0 +1,471 @@
+/**
+ * @file swarm_load_generator.cpp
+ * @brief 虚拟无人机集群负载发生器：一个进程模拟最多上万架无人机，按真实二进制协议向桥接发遥测
+ * @note 每架虚拟无人机一个UDP socket（源端口不同，桥接按来源地址区分无人机），
+ *       每个数据报包含姿态、GPS、电池三帧（与固件每次采样相同），可选带序号和CRC校验。
+ *       无人机分给若干发送线程，一次突发的多个数据报用 sendmmsg 一次系统调用发出。
+ *       sendmmsg 只能批量发同一个 socket 的数据报，而每架无人机必须有自己的源端口，
+ *       所以不同无人机的数据报无法合并：默认 --burst=1 时每个数据报就是一次系统调用，
+ *       单个发送线程的上限大致是每秒几十万个数据报，更高的负载用 --threads 或 --burst 分摊。
+ *       发送时刻按 起始相位 + k*周期 + 抖动 排定，抖动只作用于单次发送，不会累积成漂移。
+ *       启动后先每架发一个数据报供桥接注册（桥接初始化窗口5秒），等待 --register-wait 秒后开始压测。
+ *       每秒打印目标速率、实际发出速率、模拟丢弃数和发送失败数（ENOBUFS/EAGAIN 说明发送端已饱和）；
+ *       逐步调高 --drones 或 --rate，对照桥接的内核丢包和序号丢失统计即可找到桥接的饱和点。
+ *
+ * 用法：swarm_load_generator [选项]
+ *   --target=IP          桥接地址（默认 127.0.0.1）
+ *   --port=N             桥接端口（默认 9600）
+ *   --drones=N           虚拟无人机数（默认 100，最多 10000）
+ *   --rate=HZ            每架无人机的发送频率（默认 50）
+ *   --duration=S         压测时长，秒（默认 10）
+ *   --jitter=F           发送间隔抖动，占周期的比例（默认 0.1）
+ *   --loss=F             模拟丢包率，丢弃的数据报照样占用序号（默认 0）
+ *   --burst=N            每次突发连发 N 个数据报，间隔相应拉长 N 倍，平均速率不变（默认 1）
+ *   --sync               所有无人机同一时刻发送（默认各自随机相位）
+ *   --seq / --no-seq     是否带帧序号（默认带）
+ *   --check=sum|crc16|crc32c  校验方式（默认 sum）
+ *   --threads=N          发送线程数（默认 1）
+ *   --register-wait=S    注册后等待的秒数（默认 6，桥接已在运行时可设为0）
+ */
+
+#include "../src/Crc/Crc.h"
+#include "../src/FrameScanner/FrameScanner.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <random>
+#include <string>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+static const int MAX_DRONES = 10000;
+// 一次突发最多的数据报数（sendmmsg 一次调用）
+static const int MAX_BURST = 64;
+// 一个数据报的最大长度：三帧各自最多 包头2+状态1+长度1+序号2+参数12+校验4+包尾1
+static const size_t MAX_DATAGRAM = 3 * 23;
+
+struct Options {
+    std::string target = "127.0.0.1";
+    int port = 9600;
+    int drones = 100;
+    double rate = 50;
+    double duration = 10;
+    double jitter = 0.1;
+    double loss = 0;
+    int burst = 1;
+    bool sync = false;
+    bool seq = true;
+    uint8_t check = FRAME_CHECK_SUM;
+    int threads = 1;
+    double register_wait = 6;
+};
+
+// 一架虚拟无人机
+struct VirtualDrone {
+    int fd = -1;
+    uint16_t seq = 0;
+    // 发送相位：第 k 次突发的名义时刻为 base_ns + k*周期（CLOCK_MONOTONIC纳秒）
+    uint64_t base_ns = 0;
+    uint64_t period_index = 0;
+    // 下次发送时刻 = 名义时刻 + 本次抖动
+    uint64_t next_ns = 0;
+    // 模拟的飞行状态（角度：度，位置：米），每次采样随机游走
+    float roll = 0;
+    float pitch = 0;
+    float yaw = 0;
+    float x = 0;
+    float y = 0;
+    float z = 0;
+    uint8_t batt = 100;
+};
+
+// 发送统计（各线程累加）
+struct LoadCounters {
+    std::atomic<uint64_t> attempted{0};
+    std::atomic<uint64_t> sent{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> simulated_loss{0};
+    std::atomic<uint64_t> send_errors{0};
+};
+
+static std::atomic<bool> running(true);
+
+static uint64_t monotonic_ns()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+static void sleep_until(uint64_t deadline_ns)
+{
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(deadline_ns / 1000000000ULL);
+    ts.tv_nsec = static_cast<long>(deadline_ns % 1000000000ULL);
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr);
+}
+
+// ====================== 组帧 ======================
+static void put16(uint8_t* out, int16_t value)
+{
+    out[0] = static_cast<uint8_t>(static_cast<uint16_t>(value) >> 8);
+    out[1] = static_cast<uint8_t>(value);
+}
+
+static void put32(uint8_t* out, int32_t value)
+{
+    uint32_t bits = static_cast<uint32_t>(value);
+    out[0] = static_cast<uint8_t>(bits >> 24);
+    out[1] = static_cast<uint8_t>(bits >> 16);
+    out[2] = static_cast<uint8_t>(bits >> 8);
+    out[3] = static_cast<uint8_t>(bits);
+}
+
+/**
+ * @brief 在 out 处写一帧，返回写入的字节数
+ */
+static size_t write_frame(uint8_t* out, uint8_t type, const uint8_t* params, uint8_t length, const Options& options,
+                          uint16_t seq)
+{
+    uint8_t status = static_cast<uint8_t>(type | options.check | (options.seq ? FRAME_SEQ_FLAG : 0));
+    size_t n = 0;
+    out[n++] = FRAME_HEAD;
+    out[n++] = FRAME_HEAD;
+    out[n++] = status;
+    out[n++] = length;
+    if (options.seq) {
+        out[n++] = static_cast<uint8_t>(seq >> 8);
+        out[n++] = static_cast<uint8_t>(seq);
+    }
+    memcpy(out + n, params, length);
+    n += length;
+    // 校验范围：状态位到最后一个参数
+    const uint8_t* checked = out + 2;
+    size_t checked_size = n - 2;
+    switch (options.check) {
+        case FRAME_CHECK_CRC16: {
+            uint16_t crc = crc16Ccitt(checked, checked_size);
+            out[n++] = static_cast<uint8_t>(crc >> 8);
+            out[n++] = static_cast<uint8_t>(crc);
+            break;
+        }
+        case FRAME_CHECK_CRC32C: {
+            uint32_t crc = crc32c(checked, checked_size);
+            out[n++] = static_cast<uint8_t>(crc >> 24);
+            out[n++] = static_cast<uint8_t>(crc >> 16);
+            out[n++] = static_cast<uint8_t>(crc >> 8);
+            out[n++] = static_cast<uint8_t>(crc);
+            break;
+        }
+        default: {
+            uint8_t sum = 0;
+            for (size_t i = 0; i < checked_size; i++) {
+                sum += checked[i];
+            }
+            out[n++] = sum;
+            break;
+        }
+    }
+    out[n++] = FRAME_TAIL;
+    return n;
+}
+
+/**
+ * @brief 采样一次飞行状态并组成一个数据报（姿态 + GPS + 电池），返回字节数
+ * @note 每帧序号加1，与固件相同
+ */
+static size_t build_datagram(uint8_t* out, VirtualDrone& drone, const Options& options, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> step(-1.0f, 1.0f);
+    drone.roll += step(rng);
+    drone.pitch += step(rng);
+    drone.yaw = std::fmod(drone.yaw + step(rng) + 360.0f, 360.0f);
+    drone.x += step(rng) * 0.05f;
+    drone.y += step(rng) * 0.05f;
+    drone.z += step(rng) * 0.02f;
+
+    uint8_t attitude[6];
+    put16(attitude, static_cast<int16_t>(drone.roll * 10));
+    put16(attitude + 2, static_cast<int16_t>(drone.pitch * 10));
+    put16(attitude + 4, static_cast<int16_t>(drone.yaw * 10));
+    // GPS帧为32位定点整数（厘米），与桥接的解析一致
+    uint8_t gps[12];
+    put32(gps, static_cast<int32_t>(drone.x * 100));
+    put32(gps + 4, static_cast<int32_t>(drone.y * 100));
+    put32(gps + 8, static_cast<int32_t>(drone.z * 100));
+
+    size_t n = 0;
+    n += write_frame(out + n, 0x00, attitude, sizeof(attitude), options, drone.seq++);
+    n += write_frame(out + n, 0x01, gps, sizeof(gps), options, drone.seq++);
+    n += write_frame(out + n, 0x02, &drone.batt, 1, options, drone.seq++);
+    return n;
+}
+
+// ====================== 发送线程 ======================
+static void send_loop(std::vector<VirtualDrone>& drones, int first, int step, const Options& options,
+                      const sockaddr_in& target, uint64_t start_ns, uint64_t end_ns, LoadCounters& counters)
+{
+    std::mt19937 rng(static_cast<unsigned>(first * 7919 + 1));
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    uint64_t period_ns = static_cast<uint64_t>(1e9 / options.rate) * options.burst;
+
+    // 第 k 次突发的发送时刻：名义时刻加独立的抖动，抖动不累积到之后的发送
+    auto schedule = [&](VirtualDrone& drone) {
+        double offset = options.jitter > 0 ? (unit(rng) * 2 - 1) * options.jitter * period_ns : 0;
+        int64_t nominal = static_cast<int64_t>(drone.base_ns + drone.period_index * period_ns);
+        drone.next_ns = static_cast<uint64_t>(std::max<int64_t>(nominal + static_cast<int64_t>(offset),
+                                                                 static_cast<int64_t>(start_ns)));
+    };
+
+    // 发送相位：同步模式全部从 start_ns 开始，否则在一个周期内均匀分散
+    for (int i = first; i < static_cast<int>(drones.size()); i += step) {
+        drones[i].base_ns = start_ns + (options.sync ? 0 : static_cast<uint64_t>(unit(rng) * period_ns));
+        drones[i].period_index = 0;
+        schedule(drones[i]);
+    }
+
+    static thread_local uint8_t payload[MAX_BURST][MAX_DATAGRAM];
+    mmsghdr messages[MAX_BURST];
+    iovec vectors[MAX_BURST];
+    while (running.load(std::memory_order_relaxed)) {
+        uint64_t now = monotonic_ns();
+        if (now >= end_ns) {
+            break;
+        }
+        uint64_t earliest = end_ns;
+        for (int i = first; i < static_cast<int>(drones.size()); i += step) {
+            VirtualDrone& drone = drones[i];
+            if (drone.next_ns > now) {
+                earliest = drone.next_ns < earliest ? drone.next_ns : earliest;
+                continue;
+            }
+            // 一次突发：组好全部数据报，模拟丢弃的不放进批次（序号照样递增）
+            int count = 0;
+            for (int b = 0; b < options.burst; b++) {
+                size_t size = build_datagram(payload[count], drone, options, rng);
+                counters.attempted.fetch_add(1, std::memory_order_relaxed);
+                if (options.loss > 0 && unit(rng) < options.loss) {
+                    counters.simulated_loss.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+                vectors[count].iov_base = payload[count];
+                vectors[count].iov_len = size;
+                memset(&messages[count], 0, sizeof(mmsghdr));
+                messages[count].msg_hdr.msg_name = const_cast<sockaddr_in*>(&target);
+                messages[count].msg_hdr.msg_namelen = sizeof(target);
+                messages[count].msg_hdr.msg_iov = &vectors[count];
+                messages[count].msg_hdr.msg_iovlen = 1;
+                count++;
+            }
+            int done = 0;
+            while (done < count) {
+                int result = sendmmsg(drone.fd, messages + done, count - done, 0);
+                if (result <= 0) {
+                    // 发送缓冲区满或内核队列满：计入失败，不重试（重试会拖慢其他无人机）
+                    counters.send_errors.fetch_add(count - done, std::memory_order_relaxed);
+                    break;
+                }
+                for (int k = done; k < done + result; k++) {
+                    counters.bytes.fetch_add(messages[k].msg_len, std::memory_order_relaxed);
+                }
+                counters.sent.fetch_add(result, std::memory_order_relaxed);
+                done += result;
+            }
+
+            // 下一次突发：排在下一个名义时刻
+            drone.period_index++;
+            if (drone.base_ns + drone.period_index * period_ns + period_ns < now) {
+                // 落后超过一个周期（发送线程饱和）：不补发，跳到当前时刻之后的名义时刻，相位不变
+                drone.period_index = (now - drone.base_ns) / period_ns + 1;
+            }
+            schedule(drone);
+            earliest = drone.next_ns < earliest ? drone.next_ns : earliest;
+        }
+        if (earliest > monotonic_ns()) {
+            sleep_until(earliest);
+        }
+    }
+}
+
+// ====================== 参数与启动 ======================
+static bool parse_options(int argc, char** argv, Options& options)
+{
+    static const option long_options[] = {
+        {"target", required_argument, nullptr, 't'},
+        {"port", required_argument, nullptr, 'p'},
+        {"drones", required_argument, nullptr, 'n'},
+        {"rate", required_argument, nullptr, 'r'},
+        {"duration", required_argument, nullptr, 'd'},
+        {"jitter", required_argument, nullptr, 'j'},
+        {"loss", required_argument, nullptr, 'l'},
+        {"burst", required_argument, nullptr, 'b'},
+        {"sync", no_argument, nullptr, 's'},
+        {"seq", no_argument, nullptr, 'q'},
+        {"no-seq", no_argument, nullptr, 'Q'},
+        {"check", required_argument, nullptr, 'c'},
+        {"threads", required_argument, nullptr, 'T'},
+        {"register-wait", required_argument, nullptr, 'w'},
+        {nullptr, 0, nullptr, 0},
+    };
+    int c;
+    while ((c = getopt_long(argc, argv, "", long_options, nullptr)) != -1) {
+        switch (c) {
+            case 't': options.target = optarg; break;
+            case 'p': options.port = atoi(optarg); break;
+            case 'n': options.drones = atoi(optarg); break;
+            case 'r': options.rate = atof(optarg); break;
+            case 'd': options.duration = atof(optarg); break;
+            case 'j': options.jitter = atof(optarg); break;
+            case 'l': options.loss = atof(optarg); break;
+            case 'b': options.burst = atoi(optarg); break;
+            case 's': options.sync = true; break;
+            case 'q': options.seq = true; break;
+            case 'Q': options.seq = false; break;
+            case 'c':
+                if (strcmp(optarg, "sum") == 0) {
+                    options.check = FRAME_CHECK_SUM;
+                } else if (strcmp(optarg, "crc16") == 0) {
+                    options.check = FRAME_CHECK_CRC16;
+                } else if (strcmp(optarg, "crc32c") == 0) {
+                    options.check = FRAME_CHECK_CRC32C;
+                } else {
+                    fprintf(stderr, "未知校验方式: %s\n", optarg);
+                    return false;
+                }
+                break;
+            case 'T': options.threads = atoi(optarg); break;
+            case 'w': options.register_wait = atof(optarg); break;
+            default: return false;
+        }
+    }
+    if (options.drones < 1 || options.drones > MAX_DRONES || options.rate <= 0 || options.burst < 1 ||
+        options.burst > MAX_BURST || options.threads < 1 || options.loss < 0 || options.loss >= 1 ||
+        options.jitter < 0 || options.jitter >= 1) {
+        fprintf(stderr, "参数超出范围：drones 1~%d，rate>0，burst 1~%d，threads>=1，loss/jitter 在[0,1)内\n",
+                MAX_DRONES, MAX_BURST);
+        return false;
+    }
+    return true;
+}
+
+// 每架无人机一个socket，数量多时需要调高文件描述符上限
+static bool raise_fd_limit(int needed)
+{
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+        return false;
+    }
+    if (limit.rlim_cur >= static_cast<rlim_t>(needed)) {
+        return true;
+    }
+    limit.rlim_cur = limit.rlim_max < static_cast<rlim_t>(needed) ? limit.rlim_max : needed;
+    return setrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur >= static_cast<rlim_t>(needed);
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        return 2;
+    }
+    if (!raise_fd_limit(options.drones + 64)) {
+        fprintf(stderr, "文件描述符上限不足 %d（ulimit -n），无法打开每架无人机的socket\n", options.drones + 64);
+        return 1;
+    }
+
+    sockaddr_in target;
+    memset(&target, 0, sizeof(target));
+    target.sin_family = AF_INET;
+    target.sin_port = htons(static_cast<uint16_t>(options.port));
+    if (inet_pton(AF_INET, options.target.c_str(), &target.sin_addr) != 1) {
+        fprintf(stderr, "无效地址: %s\n", options.target.c_str());
+        return 2;
+    }
+
+    std::vector<VirtualDrone> drones(options.drones);
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> spread(-50.0f, 50.0f);
+    for (VirtualDrone& drone : drones) {
+        drone.fd = socket(AF_INET, SOCK_DGRAM, 0);
+        if (drone.fd < 0) {
+            perror("socket");
+            return 1;
+        }
+        // 绑定随机源端口后，桥接按来源地址把每个socket当成一架无人机
+        sockaddr_in local;
+        memset(&local, 0, sizeof(local));
+        local.sin_family = AF_INET;
+        bind(drone.fd, reinterpret_cast<sockaddr*>(&local), sizeof(local));
+        drone.x = spread(rng);
+        drone.y = spread(rng);
+        drone.z = 10;
+        drone.yaw = spread(rng) + 50;
+        drone.batt = static_cast<uint8_t>(80 + rng() % 20);
+    }
+
+    // 注册：每架发一个数据报，桥接在初始化窗口内记录来源地址
+    uint8_t hello[MAX_DATAGRAM];
+    for (VirtualDrone& drone : drones) {
+        size_t size = build_datagram(hello, drone, options, rng);
+        sendto(drone.fd, hello, size, 0, reinterpret_cast<const sockaddr*>(&target), sizeof(target));
+    }
+    fprintf(stderr, "%d 架虚拟无人机已发送注册数据报，等待 %.1f 秒\n", options.drones, options.register_wait);
+    sleep_until(monotonic_ns() + static_cast<uint64_t>(options.register_wait * 1e9));
+
+    double target_rate = options.drones * options.rate;
+    fprintf(stderr, "开始压测：目标 %.0f 数据报/秒（%d 架 x %.1f Hz，突发 %d，抖动 %.0f%%，丢包 %.1f%%），%d 个发送线程\n",
+            target_rate, options.drones, options.rate, options.burst, options.jitter * 100, options.loss * 100,
+            options.threads);
+
+    LoadCounters counters;
+    uint64_t start_ns = monotonic_ns();
+    uint64_t end_ns = start_ns + static_cast<uint64_t>(options.duration * 1e9);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < options.threads; t++) {
+        threads.emplace_back(send_loop, std::ref(drones), t, options.threads, std::cref(options), std::cref(target),
+                             start_ns, end_ns, std::ref(counters));
+    }
+
+    // 每秒报告一次
+    uint64_t last_sent = 0;
+    uint64_t last_bytes = 0;
+    uint64_t next_report = start_ns + 1000000000ULL;
+    while (next_report <= end_ns) {
+        sleep_until(next_report);
+        uint64_t sent = counters.sent.load();
+        uint64_t bytes = counters.bytes.load();
+        fprintf(stderr, "[%3.0fs] 发出 %8lu 数据报/秒 %7.2f Mbit/s（目标 %.0f），模拟丢弃 %lu，发送失败 %lu\n",
+                (next_report - start_ns) / 1e9, static_cast<unsigned long>(sent - last_sent),
+                (bytes - last_bytes) * 8 / 1e6, target_rate, static_cast<unsigned long>(counters.simulated_loss.load()),
+                static_cast<unsigned long>(counters.send_errors.load()));
+        last_sent = sent;
+        last_bytes = bytes;
+        next_report += 1000000000ULL;
+    }
+    running.store(false);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    double seconds = (monotonic_ns() - start_ns) / 1e9;
+    uint64_t sent = counters.sent.load();
+    double achieved = sent / seconds;
+    fprintf(stderr, "合计：尝试 %lu，发出 %lu（%.0f 数据报/秒，目标的 %.1f%%），模拟丢弃 %lu，发送失败 %lu\n",
+            static_cast<unsigned long>(counters.attempted.load()), static_cast<unsigned long>(sent), achieved,
+            achieved / target_rate * 100, static_cast<unsigned long>(counters.simulated_loss.load()),
+            static_cast<unsigned long>(counters.send_errors.load()));
+    for (VirtualDrone& drone : drones) {
+        close(drone.fd);
+    }
+    return 0;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file swarm_shm_monitor.cpp
+ * @brief 集群状态共享内存读者示例：等待桥接发布新快照，每秒打印一次快照速率、读取延迟和各无人机状态
+ * @note 规划、GUI等节点读取共享内存的写法与此相同：open 后循环 wait/read，写者关闭（桥接重启）时重新 open。
+ *
+ * 用法：swarm_shm_monitor [--name=/hive_swarm_state] [--drones=N]
+ *   --name=NAME    共享内存名（默认与桥接 ~shm_name 相同）
+ *   --drones=N     每秒打印前 N 架无人机的状态（默认10，0表示只打印速率）
+ */
+
+#include "udp_ros_bridge/SwarmShm.h"
+#include <cstdio>
+#include <cstdlib>
+#include <getopt.h>
+#include <string>
+#include <time.h>
+#include <unistd.h>
+
+static uint64_t realtime_ns()
+{
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+int main(int argc, char** argv)
+{
+    std::string name = SWARM_SHM_DEFAULT_NAME;
+    int shown = 10;
+    static const option long_options[] = {
+        {"name", required_argument, nullptr, 'n'},
+        {"drones", required_argument, nullptr, 'd'},
+        {nullptr, 0, nullptr, 0},
+    };
+    int c;
+    while ((c = getopt_long(argc, argv, "", long_options, nullptr)) != -1) {
+        switch (c) {
+            case 'n': name = optarg; break;
+            case 'd': shown = atoi(optarg); break;
+            default: fprintf(stderr, "用法：swarm_shm_monitor [--name=NAME] [--drones=N]\n"); return 2;
+        }
+    }
+
+    SwarmShmReader reader;
+    SwarmShmState state;
+    uint64_t window_start = realtime_ns();
+    uint64_t snapshots = 0;
+    uint64_t latency_sum_ns = 0;
+    while (true) {
+        if (!reader.isOpen() || reader.isWriterClosed()) {
+            // 桥接未启动或已重启：每秒重试
+            if (!reader.open(name)) {
+                fprintf(stderr, "等待共享内存 %s ...\n", name.c_str());
+                sleep(1);
+                continue;
+            }
+            fprintf(stderr, "已打开 %s：%u 架\n", name.c_str(), reader.getSlotCount());
+            state.version = 0;
+        }
+        if (reader.wait(state.version, 1000) && reader.read(state)) {
+            snapshots++;
+            latency_sum_ns += realtime_ns() - state.publish_ns;
+        }
+        uint64_t now = realtime_ns();
+        if (now - window_start < 1000000000ULL) {
+            continue;
+        }
+        printf("版本 %lu：%lu 个快照/秒，发布->读完平均 %.1f us，%zu 架\n", static_cast<unsigned long>(state.version),
+               static_cast<unsigned long>(snapshots), snapshots > 0 ? latency_sum_ns / 1000.0 / snapshots : 0.0,
+               state.drones.size());
+        for (size_t i = 0; i < state.drones.size() && static_cast<int>(i) < shown; i++) {
+            const SwarmShmDrone& drone = state.drones[i];
+            if (drone.updated_ns == 0) {
+                continue;
+            }
+            printf("  槽位 %u id %u：x=%.0f y=%.0f z=%.0f roll=%d pitch=%d yaw=%d 电量 %u%%，%.0f ms 前更新\n",
+                   drone.slot, drone.id, drone.x, drone.y, drone.z, drone.roll, drone.pitch, drone.yaw, drone.batt,
+                   (now - drone.updated_ns) / 1e6);
+        }
+        fflush(stdout);
+        window_start = now;
+        snapshots = 0;
+        latency_sum_ns = 0;
+    }
+}
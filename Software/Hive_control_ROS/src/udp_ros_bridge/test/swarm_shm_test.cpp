@@ -0,0 +1,244 @@
+/**
+ * @file swarm_shm_test.cpp
+ * @brief 集群状态共享内存测试：写者全速发布时另一进程读到的快照没有撕裂、版本号不回退；
+ *        写者按1kHz发布时读者 wait() 的唤醒延迟；读取1000架的开销；写者重建后旧读者收到关闭标志
+ * @note 每个快照的内容由版本号确定（每架无人机的 updated_ns 等于版本号，x/z 由版本号和槽位算出），
+ *       读者逐架核对，混入不同版本的数据即为撕裂。读者在 fork 出的子进程中运行，结果由退出码返回
+ */
+
+#include "udp_ros_bridge/SwarmShm.h"
+#include "udp_ros_bridge/Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+static const uint32_t DRONES = 1000;
+
+static uint64_t realtime_ns()
+{
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+static void fill(SwarmShmDrone* drones, uint64_t version)
+{
+    for (uint32_t slot = 0; slot < DRONES; slot++) {
+        SwarmShmDrone& drone = drones[slot];
+        drone.updated_ns = version;
+        drone.x = static_cast<float>(version % 100000);
+        drone.y = static_cast<float>(slot);
+        drone.z = static_cast<float>((version + slot) % 100000);
+        drone.roll = static_cast<int16_t>(version % 900);
+        drone.pitch = 0;
+        drone.yaw = 0;
+        drone.slot = static_cast<uint16_t>(slot);
+        drone.id = static_cast<uint8_t>(slot % 250 + 1);
+        drone.batt = static_cast<uint8_t>(version % 101);
+    }
+}
+
+static bool consistent(const SwarmShmState& state)
+{
+    if (state.drones.size() != DRONES) {
+        return false;
+    }
+    for (uint32_t slot = 0; slot < DRONES; slot++) {
+        const SwarmShmDrone& drone = state.drones[slot];
+        if (drone.updated_ns != state.version || drone.x != static_cast<float>(state.version % 100000) ||
+            drone.z != static_cast<float>((state.version + slot) % 100000) || drone.slot != slot ||
+            drone.batt != state.version % 101) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 在子进程中运行 body，返回值作为退出码（0为通过）
+template <typename Body>
+static pid_t spawn(Body body)
+{
+    fflush(stderr);
+    pid_t pid = fork();
+    if (pid == 0) {
+        _exit(body() ? 0 : 1);
+    }
+    return pid;
+}
+
+static bool join(pid_t pid)
+{
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// ====================== 全速发布下的一致性 ======================
+static bool check_consistency(const std::string& name)
+{
+    SwarmShmWriter writer;
+    if (!writer.create(name, DRONES)) {
+        return false;
+    }
+    auto reader_body = [&name]() {
+        SwarmShmReader reader;
+        if (!reader.open(name)) {
+            return false;
+        }
+        SwarmShmState state;
+        uint64_t reads = 0;
+        uint64_t torn = 0;
+        uint64_t failed = 0;
+        uint64_t regressed = 0;
+        uint64_t last = 0;
+        while (!reader.isWriterClosed()) {
+            if (!reader.read(state)) {
+                failed += reader.getLatestVersion() != 0 ? 1 : 0;
+                continue;
+            }
+            reads++;
+            torn += consistent(state) ? 0 : 1;
+            regressed += state.version < last ? 1 : 0;
+            last = state.version;
+        }
+        fprintf(stderr, "  读者进程 %d：读到 %lu 个快照，撕裂 %lu，版本回退 %lu，%d 次都被覆盖 %lu\n", getpid(),
+                static_cast<unsigned long>(reads), static_cast<unsigned long>(torn),
+                static_cast<unsigned long>(regressed), SwarmShmReader::READ_ATTEMPTS,
+                static_cast<unsigned long>(failed));
+        return reads > 0 && torn == 0 && regressed == 0;
+    };
+    pid_t a = spawn(reader_body);
+    pid_t b = spawn(reader_body);
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t published = 0;
+    while (std::chrono::steady_clock::now() - start < std::chrono::seconds(2)) {
+        SwarmShmDrone* drones = writer.begin();
+        fill(drones, writer.getVersion() + 1);
+        writer.commit(DRONES, realtime_ns());
+        published++;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    writer.close();
+    bool ok = join(a);
+    ok = join(b) && ok;
+    fprintf(stderr, "全速发布 %u 架：%lu 个快照，%.0f 个/秒（%.2f us/个） %s\n", DRONES,
+            static_cast<unsigned long>(published), published / seconds, seconds * 1e6 / published,
+            ok ? "" : "错误");
+    return ok;
+}
+
+// ====================== 通知延迟 ======================
+static bool check_notify(const std::string& name)
+{
+    const int PUBLISHES = 2000;
+    SwarmShmWriter writer;
+    if (!writer.create(name, DRONES)) {
+        return false;
+    }
+    pid_t child = spawn([&name]() {
+        SwarmShmReader reader;
+        if (!reader.open(name)) {
+            return false;
+        }
+        SwarmShmState state;
+        std::vector<int64_t> latency;
+        uint64_t last = 0;
+        bool ordered = true;
+        while (reader.wait(state.version, 2000)) {
+            if (!reader.read(state)) {
+                continue;
+            }
+            latency.push_back(static_cast<int64_t>(realtime_ns() - state.publish_ns));
+            ordered = ordered && state.version > last && consistent(state);
+            last = state.version;
+        }
+        if (latency.empty()) {
+            fprintf(stderr, "  读者没有被唤醒\n");
+            return false;
+        }
+        std::sort(latency.begin(), latency.end());
+        fprintf(stderr, "  读者被唤醒 %zu 次（写者发布 %d 次），发布->读完 p50=%.1fus p99=%.1fus max=%.1fus\n",
+                latency.size(), PUBLISHES, latency[latency.size() / 2] / 1000.0,
+                latency[latency.size() * 99 / 100] / 1000.0, latency.back() / 1000.0);
+        // 读者可能合并相邻的发布，但必须看到最后一个
+        return ordered && last == PUBLISHES && reader.isWriterClosed();
+    });
+
+    // 等读者进入等待后再开始
+    usleep(200000);
+    timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    for (int i = 0; i < PUBLISHES; i++) {
+        next.tv_nsec += 1000000;
+        if (next.tv_nsec >= 1000000000L) {
+            next.tv_sec++;
+            next.tv_nsec -= 1000000000L;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr);
+        SwarmShmDrone* drones = writer.begin();
+        fill(drones, writer.getVersion() + 1);
+        writer.commit(DRONES, realtime_ns());
+    }
+    usleep(50000);
+    writer.close();
+    bool ok = join(child);
+    fprintf(stderr, "1kHz 发布的通知 %s\n", ok ? "正确" : "错误");
+    return ok;
+}
+
+// ====================== 读取开销、超时、重建 ======================
+static bool check_reader(const std::string& name)
+{
+    SwarmShmWriter writer;
+    SwarmShmReader reader;
+    SwarmShmState state;
+    bool ok = !reader.open(name);
+    ok = writer.create(name, DRONES) && ok;
+    ok = reader.open(name) && ok;
+    // 还没有快照：读取失败，等待超时
+    ok = ok && !reader.read(state) && reader.getLatestVersion() == 0;
+    auto start = std::chrono::steady_clock::now();
+    ok = ok && !reader.wait(0, 50);
+    double waited_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    ok = ok && waited_ms >= 45;
+
+    fill(writer.begin(), 1);
+    writer.commit(DRONES, realtime_ns());
+    ok = ok && reader.wait(0, 0) && reader.read(state) && state.version == 1 && consistent(state);
+
+    const int READS = 20000;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < READS; i++) {
+        ok = reader.read(state) && ok;
+    }
+    double read_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / READS;
+
+    // 写者重建：旧映射收到关闭标志，重新打开后是新的区域
+    SwarmShmWriter restarted;
+    ok = restarted.create(name, 10) && ok;
+    ok = ok && reader.isWriterClosed() && !reader.wait(1, 100);
+    ok = ok && reader.open(name) && !reader.isWriterClosed() && reader.getSlotCount() == 10 &&
+         reader.getLatestVersion() == 0;
+    restarted.close();
+    ok = ok && !reader.open(name);
+    fprintf(stderr, "读取 %u 架一个快照 %.2f us（%.1f KB）；超时、重建后重新打开 %s\n", DRONES, read_us,
+            DRONES * sizeof(SwarmShmDrone) / 1024.0, ok ? "正确" : "错误");
+    return ok;
+}
+
+int main()
+{
+    Logger::setLevel(LogLevel::ERROR);
+    std::string name = "/hive_swarm_shm_test_" + std::to_string(getpid());
+    bool passed = check_reader(name);
+    passed = check_consistency(name) && passed;
+    passed = check_notify(name) && passed;
+    fprintf(stderr, "%s\n", passed ? "PASS" : "FAIL");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,355 @@
+/**
+ * @file telemetry_query.cpp
+ * @brief 飞行记录查询：对 ~record_path 录下的列式遥测记录按时间范围、无人机和列条件做多线程扫描
+ * @note 时间以记录开始为0点，单位秒。条件可重复给出，同时满足；条件涉及的列先解码过滤，
+ *       块统计区判断不可能满足的块不读取。扫描统计和耗时打印到 stderr，结果打印到 stdout。
+ *
+ * 用法：telemetry_query --file=PATH [选项] 命令
+ *   命令：
+ *     count     每架无人机满足条件的行数、首次和最后出现时间、最低电量（如“哪些无人机电量低于20%”）
+ *     rows      满足条件的行，按时间排序输出CSV
+ *     stats     满足条件的行中各列的最小值、最大值、平均值
+ *     closest   任意两架无人机的最近距离及发生时间
+ *   选项：
+ *     --from=S          起始时间（秒，默认记录开始）
+ *     --to=S            结束时间（秒，默认记录结束）
+ *     --drones=A,B,...  槽位列表（默认全部）
+ *     --where=COND      条件，如 batt<20、z>=100、id!=3，可重复
+ *     --threads=N       扫描线程数（默认CPU核数）
+ *     --bin-ms=N        closest 的分格宽度（毫秒，默认20，即50Hz上报周期）
+ *     --limit=N         rows 最多输出的行数（默认1000，0表示不限）
+ */
+
+#include "../src/TelemetryQuery/TelemetryQuery.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Options {
+    std::string file;
+    std::string command;
+    double from = -1;
+    double to = -1;
+    std::vector<uint16_t> drones;
+    std::vector<ColumnPredicate> predicates;
+    int threads = static_cast<int>(std::thread::hardware_concurrency());
+    int bin_ms = 20;
+    size_t limit = 1000;
+};
+
+static void usage()
+{
+    fprintf(stderr, "用法：telemetry_query --file=PATH [--from=S] [--to=S] [--drones=A,B,...] [--where=COND]... "
+                    "[--threads=N] [--bin-ms=N] [--limit=N] count|rows|stats|closest\n");
+}
+
+static bool parse_drones(const char* text, std::vector<uint16_t>& out)
+{
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        char* end = nullptr;
+        long slot = strtol(item.c_str(), &end, 10);
+        if (end == item.c_str() || *end != '\0' || slot < 0 || slot > 65535) {
+            return false;
+        }
+        out.push_back(static_cast<uint16_t>(slot));
+    }
+    return !out.empty();
+}
+
+static bool parse_options(int argc, char** argv, Options& options)
+{
+    static const option long_options[] = {
+        {"file", required_argument, nullptr, 'f'},
+        {"from", required_argument, nullptr, 'a'},
+        {"to", required_argument, nullptr, 'b'},
+        {"drones", required_argument, nullptr, 'd'},
+        {"where", required_argument, nullptr, 'w'},
+        {"threads", required_argument, nullptr, 't'},
+        {"bin-ms", required_argument, nullptr, 'm'},
+        {"limit", required_argument, nullptr, 'l'},
+        {nullptr, 0, nullptr, 0},
+    };
+    int c;
+    while ((c = getopt_long(argc, argv, "", long_options, nullptr)) != -1) {
+        switch (c) {
+            case 'f': options.file = optarg; break;
+            case 'a': options.from = atof(optarg); break;
+            case 'b': options.to = atof(optarg); break;
+            case 'd':
+                if (!parse_drones(optarg, options.drones)) {
+                    fprintf(stderr, "无效的槽位列表: %s\n", optarg);
+                    return false;
+                }
+                break;
+            case 'w': {
+                ColumnPredicate predicate;
+                if (!parsePredicate(optarg, predicate)) {
+                    fprintf(stderr, "无效的条件: %s（列为 slot roll pitch yaw x y z id batt，运算符为 < <= > >= == !=）\n",
+                            optarg);
+                    return false;
+                }
+                options.predicates.push_back(predicate);
+                break;
+            }
+            case 't': options.threads = atoi(optarg); break;
+            case 'm': options.bin_ms = atoi(optarg); break;
+            case 'l': options.limit = static_cast<size_t>(atol(optarg)); break;
+            default: usage(); return false;
+        }
+    }
+    if (optind < argc) {
+        options.command = argv[optind];
+    }
+    if (options.file.empty() || options.bin_ms < 1 ||
+        (options.command != "count" && options.command != "rows" && options.command != "stats" &&
+         options.command != "closest")) {
+        usage();
+        return false;
+    }
+    options.threads = options.threads < 1 ? 1 : options.threads;
+    return true;
+}
+
+// 记录开始为0点的秒数
+static double relative_seconds(uint64_t time_ns, uint64_t origin_ns)
+{
+    return (static_cast<double>(time_ns) - static_cast<double>(origin_ns)) / 1e9;
+}
+
+static void print_stats(const TelemetryScanStats& stats, double seconds)
+{
+    fprintf(stderr, "扫描 %lu 块（统计区跳过 %lu，过滤后为空 %lu），过滤 %lu 行，命中 %lu 行，用时 %.3f 秒（%.0f 万行/秒）\n",
+            static_cast<unsigned long>(stats.chunks), static_cast<unsigned long>(stats.chunks_pruned),
+            static_cast<unsigned long>(stats.chunks_filtered), static_cast<unsigned long>(stats.rows_scanned),
+            static_cast<unsigned long>(stats.rows_matched), seconds,
+            seconds > 0 ? stats.rows_scanned / seconds / 1e4 : 0.0);
+}
+
+struct DroneSummary {
+    uint64_t rows = 0;
+    uint64_t first_ns = UINT64_MAX;
+    uint64_t last_ns = 0;
+    uint8_t id = 0;
+    uint8_t min_batt = 255;
+};
+
+static TelemetryScanStats run_count(const TelemetryQuery& query, TelemetryScan scan, const Options& options,
+                                    uint64_t origin_ns)
+{
+    scan.columns = (1u << TELEMETRY_TIME) | (1u << TELEMETRY_SLOT) | (1u << TELEMETRY_ID) | (1u << TELEMETRY_BATT);
+    // 每个线程一张按槽位索引的表，扫描结束后合并
+    std::vector<std::vector<DroneSummary>> tables(options.threads, std::vector<DroneSummary>(65536));
+    TelemetryScanStats stats = query.scan(
+        scan, options.threads, [&](int worker, const TelemetryColumns& columns, const uint32_t* rows, size_t count) {
+            std::vector<DroneSummary>& table = tables[worker];
+            for (size_t k = 0; k < count; k++) {
+                uint32_t i = rows[k];
+                DroneSummary& drone = table[columns.slot[i]];
+                drone.rows++;
+                drone.first_ns = std::min(drone.first_ns, columns.time[i]);
+                drone.last_ns = std::max(drone.last_ns, columns.time[i]);
+                drone.id = columns.id[i];
+                drone.min_batt = std::min(drone.min_batt, columns.batt[i]);
+            }
+        });
+    printf("slot,id,rows,first_s,last_s,min_batt\n");
+    size_t drones = 0;
+    for (size_t slot = 0; slot < 65536; slot++) {
+        DroneSummary total;
+        for (const std::vector<DroneSummary>& table : tables) {
+            const DroneSummary& drone = table[slot];
+            total.rows += drone.rows;
+            total.first_ns = std::min(total.first_ns, drone.first_ns);
+            total.last_ns = std::max(total.last_ns, drone.last_ns);
+            total.id = drone.rows > 0 ? drone.id : total.id;
+            total.min_batt = std::min(total.min_batt, drone.min_batt);
+        }
+        if (total.rows == 0) {
+            continue;
+        }
+        drones++;
+        printf("%zu,%u,%lu,%.3f,%.3f,%u\n", slot, total.id, static_cast<unsigned long>(total.rows),
+               relative_seconds(total.first_ns, origin_ns), relative_seconds(total.last_ns, origin_ns), total.min_batt);
+    }
+    fprintf(stderr, "%zu 架无人机满足条件\n", drones);
+    return stats;
+}
+
+static TelemetryScanStats run_rows(const TelemetryQuery& query, const TelemetryScan& scan, const Options& options,
+                                   uint64_t origin_ns)
+{
+    std::vector<std::vector<TelemetryRow>> parts(options.threads);
+    TelemetryScanStats stats = query.scan(
+        scan, options.threads, [&](int worker, const TelemetryColumns& columns, const uint32_t* rows, size_t count) {
+            std::vector<TelemetryRow>& part = parts[worker];
+            for (size_t k = 0; k < count; k++) {
+                uint32_t i = rows[k];
+                TelemetryRow row;
+                row.time_ns = columns.time[i];
+                row.slot = columns.slot[i];
+                row.id = columns.id[i];
+                row.roll = columns.roll[i];
+                row.pitch = columns.pitch[i];
+                row.yaw = columns.yaw[i];
+                row.x = columns.x[i];
+                row.y = columns.y[i];
+                row.z = columns.z[i];
+                row.batt = columns.batt[i];
+                part.push_back(row);
+            }
+        });
+    std::vector<TelemetryRow> all;
+    for (std::vector<TelemetryRow>& part : parts) {
+        all.insert(all.end(), part.begin(), part.end());
+    }
+    std::sort(all.begin(), all.end(), [](const TelemetryRow& a, const TelemetryRow& b) {
+        return a.time_ns != b.time_ns ? a.time_ns < b.time_ns : a.slot < b.slot;
+    });
+    size_t shown = options.limit == 0 ? all.size() : std::min(all.size(), options.limit);
+    printf("time_s,slot,id,roll,pitch,yaw,x,y,z,batt\n");
+    for (size_t i = 0; i < shown; i++) {
+        const TelemetryRow& row = all[i];
+        printf("%.3f,%u,%u,%d,%d,%d,%g,%g,%g,%u\n", relative_seconds(row.time_ns, origin_ns), row.slot, row.id,
+               row.roll, row.pitch, row.yaw, row.x, row.y, row.z, row.batt);
+    }
+    if (shown < all.size()) {
+        fprintf(stderr, "共 %zu 行，只输出前 %zu 行（--limit）\n", all.size(), shown);
+    }
+    return stats;
+}
+
+struct ColumnSummary {
+    double min[TELEMETRY_COLUMN_COUNT];
+    double max[TELEMETRY_COLUMN_COUNT];
+    double sum[TELEMETRY_COLUMN_COUNT];
+    uint64_t rows = 0;
+
+    ColumnSummary()
+    {
+        std::fill(min, min + TELEMETRY_COLUMN_COUNT, std::numeric_limits<double>::infinity());
+        std::fill(max, max + TELEMETRY_COLUMN_COUNT, -std::numeric_limits<double>::infinity());
+        std::fill(sum, sum + TELEMETRY_COLUMN_COUNT, 0.0);
+    }
+};
+
+template <typename T>
+static void summarize(ColumnSummary& summary, int column, const T* values, const uint32_t* rows, size_t count)
+{
+    double min = summary.min[column];
+    double max = summary.max[column];
+    double sum = 0;
+    for (size_t k = 0; k < count; k++) {
+        double value = static_cast<double>(values[rows[k]]);
+        min = std::min(min, value);
+        max = std::max(max, value);
+        sum += value;
+    }
+    summary.min[column] = min;
+    summary.max[column] = max;
+    summary.sum[column] += sum;
+}
+
+static TelemetryScanStats run_stats(const TelemetryQuery& query, TelemetryScan scan, const Options& options)
+{
+    scan.columns = TELEMETRY_ALL_COLUMNS & ~(1u << TELEMETRY_TIME);
+    std::vector<ColumnSummary> parts(options.threads);
+    TelemetryScanStats stats = query.scan(
+        scan, options.threads, [&](int worker, const TelemetryColumns& columns, const uint32_t* rows, size_t count) {
+            ColumnSummary& summary = parts[worker];
+            summary.rows += count;
+            summarize(summary, TELEMETRY_SLOT, columns.slot, rows, count);
+            summarize(summary, TELEMETRY_ROLL, columns.roll, rows, count);
+            summarize(summary, TELEMETRY_PITCH, columns.pitch, rows, count);
+            summarize(summary, TELEMETRY_YAW, columns.yaw, rows, count);
+            summarize(summary, TELEMETRY_X, columns.x, rows, count);
+            summarize(summary, TELEMETRY_Y, columns.y, rows, count);
+            summarize(summary, TELEMETRY_Z, columns.z, rows, count);
+            summarize(summary, TELEMETRY_ID, columns.id, rows, count);
+            summarize(summary, TELEMETRY_BATT, columns.batt, rows, count);
+        });
+    ColumnSummary total;
+    for (const ColumnSummary& part : parts) {
+        total.rows += part.rows;
+        for (int c = TELEMETRY_SLOT; c < TELEMETRY_COLUMN_COUNT; c++) {
+            total.min[c] = std::min(total.min[c], part.min[c]);
+            total.max[c] = std::max(total.max[c], part.max[c]);
+            total.sum[c] += part.sum[c];
+        }
+    }
+    printf("column,min,max,mean\n");
+    if (total.rows > 0) {
+        for (int c = TELEMETRY_SLOT; c < TELEMETRY_COLUMN_COUNT; c++) {
+            printf("%s,%g,%g,%g\n", telemetryColumnName(c), total.min[c], total.max[c], total.sum[c] / total.rows);
+        }
+    }
+    return stats;
+}
+
+static TelemetryScanStats run_closest(const TelemetryQuery& query, const TelemetryScan& scan, const Options& options,
+                                      uint64_t origin_ns)
+{
+    TelemetryScanStats stats;
+    TelemetryApproach approach =
+        query.closestApproach(scan, static_cast<uint64_t>(options.bin_ms) * 1000000ULL, options.threads, &stats);
+    if (!approach.found) {
+        fprintf(stderr, "范围内没有同时出现的两架无人机\n");
+        return stats;
+    }
+    printf("time_s,slot_a,id_a,slot_b,id_b,distance\n");
+    printf("%.3f,%u,%u,%u,%u,%g\n", relative_seconds(approach.time_ns, origin_ns), approach.slot_a, approach.id_a,
+           approach.slot_b, approach.id_b, approach.distance);
+    return stats;
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        return 2;
+    }
+    TelemetryRecordReader reader;
+    if (!reader.open(options.file)) {
+        fprintf(stderr, "无法打开遥测记录文件或格式不符: %s\n", options.file.c_str());
+        return 1;
+    }
+    uint64_t origin_ns = reader.getBeginNs();
+    fprintf(stderr, "%lu 行，%zu 块，时长 %.3f 秒\n", static_cast<unsigned long>(reader.getRowCount()),
+            reader.getChunkCount(), relative_seconds(reader.getEndNs(), origin_ns));
+
+    TelemetryScan scan;
+    if (options.from >= 0) {
+        scan.begin_ns = origin_ns + static_cast<uint64_t>(options.from * 1e9);
+    }
+    if (options.to >= 0) {
+        scan.end_ns = origin_ns + static_cast<uint64_t>(options.to * 1e9);
+    }
+    scan.slots = options.drones;
+    scan.predicates = options.predicates;
+
+    TelemetryQuery query(reader);
+    auto start = std::chrono::steady_clock::now();
+    TelemetryScanStats stats;
+    if (options.command == "count") {
+        stats = run_count(query, scan, options, origin_ns);
+    } else if (options.command == "rows") {
+        stats = run_rows(query, scan, options, origin_ns);
+    } else if (options.command == "stats") {
+        stats = run_stats(query, scan, options);
+    } else {
+        stats = run_closest(query, scan, options, origin_ns);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    print_stats(stats, seconds);
+    return 0;
+}
@@ -0,0 +1,401 @@
+/**
+ * @file telemetry_query_test.cpp
+ * @brief 遥测记录查询测试：条件扫描和最近距离与逐行暴力计算核对，并检查统计区剪枝生效；
+ *        再录一段 1000 架无人机 50Hz 的长记录，给出典型飞行后查询的耗时
+ * @note 小记录 200 架无人机 120 秒，原样块和 Gorilla 压缩块各做一遍。电量随时间下降，
+ *       前半段没有低于 20% 的无人机，这些块应当按统计区跳过；槽位 7 和 8 在第 4005 次上报时
+ *       相距 50 厘米，是全程的最近一对。长记录默认 10 分钟（--minutes=N 调整，如 120 模拟两小时）。
+ *
+ * 用法：telemetry_query_test [--minutes=N] [--threads=N]
+ */
+
+#include "../src/TelemetryQuery/TelemetryQuery.h"
+#include "udp_ros_bridge/Logger.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <limits>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static const char* PATH = "/tmp/telemetry_query_test.tlm";
+
+static const int RATE_HZ = 50;
+static const uint64_t PERIOD_NS = 1000000000ULL / RATE_HZ;
+static const uint64_t START_NS = 1700000000ULL * 1000000000ULL;
+// 同一周期内各无人机的上报时间错开
+static const uint64_t STAGGER_NS = 10000;
+// 编队网格间距（厘米）和每架无人机绕网格点盘旋的半径
+static const int GRID_CM = 500;
+static const int RADIUS_CM = 100;
+static const int TABLE_SIZE = 3600;
+
+// 小记录
+static const int SMALL_DRONES = 200;
+static const int SMALL_TICKS = RATE_HZ * 120;
+// 注入的最近一对
+static const int CLOSE_A = 7;
+static const int CLOSE_B = 8;
+static const int CLOSE_TICK = 4005;
+static const float CLOSE_CM = 50;
+
+static float sin_table[TABLE_SIZE];
+static float cos_table[TABLE_SIZE];
+
+static uint64_t row_time(int slot, int tick)
+{
+    return START_NS + static_cast<uint64_t>(tick) * PERIOD_NS + static_cast<uint64_t>(slot) * STAGGER_NS;
+}
+
+/**
+ * @brief 槽位 slot 第 tick 次上报的状态：每架无人机绕自己的网格点盘旋（约20秒一圈，相位各不相同），
+ *        高度缓慢起伏，电量在记录时长 ticks 内下降60%，槽位越大起始越低；位置按二进制帧取整到厘米
+ */
+static TelemetryRow make_row(int slot, int tick, int columns, int ticks)
+{
+    int angle = (tick * 3 + slot * 97) % TABLE_SIZE;
+    TelemetryRow row;
+    row.time_ns = row_time(slot, tick);
+    row.slot = static_cast<uint16_t>(slot);
+    row.id = static_cast<uint8_t>(slot % 250 + 1);
+    row.roll = static_cast<int16_t>(cos_table[angle] * 150);
+    row.pitch = static_cast<int16_t>(sin_table[angle] * 150);
+    row.yaw = static_cast<int16_t>(angle);
+    row.x = std::round((slot % columns) * GRID_CM + RADIUS_CM * cos_table[angle]);
+    row.y = std::round((slot / columns) * GRID_CM + RADIUS_CM * sin_table[angle]);
+    row.z = static_cast<float>(1000 + (tick / 50 + slot) % 200);
+    row.batt = static_cast<uint8_t>(std::max<int64_t>(0, 100 - static_cast<int64_t>(tick) * 60 / ticks - slot % 50));
+    if (columns == 20 && slot == CLOSE_B && std::abs(tick - CLOSE_TICK) <= 20) {
+        // 槽位 8 短暂贴近槽位 7：沿 x 方向在 CLOSE_TICK 时相距 CLOSE_CM
+        TelemetryRow a = make_row(CLOSE_A, tick, columns, ticks);
+        row.x = a.x + CLOSE_CM + std::abs(tick - CLOSE_TICK) * 10;
+        row.y = a.y;
+        row.z = a.z;
+    }
+    return row;
+}
+
+static bool record(int drones, int ticks, int columns, TelemetryEncoding encoding, double* seconds)
+{
+    bool compressed = encoding == TelemetryEncoding::GORILLA;
+    TelemetryRecorder recorder;
+    size_t max_bytes = static_cast<size_t>(drones) * ticks * 48 + (64u << 20);
+    if (!recorder.open(PATH, max_bytes,
+                       compressed ? TelemetryRecorder::COMPRESSED_CHUNK_ROWS : TelemetryRecorder::DEFAULT_CHUNK_ROWS,
+                       encoding)) {
+        return false;
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < ticks; tick++) {
+        for (int slot = 0; slot < drones; slot++) {
+            recorder.append(make_row(slot, tick, columns, ticks));
+        }
+    }
+    recorder.close();
+    if (seconds != nullptr) {
+        *seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    return recorder.getDroppedCount() == 0 && recorder.getRowCount() == static_cast<uint64_t>(drones) * ticks;
+}
+
+// ====================== 与暴力计算核对 ======================
+// 条件扫描：统计每架无人机通过的行数，与逐行判断的结果比较
+static bool check_scan(const TelemetryQuery& query, const TelemetryScan& scan, int threads, const char* name,
+                       TelemetryScanStats* out_stats)
+{
+    std::vector<uint64_t> expected(SMALL_DRONES, 0);
+    for (int tick = 0; tick < SMALL_TICKS; tick++) {
+        for (int slot = 0; slot < SMALL_DRONES; slot++) {
+            TelemetryRow row = make_row(slot, tick, 20, SMALL_TICKS);
+            bool pass = row.time_ns >= scan.begin_ns && row.time_ns <= scan.end_ns;
+            pass = pass && (scan.slots.empty() ||
+                            std::find(scan.slots.begin(), scan.slots.end(), row.slot) != scan.slots.end());
+            for (const ColumnPredicate& predicate : scan.predicates) {
+                float values[TELEMETRY_COLUMN_COUNT] = {0,
+                                                        static_cast<float>(row.slot),
+                                                        static_cast<float>(row.roll),
+                                                        static_cast<float>(row.pitch),
+                                                        static_cast<float>(row.yaw),
+                                                        row.x,
+                                                        row.y,
+                                                        row.z,
+                                                        static_cast<float>(row.id),
+                                                        static_cast<float>(row.batt)};
+                float v = values[predicate.column];
+                switch (predicate.op) {
+                    case CompareOp::LESS: pass = pass && v < predicate.value; break;
+                    case CompareOp::LESS_EQUAL: pass = pass && v <= predicate.value; break;
+                    case CompareOp::GREATER: pass = pass && v > predicate.value; break;
+                    case CompareOp::GREATER_EQUAL: pass = pass && v >= predicate.value; break;
+                    case CompareOp::EQUAL: pass = pass && v == predicate.value; break;
+                    case CompareOp::NOT_EQUAL: pass = pass && v != predicate.value; break;
+                }
+            }
+            expected[slot] += pass ? 1 : 0;
+        }
+    }
+
+    std::vector<std::vector<uint64_t>> counts(threads, std::vector<uint64_t>(SMALL_DRONES, 0));
+    std::atomic<bool> valid{true};
+    TelemetryScanStats stats = query.scan(
+        scan, threads, [&](int worker, const TelemetryColumns& columns, const uint32_t* rows, size_t count) {
+            for (size_t k = 0; k < count; k++) {
+                uint32_t i = rows[k];
+                // 逐行核对回调中的列值
+                TelemetryRow row = make_row(columns.slot[i], static_cast<int>((columns.time[i] - START_NS) / PERIOD_NS), 20,
+                                            SMALL_TICKS);
+                if (row.time_ns != columns.time[i] || row.batt != columns.batt[i] || row.x != columns.x[i] ||
+                    row.z != columns.z[i] || row.id != columns.id[i]) {
+                    valid = false;
+                }
+                counts[worker][columns.slot[i]]++;
+            }
+        });
+    uint64_t expected_total = 0;
+    bool ok = valid;
+    for (int slot = 0; slot < SMALL_DRONES; slot++) {
+        uint64_t total = 0;
+        for (int t = 0; t < threads; t++) {
+            total += counts[t][slot];
+        }
+        ok = ok && total == expected[slot];
+        expected_total += expected[slot];
+    }
+    ok = ok && stats.rows_matched == expected_total;
+    fprintf(stderr, "  %s，%d 线程：命中 %lu 行（应为 %lu），%lu 块中跳过 %lu、过滤后为空 %lu %s\n", name, threads,
+            static_cast<unsigned long>(stats.rows_matched), static_cast<unsigned long>(expected_total),
+            static_cast<unsigned long>(stats.chunks), static_cast<unsigned long>(stats.chunks_pruned),
+            static_cast<unsigned long>(stats.chunks_filtered), ok ? "" : "错误");
+    if (out_stats != nullptr) {
+        *out_stats = stats;
+    }
+    return ok;
+}
+
+// 最近距离：逐格两两比较
+static bool check_closest(const TelemetryQuery& query, int threads)
+{
+    float best = std::numeric_limits<float>::infinity();
+    int best_tick = -1;
+    std::vector<TelemetryRow> rows(SMALL_DRONES);
+    for (int tick = 0; tick < SMALL_TICKS; tick++) {
+        for (int slot = 0; slot < SMALL_DRONES; slot++) {
+            rows[slot] = make_row(slot, tick, 20, SMALL_TICKS);
+        }
+        for (int a = 0; a < SMALL_DRONES; a++) {
+            for (int b = a + 1; b < SMALL_DRONES; b++) {
+                float dx = rows[a].x - rows[b].x;
+                float dy = rows[a].y - rows[b].y;
+                float dz = rows[a].z - rows[b].z;
+                float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+                if (distance < best) {
+                    best = distance;
+                    best_tick = tick;
+                }
+            }
+        }
+    }
+    TelemetryScan scan;
+    TelemetryApproach approach = query.closestApproach(scan, PERIOD_NS, threads);
+    bool ok = approach.found && approach.distance == best && best == CLOSE_CM && best_tick == CLOSE_TICK &&
+              approach.slot_a == CLOSE_A && approach.slot_b == CLOSE_B &&
+              (approach.time_ns - START_NS) / PERIOD_NS == static_cast<uint64_t>(CLOSE_TICK) &&
+              approach.id_a == CLOSE_A + 1 && approach.id_b == CLOSE_B + 1;
+
+    // 排除注入的那一段后，最近距离应大于 CLOSE_CM
+    scan.end_ns = row_time(0, CLOSE_TICK - 30);
+    TelemetryApproach before = query.closestApproach(scan, PERIOD_NS, threads);
+    ok = ok && before.found && before.distance > CLOSE_CM;
+    fprintf(stderr, "  最近距离 %d 线程：%.1f 厘米（槽位 %u-%u，第 %lu 次上报；暴力计算 %.1f 厘米，第 %d 次）；"
+                    "注入前 %.1f 厘米 %s\n",
+            threads, approach.distance, approach.slot_a, approach.slot_b,
+            static_cast<unsigned long>((approach.time_ns - START_NS) / PERIOD_NS), best, best_tick, before.distance,
+            ok ? "" : "错误");
+    return ok;
+}
+
+static bool check_small(TelemetryEncoding encoding)
+{
+    bool compressed = encoding == TelemetryEncoding::GORILLA;
+    fprintf(stderr, "[%s] %d 架无人机 %d 秒\n", compressed ? "Gorilla" : "原样", SMALL_DRONES, SMALL_TICKS / RATE_HZ);
+    bool ok = record(SMALL_DRONES, SMALL_TICKS, 20, encoding, nullptr);
+    TelemetryRecordReader reader;
+    ok = ok && reader.open(PATH);
+    if (!ok) {
+        fprintf(stderr, "  记录或打开失败\n");
+        return false;
+    }
+    TelemetryQuery query(reader);
+    ColumnPredicate low_battery;
+    ok = parsePredicate("batt<20", low_battery) && ok;
+
+    TelemetryScan all;
+    TelemetryScanStats stats;
+    ok = check_scan(query, all, 1, "全部", &stats) && ok;
+    ok = ok && stats.chunks_pruned == 0 && stats.rows_matched == static_cast<uint64_t>(SMALL_DRONES) * SMALL_TICKS;
+
+    TelemetryScan battery;
+    battery.predicates.push_back(low_battery);
+    ok = check_scan(query, battery, 1, "batt<20", &stats) && ok;
+    // 前半段没有电量低于20%的无人机，应按统计区跳过
+    ok = ok && stats.chunks_pruned >= stats.chunks / 3;
+    ok = check_scan(query, battery, 4, "batt<20", nullptr) && ok;
+
+    TelemetryScan window = battery;
+    window.begin_ns = row_time(0, 5000);
+    window.end_ns = row_time(0, 5500) + 12345;
+    ok = check_scan(query, window, 3, "batt<20 时间窗口", nullptr) && ok;
+
+    TelemetryScan drones;
+    drones.slots = {3, 49, 150, 199};
+    ColumnPredicate high;
+    ok = parsePredicate("z>=1100", high) && ok;
+    drones.predicates.push_back(high);
+    ok = check_scan(query, drones, 2, "指定无人机 z>=1100", nullptr) && ok;
+
+    TelemetryScan pruned;
+    ColumnPredicate impossible;
+    ok = parsePredicate("id==251", impossible) && ok;
+    pruned.predicates.push_back(impossible);
+    ok = check_scan(query, pruned, 2, "id==251", &stats) && ok;
+    ok = ok && stats.chunks_pruned == stats.chunks;
+
+    TelemetryScan filtered;
+    ColumnPredicate yaw;
+    ok = parsePredicate("yaw==1", yaw) && ok;
+    filtered.predicates.push_back(yaw);
+    ColumnPredicate roll;
+    ok = parsePredicate("roll!=0", roll) && ok;
+    filtered.predicates.push_back(roll);
+    ok = check_scan(query, filtered, 2, "yaw==1 roll!=0", nullptr) && ok;
+
+    ok = check_closest(query, 1) && ok;
+    ok = check_closest(query, 4) && ok;
+    return ok;
+}
+
+static bool check_parse()
+{
+    ColumnPredicate predicate;
+    bool ok = parsePredicate("batt<=20.5", predicate) && predicate.column == TELEMETRY_BATT &&
+              predicate.op == CompareOp::LESS_EQUAL && predicate.value == 20.5f;
+    ok = ok && parsePredicate("x!=-3", predicate) && predicate.column == TELEMETRY_X &&
+         predicate.op == CompareOp::NOT_EQUAL && predicate.value == -3;
+    ok = ok && parsePredicate("id=4", predicate) && predicate.op == CompareOp::EQUAL;
+    ok = ok && !parsePredicate("time>5", predicate) && !parsePredicate("speed<3", predicate) &&
+         !parsePredicate("batt<", predicate) && !parsePredicate("batt<2x", predicate) &&
+         !parsePredicate("<3", predicate) && !parsePredicate("batt", predicate);
+    fprintf(stderr, "条件解析 %s\n", ok ? "正确" : "错误");
+    return ok;
+}
+
+// ====================== 1000 架长记录 ======================
+static bool run_scale(int minutes, int threads)
+{
+    const int DRONES = 1000;
+    const int ticks = minutes * 60 * RATE_HZ;
+    double record_seconds = 0;
+    bool ok = record(DRONES, ticks, 32, TelemetryEncoding::GORILLA, &record_seconds);
+    TelemetryRecordReader reader;
+    ok = ok && reader.open(PATH);
+    if (!ok) {
+        fprintf(stderr, "长记录写入或打开失败\n");
+        return false;
+    }
+    fprintf(stderr, "[长记录] %d 架无人机 %d 分钟：%lu 行，%zu 块，生成并写入 %.1f 秒\n", DRONES, minutes,
+            static_cast<unsigned long>(reader.getRowCount()), reader.getChunkCount(), record_seconds);
+    TelemetryQuery query(reader);
+
+    // 哪些无人机在后半程电量低于20%
+    TelemetryScan battery;
+    ColumnPredicate low_battery;
+    parsePredicate("batt<20", low_battery);
+    battery.predicates.push_back(low_battery);
+    battery.begin_ns = row_time(0, ticks / 2);
+    battery.columns = (1u << TELEMETRY_SLOT) | (1u << TELEMETRY_TIME);
+    std::vector<std::vector<uint8_t>> seen(threads, std::vector<uint8_t>(DRONES, 0));
+    auto start = std::chrono::steady_clock::now();
+    TelemetryScanStats stats = query.scan(
+        battery, threads, [&](int worker, const TelemetryColumns& columns, const uint32_t* rows, size_t count) {
+            for (size_t k = 0; k < count; k++) {
+                seen[worker][columns.slot[rows[k]]] = 1;
+            }
+        });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    int drones = 0;
+    for (int slot = 0; slot < DRONES; slot++) {
+        bool any = false;
+        for (int t = 0; t < threads; t++) {
+            any = any || seen[t][slot] != 0;
+        }
+        drones += any ? 1 : 0;
+    }
+    fprintf(stderr, "  后半程 batt<20：%d 架无人机，%lu 行；%lu 块中跳过 %lu，用时 %.3f 秒\n", drones,
+            static_cast<unsigned long>(stats.rows_matched), static_cast<unsigned long>(stats.chunks),
+            static_cast<unsigned long>(stats.chunks_pruned), seconds);
+
+    // 全程每列的范围（全部行、全部列）
+    TelemetryScan full;
+    full.columns = TELEMETRY_ALL_COLUMNS;
+    std::vector<uint64_t> rows_seen(threads, 0);
+    start = std::chrono::steady_clock::now();
+    stats = query.scan(full, threads, [&](int worker, const TelemetryColumns&, const uint32_t*, size_t count) {
+        rows_seen[worker] += count;
+    });
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ok = ok && stats.rows_matched == reader.getRowCount();
+    fprintf(stderr, "  全表扫描（解码全部列）：%lu 行，用时 %.3f 秒（%.0f 万行/秒）\n",
+            static_cast<unsigned long>(stats.rows_matched), seconds, stats.rows_matched / seconds / 1e4);
+
+    // 全程任意两架的最近距离
+    TelemetryScan everything;
+    start = std::chrono::steady_clock::now();
+    TelemetryApproach approach = query.closestApproach(everything, PERIOD_NS, threads, &stats);
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ok = ok && approach.found && approach.distance >= 0 && approach.distance < GRID_CM;
+    fprintf(stderr, "  全程最近距离：%.1f 厘米（槽位 %u-%u，第 %.3f 秒），%lu 行，用时 %.3f 秒\n", approach.distance,
+            approach.slot_a, approach.slot_b, (approach.time_ns - START_NS) / 1e9,
+            static_cast<unsigned long>(stats.rows_matched), seconds);
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    int minutes = 10;
+    int threads = static_cast<int>(std::thread::hardware_concurrency());
+    static const option long_options[] = {
+        {"minutes", required_argument, nullptr, 'm'},
+        {"threads", required_argument, nullptr, 't'},
+        {nullptr, 0, nullptr, 0},
+    };
+    int c;
+    while ((c = getopt_long(argc, argv, "", long_options, nullptr)) != -1) {
+        switch (c) {
+            case 'm': minutes = atoi(optarg); break;
+            case 't': threads = atoi(optarg); break;
+            default: fprintf(stderr, "用法：telemetry_query_test [--minutes=N] [--threads=N]\n"); return 2;
+        }
+    }
+    threads = threads < 1 ? 1 : threads;
+    Logger::setLevel(LogLevel::ERROR);
+    for (int i = 0; i < TABLE_SIZE; i++) {
+        sin_table[i] = static_cast<float>(std::sin(i * 2 * M_PI / TABLE_SIZE));
+        cos_table[i] = static_cast<float>(std::cos(i * 2 * M_PI / TABLE_SIZE));
+    }
+
+    bool passed = check_parse();
+    passed = check_small(TelemetryEncoding::RAW) && passed;
+    passed = check_small(TelemetryEncoding::GORILLA) && passed;
+    if (minutes > 0) {
+        passed = run_scale(minutes, threads) && passed;
+    }
+    unlink(PATH);
+    fprintf(stderr, "%s\n", passed ? "PASS" : "FAIL");
+    return passed ? 0 : 1;
+}
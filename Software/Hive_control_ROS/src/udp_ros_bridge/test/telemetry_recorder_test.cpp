@@ -0,0 +1,314 @@
+/**
+ * @file telemetry_recorder_test.cpp
+ * @brief 列式遥测记录测试：1000架无人机50Hz的写入开销，按 (时间范围, 无人机集合) 查询的正确性和耗时，
+ *        以及写满丢弃、磁盘满丢弃、未关闭时读取、按时间封块；写入和查询对原样块、Gorilla 压缩块各做一遍
+ * @note 每行的内容由 (槽位, 第几次上报) 确定，查询结果逐行核对字段，并按公式算出应有的行数，
+ *       不需要在内存中另存一份数据。写入开销以单线程追加全部行的CPU时间占模拟时长的比例给出。
+ */
+
+#include "../src/TelemetryRecorder/TelemetryRecorder.h"
+#include "udp_ros_bridge/Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <random>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+static const char* PATH = "/tmp/telemetry_recorder_test.tlm";
+
+static const int DRONES = 1000;
+static const int RATE_HZ = 50;
+static const int SECONDS = 60;
+static const uint64_t PERIOD_NS = 1000000000ULL / RATE_HZ;
+static const uint64_t START_NS = 1700000000ULL * 1000000000ULL;
+// 同一周期内各无人机的上报时间错开
+static const uint64_t STAGGER_NS = 10000;
+
+static uint64_t row_time(int slot, int tick)
+{
+    return START_NS + static_cast<uint64_t>(tick) * PERIOD_NS + static_cast<uint64_t>(slot) * STAGGER_NS;
+}
+
+static TelemetryRow make_row(int slot, int tick)
+{
+    TelemetryRow row;
+    row.time_ns = row_time(slot, tick);
+    row.slot = static_cast<uint16_t>(slot);
+    row.id = static_cast<uint8_t>(slot % 250 + 1);
+    row.roll = static_cast<int16_t>((slot * 7 + tick) % 1800 - 900);
+    row.pitch = static_cast<int16_t>((slot * 3 + tick * 2) % 1800 - 900);
+    row.yaw = static_cast<int16_t>((slot + tick * 5) % 3600);
+    row.x = slot * 0.5f + tick * 0.01f;
+    row.y = slot * -0.25f + tick * 0.02f;
+    row.z = 10.0f + (tick % 100) * 0.1f;
+    row.batt = static_cast<uint8_t>(100 - tick / 100 % 100);
+    return row;
+}
+
+static bool same_row(const TelemetryRow& a, const TelemetryRow& b)
+{
+    return a.time_ns == b.time_ns && a.slot == b.slot && a.id == b.id && a.roll == b.roll && a.pitch == b.pitch &&
+           a.yaw == b.yaw && a.x == b.x && a.y == b.y && a.z == b.z && a.batt == b.batt;
+}
+
+static double cpu_seconds()
+{
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// ====================== 1000架 50Hz 写入 ======================
+static bool record_swarm(TelemetryEncoding encoding)
+{
+    const int TICKS = RATE_HZ * SECONDS;
+    bool compressed = encoding == TelemetryEncoding::GORILLA;
+    TelemetryRecorder recorder;
+    bool ok = recorder.open(PATH, 512 * 1024 * 1024,
+                            compressed ? TelemetryRecorder::COMPRESSED_CHUNK_ROWS : TelemetryRecorder::DEFAULT_CHUNK_ROWS,
+                            encoding);
+    double cpu_start = cpu_seconds();
+    auto start = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < TICKS && ok; tick++) {
+        for (int slot = 0; slot < DRONES; slot++) {
+            recorder.append(make_row(slot, tick));
+        }
+    }
+    recorder.close();
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double cpu = cpu_seconds() - cpu_start;
+    uint64_t total = static_cast<uint64_t>(TICKS) * DRONES;
+    ok = ok && recorder.getRowCount() == total && recorder.getDroppedCount() == 0;
+    fprintf(stderr, "[%s] %d 架无人机 %d Hz 记录 %d 秒：%lu 行，%lu 块，%.1f MB（%.1f 字节/行）\n",
+            compressed ? "Gorilla" : "原样", DRONES, RATE_HZ, SECONDS, static_cast<unsigned long>(total), static_cast<unsigned long>(recorder.getChunkCount()),
+            recorder.getByteCount() / 1048576.0, static_cast<double>(recorder.getByteCount()) / total);
+    fprintf(stderr, "  写入 %.1f ns/行，CPU %.3f 秒，占模拟时长的 %.2f%%（单核）\n", wall * 1e9 / total, cpu,
+            cpu * 100 / SECONDS);
+    return ok;
+}
+
+// ====================== 查询 ======================
+// 槽位 slot 在 [begin, end] 内的上报次数
+static uint64_t expected_rows(int slot, uint64_t begin_ns, uint64_t end_ns)
+{
+    const int TICKS = RATE_HZ * SECONDS;
+    uint64_t count = 0;
+    for (int tick = 0; tick < TICKS; tick++) {
+        uint64_t t = row_time(slot, tick);
+        count += t >= begin_ns && t <= end_ns ? 1 : 0;
+    }
+    return count;
+}
+
+static bool check_queries()
+{
+    TelemetryRecordReader reader;
+    bool ok = reader.open(PATH);
+    uint64_t total = static_cast<uint64_t>(RATE_HZ) * SECONDS * DRONES;
+    ok = ok && reader.getRowCount() == total && reader.getBeginNs() == row_time(0, 0) &&
+         reader.getEndNs() == row_time(DRONES - 1, RATE_HZ * SECONDS - 1);
+    if (!ok) {
+        fprintf(stderr, "打开记录文件或索引错误\n");
+        return false;
+    }
+
+    std::mt19937 rng(42);
+    const int QUERIES = 200;
+    double query_ns = 0;
+    uint64_t returned = 0;
+    std::vector<TelemetryRow> out;
+    for (int q = 0; q < QUERIES && ok; q++) {
+        // 随机时间窗（10毫秒到5秒）和随机的1~20架无人机；每10次查一次全部无人机的短时间窗
+        uint64_t begin = START_NS + rng() % (static_cast<uint64_t>(SECONDS) * 1000000000ULL);
+        bool all = q % 10 == 0;
+        uint64_t length = all ? 10000000ULL + rng() % 50000000ULL : 10000000ULL + rng() % 5000000000ULL;
+        uint64_t end = begin + length;
+        std::vector<uint16_t> slots;
+        if (!all) {
+            int count = 1 + rng() % 20;
+            for (int i = 0; i < count; i++) {
+                slots.push_back(static_cast<uint16_t>(rng() % DRONES));
+            }
+            std::sort(slots.begin(), slots.end());
+            slots.erase(std::unique(slots.begin(), slots.end()), slots.end());
+        }
+
+        out.clear();
+        auto start = std::chrono::steady_clock::now();
+        reader.query(begin, end, slots, out);
+        query_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        returned += out.size();
+
+        uint64_t expected = 0;
+        if (all) {
+            for (int slot = 0; slot < DRONES; slot++) {
+                expected += expected_rows(slot, begin, end);
+            }
+        } else {
+            for (uint16_t slot : slots) {
+                expected += expected_rows(slot, begin, end);
+            }
+        }
+        ok = out.size() == expected;
+        for (const TelemetryRow& row : out) {
+            int tick = static_cast<int>((row.time_ns - START_NS - row.slot * STAGGER_NS) / PERIOD_NS);
+            bool wanted = all || std::binary_search(slots.begin(), slots.end(), row.slot);
+            if (!wanted || row.time_ns < begin || row.time_ns > end || !same_row(row, make_row(row.slot, tick))) {
+                ok = false;
+                break;
+            }
+        }
+        if (!ok) {
+            fprintf(stderr, "第 %d 次查询错误：返回 %zu 行，应为 %lu 行\n", q, out.size(),
+                    static_cast<unsigned long>(expected));
+        }
+    }
+    fprintf(stderr, "随机查询 %d 次：%s，共返回 %lu 行，平均 %.1f us/次（%lu 块）\n", QUERIES, ok ? "正确" : "错误",
+            static_cast<unsigned long>(returned), query_ns / QUERIES / 1000,
+            static_cast<unsigned long>(reader.getChunkCount()));
+
+    // 单架无人机的一个点：只读一个块内的两次二分
+    const int POINTS = 10000;
+    std::vector<uint16_t> one(1);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < POINTS && ok; i++) {
+        int slot = rng() % DRONES;
+        int tick = rng() % (RATE_HZ * SECONDS);
+        one[0] = static_cast<uint16_t>(slot);
+        out.clear();
+        uint64_t t = row_time(slot, tick);
+        reader.query(t, t, one, out);
+        ok = out.size() == 1 && same_row(out[0], make_row(slot, tick));
+    }
+    double point_ns =
+        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / POINTS;
+    fprintf(stderr, "单点查询 %d 次：%s，%.0f ns/次\n", POINTS, ok ? "正确" : "错误", point_ns);
+    return ok;
+}
+
+// ====================== 写满与未关闭 ======================
+static bool check_full_and_unclosed()
+{
+    // 每块100行，写入950行：未关闭时只能读到已封存的9块
+    TelemetryRecorder recorder;
+    bool ok = recorder.open(PATH, 1024 * 1024, 100);
+    for (int i = 0; i < 950; i++) {
+        recorder.append(make_row(i % 10, i / 10));
+    }
+    TelemetryRecordReader reader;
+    ok = ok && reader.open(PATH) && reader.getChunkCount() == 9 && reader.getRowCount() == 900;
+    std::vector<TelemetryRow> out;
+    std::vector<uint16_t> slots = {3};
+    reader.query(0, UINT64_MAX, slots, out);
+    ok = ok && out.size() == 90;
+    for (size_t i = 0; i < out.size() && ok; i++) {
+        ok = same_row(out[i], make_row(3, static_cast<int>(i)));
+    }
+    reader.close();
+    recorder.close();
+    ok = ok && reader.open(PATH) && reader.getRowCount() == 950;
+    reader.close();
+    fprintf(stderr, "未关闭时读取已封存的块：%s\n", ok ? "正确" : "错误");
+
+    // 文件只放得下两块，之后的块整块丢弃
+    bool full_ok = recorder.open(PATH, 32 + 2 * (48 + 100 * 40), 100);
+    for (int i = 0; i < 500; i++) {
+        recorder.append(make_row(i % 10, i / 10));
+    }
+    recorder.close();
+    full_ok = full_ok && recorder.getChunkCount() == 2 && recorder.getDroppedCount() == 300;
+    full_ok = full_ok && reader.open(PATH) && reader.getRowCount() == 200;
+    fprintf(stderr, "写满丢弃：%s（已写 %lu 块，丢弃 %lu 行）\n", full_ok ? "正确" : "错误",
+            static_cast<unsigned long>(recorder.getChunkCount()), static_cast<unsigned long>(recorder.getDroppedCount()));
+    return ok && full_ok;
+}
+
+// ====================== 按时间封块 ======================
+/**
+ * @brief 压缩块行数攒不满时，最早一行超过最长停留时间即封块，未关闭也能读到
+ */
+static bool check_chunk_age()
+{
+    const uint64_t MAX_AGE_NS = 5000000000ULL;
+    TelemetryRecorder recorder;
+    bool ok = recorder.open(PATH, 64 * 1024 * 1024, TelemetryRecorder::COMPRESSED_CHUNK_ROWS,
+                            TelemetryEncoding::GORILLA);
+    for (int tick = 0; tick < 10; tick++) {
+        for (int slot = 0; slot < 15; slot++) {
+            recorder.append(make_row(slot, tick));
+        }
+    }
+    uint64_t first_ns = row_time(0, 0);
+    ok = ok && !recorder.flushOlderThan(first_ns + MAX_AGE_NS - 1, MAX_AGE_NS) && recorder.getChunkCount() == 0;
+    ok = ok && recorder.flushOlderThan(first_ns + MAX_AGE_NS, MAX_AGE_NS) && recorder.getChunkCount() == 1;
+    // 当前块为空时不封块
+    ok = ok && !recorder.flushOlderThan(first_ns + 2 * MAX_AGE_NS, MAX_AGE_NS);
+    TelemetryRecordReader reader;
+    ok = ok && reader.open(PATH) && reader.getRowCount() == 150;
+    std::vector<TelemetryRow> out;
+    std::vector<uint16_t> slots = {7};
+    reader.query(0, UINT64_MAX, slots, out);
+    ok = ok && out.size() == 10 && same_row(out[9], make_row(7, 9));
+    reader.close();
+    recorder.close();
+    fprintf(stderr, "按时间封块：%s\n", ok ? "正确" : "错误");
+    return ok;
+}
+
+// ====================== 磁盘满 ======================
+/**
+ * @brief 扩展的空间先在磁盘上分配（文件不是稀疏的）；分配失败后之后的块计为丢弃，不触发 SIGBUS
+ * @note 用 RLIMIT_FSIZE 模拟磁盘满：超过上限的分配返回 EFBIG（忽略 SIGXFSZ）
+ */
+static bool check_disk_full()
+{
+    const int CHUNK_ROWS = 4096;
+    const int TOTAL = 200 * CHUNK_ROWS;
+    rlimit saved;
+    getrlimit(RLIMIT_FSIZE, &saved);
+    void (*saved_handler)(int) = signal(SIGXFSZ, SIG_IGN);
+    rlimit limited = saved;
+    limited.rlim_cur = TelemetryRecorder::GROW_BYTES + TelemetryRecorder::GROW_BYTES / 2;
+    setrlimit(RLIMIT_FSIZE, &limited);
+
+    TelemetryRecorder recorder;
+    bool ok = recorder.open(PATH, 4 * TelemetryRecorder::GROW_BYTES, CHUNK_ROWS);
+    struct stat st;
+    ok = ok && stat(PATH, &st) == 0 && static_cast<size_t>(st.st_blocks) * 512 >= TelemetryRecorder::GROW_BYTES;
+    for (int i = 0; i < TOTAL; i++) {
+        recorder.append(make_row(i % DRONES, i / DRONES));
+    }
+    setrlimit(RLIMIT_FSIZE, &saved);
+    signal(SIGXFSZ, saved_handler);
+    recorder.close();
+    // 第一段写满后停止：已封存的块都在第一段内，其余整块丢弃，已写的块完整可读
+    uint64_t chunks = recorder.getChunkCount();
+    ok = ok && chunks > 0 && recorder.getByteCount() <= TelemetryRecorder::GROW_BYTES &&
+         recorder.getDroppedCount() == static_cast<uint64_t>(TOTAL) - chunks * CHUNK_ROWS;
+    TelemetryRecordReader reader;
+    ok = ok && reader.open(PATH) && reader.getChunkCount() == chunks && reader.getRowCount() == chunks * CHUNK_ROWS;
+    reader.close();
+    fprintf(stderr, "磁盘满丢弃：%s（已写 %lu 块，丢弃 %lu 行）\n", ok ? "正确" : "错误",
+            static_cast<unsigned long>(chunks), static_cast<unsigned long>(recorder.getDroppedCount()));
+    return ok;
+}
+
+int main()
+{
+    Logger::setLevel(LogLevel::ERROR);
+    bool passed = check_full_and_unclosed();
+    passed = check_disk_full() && passed;
+    passed = check_chunk_age() && passed;
+    passed = record_swarm(TelemetryEncoding::RAW) && passed;
+    passed = check_queries() && passed;
+    passed = record_swarm(TelemetryEncoding::GORILLA) && passed;
+    passed = check_queries() && passed;
+    unlink(PATH);
+    fprintf(stderr, "%s\n", passed ? "PASS" : "FAIL");
+    return passed ? 0 : 1;
+}
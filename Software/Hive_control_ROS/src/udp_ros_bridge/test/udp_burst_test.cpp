@@ -0,0 +1,174 @@
+/**
+ * @file udp_burst_test.cpp
+ * @brief 集群同时上报时的突发负载测试
+ * @note 模拟 DRONES 架无人机在同一时刻各发 FRAMES_PER_DRONE 帧，重复 ROUNDS 轮，
+ *       比较默认接收缓冲区、加大接收缓冲区、加大缓冲区+UDP_GRO 三种配置下的内核丢包。
+ *       发送端用UDP_SEGMENT一次系统调用发出一架无人机的一轮数据，
+ *       接收端没开GRO时内核会自动拆成独立数据报，开了GRO则合并交付。
+ *       SO_RCVBUFFORCE需要root或CAP_NET_ADMIN，否则缓冲区受 net.core.rmem_max 限制。
+ */
+
+#include "../src/UDP/UDP.h"
+#include "udp_ros_bridge/Logger.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <netinet/udp.h>
+
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+
+static const int RECEIVER_PORT = 19650;
+static const int DRONES = 64;
+static const int FRAMES_PER_DRONE = 8;
+static const int ROUNDS = 50;
+// 一帧姿态数据：包头2 + 状态1 + 长度1 + 参数6 + 校验1 + 包尾1
+static const int FRAME_SIZE = 12;
+
+struct BurstResult {
+    int received;
+    // 长度和校验都正确的数据报数（GRO拆出的每一段直接引用接收块中的数据）
+    int intact;
+    uint32_t kernel_drops;
+    uint64_t near_overflow;
+    uint64_t gro_batches;
+    int rcvbuf;
+};
+
+/**
+ * @brief 检查收到的数据报是否是一帧完整的姿态数据
+ */
+static bool frame_intact(const UdpPacket& packet)
+{
+    const uint8_t* frame = packet.data();
+    if (packet.size() != FRAME_SIZE || frame[0] != 0xEE || frame[1] != 0xEE || frame[11] != 0xFF) {
+        return false;
+    }
+    uint8_t check = 0;
+    for (int i = 2; i < 10; i++) {
+        check += frame[i];
+    }
+    return check == frame[10];
+}
+
+/**
+ * @brief 生成一帧姿态数据
+ */
+static void fill_frame(uint8_t* frame, int drone, int index)
+{
+    frame[0] = 0xEE;
+    frame[1] = 0xEE;
+    frame[2] = 0x00;
+    frame[3] = 6;
+    uint8_t check = frame[2] + frame[3];
+    for (int i = 0; i < 6; i++) {
+        frame[4 + i] = static_cast<uint8_t>(drone + index + i);
+        check += frame[4 + i];
+    }
+    frame[10] = check;
+    frame[11] = 0xFF;
+}
+
+/**
+ * @brief 跑一轮突发负载
+ * @param rcvbuf 接收缓冲区大小，0表示保持系统默认
+ * @param gro 是否开启UDP_GRO
+ */
+static BurstResult run_burst(int rcvbuf, bool gro)
+{
+    UDP receiver(RECEIVER_PORT);
+    if (rcvbuf > 0) {
+        receiver.setReceiveBufferSize(rcvbuf);
+    }
+    receiver.setGro(gro);
+    receiver.startListening();
+
+    // 每架无人机一个socket（每架无人机是一条独立的流）
+    std::vector<int> senders(DRONES);
+    for (int d = 0; d < DRONES; d++) {
+        senders[d] = socket(AF_INET, SOCK_DGRAM, 0);
+        int segment = FRAME_SIZE;
+        setsockopt(senders[d], SOL_UDP, UDP_SEGMENT, &segment, sizeof(segment));
+    }
+
+    struct sockaddr_in target;
+    memset(&target, 0, sizeof(target));
+    target.sin_family = AF_INET;
+    target.sin_port = htons(RECEIVER_PORT);
+    inet_pton(AF_INET, "127.0.0.1", &target.sin_addr);
+
+    uint8_t burst[FRAME_SIZE * FRAMES_PER_DRONE];
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int d = 0; d < DRONES; d++) {
+            for (int f = 0; f < FRAMES_PER_DRONE; f++) {
+                fill_frame(burst + f * FRAME_SIZE, d, round * FRAMES_PER_DRONE + f);
+            }
+            sendto(senders[d], burst, sizeof(burst), 0, (struct sockaddr*)&target, sizeof(target));
+        }
+    }
+
+    // 等接收线程把缓冲区读空
+    int received = 0;
+    int intact = 0;
+    for (int idle = 0; idle < 20; ) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        auto queue = receiver.getMessageQueue();
+        if (queue.empty()) {
+            idle++;
+        }
+        received += static_cast<int>(queue.size());
+        for (; !queue.empty(); queue.pop()) {
+            intact += frame_intact(queue.front()) ? 1 : 0;
+        }
+    }
+
+    for (int fd : senders) {
+        close(fd);
+    }
+
+    BurstResult result;
+    result.received = received;
+    result.intact = intact;
+    result.kernel_drops = receiver.getKernelDropCount();
+    result.near_overflow = receiver.getNearOverflowCount();
+    result.gro_batches = receiver.getGroBatchCount();
+    result.rcvbuf = receiver.getReceiveBufferSize();
+    receiver.stop();
+    return result;
+}
+
+static void print_result(const char* name, const BurstResult& r)
+{
+    fprintf(stderr, "%-24s rcvbuf=%8d 收到=%6d 完整=%6d 内核丢包=%6u 接近溢出=%4llu GRO合并=%5llu\n",
+            name, r.rcvbuf, r.received, r.intact, r.kernel_drops,
+            static_cast<unsigned long long>(r.near_overflow),
+            static_cast<unsigned long long>(r.gro_batches));
+}
+
+int main()
+{
+    Logger::setLevel(LogLevel::ERROR);
+    const int total = DRONES * FRAMES_PER_DRONE * ROUNDS;
+    fprintf(stderr, "突发负载：%d 架 x %d 帧 x %d 轮 = %d 个数据报\n", DRONES, FRAMES_PER_DRONE, ROUNDS, total);
+
+    BurstResult base = run_burst(0, false);
+    BurstResult large = run_burst(8 * 1024 * 1024, false);
+    BurstResult large_gro = run_burst(8 * 1024 * 1024, true);
+
+    print_result("默认缓冲区", base);
+    print_result("8MB缓冲区", large);
+    print_result("8MB缓冲区+GRO", large_gro);
+
+    // 加大缓冲区后收到的数据报不能比默认配置少，默认配置有丢包时丢包必须减少；
+    // 收到的每个数据报（含GRO拆出的）都必须完整
+    bool passed = large.received >= base.received && large_gro.received >= base.received &&
+                  (base.received == total || large.kernel_drops < base.kernel_drops) &&
+                  base.intact == base.received && large.intact == large.received &&
+                  large_gro.intact == large_gro.received;
+    fprintf(stderr, "%s\n", passed ? "PASS" : "FAIL");
+    return passed ? 0 : 1;
+}
@@ -64,6 +64,7 @@ bool UDP::send_data(uint8_t* data, uint8_t length)
                         (struct sockaddr*)&server_addr, sizeof(server_addr));
 
     if (sent_bytes == length) {
+        this->sent_bytes += length;
         ESP_LOGD(TAG, "成功发送数据到服务器，长度: %d", length);
         return true;
     } else {
@@ -72,6 +73,62 @@ bool UDP::send_data(uint8_t* data, uint8_t length)
     }
 }
 
+//  ================ 组帧并发送 ================
+bool UDP::send_frame(uint8_t status, const uint8_t* params, uint8_t length)
+{
+    if (length > FRAME_MAX_PARAMS) {
+        ESP_LOGE(TAG, "帧参数过长: %d", length);
+        return false;
+    }
+
+    // 包头2 + 状态1 + 长度1 + 序号2 + 参数 + 校验(最多4) + 包尾1
+    uint8_t frame[FRAME_MAX_PARAMS + 11];
+    uint8_t pos = 0;
+    frame[pos++] = FRAME_HEAD;
+    frame[pos++] = FRAME_HEAD;
+    frame[pos++] = (status & FRAME_TYPE_MASK) | (frame_seq ? FRAME_SEQ_FLAG : 0) | frame_check;
+    frame[pos++] = length;
+    if (frame_seq) {
+        // 发送失败的帧也占用序号，地面端按丢包统计
+        frame[pos++] = next_seq >> 8;
+        frame[pos++] = next_seq & 0xFF;
+        next_seq++;
+    }
+    memcpy(frame + pos, params, length);
+    pos += length;
+
+    // 校验范围：状态位、数据长度、序号和全部参数
+    const uint8_t* covered = frame + 2;
+    uint8_t covered_length = pos - 2;
+    switch (frame_check) {
+        case FRAME_CHECK_CRC16: {
+            uint16_t crc = crc16_ccitt(covered, covered_length);
+            frame[pos++] = crc >> 8;
+            frame[pos++] = crc & 0xFF;
+            break;
+        }
+        case FRAME_CHECK_CRC32C: {
+            uint32_t crc = crc32c(covered, covered_length);
+            frame[pos++] = crc >> 24;
+            frame[pos++] = (crc >> 16) & 0xFF;
+            frame[pos++] = (crc >> 8) & 0xFF;
+            frame[pos++] = crc & 0xFF;
+            break;
+        }
+        default: {
+            uint8_t check = 0;
+            for (uint8_t i = 0; i < covered_length; i++) {
+                check += covered[i];
+            }
+            frame[pos++] = check;
+            break;
+        }
+    }
+    frame[pos++] = FRAME_TAIL;
+
+    return send_data(frame, pos);
+}
+
 //  ================ 从服务器接收数据 ================
 int UDP::receive_data(uint8_t* buffer, uint8_t max_length)
 {
@@ -97,3 +154,54 @@ int UDP::receive_data(uint8_t* buffer, uint8_t max_length)
     return (int)received_bytes;
 }
 
+
+//  ================ 发送遥测 ================
+bool UDP::send_telemetry(const TelemetrySample& sample)
+{
+    if (telemetry_compact) {
+        uint8_t params[KEYFRAME_LENGTH];
+        uint8_t length = 0;
+        uint8_t type = telemetry_encoder.encode(sample, params, &length);
+        return send_frame(type, params, length);
+    }
+
+    // 旧格式：姿态(0x00)、GPS(0x01)、电池(0x02)各一帧，高位在前
+    const uint8_t attitude[6] = {
+        (uint8_t)(sample.roll >> 8), (uint8_t)sample.roll,
+        (uint8_t)(sample.pitch >> 8), (uint8_t)sample.pitch,
+        (uint8_t)(sample.yaw >> 8), (uint8_t)sample.yaw,
+    };
+    uint8_t position[12];
+    const int32_t values[3] = {sample.x, sample.y, sample.z};
+    for (int i = 0; i < 3; i++) {
+        position[i * 4] = (uint32_t)values[i] >> 24;
+        position[i * 4 + 1] = ((uint32_t)values[i] >> 16) & 0xFF;
+        position[i * 4 + 2] = ((uint32_t)values[i] >> 8) & 0xFF;
+        position[i * 4 + 3] = (uint32_t)values[i] & 0xFF;
+    }
+    bool ok = send_frame(0x00, attitude, sizeof(attitude));
+    ok = send_frame(0x01, position, sizeof(position)) && ok;
+    ok = send_frame(0x02, &sample.batt, 1) && ok;
+    return ok;
+}
+
+//  ================ 处理地面下发的关键帧确认 ================
+int UDP::handle_uplink(const uint8_t* data, int length)
+{
+    // 确认帧：[0xEE][0xEE][0x0A][0x01][关键帧号][加和][0xFF]
+    int acks = 0;
+    for (int i = 0; i + 7 <= length; i++) {
+        if (data[i] != FRAME_HEAD || data[i + 1] != FRAME_HEAD ||
+            data[i + 2] != FRAME_TYPE_KEYFRAME_ACK || data[i + 3] != 1 || data[i + 6] != FRAME_TAIL) {
+            continue;
+        }
+        uint8_t check = data[i + 2] + data[i + 3] + data[i + 4];
+        if (check != data[i + 5]) {
+            continue;
+        }
+        telemetry_encoder.on_ack(data[i + 4]);
+        acks++;
+        i += 6;
+    }
+    return acks;
+}
@@ -9,6 +9,27 @@
 #include "lwip/sockets.h"
 #include "lwip/sys.h"
 #include "lwip/netdb.h"
+#include "CRC/CRC.h"
+#include "DeltaCodec/DeltaCodec.h"
+
+// ================ 二进制帧格式 ================
+// [0xEE][0xEE][状态位][数据长度]([序号高][序号低])[参数位1]...[参数位n][校验][0xFF]
+// 状态位高两位为校验方式，第5位表示带序号，低5位为数据类型（与地面端 FrameScanner.h 一致）
+// 序号为本机16位发送计数，每帧加1，地面端据此丢弃重复/过期帧并统计丢包和乱序
+#define FRAME_HEAD 0xEE
+#define FRAME_TAIL 0xFF
+// 单帧最多参数字节数（整帧长度不超过 send_data 的 uint8_t 长度）
+#define FRAME_MAX_PARAMS 64
+// 状态位中的序号标志和数据类型
+#define FRAME_SEQ_FLAG 0x20
+#define FRAME_TYPE_MASK 0x1F
+
+// 帧校验方式
+enum FrameCheck : uint8_t {
+    FRAME_CHECK_SUM = 0x00,     // 8位加和（旧格式，1字节）
+    FRAME_CHECK_CRC16 = 0x40,   // CRC-16/CCITT（2字节，高位在前）
+    FRAME_CHECK_CRC32C = 0x80,  // CRC-32C（4字节，高位在前）
+};
 
 class UDP {
 private:
@@ -18,6 +39,18 @@ private:
     struct sockaddr_in server_addr;
     // 连接状态标志
     bool is_connected = false;
+    // 帧校验方式
+    FrameCheck frame_check = FRAME_CHECK_SUM;
+    // 是否在帧中附带序号
+    bool frame_seq = true;
+    // 下一帧的序号
+    uint16_t next_seq = 0;
+    // 是否以紧凑格式（关键帧+增量）发送遥测
+    bool telemetry_compact = false;
+    // 紧凑遥测编码器
+    DeltaEncoder telemetry_encoder;
+    // 累计成功发送的字节数（UDP负载）
+    uint32_t sent_bytes = 0;
 
 public:
     // 构造函数
@@ -29,8 +62,29 @@ public:
     // 发送数据到服务器
     bool send_data(uint8_t* data, uint8_t length);
     
+    // 设置 send_frame 使用的校验方式
+    void set_frame_check(FrameCheck check) { frame_check = check; }
+
+    // 设置 send_frame 是否附带序号（默认附带；关闭后与旧固件帧格式相同）
+    void set_frame_seq(bool enable) { frame_seq = enable; }
+
+    // 组帧并发送：status 为数据类型（低5位），校验方式按 set_frame_check 设置
+    bool send_frame(uint8_t status, const uint8_t* params, uint8_t length);
+
     // 从服务器接收数据（非阻塞）
     int receive_data(uint8_t* buffer, uint8_t max_length);
+
+    // 设置 send_telemetry 是否使用紧凑格式（需要地面端支持类型0x08/0x09并回复确认）
+    void set_telemetry_compact(bool enable) { telemetry_compact = enable; }
+
+    // 发送一次遥测：紧凑格式发一帧关键帧或增量帧，否则分别发姿态、GPS、电池三帧
+    bool send_telemetry(const TelemetrySample& sample);
+
+    // 处理 receive_data 收到的一个数据报中的关键帧确认，返回确认数
+    int handle_uplink(const uint8_t* data, int length);
+
+    // 累计成功发送的字节数，用于统计链路占用
+    uint32_t get_sent_bytes() const { return sent_bytes; }
     
 };
 
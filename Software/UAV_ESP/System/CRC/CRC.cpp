@@ -0,0 +1,32 @@
+#include "CRC.h"
+#include "esp_rom_crc.h"
+
+// ============ CRC-32C 半字节表 ============
+// crc32c_nibble[i] = 4位输入i对应的余数（反转多项式0x82F63B78）
+static const uint32_t crc32c_nibble[16] = {
+    0x00000000, 0x105EC76F, 0x20BD8EDE, 0x30E349B1,
+    0x417B1DBC, 0x5125DAD3, 0x61C69362, 0x7198540D,
+    0x82F63B78, 0x92A8FC17, 0xA24BB5A6, 0xB21572C9,
+    0xC38D26C4, 0xD3D3E1AB, 0xE330A81A, 0xF36E6F75,
+};
+
+// ============ CRC-16/CCITT ============
+uint16_t crc16_ccitt(const uint8_t* data, size_t length)
+{
+    // ROM函数内部对输入输出都取反，按 CCITT-FALSE（初值0xFFFF，不取反输出）换算
+    return (uint16_t)~esp_rom_crc16_be((uint16_t)~0xFFFF, data, length);
+}
+
+// ============ CRC-32C ============
+uint32_t crc32c(const uint8_t* data, size_t length)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < length; i++)
+    {
+        crc ^= data[i];
+        // 每字节查两次表（低4位、高4位）
+        crc = (crc >> 4) ^ crc32c_nibble[crc & 0x0F];
+        crc = (crc >> 4) ^ crc32c_nibble[crc & 0x0F];
+    }
+    return crc ^ 0xFFFFFFFF;
+}
@@ -0,0 +1,28 @@
+#ifndef CRC_H
+#define CRC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief 帧校验CRC，参数与地面端 udp_ros_bridge/src/Crc 一致
+ * CRC-16/CCITT-FALSE：多项式0x1021，初值0xFFFF，使用ROM中的查表实现，不占用额外flash
+ * CRC-32C(Castagnoli)：ROM中只有IEEE多项式的CRC-32，这里用16项半字节表（64字节）
+ * 校验值 "123456789" -> CRC-16 0x29B1，CRC-32C 0xE3069283
+ */
+
+/**
+ * @brief 计算CRC-16/CCITT-FALSE
+ * @param data 数据
+ * @param length 数据长度
+ */
+uint16_t crc16_ccitt(const uint8_t* data, size_t length);
+
+/**
+ * @brief 计算CRC-32C
+ * @param data 数据
+ * @param length 数据长度
+ */
+uint32_t crc32c(const uint8_t* data, size_t length);
+
+#endif // CRC_H
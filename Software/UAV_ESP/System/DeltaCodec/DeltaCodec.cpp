@@ -0,0 +1,117 @@
+#include "DeltaCodec.h"
+#include <string.h>
+
+// ============ varint ============
+size_t write_svarint(int32_t value, uint8_t* out)
+{
+    uint32_t zigzag = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+    size_t n = 0;
+    while (zigzag >= 0x80)
+    {
+        out[n++] = (uint8_t)(zigzag | 0x80);
+        zigzag >>= 7;
+    }
+    out[n++] = (uint8_t)zigzag;
+    return n;
+}
+
+// ============ 采样字段 ============
+// 按掩码顺序取第i个字段
+static int32_t sample_field(const TelemetrySample& sample, int i)
+{
+    switch (i)
+    {
+        case 0: return sample.roll;
+        case 1: return sample.pitch;
+        case 2: return sample.yaw;
+        case 3: return sample.x;
+        case 4: return sample.y;
+        case 5: return sample.z;
+        default: return sample.batt;
+    }
+}
+
+static void write_keyframe(uint8_t key_id, const TelemetrySample& sample, uint8_t* params)
+{
+    params[0] = key_id;
+    params[1] = (uint8_t)(sample.roll >> 8);
+    params[2] = (uint8_t)sample.roll;
+    params[3] = (uint8_t)(sample.pitch >> 8);
+    params[4] = (uint8_t)sample.pitch;
+    params[5] = (uint8_t)(sample.yaw >> 8);
+    params[6] = (uint8_t)sample.yaw;
+    const int32_t position[3] = {sample.x, sample.y, sample.z};
+    for (int i = 0; i < 3; i++)
+    {
+        uint32_t value = (uint32_t)position[i];
+        params[7 + i * 4] = (uint8_t)(value >> 24);
+        params[8 + i * 4] = (uint8_t)(value >> 16);
+        params[9 + i * 4] = (uint8_t)(value >> 8);
+        params[10 + i * 4] = (uint8_t)value;
+    }
+    params[19] = sample.batt;
+}
+
+// ============ 编码 ============
+DeltaEncoder::DeltaEncoder(uint16_t keyframe_interval, uint16_t resend_interval)
+    : keyframe_interval(keyframe_interval), resend_interval(resend_interval)
+{
+}
+
+uint8_t DeltaEncoder::encode(const TelemetrySample& sample, uint8_t* params, uint8_t* length)
+{
+    since_keyframe++;
+    bool keyframe = !has_base || since_keyframe >= keyframe_interval ||
+                    (pending && since_keyframe >= resend_interval);
+    if (!keyframe)
+    {
+        uint8_t buffer[DELTA_MAX_LENGTH];
+        uint8_t mask = 0;
+        size_t n = 2;
+        for (int i = 0; i < TELEMETRY_FIELD_COUNT; i++)
+        {
+            // 32位回绕相减，地面按回绕相加还原
+            int32_t diff = (int32_t)((uint32_t)sample_field(sample, i) - (uint32_t)sample_field(base, i));
+            if (diff != 0)
+            {
+                mask |= 1 << i;
+                n += write_svarint(diff, buffer + n);
+            }
+        }
+        // 变化太大时增量不比关键帧短，改发关键帧
+        if (n < KEYFRAME_LENGTH)
+        {
+            buffer[0] = base_id;
+            buffer[1] = mask;
+            memcpy(params, buffer, n);
+            *length = (uint8_t)n;
+            return FRAME_TYPE_DELTA;
+        }
+    }
+
+    // 每个关键帧（含重发）取新帧号，迟到的旧确认不会把不同的值当作基准；
+    // 跳过与基准占同一存储位置的帧号，地面的基准关键帧不会被覆盖
+    pending_id = next_id++;
+    if (has_base && pending_id % KEYFRAME_SLOTS == base_id % KEYFRAME_SLOTS)
+    {
+        pending_id = next_id++;
+    }
+    pending = true;
+    pending_sample = sample;
+    since_keyframe = 0;
+    write_keyframe(pending_id, sample, params);
+    *length = KEYFRAME_LENGTH;
+    return FRAME_TYPE_KEYFRAME;
+}
+
+void DeltaEncoder::on_ack(uint8_t key_id)
+{
+    if (!pending || key_id != pending_id)
+    {
+        return;
+    }
+    has_base = true;
+    base_id = pending_id;
+    base = pending_sample;
+    pending = false;
+}
@@ -0,0 +1,82 @@
+#ifndef DELTA_CODEC_H
+#define DELTA_CODEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief 紧凑遥测编码，帧格式与地面端 udp_ros_bridge/src/DeltaCodec 一致
+ * 姿态、位置、电池合成一帧：
+ *   关键帧（类型0x08，20字节）：[关键帧号][roll:2][pitch:2][yaw:2][x:4][y:4][z:4][batt:1]，高位在前
+ *   增量帧（类型0x09）：[关键帧号][字段掩码][变化字段相对关键帧的 zig-zag varint 差值...]
+ *   关键帧确认（类型0x0A，地面->本机）：[关键帧号]
+ * 只以地面确认过的关键帧为基准发增量；没有基准、到了关键帧周期或增量不比关键帧短时发关键帧
+ */
+#define FRAME_TYPE_KEYFRAME 0x08
+#define FRAME_TYPE_DELTA 0x09
+#define FRAME_TYPE_KEYFRAME_ACK 0x0A
+
+// 关键帧参数长度
+#define KEYFRAME_LENGTH 20
+// 增量帧最长参数长度
+#define DELTA_MAX_LENGTH 28
+// 字段数：roll, pitch, yaw, x, y, z, batt
+#define TELEMETRY_FIELD_COUNT 7
+// 地面保存的关键帧数（按帧号低2位存放），新关键帧的帧号不与基准占同一位置
+#define KEYFRAME_SLOTS 4
+
+// 一次遥测采样（定点数）
+struct TelemetrySample {
+    int16_t roll = 0;
+    int16_t pitch = 0;
+    int16_t yaw = 0;
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t z = 0;
+    uint8_t batt = 0;
+};
+
+/**
+ * @brief 写一个 zig-zag 编码的有符号varint（每字节7位，低位在前）
+ * @return 写入的字节数（1~5）
+ */
+size_t write_svarint(int32_t value, uint8_t* out);
+
+class DeltaEncoder {
+private:
+    uint16_t keyframe_interval;
+    uint16_t resend_interval;
+    // 已确认的基准关键帧
+    bool has_base = false;
+    uint8_t base_id = 0;
+    TelemetrySample base;
+    // 已发出、等待确认的关键帧
+    bool pending = false;
+    uint8_t pending_id = 0;
+    TelemetrySample pending_sample;
+    uint16_t since_keyframe = 0;
+    uint8_t next_id = 0;
+
+public:
+    /**
+     * @param keyframe_interval 每隔多少次采样发一个新关键帧
+     * @param resend_interval 关键帧未被确认时，隔多少次采样重发
+     */
+    DeltaEncoder(uint16_t keyframe_interval = 50, uint16_t resend_interval = 10);
+
+    /**
+     * @brief 编码一次采样
+     * @param params 输出参数区，至少 KEYFRAME_LENGTH 字节
+     * @param length 输出参数长度
+     * @return 帧类型（FRAME_TYPE_KEYFRAME 或 FRAME_TYPE_DELTA）
+     */
+    uint8_t encode(const TelemetrySample& sample, uint8_t* params, uint8_t* length);
+
+    // 收到地面的关键帧确认
+    void on_ack(uint8_t key_id);
+
+    // 是否已有确认过的关键帧
+    bool has_keyframe() const { return has_base; }
+};
+
+#endif // DELTA_CODEC_H
@@ -0,0 +1,129 @@
+/**
+ * @file delta_codec_test.cpp
+ * @brief 紧凑遥测编码测试程序
+ * @note 模拟50Hz悬停和匀速飞行两种工况，统计旧格式（姿态、GPS、电池三帧）
+ *       与紧凑格式（关键帧+增量帧）每秒发送的字节数，并测量单次编码的CPU周期数。
+ *       地面端的解码正确性和解码耗时见 udp_ros_bridge/test/delta_codec_benchmark.cpp
+ */
+
+#include "../System/DeltaCodec/DeltaCodec.h"
+#include "esp_cpu.h"
+#include "esp_log.h"
+#include "esp_random.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static const char* TAG = "DeltaCodecTest";
+
+// 采样频率和模拟时长（采样数）
+#define SAMPLE_HZ 50
+#define TEST_SAMPLES (SAMPLE_HZ * 60)
+// 帧头尾、状态、长度、序号、加和校验
+#define FRAME_OVERHEAD 8
+// IPv4 + UDP 头
+#define DATAGRAM_OVERHEAD 28
+
+// 防止编译器把计算优化掉
+static volatile uint32_t sink;
+
+// 小幅噪声 [-amplitude, amplitude]
+static int32_t noise(int32_t amplitude)
+{
+    return (int32_t)(esp_random() % (2 * amplitude + 1)) - amplitude;
+}
+
+/**
+ * @brief 生成第i次采样
+ * @param speed 每次采样的位置变化（厘米），0为悬停
+ */
+static TelemetrySample make_sample(int i, int32_t speed)
+{
+    TelemetrySample sample;
+    sample.roll = (int16_t)(20 + noise(4));
+    sample.pitch = (int16_t)(-15 + noise(4));
+    sample.yaw = (int16_t)(900 + i / 10);
+    sample.x = 5000 + speed * i + noise(2);
+    sample.y = -2000 + speed / 2 * i + noise(2);
+    sample.z = 1500 + noise(2);
+    sample.batt = (uint8_t)(168 - i / 3000);
+    return sample;
+}
+
+/**
+ * @brief 统计一种工况下的字节率和编码耗时
+ * @note 每个关键帧都立即确认，相当于链路不丢包
+ */
+static void test_link_bytes(const char* name, int32_t speed)
+{
+    DeltaEncoder encoder;
+    uint8_t params[KEYFRAME_LENGTH];
+    uint8_t length = 0;
+    uint32_t compact_bytes = 0;
+    uint32_t keyframes = 0;
+    uint32_t cycles = 0;
+    uint32_t acc = 0;
+
+    for (int i = 0; i < TEST_SAMPLES; i++) {
+        TelemetrySample sample = make_sample(i, speed);
+        uint32_t start = esp_cpu_get_cycle_count();
+        uint8_t type = encoder.encode(sample, params, &length);
+        cycles += esp_cpu_get_cycle_count() - start;
+        if (type == FRAME_TYPE_KEYFRAME) {
+            keyframes++;
+            encoder.on_ack(params[0]);
+        }
+        compact_bytes += length + FRAME_OVERHEAD + DATAGRAM_OVERHEAD;
+        acc += params[0];
+    }
+    sink = acc;
+
+    uint32_t legacy_bytes = (6 + 12 + 1 + 3 * FRAME_OVERHEAD + 3 * DATAGRAM_OVERHEAD) * TEST_SAMPLES;
+    uint32_t seconds = TEST_SAMPLES / SAMPLE_HZ;
+    ESP_LOGI(TAG, "%s：旧格式 %lu 字节/秒，紧凑格式 %lu 字节/秒（含IP/UDP头），关键帧 %lu 帧，编码 %lu 周期/采样",
+             name, legacy_bytes / seconds, compact_bytes / seconds, keyframes, cycles / TEST_SAMPLES);
+}
+
+/**
+ * @brief 测试确认丢失时的重发
+ */
+static void test_lost_ack()
+{
+    ESP_LOGI(TAG, "=== 测试确认丢失 ===");
+    DeltaEncoder encoder(50, 10);
+    uint8_t params[KEYFRAME_LENGTH];
+    uint8_t length = 0;
+
+    // 没有确认前每次都发关键帧
+    TelemetrySample sample = make_sample(0, 0);
+    bool ok = encoder.encode(sample, params, &length) == FRAME_TYPE_KEYFRAME &&
+              encoder.encode(sample, params, &length) == FRAME_TYPE_KEYFRAME;
+    // 迟到的旧确认无效
+    encoder.on_ack((uint8_t)(params[0] - 1));
+    ok = ok && !encoder.has_keyframe();
+    encoder.on_ack(params[0]);
+    ok = ok && encoder.has_keyframe() && encoder.encode(sample, params, &length) == FRAME_TYPE_DELTA;
+    // 与关键帧相同的采样只有帧号和掩码
+    ok = ok && length == 2 && params[1] == 0;
+    ESP_LOGI(TAG, "确认丢失与重发: %s", ok ? "通过" : "失败");
+}
+
+/**
+ * @brief 主测试函数
+ */
+void delta_codec_test_main() {
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "          紧凑遥测编码测试");
+    ESP_LOGI(TAG, "========================================");
+
+    test_lost_ack();
+    vTaskDelay(100 / portTICK_PERIOD_MS);
+
+    ESP_LOGI(TAG, "=== 测试每架无人机字节率（%dHz） ===", SAMPLE_HZ);
+    test_link_bytes("悬停", 0);
+    test_link_bytes("匀速 1m/s", 2);
+    test_link_bytes("匀速 5m/s", 10);
+
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "           测试完成");
+    ESP_LOGI(TAG, "========================================");
+}
@@ -0,0 +1,105 @@
+/**
+ * @file frame_crc_test.cpp
+ * @brief 帧校验CRC测试程序
+ * @note 验证CRC-16/CCITT（ROM）和CRC-32C（半字节表）的标准校验值，
+ *       并测量不同参数长度下加和校验与两种CRC的单帧CPU周期数
+ */
+
+#include "../System/CRC/CRC.h"
+#include "esp_cpu.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static const char* TAG = "FrameCrcTest";
+
+#define TEST_ITERATIONS 10000
+
+// 防止编译器把计算优化掉
+static volatile uint32_t sink;
+
+static uint8_t sum8(const uint8_t* data, size_t length)
+{
+    uint8_t sum = 0;
+    for (size_t i = 0; i < length; i++) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+/**
+ * @brief 测试标准校验值
+ */
+void test_check_values() {
+    ESP_LOGI(TAG, "=== 测试标准校验值 ===");
+
+    const uint8_t text[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    uint16_t crc16 = crc16_ccitt(text, sizeof(text));
+    uint32_t crc32 = crc32c(text, sizeof(text));
+
+    ESP_LOGI(TAG, "CRC-16/CCITT: 0x%04X (期望 0x29B1) %s", crc16, crc16 == 0x29B1 ? "通过" : "失败");
+    ESP_LOGI(TAG, "CRC-32C:      0x%08lX (期望 0xE3069283) %s", crc32,
+             crc32 == 0xE3069283 ? "通过" : "失败");
+}
+
+/**
+ * @brief 测试单帧校验耗时
+ */
+void test_frame_cost() {
+    ESP_LOGI(TAG, "=== 测试单帧校验耗时（CPU周期） ===");
+
+    uint8_t buffer[66];
+    for (int i = 0; i < (int)sizeof(buffer); i++) {
+        buffer[i] = (uint8_t)(i * 37 + 11);
+    }
+
+    // 参数长度：ID/电池1字节、PID 3字节、姿态6字节、GPS 12字节、较长的自定义帧64字节
+    const uint8_t lengths[] = {1, 3, 6, 12, 64};
+    const int length_count = sizeof(lengths) / sizeof(lengths[0]);
+
+    for (int i = 0; i < length_count; i++) {
+        // 覆盖范围 = 状态位 + 长度 + 参数
+        size_t covered = 2 + lengths[i];
+        uint32_t acc = 0;
+
+        uint32_t start = esp_cpu_get_cycle_count();
+        for (int n = 0; n < TEST_ITERATIONS; n++) {
+            acc += sum8(buffer, covered);
+        }
+        uint32_t sum_cycles = (esp_cpu_get_cycle_count() - start) / TEST_ITERATIONS;
+
+        start = esp_cpu_get_cycle_count();
+        for (int n = 0; n < TEST_ITERATIONS; n++) {
+            acc += crc16_ccitt(buffer, covered);
+        }
+        uint32_t crc16_cycles = (esp_cpu_get_cycle_count() - start) / TEST_ITERATIONS;
+
+        start = esp_cpu_get_cycle_count();
+        for (int n = 0; n < TEST_ITERATIONS; n++) {
+            acc += crc32c(buffer, covered);
+        }
+        uint32_t crc32_cycles = (esp_cpu_get_cycle_count() - start) / TEST_ITERATIONS;
+        sink = acc;
+
+        ESP_LOGI(TAG, "参数 %2d 字节 -> 加和 %4lu 周期, CRC-16 %4lu 周期, CRC-32C %4lu 周期",
+                 lengths[i], sum_cycles, crc16_cycles, crc32_cycles);
+    }
+}
+
+/**
+ * @brief 主测试函数
+ */
+void frame_crc_test_main() {
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "          帧校验CRC测试");
+    ESP_LOGI(TAG, "========================================");
+
+    test_check_values();
+    vTaskDelay(100 / portTICK_PERIOD_MS);
+
+    test_frame_cost();
+
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "           测试完成");
+    ESP_LOGI(TAG, "========================================");
+}